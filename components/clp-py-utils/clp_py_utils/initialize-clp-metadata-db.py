@@ -43,12 +43,28 @@ def main(argv):
                     `size` BIGINT NOT NULL,
                     `creator_id` VARCHAR(64) NOT NULL,
                     `creation_ix` INT NOT NULL,
+                    `is_finalized` BOOL NOT NULL DEFAULT FALSE,
                     KEY `archives_creation_order` (`creator_id`,`creation_ix`) USING BTREE,
                     UNIQUE KEY `archive_id` (`id`) USING BTREE,
                     PRIMARY KEY (`pagination_id`)
                 );
                 """)
 
+            # Archives tables created before archives were marked finalized lack the column, so add it. Archives in such tables were
+            # created by compressors that didn't mark them, so they're treated as finalized.
+            metadata_db_cursor.execute(f"""
+                SELECT COUNT(*) AS `num_columns` FROM `information_schema`.`COLUMNS`
+                WHERE `TABLE_SCHEMA` = DATABASE() AND `TABLE_NAME` = '{table_prefix}archives' AND `COLUMN_NAME` = 'is_finalized'
+                """)
+            if 0 == metadata_db_cursor.fetchone()['num_columns']:
+                metadata_db_cursor.execute(f"""
+                    ALTER TABLE `{table_prefix}archives` ADD COLUMN `is_finalized` BOOL NOT NULL DEFAULT TRUE
+                    """)
+                # New archives aren't finalized until the compressor marks them so
+                metadata_db_cursor.execute(f"""
+                    ALTER TABLE `{table_prefix}archives` ALTER COLUMN `is_finalized` SET DEFAULT FALSE
+                    """)
+
             metadata_db_cursor.execute(f"""
                 CREATE TABLE IF NOT EXISTS `{table_prefix}files` (
                     `id` VARCHAR(64) NOT NULL,
@@ -2,34 +2,28 @@
 #define ARRAYBACKEDPOSINTSET_HPP
 
 // C++ standard libraries
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 // Project headers
+#include "Bitmap.hpp"
 #include "Defs.h"
-#include "spdlog_with_specializations.hpp"
 #include "streaming_compression/zstd/Compressor.hpp"
-#include "TraceableException.hpp"
 
 /**
- * Template class of set implemented with vector<bool> for continuously increasing numeric value
+ * Template class of set for positive integer values that are allocated in increasing order (e.g., dictionary IDs). The value range is split into
+ * fixed-size chunks and only the chunks containing values are allocated. A chunk's values are stored as a sorted array of offsets while the
+ * chunk is sparse, and as a bitmap once the bitmap would be smaller, so the set's size depends on the number of values rather than the largest
+ * value.
  * @tparam PosIntType
  */
 template<typename PosIntType>
 class ArrayBackedPosIntSet {
 public:
-    // Types
-    class OperationFailed : public TraceableException {
-    public:
-        // Constructors
-        OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException(error_code, filename, line_number) {}
-
-        // Methods
-        const char* what () const noexcept override {
-            return "ArrayBackedPosIntSet operation failed";
-        }
-    };
-
     // Constructors
     ArrayBackedPosIntSet ();
 
@@ -42,7 +36,12 @@ public:
     size_t size () const { return m_size; }
 
     /**
-     * Clears the set and restores its initial capacity
+     * Gets the number of chunks of the value range that contain values (and so are allocated)
+     */
+    size_t get_num_chunks () const { return m_chunks.size(); }
+
+    /**
+     * Clears the set
      */
     void clear ();
 
@@ -67,29 +66,76 @@ public:
     void insert_all (const std::vector<PosIntType>& input_vector);
 
     /**
-     * Writes all values in the set into the given compressor
+     * Writes all values in the set into the given compressor, in increasing order
      * @param compressor
      */
     void write_to_compressor (streaming_compression::Compressor& compressor) const;
 
 private:
+    // Constants
+    static constexpr size_t cNumValueBitsPerChunk = 16;
+    static constexpr size_t cNumValuesPerChunk = (size_t)1 << cNumValueBitsPerChunk;
+    // A chunk is converted to a bitmap once its sorted array of offsets would be larger than the bitmap
+    static constexpr size_t cMaxNumValuesInSparseChunk = cNumValuesPerChunk / (sizeof(uint16_t) * 8);
+
+    // Types
+    /**
+     * The values in one chunk of the value range, stored as offsets from the start of the chunk
+     */
+    class Chunk {
+    public:
+        // Constructors
+        Chunk () : m_is_dense(false), m_num_values(0) {}
+
+        // Methods
+        size_t size () const { return m_num_values; }
+
+        /**
+         * @param offset
+         * @return Whether the offset was not already in the chunk
+         */
+        bool insert (uint16_t offset);
+        /**
+         * Inserts all offsets from the given chunk
+         * @param chunk
+         * @return The number of offsets that were not already in this chunk
+         */
+        size_t insert_all (const Chunk& chunk);
+
+        /**
+         * Writes all values in the chunk into the given compressor, in increasing order
+         * @param first_value The value at offset 0 of the chunk
+         * @param compressor
+         */
+        void write_to_compressor (uint64_t first_value, streaming_compression::Compressor& compressor) const;
+
+    private:
+        // Methods
+        void convert_to_bitmap ();
+
+        // Variables
+        bool m_is_dense;
+        size_t m_num_values;
+        // Used while the chunk is sparse
+        std::vector<uint16_t> m_sorted_offsets;
+        // Used once the chunk is dense
+        Bitmap m_bitmap;
+    };
+
     // Methods
     /**
-     * Increases the capacity of the bool array so that
-     * the given value becomes a valid index in the array
-     * @param value
+     * @param chunk_ix
+     * @return The chunk with the given index, adding an empty chunk if it doesn't exist
      */
-    void increase_capacity (size_t value);
+    Chunk& get_or_add_chunk (uint64_t chunk_ix);
 
     // Variables
-    std::vector<bool> m_data;
+    // Chunks which contain values and their indices (value >> cNumValueBitsPerChunk), sorted by index
+    std::vector<std::pair<uint64_t, Chunk>> m_chunks;
     size_t m_initial_capacity;
 
     // The number of unique values in the set
     size_t m_size;
-
-    // The largest value in the set
-    PosIntType m_largest_value;
 };
 
 template<typename PosIntType>
@@ -107,53 +153,26 @@ ArrayBackedPosIntSet<PosIntType>::ArrayBackedPosIntSet (size_t initial_capacity)
 
 template<typename PosIntType>
 void ArrayBackedPosIntSet<PosIntType>::clear () {
-    m_data.clear();
-    m_data.resize(m_initial_capacity, false);
+    m_chunks.clear();
+    m_chunks.reserve((m_initial_capacity + cNumValuesPerChunk - 1) / cNumValuesPerChunk);
     m_size = 0;
-    m_largest_value = 0;
 }
 
 template<typename PosIntType>
 void ArrayBackedPosIntSet<PosIntType>::insert (PosIntType value) {
-    if (value >= m_data.size()) {
-        increase_capacity(value);
-    }
-
-    // Add the value if it is not already in the set
-    if (false == m_data[value]) {
-        m_data[value] = true;
-        m_size++;
-
-        // Update the largest value if necessary
-        if (value > m_largest_value) {
-            m_largest_value = value;
-        }
+    auto chunk_ix = static_cast<uint64_t>(value) >> cNumValueBitsPerChunk;
+    if (get_or_add_chunk(chunk_ix).insert(static_cast<uint16_t>(value))) {
+        ++m_size;
     }
 }
 
 template<typename PosIntType>
 void ArrayBackedPosIntSet<PosIntType>::insert_all (const ArrayBackedPosIntSet<PosIntType>& input_set) {
-    // Increase capacity if necessary
-    size_t input_set_largest_value = input_set.m_largest_value;
-    if (input_set_largest_value >= m_data.size()) {
-        increase_capacity(input_set_largest_value);
-    }
-
-    // Copy values from the input set
-    auto input_set_data = input_set.m_data;
-    for (auto value = 0; value <= input_set_largest_value; ++value) {
-        // Add a value only if
-        // - doesn't exist in this set
-        // - exists in the input set
-        if (false == m_data[value] && input_set_data[value]) {
-            m_data[value] = true;
-            m_size++;
-        }
+    if (&input_set == this) {
+        return;
     }
-
-    // Update the largest value if necessary
-    if (input_set_largest_value > m_largest_value) {
-        m_largest_value = input_set_largest_value;
+    for (const auto& [chunk_ix, chunk] : input_set.m_chunks) {
+        m_size += get_or_add_chunk(chunk_ix).insert_all(chunk);
     }
 }
 
@@ -173,25 +192,110 @@ void ArrayBackedPosIntSet<PosIntType>::insert_all (const std::vector<PosIntType>
 
 template<typename PosIntType>
 void ArrayBackedPosIntSet<PosIntType>::write_to_compressor (streaming_compression::Compressor& compressor) const {
-    for (PosIntType value = 0; value <= m_largest_value; ++value) {
-        if (m_data[value]) {
-            compressor.write_numeric_value(value);
+    for (const auto& [chunk_ix, chunk] : m_chunks) {
+        chunk.write_to_compressor(chunk_ix << cNumValueBitsPerChunk, compressor);
+    }
+}
+
+template<typename PosIntType>
+typename ArrayBackedPosIntSet<PosIntType>::Chunk& ArrayBackedPosIntSet<PosIntType>::get_or_add_chunk (uint64_t chunk_ix) {
+    // Values are usually inserted in increasing order, so avoid searching for the chunk
+    if (false == m_chunks.empty() && m_chunks.back().first == chunk_ix) {
+        return m_chunks.back().second;
+    }
+    if (m_chunks.empty() || chunk_ix > m_chunks.back().first) {
+        return m_chunks.emplace_back(chunk_ix, Chunk()).second;
+    }
+
+    auto it = std::lower_bound(m_chunks.begin(), m_chunks.end(), chunk_ix,
+                               [] (const std::pair<uint64_t, Chunk>& entry, uint64_t ix) { return entry.first < ix; });
+    if (it->first != chunk_ix) {
+        it = m_chunks.emplace(it, chunk_ix, Chunk());
+    }
+    return it->second;
+}
+
+template<typename PosIntType>
+bool ArrayBackedPosIntSet<PosIntType>::Chunk::insert (uint16_t offset) {
+    if (m_is_dense) {
+        if (m_bitmap.test(offset)) {
+            return false;
+        }
+        m_bitmap.set(offset);
+    } else if (m_sorted_offsets.empty() || offset > m_sorted_offsets.back()) {
+        // Values are usually inserted in increasing order, so avoid searching for the insertion point
+        m_sorted_offsets.push_back(offset);
+    } else {
+        auto it = std::lower_bound(m_sorted_offsets.begin(), m_sorted_offsets.end(), offset);
+        if (*it == offset) {
+            return false;
+        }
+        m_sorted_offsets.insert(it, offset);
+    }
+    ++m_num_values;
+
+    if (false == m_is_dense && m_num_values > cMaxNumValuesInSparseChunk) {
+        convert_to_bitmap();
+    }
+    return true;
+}
+
+template<typename PosIntType>
+size_t ArrayBackedPosIntSet<PosIntType>::Chunk::insert_all (const Chunk& chunk) {
+    if (0 == chunk.m_num_values) {
+        return 0;
+    }
+
+    auto prev_num_values = m_num_values;
+    if (false == m_is_dense && false == chunk.m_is_dense) {
+        std::vector<uint16_t> merged_offsets;
+        merged_offsets.reserve(m_sorted_offsets.size() + chunk.m_sorted_offsets.size());
+        std::set_union(m_sorted_offsets.cbegin(), m_sorted_offsets.cend(), chunk.m_sorted_offsets.cbegin(), chunk.m_sorted_offsets.cend(),
+                       std::back_inserter(merged_offsets));
+        m_sorted_offsets.swap(merged_offsets);
+        m_num_values = m_sorted_offsets.size();
+        if (m_num_values > cMaxNumValuesInSparseChunk) {
+            convert_to_bitmap();
+        }
+    } else {
+        if (false == m_is_dense) {
+            convert_to_bitmap();
         }
+        if (chunk.m_is_dense) {
+            m_bitmap |= chunk.m_bitmap;
+        } else {
+            for (auto offset : chunk.m_sorted_offsets) {
+                m_bitmap.set(offset);
+            }
+        }
+        m_num_values = m_bitmap.count();
     }
+
+    return m_num_values - prev_num_values;
 }
 
 template<typename PosIntType>
-void ArrayBackedPosIntSet<PosIntType>::increase_capacity (size_t value) {
-    if (value < m_data.size()) {
-        SPDLOG_ERROR("Calling increase_capacity on value smaller than capacity.");
-        throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
+void ArrayBackedPosIntSet<PosIntType>::Chunk::write_to_compressor (uint64_t first_value, streaming_compression::Compressor& compressor) const {
+    if (m_is_dense) {
+        for (auto offset = m_bitmap.find_next(0); offset < m_bitmap.size(); offset = m_bitmap.find_next(offset + 1)) {
+            compressor.write_numeric_value(static_cast<PosIntType>(first_value + offset));
+        }
+    } else {
+        for (auto offset : m_sorted_offsets) {
+            compressor.write_numeric_value(static_cast<PosIntType>(first_value + offset));
+        }
     }
-    auto capacity = m_data.size();
-    do {
-        capacity += capacity / 2;
-    } while (capacity <= value);
+}
 
-    m_data.resize(capacity, false);
+template<typename PosIntType>
+void ArrayBackedPosIntSet<PosIntType>::Chunk::convert_to_bitmap () {
+    m_bitmap.resize_and_clear(cNumValuesPerChunk);
+    for (auto offset : m_sorted_offsets) {
+        m_bitmap.set(offset);
+    }
+    m_sorted_offsets.clear();
+    m_sorted_offsets.shrink_to_fit();
+    m_is_dense = true;
 }
 
 #endif //ARRAYBACKEDPOSINTSET_HPP
@@ -0,0 +1,120 @@
+#include "Bitmap.hpp"
+
+// C standard libraries
+#include <sys/stat.h>
+
+// C++ standard libraries
+#include <algorithm>
+
+void Bitmap::resize_and_clear (size_t num_bits) {
+    m_num_bits = num_bits;
+    m_words.assign((num_bits + cNumBitsPerWord - 1) / cNumBitsPerWord, 0);
+}
+
+void Bitmap::resize (size_t num_bits) {
+    m_words.resize((num_bits + cNumBitsPerWord - 1) / cNumBitsPerWord, 0);
+    if (num_bits < m_num_bits && num_bits % cNumBitsPerWord != 0) {
+        // Unset the bits that are now past the end of the last word
+        m_words.back() &= ~(~(uint64_t)0 << (num_bits % cNumBitsPerWord));
+    }
+    m_num_bits = num_bits;
+}
+
+size_t Bitmap::count () const {
+    size_t num_set_bits = 0;
+    for (auto word : m_words) {
+        num_set_bits += __builtin_popcountll(word);
+    }
+    return num_set_bits;
+}
+
+bool Bitmap::none () const {
+    for (auto word : m_words) {
+        if (0 != word) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Bitmap::find_next (size_t ix) const {
+    if (ix >= m_num_bits) {
+        return m_num_bits;
+    }
+
+    auto word_ix = ix / cNumBitsPerWord;
+    // Ignore the bits before ix in its word
+    auto word = m_words[word_ix] & (~(uint64_t)0 << (ix % cNumBitsPerWord));
+    while (0 == word) {
+        ++word_ix;
+        if (word_ix >= m_words.size()) {
+            return m_num_bits;
+        }
+        word = m_words[word_ix];
+    }
+    return word_ix * cNumBitsPerWord + __builtin_ctzll(word);
+}
+
+Bitmap& Bitmap::operator&= (const Bitmap& rhs) {
+    auto num_common_words = std::min(m_words.size(), rhs.m_words.size());
+    for (size_t i = 0; i < num_common_words; ++i) {
+        m_words[i] &= rhs.m_words[i];
+    }
+    std::fill(m_words.begin() + num_common_words, m_words.end(), 0);
+    return *this;
+}
+
+Bitmap& Bitmap::operator|= (const Bitmap& rhs) {
+    if (rhs.m_num_bits > m_num_bits) {
+        resize(rhs.m_num_bits);
+    }
+    for (size_t i = 0; i < rhs.m_words.size(); ++i) {
+        m_words[i] |= rhs.m_words[i];
+    }
+    return *this;
+}
+
+Bitmap& Bitmap::subtract (const Bitmap& rhs) {
+    auto num_common_words = std::min(m_words.size(), rhs.m_words.size());
+    for (size_t i = 0; i < num_common_words; ++i) {
+        m_words[i] &= ~rhs.m_words[i];
+    }
+    return *this;
+}
+
+void Bitmap::write_to_file (WriterInterface& writer) const {
+    writer.write_numeric_value<uint64_t>(m_num_bits);
+    writer.write(reinterpret_cast<const char*>(m_words.data()), m_words.size() * sizeof(uint64_t));
+}
+
+ErrorCode Bitmap::try_read_from_file (FileReader& reader) {
+    uint64_t num_bits;
+    auto error_code = reader.try_read_numeric_value(num_bits);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+
+    // Ensure the file could contain all the bits before allocating space for them, so a corrupt count can't exhaust memory
+    size_t pos;
+    error_code = reader.try_get_pos(pos);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    struct stat stat_buffer = {};
+    error_code = reader.try_fstat(stat_buffer);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    size_t file_size = stat_buffer.st_size;
+    size_t num_remaining_words = (file_size > pos) ? (file_size - pos) / sizeof(uint64_t) : 0;
+    if (num_bits / cNumBitsPerWord + (0 != num_bits % cNumBitsPerWord) > num_remaining_words) {
+        return ErrorCode_Corrupt;
+    }
+
+    resize_and_clear(num_bits);
+    error_code = reader.try_read_exact_length(reinterpret_cast<char*>(m_words.data()), m_words.size() * sizeof(uint64_t));
+    if (ErrorCode_EndOfFile == error_code) {
+        return ErrorCode_Truncated;
+    }
+    return error_code;
+}
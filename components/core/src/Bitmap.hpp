@@ -0,0 +1,119 @@
+#ifndef BITMAP_HPP
+#define BITMAP_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Project headers
+#include "ErrorCode.hpp"
+#include "FileReader.hpp"
+#include "WriterInterface.hpp"
+
+/**
+ * Class representing a set of bits, stored as 64-bit words so that bitwise operations between bitmaps process 64 bits at a time. It can also be
+ * used as a compact set of small non-negative integers (e.g., dictionary or segment IDs) with constant-time membership tests.
+ */
+class Bitmap {
+public:
+    // Constructors
+    Bitmap () : m_num_bits(0) {}
+
+    explicit Bitmap (size_t num_bits) { resize_and_clear(num_bits); }
+
+    // Methods
+    /**
+     * Resizes the bitmap to the given number of bits, all of which are unset
+     * @param num_bits
+     */
+    void resize_and_clear (size_t num_bits);
+
+    /**
+     * Resizes the bitmap to the given number of bits, keeping the values of the existing bits that are still in range. Any new bits are
+     * unset.
+     * @param num_bits
+     */
+    void resize (size_t num_bits);
+
+    size_t size () const { return m_num_bits; }
+
+    void set (size_t ix) { m_words[ix / cNumBitsPerWord] |= (uint64_t)1 << (ix % cNumBitsPerWord); }
+    void reset (size_t ix) { m_words[ix / cNumBitsPerWord] &= ~((uint64_t)1 << (ix % cNumBitsPerWord)); }
+    bool test (size_t ix) const { return (m_words[ix / cNumBitsPerWord] >> (ix % cNumBitsPerWord)) & 1; }
+    /**
+     * Sets the given bit, growing the bitmap if the bit is out of range
+     * @param ix
+     */
+    void insert (size_t ix) {
+        if (ix >= m_num_bits) {
+            resize(ix + 1);
+        }
+        set(ix);
+    }
+    /**
+     * @param ix
+     * @return Whether the given bit is in range and set
+     */
+    bool contains (size_t ix) const { return ix < m_num_bits && test(ix); }
+
+    /**
+     * @return The number of set bits
+     */
+    size_t count () const;
+    /**
+     * @return Whether no bits are set
+     */
+    bool none () const;
+    /**
+     * Finds the first set bit at or after the given index
+     * @param ix
+     * @return The index of the set bit, or size() if there's none
+     */
+    size_t find_next (size_t ix) const;
+
+    /**
+     * Sets this bitmap to the intersection of itself and the given bitmap. Bits beyond the end of the given bitmap are treated as unset.
+     * @param rhs
+     * @return This bitmap
+     */
+    Bitmap& operator&= (const Bitmap& rhs);
+    /**
+     * Sets this bitmap to the union of itself and the given bitmap, growing this bitmap if the given one is larger
+     * @param rhs
+     * @return This bitmap
+     */
+    Bitmap& operator|= (const Bitmap& rhs);
+    /**
+     * Unsets the bits that are set in the given bitmap
+     * @param rhs
+     * @return This bitmap
+     */
+    Bitmap& subtract (const Bitmap& rhs);
+
+    /**
+     * Writes the bitmap to the given writer
+     * @param writer
+     */
+    void write_to_file (WriterInterface& writer) const;
+    /**
+     * Tries to read a bitmap written by write_to_file from the given reader, replacing this bitmap's contents
+     * @param reader
+     * @return ErrorCode_Corrupt if the file is too small to contain the number of bits the bitmap claims to have
+     * @return ErrorCode_Truncated if the reader ended before the end of the bitmap
+     * @return Same as FileReader::try_get_pos and FileReader::try_fstat
+     * @return Same as ReaderInterface::try_read_numeric_value otherwise
+     */
+    ErrorCode try_read_from_file (FileReader& reader);
+
+private:
+    // Constants
+    static constexpr size_t cNumBitsPerWord = 64;
+
+    // Variables
+    size_t m_num_bits;
+    // NOTE: The bits past m_num_bits in the last word are always unset
+    std::vector<uint64_t> m_words;
+};
+
+#endif // BITMAP_HPP
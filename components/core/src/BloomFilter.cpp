@@ -0,0 +1,91 @@
+#include "BloomFilter.hpp"
+
+// C++ standard libraries
+#include <algorithm>
+#include <cmath>
+
+// Local prototypes
+/**
+ * Mixes the bits of the given value using the splitmix64 finalizer
+ * @param value
+ * @return The mixed value
+ */
+static uint64_t mix_bits (uint64_t value);
+
+static uint64_t mix_bits (uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+BloomFilter::BloomFilter (size_t num_expected_values, double false_positive_rate) {
+    // The optimal number of bits is -n * ln(p) / ln(2)^2, and the optimal number of hash functions is (bits / n) * ln(2)
+    const double ln2 = std::log(2.0);
+    auto num_values = static_cast<double>(std::max<size_t>(num_expected_values, 1));
+    auto num_bits = static_cast<size_t>(std::ceil(-num_values * std::log(false_positive_rate) / (ln2 * ln2)));
+    num_bits = std::max<size_t>(num_bits, 64);
+    m_bitmap.resize_and_clear(num_bits);
+    m_num_hash_functions = std::max<size_t>(std::lround(static_cast<double>(num_bits) / num_values * ln2), 1);
+}
+
+uint64_t BloomFilter::hash (std::string_view value) {
+    // 64-bit FNV-1a, with the result mixed so that similar values are spread across all bits
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (auto c : value) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return mix_bits(hash);
+}
+
+void BloomFilter::add (uint64_t hash) {
+    // Derive each hash function's bit from the hash and a remix of it (Kirsch-Mitzenmacher double hashing)
+    const auto num_bits = m_bitmap.size();
+    uint64_t h1 = hash;
+    uint64_t h2 = mix_bits(hash) | 1;
+    for (size_t i = 0; i < m_num_hash_functions; ++i) {
+        m_bitmap.set((h1 + i * h2) % num_bits);
+    }
+}
+
+bool BloomFilter::possibly_contains (uint64_t hash) const {
+    if (0 == m_num_hash_functions) {
+        // Empty filter
+        return false;
+    }
+
+    const auto num_bits = m_bitmap.size();
+    uint64_t h1 = hash;
+    uint64_t h2 = mix_bits(hash) | 1;
+    for (size_t i = 0; i < m_num_hash_functions; ++i) {
+        if (false == m_bitmap.test((h1 + i * h2) % num_bits)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BloomFilter::write_to_file (WriterInterface& writer) const {
+    writer.write_numeric_value<uint64_t>(m_num_hash_functions);
+    m_bitmap.write_to_file(writer);
+}
+
+ErrorCode BloomFilter::try_read_from_file (FileReader& reader) {
+    uint64_t num_hash_functions;
+    auto error_code = reader.try_read_numeric_value(num_hash_functions);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    error_code = m_bitmap.try_read_from_file(reader);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    if (num_hash_functions > 0 && 0 == m_bitmap.size()) {
+        return ErrorCode_Corrupt;
+    }
+    m_num_hash_functions = num_hash_functions;
+    return ErrorCode_Success;
+}
@@ -0,0 +1,73 @@
+#ifndef BLOOMFILTER_HPP
+#define BLOOMFILTER_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Project headers
+#include "Bitmap.hpp"
+#include "ErrorCode.hpp"
+#include "FileReader.hpp"
+#include "WriterInterface.hpp"
+
+/**
+ * A Bloom filter over 64-bit hashes of values. It can answer whether a value was definitely not added to the filter, or whether it possibly was,
+ * with a false positive rate chosen at construction.
+ */
+class BloomFilter {
+public:
+    // Constructors
+    BloomFilter () : m_num_hash_functions(0) {}
+
+    /**
+     * Constructs a filter sized so that once it contains the given number of values, its false positive rate is approximately the given rate
+     * @param num_expected_values
+     * @param false_positive_rate
+     */
+    BloomFilter (size_t num_expected_values, double false_positive_rate);
+
+    // Methods
+    /**
+     * @param value
+     * @return A hash of the given value suitable for adding to or querying the filter. The hash is the same across processes and platforms.
+     */
+    static uint64_t hash (std::string_view value);
+
+    /**
+     * Adds the value with the given hash to the filter
+     * @param hash
+     */
+    void add (uint64_t hash);
+    /**
+     * @param hash
+     * @return false if the value with the given hash was definitely not added to the filter, true otherwise
+     */
+    bool possibly_contains (uint64_t hash) const;
+
+    /**
+     * @return The number of bytes used by the filter's bits
+     */
+    size_t get_size_in_bytes () const { return (m_bitmap.size() + 7) / 8; }
+
+    /**
+     * Writes the filter to the given writer
+     * @param writer
+     */
+    void write_to_file (WriterInterface& writer) const;
+    /**
+     * Tries to read a filter written by write_to_file from the given reader, replacing this filter
+     * @param reader
+     * @return ErrorCode_Corrupt if the filter is invalid
+     * @return Same as Bitmap::try_read_from_file otherwise
+     */
+    ErrorCode try_read_from_file (FileReader& reader);
+
+private:
+    // Variables
+    Bitmap m_bitmap;
+    size_t m_num_hash_functions;
+};
+
+#endif // BLOOMFILTER_HPP
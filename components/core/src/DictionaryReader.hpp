@@ -3,6 +3,7 @@
 
 // C++ standard libraries
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 // Boost libraries
@@ -12,6 +13,7 @@
 #include "dictionary_utils.hpp"
 #include "DictionaryEntry.hpp"
 #include "FileReader.hpp"
+#include "MultiWildcardMatcher.hpp"
 #include "streaming_compression/passthrough/Decompressor.hpp"
 #include "streaming_compression/zstd/Decompressor.hpp"
 #include "string_utils.hpp"
@@ -92,6 +94,14 @@ public:
      * @param entries Set in which to store found entries
      */
     void get_entries_matching_wildcard_string (const std::string& wildcard_string, bool ignore_case, std::unordered_set<const EntryType*>& entries) const;
+    /**
+     * Gets the entries that match each of the given wildcard strings, in a single pass over the dictionary
+     * @param wildcard_strings
+     * @param ignore_case
+     * @param entries Returns the set of entries matching each wildcard string
+     */
+    void get_entries_matching_wildcard_strings (const std::vector<std::string>& wildcard_strings, bool ignore_case,
+                                                std::vector<std::unordered_set<const EntryType*>>& entries) const;
 
 protected:
     // Methods
@@ -187,6 +197,7 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_new_entries () {
         for (size_t i = m_num_segments_read_from_index; i < num_segments; ++i) {
             read_segment_ids();
         }
+        m_num_segments_read_from_index = num_segments;
     }
 }
 
@@ -241,6 +252,24 @@ void DictionaryReader<DictionaryIdType, EntryType>::get_entries_matching_wildcar
     }
 }
 
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryReader<DictionaryIdType, EntryType>::get_entries_matching_wildcard_strings (const std::vector<std::string>& wildcard_strings,
+                                                                                           bool ignore_case,
+                                                                                           std::vector<std::unordered_set<const EntryType*>>& entries) const
+{
+    entries.clear();
+    entries.resize(wildcard_strings.size());
+
+    MultiWildcardMatcher matcher(wildcard_strings, ignore_case);
+    std::vector<size_t> matching_wildcard_string_ixs;
+    for (const auto& entry : m_entries) {
+        matcher.get_matching_wildcard_strings(entry.get_value(), matching_wildcard_string_ixs);
+        for (auto wildcard_string_ix : matching_wildcard_string_ixs) {
+            entries[wildcard_string_ix].insert(&entry);
+        }
+    }
+}
+
 template <typename DictionaryIdType, typename EntryType>
 void DictionaryReader<DictionaryIdType, EntryType>::read_segment_ids () {
     segment_id_t segment_id;
@@ -3,6 +3,7 @@
 
 // C++ standard libraries
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -12,11 +13,13 @@
 #include "Defs.h"
 #include "dictionary_utils.hpp"
 #include "FileWriter.hpp"
+#include "OnDiskValueToIdMap.hpp"
 #include "spdlog_with_specializations.hpp"
 #include "streaming_compression/passthrough/Compressor.hpp"
 #include "streaming_compression/passthrough/Decompressor.hpp"
 #include "streaming_compression/zstd/Compressor.hpp"
 #include "streaming_compression/zstd/Decompressor.hpp"
+#include "StringArena.hpp"
 #include "TraceableException.hpp"
 
 /**
@@ -88,14 +91,49 @@ public:
      */
     size_t get_data_size () const { return m_data_size; }
 
+    /**
+     * Gets the approximate amount of memory used by the value-to-ID mappings that are in memory (i.e., that can be spilled to disk)
+     * @return Size in bytes
+     */
+    size_t get_in_memory_mappings_size () const;
+    /**
+     * Gets the approximate amount of memory used to map the dictionary's values to IDs, including the indexes of spilled mappings
+     * @return Size in bytes
+     */
+    size_t get_in_memory_size () const { return get_in_memory_mappings_size() + m_spilled_value_to_id.get_in_memory_size(); }
+
+    /**
+     * Moves the dictionary's in-memory value-to-ID mappings to disk, freeing the memory they use. Values are still found by later lookups, albeit
+     * more slowly; values which are looked up again are brought back into memory.
+     */
+    void spill_mappings_to_disk ();
+
 protected:
     // Types
-    typedef std::unordered_map<std::string, DictionaryIdType> value_to_id_t;
+    // NOTE: Keys are views into m_value_arena, so looking up an existing value doesn't require any allocation
+    typedef std::unordered_map<std::string_view, DictionaryIdType> value_to_id_t;
+
+    // Methods
+    /**
+     * Copies the given value into the dictionary's storage and maps it to the given ID
+     * @param value
+     * @param id
+     */
+    void add_value_to_id_mapping (std::string_view value, DictionaryIdType id) { m_value_to_id.emplace(m_value_arena.add(value), id); }
+
+    /**
+     * Gets the ID of the given value, whether its mapping is in memory or was spilled to disk
+     * @param value
+     * @param id Returns the ID if the value exists
+     * @return true if the value exists in the dictionary, false otherwise
+     */
+    bool try_get_id (std::string_view value, DictionaryIdType& id);
 
     // Variables
     bool m_is_open;
 
     // Variables related to on-disk storage
+    std::string m_dictionary_path;
     FileWriter m_dictionary_file_writer;
     FileWriter m_segment_index_file_writer;
 #if USE_PASSTHROUGH_COMPRESSION
@@ -109,7 +147,10 @@ protected:
 #endif
     size_t m_num_segments_in_index;
 
+    StringArena m_value_arena;
     value_to_id_t m_value_to_id;
+    // Mappings which were moved out of m_value_to_id to reduce memory usage
+    OnDiskValueToIdMap m_spilled_value_to_id;
     DictionaryIdType m_next_id;
     DictionaryIdType m_max_id;
 
@@ -123,6 +164,7 @@ void DictionaryWriter<DictionaryIdType, EntryType>::open (const std::string& dic
         throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
     }
 
+    m_dictionary_path = dictionary_path;
     m_dictionary_file_writer.open(dictionary_path, FileWriter::OpenMode::CREATE_FOR_WRITING);
     // Write header
     m_dictionary_file_writer.write_numeric_value<uint64_t>(0);
@@ -136,6 +178,8 @@ void DictionaryWriter<DictionaryIdType, EntryType>::open (const std::string& dic
     m_segment_index_compressor.open(m_segment_index_file_writer);
     m_num_segments_in_index = 0;
 
+    m_spilled_value_to_id.open(dictionary_path + ".spill");
+
     m_next_id = 0;
     m_max_id = max_id;
 
@@ -157,6 +201,9 @@ void DictionaryWriter<DictionaryIdType, EntryType>::close () {
     m_dictionary_file_writer.close();
 
     m_value_to_id.clear();
+    m_value_arena.clear();
+    m_spilled_value_to_id.close();
+    m_dictionary_path.clear();
 
     m_is_open = false;
 }
@@ -167,16 +214,26 @@ void DictionaryWriter<DictionaryIdType, EntryType>::write_header_and_flush_to_di
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
-    // Update header
+    // NOTE: Readers may refresh the dictionary while it's still being written, so the headers are only updated once all the content they
+    // count is on disk
+    m_segment_index_compressor.flush();
+    m_segment_index_file_writer.flush();
+    m_dictionary_compressor.flush();
+    m_dictionary_file_writer.flush();
+
+    // Update headers
     auto dictionary_file_writer_pos = m_dictionary_file_writer.get_pos();
     m_dictionary_file_writer.seek_from_begin(0);
-    m_dictionary_file_writer.write_numeric_value<uint64_t>(m_value_to_id.size());
+    // NOTE: Since IDs are assigned sequentially, the next ID is the number of entries (including those whose mappings were spilled to disk)
+    m_dictionary_file_writer.write_numeric_value<uint64_t>(m_next_id);
     m_dictionary_file_writer.seek_from_begin(dictionary_file_writer_pos);
+    m_dictionary_file_writer.flush();
 
-    m_segment_index_compressor.flush();
+    auto segment_index_file_writer_pos = m_segment_index_file_writer.get_pos();
+    m_segment_index_file_writer.seek_from_begin(0);
+    m_segment_index_file_writer.write_numeric_value<uint64_t>(m_num_segments_in_index);
+    m_segment_index_file_writer.seek_from_begin(segment_index_file_writer_pos);
     m_segment_index_file_writer.flush();
-    m_dictionary_compressor.flush();
-    m_dictionary_file_writer.flush();
 }
 
 template <typename DictionaryIdType, typename EntryType>
@@ -220,7 +277,7 @@ void DictionaryWriter<DictionaryIdType, EntryType>::open_and_preload (const std:
             throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
         }
 
-        m_value_to_id[str_value] = entry.get_id();;
+        add_value_to_id_mapping(str_value, entry.get_id());
         m_data_size += entry.get_data_size();
     }
 
@@ -231,6 +288,7 @@ void DictionaryWriter<DictionaryIdType, EntryType>::open_and_preload (const std:
     dictionary_decompressor.close();
     dictionary_file_reader.close();
 
+    m_dictionary_path = dictionary_path;
     m_dictionary_file_writer.open(dictionary_path, FileWriter::OpenMode::CREATE_IF_NONEXISTENT_FOR_SEEKABLE_WRITING);
     // Open compressor
     m_dictionary_compressor.open(m_dictionary_file_writer);
@@ -239,6 +297,8 @@ void DictionaryWriter<DictionaryIdType, EntryType>::open_and_preload (const std:
     // Open compressor
     m_segment_index_compressor.open(m_segment_index_file_writer);
 
+    m_spilled_value_to_id.open(dictionary_path + ".spill");
+
     m_is_open = true;
 }
 
@@ -255,12 +315,45 @@ void DictionaryWriter<DictionaryIdType, EntryType>::index_segment (segment_id_t
     ids.write_to_compressor(m_segment_index_compressor);
 
     ++m_num_segments_in_index;
+}
 
-    // Update header
-    auto segment_index_file_writer_pos = m_segment_index_file_writer.get_pos();
-    m_segment_index_file_writer.seek_from_begin(0);
-    m_segment_index_file_writer.write_numeric_value<uint64_t>(m_num_segments_in_index);
-    m_segment_index_file_writer.seek_from_begin(segment_index_file_writer_pos);
+template <typename DictionaryIdType, typename EntryType>
+size_t DictionaryWriter<DictionaryIdType, EntryType>::get_in_memory_mappings_size () const {
+    // Approximates each of the map's nodes as the key, value, cached hash, and next pointer; and each bucket as a pointer
+    constexpr size_t cNodeSize = sizeof(typename value_to_id_t::value_type) + sizeof(size_t) + sizeof(void*);
+    return m_value_arena.get_allocated_size() + m_value_to_id.size() * cNodeSize + m_value_to_id.bucket_count() * sizeof(void*);
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryWriter<DictionaryIdType, EntryType>::spill_mappings_to_disk () {
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+
+    std::vector<std::pair<std::string_view, uint64_t>> mappings(m_value_to_id.cbegin(), m_value_to_id.cend());
+    m_spilled_value_to_id.add_mappings(mappings);
+
+    // Swap with empty containers so that their memory is actually freed
+    value_to_id_t().swap(m_value_to_id);
+    m_value_arena.clear();
+}
+
+template <typename DictionaryIdType, typename EntryType>
+bool DictionaryWriter<DictionaryIdType, EntryType>::try_get_id (std::string_view value, DictionaryIdType& id) {
+    const auto ix = m_value_to_id.find(value);
+    if (m_value_to_id.end() != ix) {
+        id = ix->second;
+        return true;
+    }
+
+    uint64_t spilled_id;
+    if (false == m_spilled_value_to_id.find(value, spilled_id)) {
+        return false;
+    }
+    id = static_cast<DictionaryIdType>(spilled_id);
+    // Keep the mapping in memory, since a value that's seen again is likely to be seen often
+    add_value_to_id_mapping(value, id);
+    return true;
 }
 
 #endif // DICTIONARYWRITER_HPP
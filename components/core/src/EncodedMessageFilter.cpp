@@ -0,0 +1,210 @@
+#include "EncodedMessageFilter.hpp"
+
+// C++ standard libraries
+#include <algorithm>
+#include <cctype>
+
+// Project headers
+#include "EncodedVariableInterpreter.hpp"
+
+using std::string;
+using std::vector;
+
+// Constants
+static constexpr size_t cMaxFragmentLength = 64;
+static constexpr char cIntVarChars[] = "-0123456789";
+static constexpr char cFloatVarChars[] = "-.0123456789";
+
+// Local function prototypes
+/**
+ * Computes the mask of fragment positions that could be matched by any of the given characters
+ * @param char_masks
+ * @param chars
+ * @return The mask
+ */
+static uint64_t get_mask_for_chars (const uint64_t* char_masks, const string& chars);
+/**
+ * Advances the given shift-and state over a gap that may contain any string (including the empty string) of characters which match the given mask
+ * @param state
+ * @param gap_mask
+ * @return The new state
+ */
+static uint64_t advance_over_gap (uint64_t state, uint64_t gap_mask);
+
+static uint64_t get_mask_for_chars (const uint64_t* char_masks, const string& chars) {
+    uint64_t mask = 0;
+    for (auto c : chars) {
+        mask |= char_masks[static_cast<unsigned char>(c)];
+    }
+    return mask;
+}
+
+static uint64_t advance_over_gap (uint64_t state, uint64_t gap_mask) {
+    while (true) {
+        auto next_state = state | (((state << 1) | 1) & gap_mask);
+        if (next_state == state) {
+            return state;
+        }
+        state = next_state;
+    }
+}
+
+EncodedMessageFilter::EncodedMessageFilter (const string& search_string, bool ignore_case) : m_cached_ts_pattern_format_is_valid(false) {
+    string literal;
+    vector<bool> is_wildcard;
+    auto search_string_length = search_string.length();
+    for (size_t i = 0; i < search_string_length; ++i) {
+        auto c = search_string[i];
+        if ('*' == c) {
+            add_fragment(literal, is_wildcard, ignore_case);
+            literal.clear();
+            is_wildcard.clear();
+            continue;
+        }
+
+        if ('\\' == c && i + 1 < search_string_length) {
+            ++i;
+            literal += search_string[i];
+            is_wildcard.push_back(false);
+        } else {
+            literal += c;
+            is_wildcard.push_back('?' == c);
+        }
+    }
+    add_fragment(literal, is_wildcard, ignore_case);
+}
+
+bool EncodedMessageFilter::may_match (const LogTypeDictionaryEntry& logtype_entry, const VariableDictionaryReader& var_dict,
+                                      const vector<encoded_variable_t>& encoded_vars, const TimestampPattern* ts_pattern) const
+{
+    if (m_fragments.empty() || logtype_entry.get_num_vars() != encoded_vars.size()) {
+        // Nothing to filter on, or the message is malformed (which decoding will report)
+        return true;
+    }
+
+    int num_spaces_before_ts = -1;
+    if (nullptr != ts_pattern) {
+        update_ts_masks(*ts_pattern);
+        num_spaces_before_ts = ts_pattern->get_num_spaces_before_ts();
+    }
+
+    for (const auto& fragment : m_fragments) {
+        if (false == fragment_may_occur(fragment, logtype_entry, var_dict, encoded_vars, num_spaces_before_ts)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EncodedMessageFilter::add_fragment (const string& literal, const vector<bool>& is_wildcard, bool ignore_case) {
+    if (literal.empty()) {
+        return;
+    }
+
+    // NOTE: If the literal is too long, we only search for its prefix which is still a necessary condition for a match
+    auto fragment_length = std::min(literal.length(), cMaxFragmentLength);
+
+    auto& fragment = m_fragments.emplace_back();
+    for (size_t c = 0; c < 256; ++c) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < fragment_length; ++i) {
+            auto fragment_char = static_cast<unsigned char>(literal[i]);
+            if (is_wildcard[i] || c == fragment_char || (ignore_case && std::tolower(c) == std::tolower(fragment_char))) {
+                mask |= (uint64_t)1 << i;
+            }
+        }
+        fragment.char_masks[c] = mask;
+    }
+    fragment.int_var_mask = get_mask_for_chars(fragment.char_masks, cIntVarChars);
+    fragment.float_var_mask = get_mask_for_chars(fragment.char_masks, cFloatVarChars);
+    fragment.ts_mask = 0;
+    fragment.match_mask = (uint64_t)1 << (fragment_length - 1);
+}
+
+void EncodedMessageFilter::update_ts_masks (const TimestampPattern& ts_pattern) const {
+    const auto& format = ts_pattern.get_format();
+    if (m_cached_ts_pattern_format_is_valid && format == m_cached_ts_pattern_format) {
+        return;
+    }
+
+    auto ts_chars = ts_pattern.get_possible_formatted_timestamp_chars();
+    for (auto& fragment : m_fragments) {
+        fragment.ts_mask = get_mask_for_chars(fragment.char_masks, ts_chars);
+    }
+    m_cached_ts_pattern_format = format;
+    m_cached_ts_pattern_format_is_valid = true;
+}
+
+bool EncodedMessageFilter::fragment_may_occur (const Fragment& fragment, const LogTypeDictionaryEntry& logtype_entry,
+                                               const VariableDictionaryReader& var_dict, const vector<encoded_variable_t>& encoded_vars,
+                                               int num_spaces_before_ts)
+{
+    // Bit i of the state is set if the first i + 1 characters of the fragment match the text processed so far
+    uint64_t state = 0;
+    if (0 == num_spaces_before_ts) {
+        state = advance_over_gap(state, fragment.ts_mask);
+        if (state & fragment.match_mask) {
+            return true;
+        }
+    }
+    auto num_spaces_remaining = num_spaces_before_ts;
+    auto advance_over_text = [&] (const char* text, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            auto c = text[i];
+            state = ((state << 1) | 1) & fragment.char_masks[static_cast<unsigned char>(c)];
+            if (' ' == c && num_spaces_remaining > 0) {
+                --num_spaces_remaining;
+                if (0 == num_spaces_remaining) {
+                    // The timestamp is inserted after the last space before it
+                    state = advance_over_gap(state, fragment.ts_mask);
+                }
+            }
+            if (state & fragment.match_mask) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const auto& logtype_value = logtype_entry.get_value();
+    ir::VariablePlaceholder var_placeholder;
+    size_t constant_begin_pos = 0;
+    for (size_t i = 0; i < encoded_vars.size(); ++i) {
+        size_t var_position = logtype_entry.get_var_info(i, var_placeholder);
+        if (advance_over_text(logtype_value.data() + constant_begin_pos, var_position - constant_begin_pos)) {
+            return true;
+        }
+
+        switch (var_placeholder) {
+            case ir::VariablePlaceholder::Integer:
+                state = advance_over_gap(state, fragment.int_var_mask);
+                break;
+            case ir::VariablePlaceholder::Float:
+                state = advance_over_gap(state, fragment.float_var_mask);
+                break;
+            case ir::VariablePlaceholder::Dictionary: {
+                const auto& var_value = var_dict.get_value(EncodedVariableInterpreter::decode_var_dict_id(encoded_vars[i]));
+                if (advance_over_text(var_value.data(), var_value.length())) {
+                    return true;
+                }
+                break;
+            }
+            default:
+                // Let decoding report the unexpected placeholder
+                return true;
+        }
+        if (state & fragment.match_mask) {
+            return true;
+        }
+
+        constant_begin_pos = var_position + 1;
+    }
+    if (constant_begin_pos < logtype_value.length()
+        && advance_over_text(logtype_value.data() + constant_begin_pos, logtype_value.length() - constant_begin_pos))
+    {
+        return true;
+    }
+
+    // If the message doesn't have enough spaces for the timestamp, let decoding report the error
+    return num_spaces_remaining > 0;
+}
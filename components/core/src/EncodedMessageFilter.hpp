@@ -0,0 +1,99 @@
+#ifndef ENCODEDMESSAGEFILTER_HPP
+#define ENCODEDMESSAGEFILTER_HPP
+
+// C++ standard libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project headers
+#include "Defs.h"
+#include "LogTypeDictionaryEntry.hpp"
+#include "TimestampPattern.hpp"
+#include "VariableDictionaryReader.hpp"
+
+/**
+ * Class to reject encoded messages that can't match a wildcard search string without fully decoding them (i.e., without formatting their non-dictionary
+ * variables or timestamp, or building the decompressed message).
+ *
+ * The filter splits the search string into the literal fragments between its greedy wildcards. A message can only match if each fragment occurs somewhere
+ * in it, so the filter searches for each fragment in the message's logtype constants and dictionary variables, treating every integer variable, float
+ * variable, and the timestamp as a gap that may contain any string of the characters it could be formatted with. Since this ignores the fragments' order and
+ * the gaps' exact values, a message which passes the filter must still be decoded and wildcard-matched.
+ */
+class EncodedMessageFilter {
+public:
+    // Constructors
+    EncodedMessageFilter () : m_cached_ts_pattern_format_is_valid(false) {}
+
+    /**
+     * @param search_string Wildcard search string
+     * @param ignore_case
+     */
+    EncodedMessageFilter (const std::string& search_string, bool ignore_case);
+
+    // Methods
+    /**
+     * Checks whether the given encoded message may match the search string
+     * @param logtype_entry
+     * @param var_dict
+     * @param encoded_vars
+     * @param ts_pattern The timestamp pattern that will be used to format the message's timestamp, or nullptr if the message has no timestamp
+     * @return false if the message definitely won't match, true otherwise
+     */
+    bool may_match (const LogTypeDictionaryEntry& logtype_entry, const VariableDictionaryReader& var_dict,
+                    const std::vector<encoded_variable_t>& encoded_vars, const TimestampPattern* ts_pattern) const;
+
+private:
+    // Types
+    /**
+     * A literal fragment of the search string, represented for bit-parallel (shift-and) searching. Bit i of a mask corresponds to the i-th character of the
+     * fragment.
+     */
+    struct Fragment {
+        // Mask of positions in the fragment that match each character
+        uint64_t char_masks[256];
+        // Masks of positions in the fragment that could be matched by a formatted integer/float variable
+        uint64_t int_var_mask;
+        uint64_t float_var_mask;
+        // Mask of positions in the fragment that could be matched by the cached timestamp pattern
+        uint64_t ts_mask;
+        // Mask of the last position in the fragment
+        uint64_t match_mask;
+    };
+
+    // Methods
+    /**
+     * Adds a fragment for the given literal
+     * @param literal Unescaped literal where '?' represents any character
+     * @param is_wildcard Whether each character of the literal is a '?' wildcard
+     * @param ignore_case
+     */
+    void add_fragment (const std::string& literal, const std::vector<bool>& is_wildcard, bool ignore_case);
+
+    /**
+     * Updates each fragment's timestamp mask for the given timestamp pattern, if it's different from the cached one
+     * @param ts_pattern
+     */
+    void update_ts_masks (const TimestampPattern& ts_pattern) const;
+
+    /**
+     * Checks whether the given fragment may occur in the given message
+     * @param fragment
+     * @param logtype_entry
+     * @param var_dict
+     * @param encoded_vars
+     * @param num_spaces_before_ts The number of spaces before the timestamp gap, or -1 if there's no timestamp
+     * @return Whether the fragment may occur
+     */
+    static bool fragment_may_occur (const Fragment& fragment, const LogTypeDictionaryEntry& logtype_entry, const VariableDictionaryReader& var_dict,
+                                    const std::vector<encoded_variable_t>& encoded_vars, int num_spaces_before_ts);
+
+    // Variables
+    // NOTE: Fragments are only mutated to cache the timestamp masks of the most recent timestamp pattern
+    mutable std::vector<Fragment> m_fragments;
+    mutable bool m_cached_ts_pattern_format_is_valid;
+    mutable std::string m_cached_ts_pattern_format;
+};
+
+#endif // ENCODEDMESSAGEFILTER_HPP
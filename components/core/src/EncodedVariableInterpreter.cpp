@@ -15,6 +15,7 @@
 
 using ffi::cEightByteEncodedFloatDigitsBitMask;
 using std::string;
+using std::string_view;
 using std::unordered_set;
 using std::vector;
 
@@ -22,7 +23,7 @@ variable_dictionary_id_t EncodedVariableInterpreter::decode_var_dict_id (encoded
     return bit_cast<variable_dictionary_id_t>(encoded_var);
 }
 
-bool EncodedVariableInterpreter::convert_string_to_representable_integer_var (const string& value, encoded_variable_t& encoded_var) {
+bool EncodedVariableInterpreter::convert_string_to_representable_integer_var (string_view value, encoded_variable_t& encoded_var) {
     size_t length = value.length();
     if (0 == length) {
         // Empty string cannot be converted
@@ -59,7 +60,7 @@ bool EncodedVariableInterpreter::convert_string_to_representable_integer_var (co
 }
 
 bool EncodedVariableInterpreter::convert_string_to_representable_float_var (
-        const string& value, encoded_variable_t& encoded_var)
+        string_view value, encoded_variable_t& encoded_var)
 {
     if (value.empty()) {
         // Can't convert an empty string
@@ -287,53 +288,69 @@ void EncodedVariableInterpreter::encode_and_add_to_dictionary(
 bool EncodedVariableInterpreter::decode_variables_into_message (const LogTypeDictionaryEntry& logtype_dict_entry, const VariableDictionaryReader& var_dict,
                                                                 const vector<encoded_variable_t>& encoded_vars, string& decompressed_msg)
 {
-    size_t num_vars_in_logtype = logtype_dict_entry.get_num_vars();
+    return decode_variables_into_message(LogTypeRenderTemplate(logtype_dict_entry), var_dict, encoded_vars, decompressed_msg);
+}
+
+bool EncodedVariableInterpreter::decode_variables_into_message (const LogTypeRenderTemplate& logtype_template, const VariableDictionaryReader& var_dict,
+                                                                const vector<encoded_variable_t>& encoded_vars, string& decompressed_msg)
+{
+    const auto& var_slots = logtype_template.get_variable_slots();
+    size_t num_vars_in_logtype = var_slots.size();
 
     // Ensure the number of variables in the logtype matches the number of encoded variables given
-    const auto& logtype_value = logtype_dict_entry.get_value();
+    const auto& constants = logtype_template.get_constants();
     if (num_vars_in_logtype != encoded_vars.size()) {
-        SPDLOG_ERROR("EncodedVariableInterpreter: Logtype '{}' contains {} variables, but {} were given for decoding.", logtype_value.c_str(),
+        SPDLOG_ERROR("EncodedVariableInterpreter: Logtype '{}' contains {} variables, but {} were given for decoding.", constants.c_str(),
                      num_vars_in_logtype, encoded_vars.size());
         return false;
     }
 
-    ir::VariablePlaceholder var_placeholder;
-    size_t constant_begin_pos = 0;
+    // Longest int64_t is "-9223372036854775808"
+    char int_buf[20];
     string float_str;
-    variable_dictionary_id_t var_dict_id;
+    const char* constant = constants.data();
     for (size_t i = 0; i < num_vars_in_logtype; ++i) {
-        size_t var_position = logtype_dict_entry.get_var_info(i, var_placeholder);
+        const auto& var_slot = var_slots[i];
 
         // Add the constant that's between the last variable and this one
-        decompressed_msg.append(logtype_value, constant_begin_pos,
-                                var_position - constant_begin_pos);
-        switch (var_placeholder) {
-            case ir::VariablePlaceholder::Integer:
-                decompressed_msg += std::to_string(encoded_vars[i]);
+        decompressed_msg.append(constant, var_slot.preceding_constant_length);
+        constant += var_slot.preceding_constant_length;
+
+        switch (var_slot.placeholder) {
+            case ir::VariablePlaceholder::Integer: {
+                // Format the integer from back to front
+                auto value = encoded_vars[i];
+                // NOTE: We negate into an unsigned value so that INT64_MIN doesn't overflow
+                uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+                char* int_begin = int_buf + sizeof(int_buf);
+                do {
+                    *(--int_begin) = static_cast<char>('0' + magnitude % 10);
+                    magnitude /= 10;
+                } while (magnitude > 0);
+                if (value < 0) {
+                    *(--int_begin) = '-';
+                }
+                decompressed_msg.append(int_begin, int_buf + sizeof(int_buf) - int_begin);
                 break;
+            }
             case ir::VariablePlaceholder::Float:
                 convert_encoded_float_to_string(encoded_vars[i], float_str);
                 decompressed_msg += float_str;
                 break;
             case ir::VariablePlaceholder::Dictionary:
-                var_dict_id = decode_var_dict_id(encoded_vars[i]);
-                decompressed_msg += var_dict.get_value(var_dict_id);
+                decompressed_msg += var_dict.get_value(decode_var_dict_id(encoded_vars[i]));
                 break;
             default:
                 SPDLOG_ERROR(
                     "EncodedVariableInterpreter: Logtype '{}' contains "
                     "unexpected variable placeholder 0x{:x}",
-                    logtype_value,
-                    enum_to_underlying_type(var_placeholder));
+                    constants,
+                    enum_to_underlying_type(var_slot.placeholder));
                 return false;
         }
-        // Move past the variable placeholder
-        constant_begin_pos = var_position + 1;
     }
     // Append remainder of logtype, if any
-    if (constant_begin_pos < logtype_value.length()) {
-        decompressed_msg.append(logtype_value, constant_begin_pos, string::npos);
-    }
+    decompressed_msg.append(constant, logtype_template.get_trailing_constant_length());
 
     return true;
 }
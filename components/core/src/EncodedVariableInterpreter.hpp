@@ -3,10 +3,12 @@
 
 // C++ standard libraries
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Project headers
 #include "ir/LogEvent.hpp"
+#include "LogTypeRenderTemplate.hpp"
 #include "Query.hpp"
 #include "TraceableException.hpp"
 #include "VariableDictionaryReader.hpp"
@@ -49,14 +51,14 @@ public:
      * @param encoded_var
      * @return true if was successfully converted, false otherwise
      */
-    static bool convert_string_to_representable_integer_var (const std::string& value, encoded_variable_t& encoded_var);
+    static bool convert_string_to_representable_integer_var (std::string_view value, encoded_variable_t& encoded_var);
     /**
      * Converts the given string into a representable float variable if possible
      * @param value
      * @param encoded_var
      * @return true if was successfully converted, false otherwise
      */
-    static bool convert_string_to_representable_float_var (const std::string& value, encoded_variable_t& encoded_var);
+    static bool convert_string_to_representable_float_var (std::string_view value, encoded_variable_t& encoded_var);
     /**
      * Converts the given encoded float into a string
      * @param encoded_var
@@ -110,6 +112,16 @@ public:
      */
     static bool decode_variables_into_message (const LogTypeDictionaryEntry& logtype_dict_entry, const VariableDictionaryReader& var_dict,
                                                const std::vector<encoded_variable_t>& encoded_vars, std::string& decompressed_msg);
+    /**
+     * Decodes all variables and renders them into a message using the given logtype render template
+     * @param logtype_template
+     * @param var_dict
+     * @param encoded_vars
+     * @param decompressed_msg Buffer which the message is appended to
+     * @return true if successful, false otherwise
+     */
+    static bool decode_variables_into_message (const LogTypeRenderTemplate& logtype_template, const VariableDictionaryReader& var_dict,
+                                               const std::vector<encoded_variable_t>& encoded_vars, std::string& decompressed_msg);
 
     /**
      * Encodes a string-form variable, and if it is dictionary variable, searches for its ID in the given variable dictionary
@@ -125,6 +125,31 @@ ErrorCode FileReader::try_read_to_delimiter (char delim, bool keep_delimiter, bo
     return ErrorCode_Success;
 }
 
+ErrorCode FileReader::try_read_exact_length_at (size_t pos, char* buf, size_t num_bytes) {
+    if (nullptr == m_file) {
+        return ErrorCode_NotInit;
+    }
+
+    auto fd = fileno(m_file);
+    while (num_bytes > 0) {
+        auto num_bytes_read = pread(fd, buf, num_bytes, (off_t)pos);
+        if (num_bytes_read < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return ErrorCode_errno;
+        }
+        if (0 == num_bytes_read) {
+            return ErrorCode_EndOfFile;
+        }
+        buf += num_bytes_read;
+        pos += num_bytes_read;
+        num_bytes -= num_bytes_read;
+    }
+
+    return ErrorCode_Success;
+}
+
 ErrorCode FileReader::try_fstat (struct stat& stat_buffer) {
     if (nullptr == m_file) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
@@ -103,6 +103,19 @@ public:
      */
     ErrorCode try_fstat (struct stat& stat_buffer);
 
+    /**
+     * Tries to read the given number of bytes from the given position in the file without moving the read head. Unlike seeking and reading,
+     * this bypasses the read buffer, so it observes changes made to the file (e.g., by a concurrent writer) after it was buffered.
+     * @param pos
+     * @param buf
+     * @param num_bytes
+     * @return ErrorCode_NotInit if the file is not open
+     * @return ErrorCode_EndOfFile if the file ends before the given number of bytes
+     * @return ErrorCode_errno on error
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_read_exact_length_at (size_t pos, char* buf, size_t num_bytes);
+
 private:
     FILE* m_file;
     size_t m_getdelim_buf_len;
@@ -24,6 +24,14 @@ public:
         virtual bool contains_element () const = 0;
         virtual void get_next () = 0;
         virtual void get_id (std::string& id) const = 0;
+        /**
+         * @return The end timestamp of the current archive
+         */
+        virtual epochtime_t get_end_ts () const = 0;
+        /**
+         * @return Whether the current archive has been finalized, i.e., no more data will be added to it
+         */
+        virtual bool is_finalized () const = 0;
     };
 
     // Constructors
@@ -60,6 +68,11 @@ public:
      * @param files
      */
     virtual void update_metadata_for_files (const std::string& archive_id, const std::vector<streaming_archive::writer::File*>& files) = 0;
+    /**
+     * Marks the archive identified by the given ID as finalized in the global metadata database, once all of its data has been written
+     * @param archive_id
+     */
+    virtual void mark_archive_finalized (const std::string& archive_id) = 0;
 
     /**
      * Gets an iterator to iterate over every archive in the global metadata database
@@ -73,6 +86,14 @@ public:
      * @return The archive iterator
      */
     virtual ArchiveIterator* get_archive_iterator_for_time_window (epochtime_t begin_ts, epochtime_t end_ts) = 0;
+    /**
+     * Gets an iterator to iterate over every archive that falls in the given time window in the global metadata database, from the archive with
+     * the latest end timestamp to the one with the earliest
+     * @param begin_ts
+     * @param end_ts
+     * @return The archive iterator
+     */
+    virtual ArchiveIterator* get_archive_iterator_for_time_window_in_descending_end_ts_order (epochtime_t begin_ts, epochtime_t end_ts) = 0;
     /**
      * Gets an iterator to iterate over every archive that contains a given file path in the global metadata database
      * @return The archive iterator
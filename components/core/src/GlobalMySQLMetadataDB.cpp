@@ -1,11 +1,16 @@
 #include "GlobalMySQLMetadataDB.hpp"
 
+// C++ standard libraries
+#include <algorithm>
+
 // fmt
 #include <fmt/core.h>
 
 // Project headers
 #include "database_utils.hpp"
+#include "spdlog_with_specializations.hpp"
 #include "streaming_archive/Constants.hpp"
+#include "string_utils.hpp"
 #include "type_utils.hpp"
 
 using std::pair;
@@ -23,6 +28,12 @@ enum class ArchivesTableFieldIndexes : uint16_t {
     CreationIx,
     Length,
 };
+enum class ArchiveIteratorFieldIndexes : uint16_t {
+    Id = 0,
+    EndTimestamp,
+    IsFinalized,
+    Length,
+};
 enum class UpdateArchiveSizeStmtFieldIndexes : uint16_t {
     BeginTimestamp = 0,
     EndTimestamp,
@@ -42,8 +53,52 @@ enum class FilesTableFieldIndexes : uint16_t {
     Length,
 };
 
+/**
+ * Gets the SQL for a statement which upserts the given number of files
+ * @param table_prefix
+ * @param num_files
+ * @return The SQL
+ */
+static string get_upsert_files_statement_sql (const string& table_prefix, size_t num_files) {
+    vector<string> file_field_names(enum_to_underlying_type(FilesTableFieldIndexes::Length));
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::Id)] = streaming_archive::cMetadataDB::File::Id;
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId)] = streaming_archive::cMetadataDB::File::OrigFileId;
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::Path)] = streaming_archive::cMetadataDB::File::Path;
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp)] = streaming_archive::cMetadataDB::File::BeginTimestamp;
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp)] = streaming_archive::cMetadataDB::File::EndTimestamp;
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes)] =
+            streaming_archive::cMetadataDB::File::NumUncompressedBytes;
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::NumMessages)] = streaming_archive::cMetadataDB::File::NumMessages;
+    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId)] = streaming_archive::cMetadataDB::File::ArchiveId;
+
+    // Insert or on conflict, set all fields except the ID to those of the row being inserted
+    auto statement = fmt::format("INSERT INTO {}{} ({}) VALUES {} ON DUPLICATE KEY UPDATE {}", table_prefix,
+                                 streaming_archive::cMetadataDB::FilesTableName, get_field_names_sql(file_field_names),
+                                 get_multi_row_placeholders_sql(file_field_names.size(), num_files),
+                                 get_set_field_to_inserted_value_sql(file_field_names, enum_to_underlying_type(FilesTableFieldIndexes::Id) + 1,
+                                                                     enum_to_underlying_type(FilesTableFieldIndexes::Length)));
+    SPDLOG_DEBUG("{}", statement);
+    return statement;
+}
+
 void GlobalMySQLMetadataDB::ArchiveIterator::get_id (string& id) const {
-    m_db_iterator->get_field_as_string(enum_to_underlying_type(ArchivesTableFieldIndexes::Id), id);
+    m_db_iterator->get_field_as_string(enum_to_underlying_type(ArchiveIteratorFieldIndexes::Id), id);
+}
+
+epochtime_t GlobalMySQLMetadataDB::ArchiveIterator::get_end_ts () const {
+    string end_ts_as_string;
+    m_db_iterator->get_field_as_string(enum_to_underlying_type(ArchiveIteratorFieldIndexes::EndTimestamp), end_ts_as_string);
+    epochtime_t end_ts;
+    if (false == convert_string_to_int(end_ts_as_string, end_ts)) {
+        throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+    }
+    return end_ts;
+}
+
+bool GlobalMySQLMetadataDB::ArchiveIterator::is_finalized () const {
+    string is_finalized_as_string;
+    m_db_iterator->get_field_as_string(enum_to_underlying_type(ArchiveIteratorFieldIndexes::IsFinalized), is_finalized_as_string);
+    return "0" != is_finalized_as_string;
 }
 
 void GlobalMySQLMetadataDB::open () {
@@ -54,6 +109,19 @@ void GlobalMySQLMetadataDB::open () {
     m_db.open(m_host, m_port, m_username, m_password, m_database_name);
     m_is_open = true;
 
+    prepare_statements();
+}
+
+void GlobalMySQLMetadataDB::close () {
+    m_insert_archive_statement.reset(nullptr);
+    m_update_archive_size_statement.reset(nullptr);
+    m_mark_archive_finalized_statement.reset(nullptr);
+    m_upsert_files_statements.clear();
+    m_db.close();
+    m_is_open = false;
+}
+
+void GlobalMySQLMetadataDB::prepare_statements () {
     vector<string> archive_field_names(enum_to_underlying_type(ArchivesTableFieldIndexes::Length));
     archive_field_names[enum_to_underlying_type(ArchivesTableFieldIndexes::Id)] = streaming_archive::cMetadataDB::Archive::Id;
     archive_field_names[enum_to_underlying_type(ArchivesTableFieldIndexes::BeginTimestamp)] = streaming_archive::cMetadataDB::Archive::BeginTimestamp;
@@ -89,32 +157,29 @@ void GlobalMySQLMetadataDB::open () {
     m_update_archive_size_statement = std::make_unique<MySQLPreparedStatement>(m_db.prepare_statement(statement_buffer.data(), statement_buffer.size()));
     statement_buffer.clear();
 
-    vector<string> file_field_names(enum_to_underlying_type(FilesTableFieldIndexes::Length));
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::Id)] = streaming_archive::cMetadataDB::File::Id;
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId)] = streaming_archive::cMetadataDB::File::OrigFileId;
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::Path)] = streaming_archive::cMetadataDB::File::Path;
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp)] = streaming_archive::cMetadataDB::File::BeginTimestamp;
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp)] = streaming_archive::cMetadataDB::File::EndTimestamp;
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes)] =
-            streaming_archive::cMetadataDB::File::NumUncompressedBytes;
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::NumMessages)] = streaming_archive::cMetadataDB::File::NumMessages;
-    file_field_names[enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId)] = streaming_archive::cMetadataDB::File::ArchiveId;
-
-    // Insert or on conflict, set all fields except the ID
-    fmt::format_to(statement_buffer_ix, "INSERT INTO {}{} ({}) VALUES ({}) ON DUPLICATE KEY UPDATE {}", m_table_prefix,
-                   streaming_archive::cMetadataDB::FilesTableName, get_field_names_sql(file_field_names), get_placeholders_sql(file_field_names.size()),
-                   get_set_field_sql(file_field_names, enum_to_underlying_type(FilesTableFieldIndexes::Id) + 1,
-                                     enum_to_underlying_type(FilesTableFieldIndexes::Length)));
+    fmt::format_to(statement_buffer_ix, "UPDATE {}{} SET {} = TRUE WHERE {} = ?", m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName,
+                   streaming_archive::cMetadataDB::Archive::IsFinalized, streaming_archive::cMetadataDB::Archive::Id);
     SPDLOG_DEBUG("{:.{}}", statement_buffer.data(), statement_buffer.size());
-    m_upsert_file_statement = std::make_unique<MySQLPreparedStatement>(m_db.prepare_statement(statement_buffer.data(), statement_buffer.size()));
+    m_mark_archive_finalized_statement = std::make_unique<MySQLPreparedStatement>(m_db.prepare_statement(statement_buffer.data(),
+                                                                                                         statement_buffer.size()));
 }
 
-void GlobalMySQLMetadataDB::close () {
+void GlobalMySQLMetadataDB::reconnect () {
+    // NOTE: Statements must be closed before the connection they were prepared on
     m_insert_archive_statement.reset(nullptr);
     m_update_archive_size_statement.reset(nullptr);
-    m_upsert_file_statement.reset(nullptr);
+    m_mark_archive_finalized_statement.reset(nullptr);
+    m_upsert_files_statements.clear();
     m_db.close();
-    m_is_open = false;
+
+    m_db.open(m_host, m_port, m_username, m_password, m_database_name);
+    prepare_statements();
+}
+
+void GlobalMySQLMetadataDB::try_rollback_transaction () {
+    if (false == m_db.execute_query("ROLLBACK")) {
+        SPDLOG_WARN("GlobalMySQLMetadataDB: Failed to roll back transaction.");
+    }
 }
 
 void GlobalMySQLMetadataDB::add_archive (const string& id, const streaming_archive::ArchiveMetadata& metadata) {
@@ -148,17 +213,12 @@ void GlobalMySQLMetadataDB::update_archive_metadata (const std::string& archive_
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
-    auto& statement_bindings = m_update_archive_size_statement->get_statement_bindings();
-    auto begin_timestamp = metadata.get_begin_timestamp();
-    statement_bindings.bind_int64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::BeginTimestamp), begin_timestamp);
-    auto end_timestamp = metadata.get_end_timestamp();
-    statement_bindings.bind_int64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::EndTimestamp), end_timestamp);
-    auto uncompressed_size = metadata.get_uncompressed_size_bytes();
-    statement_bindings.bind_uint64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::UncompressedSize), uncompressed_size);
-    auto compressed_size = metadata.get_compressed_size_bytes();
-    statement_bindings.bind_uint64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Size), compressed_size);
-    statement_bindings.bind_varchar(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Length), archive_id.c_str(), archive_id.length());
-    if (false == m_update_archive_size_statement->execute()) {
+    if (try_update_archive_metadata(archive_id, metadata)) {
+        return;
+    }
+    SPDLOG_WARN("GlobalMySQLMetadataDB: Failed to update metadata of archive {}, retrying on a new connection.", archive_id);
+    reconnect();
+    if (false == try_update_archive_metadata(archive_id, metadata)) {
         throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
     }
 }
@@ -168,58 +228,93 @@ void GlobalMySQLMetadataDB::update_metadata_for_files (const std::string& archiv
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
-    // TODO Split into multiple transactions if necessary
-    if (false == m_db.execute_query("BEGIN")) {
+    if (try_update_metadata_for_files(archive_id, files)) {
+        return;
+    }
+    SPDLOG_WARN("GlobalMySQLMetadataDB: Failed to update metadata of files in archive {}, retrying on a new connection.", archive_id);
+    reconnect();
+    if (false == try_update_metadata_for_files(archive_id, files)) {
         throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
     }
-    auto& statement_bindings = m_upsert_file_statement->get_statement_bindings();
-    for (auto file : files) {
-        const auto id_as_string = file->get_id_as_string();
-        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::Id), id_as_string.c_str(), id_as_string.length());
-
-        const auto orig_file_id_as_string = file->get_orig_file_id_as_string();
-        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId), orig_file_id_as_string.c_str(),
-                                        orig_file_id_as_string.length());
-
-        const auto& orig_path = file->get_orig_path();
-        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::Path), orig_path.c_str(), orig_path.length());
-
-        auto begin_ts = file->get_begin_ts();
-        statement_bindings.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp), begin_ts);
-
-        auto end_ts = file->get_end_ts();
-        statement_bindings.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp), end_ts);
+}
 
-        auto num_uncompressed_bytes = file->get_num_uncompressed_bytes();
-        statement_bindings.bind_uint64(enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes), num_uncompressed_bytes);
+void GlobalMySQLMetadataDB::mark_archive_finalized (const string& archive_id) {
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
 
-        auto num_messages = file->get_num_messages();
-        statement_bindings.bind_uint64(enum_to_underlying_type(FilesTableFieldIndexes::NumMessages), num_messages);
+    if (try_mark_archive_finalized(archive_id)) {
+        return;
+    }
+    SPDLOG_WARN("GlobalMySQLMetadataDB: Failed to mark archive {} as finalized, retrying on a new connection.", archive_id);
+    reconnect();
+    if (false == try_mark_archive_finalized(archive_id)) {
+        throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
+    }
+}
 
-        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId), archive_id.c_str(), archive_id.length());
+bool GlobalMySQLMetadataDB::try_update_archive_metadata (const string& archive_id, const streaming_archive::ArchiveMetadata& metadata) {
+    auto& statement_bindings = m_update_archive_size_statement->get_statement_bindings();
+    auto begin_timestamp = metadata.get_begin_timestamp();
+    statement_bindings.bind_int64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::BeginTimestamp), begin_timestamp);
+    auto end_timestamp = metadata.get_end_timestamp();
+    statement_bindings.bind_int64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::EndTimestamp), end_timestamp);
+    auto uncompressed_size = metadata.get_uncompressed_size_bytes();
+    statement_bindings.bind_uint64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::UncompressedSize), uncompressed_size);
+    auto compressed_size = metadata.get_compressed_size_bytes();
+    statement_bindings.bind_uint64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Size), compressed_size);
+    statement_bindings.bind_varchar(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Length), archive_id.c_str(), archive_id.length());
+    return m_update_archive_size_statement->execute();
+}
 
-        // NOTE: We subtract 1 since the ID is not repeated in the query
-        size_t offset = enum_to_underlying_type(FilesTableFieldIndexes::Length) - 1;
-        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId) + offset, orig_file_id_as_string.c_str(),
-                                        orig_file_id_as_string.length());
-        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::Path) + offset, orig_path.c_str(), orig_path.length());
-        statement_bindings.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp) + offset, begin_ts);
-        statement_bindings.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp) + offset, end_ts);
-        statement_bindings.bind_uint64(enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes) + offset, num_uncompressed_bytes);
-        statement_bindings.bind_uint64(enum_to_underlying_type(FilesTableFieldIndexes::NumMessages) + offset, num_messages);
-        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId) + offset, archive_id.c_str(), archive_id.length());
+bool GlobalMySQLMetadataDB::try_mark_archive_finalized (const string& archive_id) {
+    auto& statement_bindings = m_mark_archive_finalized_statement->get_statement_bindings();
+    statement_bindings.bind_varchar(0, archive_id.c_str(), archive_id.length());
+    return m_mark_archive_finalized_statement->execute();
+}
 
-        if (false == m_upsert_file_statement->execute()) {
-            throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
+bool GlobalMySQLMetadataDB::try_update_metadata_for_files (const string& archive_id, const vector<streaming_archive::writer::File*>& files) {
+    // TODO Split into multiple transactions if necessary
+    if (false == m_db.execute_query("BEGIN")) {
+        return false;
+    }
+    auto files_it = files.cbegin();
+    while (files.cend() != files_it) {
+        auto num_files = std::min(static_cast<size_t>(files.cend() - files_it), cMaxNumFilesPerUpsert);
+        auto upsert_files_statement = try_get_upsert_files_statement(num_files);
+        if (nullptr == upsert_files_statement || false == upsert_files(*upsert_files_statement, archive_id, files_it, files_it + num_files)) {
+            try_rollback_transaction();
+            return false;
         }
+        files_it += num_files;
     }
     if (false == m_db.execute_query("COMMIT")) {
-        throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
+        try_rollback_transaction();
+        return false;
     }
+    return true;
+}
+
+MySQLPreparedStatement* GlobalMySQLMetadataDB::try_get_upsert_files_statement (size_t num_files) {
+    auto& statement = m_upsert_files_statements[num_files];
+    if (nullptr == statement) {
+        auto statement_sql = get_upsert_files_statement_sql(m_table_prefix, num_files);
+        try {
+            statement = std::make_unique<MySQLPreparedStatement>(m_db.prepare_statement(statement_sql.c_str(), statement_sql.length()));
+        } catch (TraceableException& e) {
+            // NOTE: This can fail if the connection was dropped, in which case the caller should retry on a new connection
+            SPDLOG_WARN("GlobalMySQLMetadataDB: Failed to prepare statement to upsert {} files - {}:{} {}", num_files, e.get_filename(),
+                        e.get_line_number(), e.what());
+            return nullptr;
+        }
+    }
+    return statement.get();
 }
 
 GlobalMetadataDB::ArchiveIterator* GlobalMySQLMetadataDB::get_archive_iterator () {
-    auto statement_string = fmt::format("SELECT {} FROM {}{} ORDER BY {} ASC, {} ASC", streaming_archive::cMetadataDB::Archive::Id, m_table_prefix,
+    auto statement_string = fmt::format("SELECT {}, {}, {} FROM {}{} ORDER BY {} ASC, {} ASC", streaming_archive::cMetadataDB::Archive::Id,
+                                        streaming_archive::cMetadataDB::Archive::EndTimestamp, streaming_archive::cMetadataDB::Archive::IsFinalized,
+                                        m_table_prefix,
                                         streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::CreatorId,
                                         streaming_archive::cMetadataDB::Archive::CreationIx);
     SPDLOG_DEBUG("{}", statement_string);
@@ -232,25 +327,27 @@ GlobalMetadataDB::ArchiveIterator* GlobalMySQLMetadataDB::get_archive_iterator (
 }
 
 GlobalMetadataDB::ArchiveIterator* GlobalMySQLMetadataDB::get_archive_iterator_for_time_window (epochtime_t begin_ts, epochtime_t end_ts) {
-    auto statement_string = fmt::format("SELECT DISTINCT {} FROM {}{} WHERE {} <= {} AND {} >= {} ORDER BY {} ASC, {} ASC",
-                                        streaming_archive::cMetadataDB::Archive::Id,
-                                        m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName,
-                                        streaming_archive::cMetadataDB::File::BeginTimestamp, end_ts,
-                                        streaming_archive::cMetadataDB::File::EndTimestamp, begin_ts,
-                                        streaming_archive::cMetadataDB::Archive::CreatorId, streaming_archive::cMetadataDB::Archive::CreationIx);
-    SPDLOG_DEBUG("{}", statement_string);
-
-    if (false == m_db.execute_query(statement_string)) {
-        throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
-    }
+    auto order_by_clause = fmt::format("{} ASC, {} ASC", streaming_archive::cMetadataDB::Archive::CreatorId,
+                                       streaming_archive::cMetadataDB::Archive::CreationIx);
+    return get_archive_iterator_for_time_window(begin_ts, end_ts, order_by_clause);
+}
 
-    return new ArchiveIterator(m_db.get_iterator());
+GlobalMetadataDB::ArchiveIterator* GlobalMySQLMetadataDB::get_archive_iterator_for_time_window_in_descending_end_ts_order (epochtime_t begin_ts,
+                                                                                                                          epochtime_t end_ts)
+{
+    auto order_by_clause = fmt::format("{} DESC", streaming_archive::cMetadataDB::Archive::EndTimestamp);
+    return get_archive_iterator_for_time_window(begin_ts, end_ts, order_by_clause);
 }
 
 GlobalMetadataDB::ArchiveIterator* GlobalMySQLMetadataDB::get_archive_iterator_for_file_path (const string& file_path) {
-    auto statement_string = fmt::format("SELECT DISTINCT {}{}.{} FROM {}{} JOIN {}{} ON {}{}.{} = {}{}.{} WHERE {}{}.{} = '{}' ORDER BY {} ASC, {} ASC",
+    auto statement_string = fmt::format("SELECT DISTINCT {}{}.{}, {}{}.{}, {}{}.{} FROM {}{} JOIN {}{} ON {}{}.{} = {}{}.{} WHERE {}{}.{} = '{}' "
+                                        "ORDER BY {} ASC, {} ASC",
                                         m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::Id,
                                         m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName,
+                                        streaming_archive::cMetadataDB::Archive::EndTimestamp,
+                                        m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName,
+                                        streaming_archive::cMetadataDB::Archive::IsFinalized,
+                                        m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName,
                                         m_table_prefix, streaming_archive::cMetadataDB::FilesTableName,
                                         m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::Id,
                                         m_table_prefix, streaming_archive::cMetadataDB::FilesTableName, streaming_archive::cMetadataDB::File::ArchiveId,
@@ -264,3 +361,68 @@ GlobalMetadataDB::ArchiveIterator* GlobalMySQLMetadataDB::get_archive_iterator_f
 
     return new ArchiveIterator(m_db.get_iterator());
 }
+
+bool GlobalMySQLMetadataDB::upsert_files (MySQLPreparedStatement& upsert_files_statement, const string& archive_id,
+                                          vector<streaming_archive::writer::File*>::const_iterator files_begin,
+                                          vector<streaming_archive::writer::File*>::const_iterator files_end)
+{
+    // NOTE: The bindings point to these values, so they must remain unchanged until the statement is executed
+    size_t num_files = files_end - files_begin;
+    vector<string> ids_as_strings(num_files);
+    vector<string> orig_file_ids_as_strings(num_files);
+    vector<int64_t> begin_timestamps(num_files);
+    vector<int64_t> end_timestamps(num_files);
+    vector<uint64_t> nums_uncompressed_bytes(num_files);
+    vector<uint64_t> nums_messages(num_files);
+
+    auto& statement_bindings = upsert_files_statement.get_statement_bindings();
+    size_t num_fields_per_file = enum_to_underlying_type(FilesTableFieldIndexes::Length);
+    for (size_t i = 0; i < num_files; ++i) {
+        auto file = *(files_begin + i);
+        size_t offset = i * num_fields_per_file;
+
+        ids_as_strings[i] = file->get_id_as_string();
+        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::Id) + offset, ids_as_strings[i].c_str(),
+                                        ids_as_strings[i].length());
+
+        orig_file_ids_as_strings[i] = file->get_orig_file_id_as_string();
+        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId) + offset, orig_file_ids_as_strings[i].c_str(),
+                                        orig_file_ids_as_strings[i].length());
+
+        const auto& orig_path = file->get_orig_path();
+        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::Path) + offset, orig_path.c_str(), orig_path.length());
+
+        begin_timestamps[i] = file->get_begin_ts();
+        statement_bindings.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp) + offset, begin_timestamps[i]);
+
+        end_timestamps[i] = file->get_end_ts();
+        statement_bindings.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp) + offset, end_timestamps[i]);
+
+        nums_uncompressed_bytes[i] = file->get_num_uncompressed_bytes();
+        statement_bindings.bind_uint64(enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes) + offset, nums_uncompressed_bytes[i]);
+
+        nums_messages[i] = file->get_num_messages();
+        statement_bindings.bind_uint64(enum_to_underlying_type(FilesTableFieldIndexes::NumMessages) + offset, nums_messages[i]);
+
+        statement_bindings.bind_varchar(enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId) + offset, archive_id.c_str(), archive_id.length());
+    }
+
+    return upsert_files_statement.execute();
+}
+
+GlobalMetadataDB::ArchiveIterator* GlobalMySQLMetadataDB::get_archive_iterator_for_time_window (epochtime_t begin_ts, epochtime_t end_ts,
+                                                                                               const string& order_by_clause)
+{
+    auto statement_string = fmt::format("SELECT DISTINCT {}, {}, {} FROM {}{} WHERE {} <= {} AND {} >= {} ORDER BY {}",
+                                        streaming_archive::cMetadataDB::Archive::Id, streaming_archive::cMetadataDB::Archive::EndTimestamp,
+                                        streaming_archive::cMetadataDB::Archive::IsFinalized, m_table_prefix, streaming_archive::cMetadataDB::ArchivesTableName,
+                                        streaming_archive::cMetadataDB::File::BeginTimestamp, end_ts,
+                                        streaming_archive::cMetadataDB::File::EndTimestamp, begin_ts, order_by_clause);
+    SPDLOG_DEBUG("{}", statement_string);
+
+    if (false == m_db.execute_query(statement_string)) {
+        throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
+    }
+
+    return new ArchiveIterator(m_db.get_iterator());
+}
@@ -1,6 +1,10 @@
 #ifndef GLOBALMYSQLMETADATADB_HPP
 #define GLOBALMYSQLMETADATADB_HPP
 
+// C++ standard libraries
+#include <memory>
+#include <unordered_map>
+
 // Project headers
 #include "ErrorCode.hpp"
 #include "GlobalMetadataDB.hpp"
@@ -9,6 +13,10 @@
 
 /**
  * Class representing a MySQL global metadata database
+ *
+ * NOTE: Updates may be made long after the connection was opened (e.g., by an archive's segment finalizer), by which point the server may have
+ * closed it. So a failed update is retried once on a new connection; since updates are idempotent, this is safe even if the failed attempt was
+ * partially applied.
  */
 class GlobalMySQLMetadataDB : public GlobalMetadataDB {
 public:
@@ -45,6 +53,8 @@ public:
         bool contains_element () const override { return m_db_iterator->contains_element(); }
         void get_next () override { m_db_iterator->get_next(); }
         void get_id (std::string& id) const override;
+        epochtime_t get_end_ts () const override;
+        bool is_finalized () const override;
 
     private:
         // Variables
@@ -63,13 +73,89 @@ public:
     void add_archive (const std::string& id, const streaming_archive::ArchiveMetadata& metadata) override;
     void update_archive_metadata (const std::string& archive_id, const streaming_archive::ArchiveMetadata& metadata) override;
     void update_metadata_for_files (const std::string& archive_id, const std::vector<streaming_archive::writer::File*>& files) override;
+    void mark_archive_finalized (const std::string& archive_id) override;
 
     GlobalMetadataDB::ArchiveIterator* get_archive_iterator () override;
     GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_time_window (epochtime_t begin_ts, epochtime_t end_ts) override;
+    GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_time_window_in_descending_end_ts_order (epochtime_t begin_ts,
+                                                                                                      epochtime_t end_ts) override;
     GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_file_path (const std::string& file_path) override;
 
 private:
+    // Methods
+    /**
+     * Prepares the statements used to update the database
+     */
+    void prepare_statements ();
+
+    /**
+     * Closes the current connection (ignoring any errors, since it may already be broken) and opens a new one
+     * @throw MySQLDB::OperationFailed if the connection can't be reopened
+     */
+    void reconnect ();
+
+    /**
+     * Rolls back the current transaction, if any, ignoring any errors since the connection may be broken
+     */
+    void try_rollback_transaction ();
+
+    /**
+     * Updates the given archive's metadata
+     * @param archive_id
+     * @param metadata
+     * @return true on success, false otherwise
+     */
+    bool try_update_archive_metadata (const std::string& archive_id, const streaming_archive::ArchiveMetadata& metadata);
+
+    /**
+     * Marks the given archive as finalized
+     * @param archive_id
+     * @return true on success, false otherwise
+     */
+    bool try_mark_archive_finalized (const std::string& archive_id);
+
+    /**
+     * Upserts the metadata of the given files in a single transaction, which is rolled back on failure
+     * @param archive_id
+     * @param files
+     * @return true on success, false otherwise
+     */
+    bool try_update_metadata_for_files (const std::string& archive_id, const std::vector<streaming_archive::writer::File*>& files);
+
+    /**
+     * Gets the statement which upserts the given number of files, preparing it if it hasn't been prepared on the current connection
+     * @param num_files
+     * @return The statement, or nullptr if it couldn't be prepared
+     */
+    MySQLPreparedStatement* try_get_upsert_files_statement (size_t num_files);
+
+    /**
+     * Gets an iterator to iterate over every archive that falls in the given time window, in the given order
+     * @param begin_ts
+     * @param end_ts
+     * @param order_by_clause SQL with which to order the archives
+     * @return The archive iterator
+     * @throw GlobalMySQLMetadataDB::OperationFailed if the query fails
+     */
+    GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_time_window (epochtime_t begin_ts, epochtime_t end_ts,
+                                                                            const std::string& order_by_clause);
+
+    /**
+     * Upserts the metadata of the given files using the given multi-row statement
+     * @param upsert_files_statement A statement which upserts exactly as many files as given
+     * @param archive_id
+     * @param files_begin
+     * @param files_end
+     * @return true on success, false otherwise
+     */
+    static bool upsert_files (MySQLPreparedStatement& upsert_files_statement, const std::string& archive_id,
+                              std::vector<streaming_archive::writer::File*>::const_iterator files_begin,
+                              std::vector<streaming_archive::writer::File*>::const_iterator files_end);
+
     // Variables
+    // Maximum number of files to upsert with a single statement
+    static constexpr size_t cMaxNumFilesPerUpsert = 256;
+
     std::string m_host;
     int m_port;
     std::string m_username;
@@ -81,7 +167,9 @@ private:
 
     std::unique_ptr<MySQLPreparedStatement> m_insert_archive_statement;
     std::unique_ptr<MySQLPreparedStatement> m_update_archive_size_statement;
-    std::unique_ptr<MySQLPreparedStatement> m_upsert_file_statement;
+    std::unique_ptr<MySQLPreparedStatement> m_mark_archive_finalized_statement;
+    // Statements to upsert files, keyed by the number of files each upserts (at most cMaxNumFilesPerUpsert)
+    std::unordered_map<size_t, std::unique_ptr<MySQLPreparedStatement>> m_upsert_files_statements;
 };
 
 #endif // GLOBALMYSQLMETADATADB_HPP
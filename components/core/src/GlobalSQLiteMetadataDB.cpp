@@ -1,6 +1,7 @@
 #include "GlobalSQLiteMetadataDB.hpp"
 
 // C++ standard libraries
+#include <algorithm>
 #include <tuple>
 #include <utility>
 
@@ -22,6 +23,7 @@ enum class ArchivesTableFieldIndexes : uint16_t {
     Size,
     CreatorId,
     CreationIx,
+    IsFinalized,
     Length,
 };
 enum class UpdateArchiveSizeStmtFieldIndexes : uint16_t {
@@ -62,6 +64,24 @@ static void create_tables (const vector<std::pair<string, string>>& archive_fiel
     create_archives_table.step();
     statement_buffer.clear();
 
+    // Archives tables created before archives were marked finalized lack the column, so add it. Archives in such tables were created by
+    // compressors that didn't mark them, so they're treated as finalized.
+    fmt::format_to(statement_buffer_ix, "SELECT COUNT(*) FROM pragma_table_info('{}') WHERE name = '{}'",
+                   streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::IsFinalized);
+    SPDLOG_DEBUG("{:.{}}", statement_buffer.data(), statement_buffer.size());
+    auto count_is_finalized_columns = db.prepare_statement(statement_buffer.data(), statement_buffer.size());
+    count_is_finalized_columns.step();
+    auto archives_table_has_is_finalized_column = (0 != count_is_finalized_columns.column_int(0));
+    statement_buffer.clear();
+    if (false == archives_table_has_is_finalized_column) {
+        fmt::format_to(statement_buffer_ix, "ALTER TABLE {} ADD COLUMN {} INTEGER NOT NULL DEFAULT 1", streaming_archive::cMetadataDB::ArchivesTableName,
+                       streaming_archive::cMetadataDB::Archive::IsFinalized);
+        SPDLOG_DEBUG("{:.{}}", statement_buffer.data(), statement_buffer.size());
+        auto add_is_finalized_column = db.prepare_statement(statement_buffer.data(), statement_buffer.size());
+        add_is_finalized_column.step();
+        statement_buffer.clear();
+    }
+
     fmt::format_to(statement_buffer_ix, "CREATE INDEX IF NOT EXISTS archives_creation_order ON {} ({},{})", streaming_archive::cMetadataDB::ArchivesTableName,
                    streaming_archive::cMetadataDB::Archive::CreatorId, streaming_archive::cMetadataDB::Archive::CreationIx);
     SPDLOG_DEBUG("{:.{}}", statement_buffer.data(), statement_buffer.size());
@@ -90,8 +110,35 @@ static void create_tables (const vector<std::pair<string, string>>& archive_fiel
     create_files_archive_id_index.step();
 }
 
+/**
+ * Gets the SQL for a statement which upserts the given number of files
+ * @param num_files
+ * @return The SQL
+ */
+static string get_upsert_files_statement_sql (size_t num_files) {
+    vector<pair<string, string>> file_field_names_and_types(enum_to_underlying_type(FilesTableFieldIndexes::Length));
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].first = streaming_archive::cMetadataDB::File::Id;
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId)].first = streaming_archive::cMetadataDB::File::OrigFileId;
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Path)].first = streaming_archive::cMetadataDB::File::Path;
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp)].first = streaming_archive::cMetadataDB::File::BeginTimestamp;
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp)].first = streaming_archive::cMetadataDB::File::EndTimestamp;
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes)].first =
+            streaming_archive::cMetadataDB::File::NumUncompressedBytes;
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::NumMessages)].first = streaming_archive::cMetadataDB::File::NumMessages;
+    file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId)].first = streaming_archive::cMetadataDB::File::ArchiveId;
+
+    // Insert or on conflict, set all fields except the ID to those of the row being inserted
+    auto statement = fmt::format("INSERT INTO {} ({}) VALUES {} ON CONFLICT ({}) DO UPDATE SET {}", streaming_archive::cMetadataDB::FilesTableName,
+                                 get_field_names_sql(file_field_names_and_types),
+                                 get_multi_row_placeholders_sql(file_field_names_and_types.size(), num_files), streaming_archive::cMetadataDB::File::Id,
+                                 get_set_field_to_excluded_value_sql(file_field_names_and_types, enum_to_underlying_type(FilesTableFieldIndexes::Id) + 1));
+    SPDLOG_DEBUG("{}", statement);
+    return statement;
+}
+
 static SQLitePreparedStatement get_archives_select_statement (SQLiteDB& db) {
-    auto statement_string = fmt::format("SELECT {} FROM {} ORDER BY {} ASC, {} ASC", streaming_archive::cMetadataDB::Archive::Id,
+    auto statement_string = fmt::format("SELECT {}, {}, {} FROM {} ORDER BY {} ASC, {} ASC", streaming_archive::cMetadataDB::Archive::Id,
+                                        streaming_archive::cMetadataDB::Archive::EndTimestamp, streaming_archive::cMetadataDB::Archive::IsFinalized,
                                         streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::CreatorId,
                                         streaming_archive::cMetadataDB::Archive::CreationIx);
     SPDLOG_DEBUG("{}", statement_string);
@@ -99,11 +146,20 @@ static SQLitePreparedStatement get_archives_select_statement (SQLiteDB& db) {
 }
 
 
-static SQLitePreparedStatement get_archives_for_time_window_select_statement (SQLiteDB& db, epochtime_t begin_ts, epochtime_t end_ts) {
-    auto statement_string = fmt::format("SELECT {} FROM {} WHERE {} <= ? AND {} >= ? ORDER BY {} ASC, {} ASC",
-                                        streaming_archive::cMetadataDB::Archive::Id, streaming_archive::cMetadataDB::ArchivesTableName,
-                                        streaming_archive::cMetadataDB::File::BeginTimestamp, streaming_archive::cMetadataDB::File::EndTimestamp,
-                                        streaming_archive::cMetadataDB::Archive::CreatorId, streaming_archive::cMetadataDB::Archive::CreationIx);
+static SQLitePreparedStatement get_archives_for_time_window_select_statement (SQLiteDB& db, epochtime_t begin_ts, epochtime_t end_ts,
+                                                                              bool in_descending_end_ts_order)
+{
+    string order_by_clause;
+    if (in_descending_end_ts_order) {
+        order_by_clause = fmt::format("{} DESC", streaming_archive::cMetadataDB::Archive::EndTimestamp);
+    } else {
+        order_by_clause = fmt::format("{} ASC, {} ASC", streaming_archive::cMetadataDB::Archive::CreatorId,
+                                      streaming_archive::cMetadataDB::Archive::CreationIx);
+    }
+    auto statement_string = fmt::format("SELECT {}, {}, {} FROM {} WHERE {} <= ? AND {} >= ? ORDER BY {}",
+                                        streaming_archive::cMetadataDB::Archive::Id, streaming_archive::cMetadataDB::Archive::EndTimestamp,
+                                        streaming_archive::cMetadataDB::Archive::IsFinalized, streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::File::BeginTimestamp,
+                                        streaming_archive::cMetadataDB::File::EndTimestamp, order_by_clause);
     SPDLOG_DEBUG("{}", statement_string);
     auto statement = db.prepare_statement(statement_string.c_str(), statement_string.length());
     statement.bind_int64(1, end_ts);
@@ -113,8 +169,10 @@ static SQLitePreparedStatement get_archives_for_time_window_select_statement (SQ
 }
 
 static SQLitePreparedStatement get_archives_for_file_select_statement (SQLiteDB& db, const string& file_path) {
-    auto statement_string = fmt::format("SELECT DISTINCT {}.{} FROM {} JOIN {} ON {}.{} = {}.{} WHERE {}.{} = ? ORDER BY {} ASC, {} ASC",
+    auto statement_string = fmt::format("SELECT DISTINCT {}.{}, {}.{}, {}.{} FROM {} JOIN {} ON {}.{} = {}.{} WHERE {}.{} = ? ORDER BY {} ASC, {} ASC",
                                         streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::Id,
+                                        streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::EndTimestamp,
+                                        streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::IsFinalized,
                                         streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::FilesTableName,
                                         streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::Id,
                                         streaming_archive::cMetadataDB::FilesTableName, streaming_archive::cMetadataDB::File::ArchiveId,
@@ -131,8 +189,8 @@ GlobalSQLiteMetadataDB::ArchiveIterator::ArchiveIterator (SQLiteDB& db) : m_stat
     m_statement.step();
 }
 
-GlobalSQLiteMetadataDB::ArchiveIterator::ArchiveIterator(SQLiteDB& db, epochtime_t begin_ts, epochtime_t end_ts) :
-        m_statement(get_archives_for_time_window_select_statement(db, begin_ts, end_ts)) {
+GlobalSQLiteMetadataDB::ArchiveIterator::ArchiveIterator(SQLiteDB& db, epochtime_t begin_ts, epochtime_t end_ts, bool in_descending_end_ts_order) :
+        m_statement(get_archives_for_time_window_select_statement(db, begin_ts, end_ts, in_descending_end_ts_order)) {
     m_statement.step();
 }
 
@@ -154,6 +212,14 @@ void GlobalSQLiteMetadataDB::ArchiveIterator::get_id (string& id) const {
     m_statement.column_string(0, id);
 }
 
+epochtime_t GlobalSQLiteMetadataDB::ArchiveIterator::get_end_ts () const {
+    return m_statement.column_int64(1);
+}
+
+bool GlobalSQLiteMetadataDB::ArchiveIterator::is_finalized () const {
+    return 0 != m_statement.column_int(2);
+}
+
 void GlobalSQLiteMetadataDB::open () {
     if (m_is_open) {
         throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
@@ -188,6 +254,10 @@ void GlobalSQLiteMetadataDB::open () {
             streaming_archive::cMetadataDB::Archive::CreationIx;
     archive_field_names_and_types[enum_to_underlying_type(ArchivesTableFieldIndexes::CreationIx)].second = "INTEGER";
 
+    archive_field_names_and_types[enum_to_underlying_type(ArchivesTableFieldIndexes::IsFinalized)].first =
+            streaming_archive::cMetadataDB::Archive::IsFinalized;
+    archive_field_names_and_types[enum_to_underlying_type(ArchivesTableFieldIndexes::IsFinalized)].second = "INTEGER";
+
     vector<pair<string, string>> file_field_names_and_types(enum_to_underlying_type(FilesTableFieldIndexes::Length));
     file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].first = streaming_archive::cMetadataDB::File::Id;
     file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].second = "TEXT PRIMARY KEY";
@@ -242,16 +312,15 @@ void GlobalSQLiteMetadataDB::open () {
     m_update_archive_size_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement(statement_buffer.data(), statement_buffer.size()));
     statement_buffer.clear();
 
-    // Insert or on conflict, set all fields except the ID
-    fmt::format_to(statement_buffer_ix, "INSERT INTO {} ({}) VALUES ({}) ON CONFLICT ({}) DO UPDATE SET {}", streaming_archive::cMetadataDB::FilesTableName,
-                   get_field_names_sql(file_field_names_and_types), get_numbered_placeholders_sql(file_field_names_and_types.size()),
-                   streaming_archive::cMetadataDB::File::Id,
-                   get_numbered_set_field_sql(file_field_names_and_types, enum_to_underlying_type(FilesTableFieldIndexes::Id) + 1));
+    fmt::format_to(statement_buffer_ix, "UPDATE {} SET {} = 1 WHERE {} = ?", streaming_archive::cMetadataDB::ArchivesTableName,
+                   streaming_archive::cMetadataDB::Archive::IsFinalized, streaming_archive::cMetadataDB::Archive::Id);
     SPDLOG_DEBUG("{:.{}}", statement_buffer.data(), statement_buffer.size());
-    m_upsert_file_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement(statement_buffer.data(), statement_buffer.size()));
+    m_mark_archive_finalized_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement(statement_buffer.data(),
+                                                                                                          statement_buffer.size()));
 
     m_upsert_files_transaction_begin_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement("BEGIN TRANSACTION"));
     m_upsert_files_transaction_end_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement("END TRANSACTION"));
+    m_upsert_files_transaction_rollback_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement("ROLLBACK TRANSACTION"));
 
     m_is_open = true;
 }
@@ -259,9 +328,11 @@ void GlobalSQLiteMetadataDB::open () {
 void GlobalSQLiteMetadataDB::close () {
     m_insert_archive_statement.reset(nullptr);
     m_update_archive_size_statement.reset(nullptr);
-    m_upsert_file_statement.reset(nullptr);
+    m_mark_archive_finalized_statement.reset(nullptr);
+    m_upsert_files_statements.clear();
     m_upsert_files_transaction_begin_statement.reset(nullptr);
     m_upsert_files_transaction_end_statement.reset(nullptr);
+    m_upsert_files_transaction_rollback_statement.reset(nullptr);
     if (false == m_db.close()) {
         throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
     }
@@ -283,6 +354,7 @@ void GlobalSQLiteMetadataDB::add_archive (const string& id, const streaming_arch
     m_insert_archive_statement->bind_int64(enum_to_underlying_type(ArchivesTableFieldIndexes::Size) + 1, (int64_t)metadata.get_compressed_size_bytes());
     m_insert_archive_statement->bind_text(enum_to_underlying_type(ArchivesTableFieldIndexes::CreatorId) + 1, metadata.get_creator_id(), false);
     m_insert_archive_statement->bind_int64(enum_to_underlying_type(ArchivesTableFieldIndexes::CreationIx) + 1, (int64_t)metadata.get_creation_idx());
+    m_insert_archive_statement->bind_int(enum_to_underlying_type(ArchivesTableFieldIndexes::IsFinalized) + 1, 0);
     m_insert_archive_statement->step();
     m_insert_archive_statement->reset();
 }
@@ -305,30 +377,85 @@ void GlobalSQLiteMetadataDB::update_archive_metadata (const string& archive_id,
     m_update_archive_size_statement->reset();
 }
 
+void GlobalSQLiteMetadataDB::mark_archive_finalized (const string& archive_id) {
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+
+    m_mark_archive_finalized_statement->bind_text(1, archive_id, false);
+    m_mark_archive_finalized_statement->step();
+    m_mark_archive_finalized_statement->reset();
+}
+
 void GlobalSQLiteMetadataDB::update_metadata_for_files (const string& archive_id, const vector<streaming_archive::writer::File*>& files) {
     if (false == m_is_open) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
     m_upsert_files_transaction_begin_statement->step();
-    for (auto file : files) {
-        const auto id_as_string = file->get_id_as_string();
-        const auto orig_file_id_as_string = file->get_orig_file_id_as_string();
-        m_upsert_file_statement->bind_text(enum_to_underlying_type(FilesTableFieldIndexes::Id) + 1, id_as_string, false);
-        m_upsert_file_statement->bind_text(enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId) + 1, orig_file_id_as_string, false);
-        m_upsert_file_statement->bind_text(enum_to_underlying_type(FilesTableFieldIndexes::Path) + 1, file->get_orig_path(), false);
-        m_upsert_file_statement->bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp) + 1, file->get_begin_ts());
-        m_upsert_file_statement->bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp) + 1, file->get_end_ts());
-        m_upsert_file_statement->bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes) + 1,
-                                            (int64_t)file->get_num_uncompressed_bytes());
-        m_upsert_file_statement->bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::NumMessages) + 1, (int64_t)file->get_num_messages());
-        m_upsert_file_statement->bind_text(enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId) + 1, archive_id, false);
-
-        m_upsert_file_statement->step();
-        m_upsert_file_statement->reset();
+    m_upsert_files_transaction_begin_statement->reset();
+    try {
+        auto files_it = files.cbegin();
+        while (files.cend() != files_it) {
+            auto num_files = std::min(static_cast<size_t>(files.cend() - files_it), cMaxNumFilesPerUpsert);
+            upsert_files(get_upsert_files_statement(num_files), archive_id, files_it, files_it + num_files);
+            files_it += num_files;
+        }
+        m_upsert_files_transaction_end_statement->step();
+        m_upsert_files_transaction_end_statement->reset();
+    } catch (TraceableException& e) {
+        // Roll back the transaction so that later updates don't fail by trying to begin a transaction within it
+        for (auto& statement : m_upsert_files_statements) {
+            statement.second->reset();
+        }
+        m_upsert_files_transaction_end_statement->reset();
+        try {
+            m_upsert_files_transaction_rollback_statement->step();
+        } catch (TraceableException& rollback_exception) {
+            // SQLite may have already rolled back the transaction
+            SPDLOG_WARN("GlobalSQLiteMetadataDB: Failed to roll back transaction - {}", m_db.get_error_message());
+        }
+        m_upsert_files_transaction_rollback_statement->reset();
+        throw;
     }
-    m_upsert_files_transaction_end_statement->step();
+}
 
-    m_upsert_files_transaction_begin_statement->reset();
-    m_upsert_files_transaction_end_statement->reset();
+SQLitePreparedStatement& GlobalSQLiteMetadataDB::get_upsert_files_statement (size_t num_files) {
+    auto& statement = m_upsert_files_statements[num_files];
+    if (nullptr == statement) {
+        statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement(get_upsert_files_statement_sql(num_files)));
+    }
+    return *statement;
+}
+
+void GlobalSQLiteMetadataDB::upsert_files (SQLitePreparedStatement& upsert_files_statement, const string& archive_id,
+                                           vector<streaming_archive::writer::File*>::const_iterator files_begin,
+                                           vector<streaming_archive::writer::File*>::const_iterator files_end)
+{
+    // NOTE: The statement doesn't copy the strings it's bound to, so they must remain unchanged until the statement is executed
+    size_t num_files = files_end - files_begin;
+    vector<string> ids_as_strings(num_files);
+    vector<string> orig_file_ids_as_strings(num_files);
+
+    size_t num_fields_per_file = enum_to_underlying_type(FilesTableFieldIndexes::Length);
+    for (size_t i = 0; i < num_files; ++i) {
+        auto file = *(files_begin + i);
+        // NOTE: Parameter indexes start at 1
+        size_t offset = i * num_fields_per_file + 1;
+
+        ids_as_strings[i] = file->get_id_as_string();
+        orig_file_ids_as_strings[i] = file->get_orig_file_id_as_string();
+        upsert_files_statement.bind_text(enum_to_underlying_type(FilesTableFieldIndexes::Id) + offset, ids_as_strings[i], false);
+        upsert_files_statement.bind_text(enum_to_underlying_type(FilesTableFieldIndexes::OrigFileId) + offset, orig_file_ids_as_strings[i], false);
+        upsert_files_statement.bind_text(enum_to_underlying_type(FilesTableFieldIndexes::Path) + offset, file->get_orig_path(), false);
+        upsert_files_statement.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::BeginTimestamp) + offset, file->get_begin_ts());
+        upsert_files_statement.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp) + offset, file->get_end_ts());
+        upsert_files_statement.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::NumUncompressedBytes) + offset,
+                                          (int64_t)file->get_num_uncompressed_bytes());
+        upsert_files_statement.bind_int64(enum_to_underlying_type(FilesTableFieldIndexes::NumMessages) + offset, (int64_t)file->get_num_messages());
+        upsert_files_statement.bind_text(enum_to_underlying_type(FilesTableFieldIndexes::ArchiveId) + offset, archive_id, false);
+    }
+
+    upsert_files_statement.step();
+    upsert_files_statement.reset();
 }
@@ -2,7 +2,9 @@
 #define GLOBALSQLITEMETADATADB_HPP
 
 // C++ standard libraries
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -47,12 +49,14 @@ public:
         // Constructors
         explicit ArchiveIterator (SQLiteDB& db);
         ArchiveIterator (SQLiteDB& db, const std::string& file_path);
-        ArchiveIterator (SQLiteDB& db, epochtime_t begin_ts, epochtime_t end_ts);
+        ArchiveIterator (SQLiteDB& db, epochtime_t begin_ts, epochtime_t end_ts, bool in_descending_end_ts_order);
 
         // Methods
         bool contains_element () const override;
         void get_next () override;
         void get_id (std::string& id) const override;
+        epochtime_t get_end_ts () const override;
+        bool is_finalized () const override;
 
     private:
         // Variables
@@ -70,22 +74,55 @@ public:
     void add_archive (const std::string& id, const streaming_archive::ArchiveMetadata& metadata) override;
     void update_archive_metadata (const std::string& archive_id, const streaming_archive::ArchiveMetadata& metadata) override;
     void update_metadata_for_files (const std::string& archive_id, const std::vector<streaming_archive::writer::File*>& files) override;
+    void mark_archive_finalized (const std::string& archive_id) override;
 
     GlobalMetadataDB::ArchiveIterator* get_archive_iterator () override { return new ArchiveIterator(m_db); }
-    GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_time_window (epochtime_t begin_ts, epochtime_t end_ts) override { return new ArchiveIterator(m_db, begin_ts, end_ts); }
+    GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_time_window (epochtime_t begin_ts, epochtime_t end_ts) override {
+        return new ArchiveIterator(m_db, begin_ts, end_ts, false);
+    }
+    GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_time_window_in_descending_end_ts_order (epochtime_t begin_ts,
+                                                                                                      epochtime_t end_ts) override {
+        return new ArchiveIterator(m_db, begin_ts, end_ts, true);
+    }
     GlobalMetadataDB::ArchiveIterator* get_archive_iterator_for_file_path (const std::string& path) override { return new ArchiveIterator(m_db, path); }
 
 private:
+    // Methods
+    /**
+     * Gets the statement which upserts the given number of files, preparing it if it hasn't been prepared yet
+     * @param num_files
+     * @return The statement
+     */
+    SQLitePreparedStatement& get_upsert_files_statement (size_t num_files);
+
+    /**
+     * Upserts the metadata of the given files using the given multi-row statement
+     * @param upsert_files_statement A statement which upserts exactly as many files as given
+     * @param archive_id
+     * @param files_begin
+     * @param files_end
+     */
+    static void upsert_files (SQLitePreparedStatement& upsert_files_statement, const std::string& archive_id,
+                              std::vector<streaming_archive::writer::File*>::const_iterator files_begin,
+                              std::vector<streaming_archive::writer::File*>::const_iterator files_end);
+
     // Variables
+    // Maximum number of files to upsert with a single statement
+    // NOTE: This is limited by SQLite's maximum number of parameters per statement, which is 999 in older versions
+    static constexpr size_t cMaxNumFilesPerUpsert = 64;
+
     std::string m_path;
 
     SQLiteDB m_db;
 
     std::unique_ptr<SQLitePreparedStatement> m_insert_archive_statement;
     std::unique_ptr<SQLitePreparedStatement> m_update_archive_size_statement;
-    std::unique_ptr<SQLitePreparedStatement> m_upsert_file_statement;
+    std::unique_ptr<SQLitePreparedStatement> m_mark_archive_finalized_statement;
+    // Statements to upsert files, keyed by the number of files each upserts (at most cMaxNumFilesPerUpsert)
+    std::unordered_map<size_t, std::unique_ptr<SQLitePreparedStatement>> m_upsert_files_statements;
     std::unique_ptr<SQLitePreparedStatement> m_upsert_files_transaction_begin_statement;
     std::unique_ptr<SQLitePreparedStatement> m_upsert_files_transaction_end_statement;
+    std::unique_ptr<SQLitePreparedStatement> m_upsert_files_transaction_rollback_statement;
 };
 
 #endif // GLOBALSQLITEMETADATADB_HPP
@@ -2,11 +2,13 @@
 
 // C++ libraries
 #include <algorithm>
+#include <unordered_map>
 
 // Project headers
 #include "compressor_frontend/Constants.hpp"
 #include "EncodedVariableInterpreter.hpp"
 #include "ir/parsing.hpp"
+#include "Profiler.hpp"
 #include "StringReader.hpp"
 #include "Utils.hpp"
 
@@ -255,18 +257,30 @@ static bool process_var_token (const QueryToken& query_token, const Archive& arc
  */
 static bool find_matching_message (const Query& query, Archive& archive, const SubQuery*& matching_sub_query, File& compressed_file, Message& compressed_msg);
 /**
- * Generates logtypes and variables for subquery
+ * Checks whether a message found by find_matching_message must still be wildcard-matched after decompression, i.e., whether:
+ * - the sub-query it matched requires a wildcard match, or
+ * - no sub-queries exist and the search string is not a match-all
+ * @param query
+ * @param matching_sub_query
+ * @return Whether a wildcard match is required
+ */
+static bool is_wildcard_match_required (const Query& query, const SubQuery* matching_sub_query);
+/**
+ * Generates the logtype wildcard string and variables for subquery. The logtypes matching the wildcard string must then be found in the
+ * logtype dictionary.
  * @param archive
  * @param processed_search_string
  * @param query_tokens
  * @param ignore_case
  * @param sub_query
+ * @param logtype Returns the logtype wildcard string
  * @return SubQueryMatchabilityResult::SupercedesAllSubQueries
  * @return SubQueryMatchabilityResult::WontMatch
  * @return SubQueryMatchabilityResult::MayMatch
  */
 static SubQueryMatchabilityResult generate_logtypes_and_vars_for_subquery (const Archive& archive, string& processed_search_string,
-                                                                           vector<QueryToken>& query_tokens, bool ignore_case, SubQuery& sub_query);
+                                                                           vector<QueryToken>& query_tokens, bool ignore_case, SubQuery& sub_query,
+                                                                           string& logtype);
 
 static bool process_var_token (const QueryToken& query_token, const Archive& archive, bool ignore_case, SubQuery& sub_query, string& logtype) {
     // Even though we may have a precise variable, we still fallback to decompressing to ensure that it is in the right place in the message
@@ -274,9 +288,11 @@ static bool process_var_token (const QueryToken& query_token, const Archive& arc
 
     // Create QueryVar corresponding to token
     if (!query_token.contains_wildcards()) {
-        if (EncodedVariableInterpreter::encode_and_search_dictionary(query_token.get_value(), archive.get_var_dictionary(), ignore_case, logtype,
-                                                                     sub_query) == false)
-        {
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryMatching>();
+        bool var_found = EncodedVariableInterpreter::encode_and_search_dictionary(query_token.get_value(), archive.get_var_dictionary(), ignore_case,
+                                                                                  logtype, sub_query);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryMatching>();
+        if (false == var_found) {
             // Variable doesn't exist in dictionary
             return false;
         }
@@ -294,9 +310,12 @@ static bool process_var_token (const QueryToken& query_token, const Archive& arc
 
             if (query_token.cannot_convert_to_non_dict_var()) {
                 // Must be a dictionary variable, so search variable dictionary
-                if (!EncodedVariableInterpreter::wildcard_search_dictionary_and_get_encoded_matches(query_token.get_value(), archive.get_var_dictionary(),
-                                                                                                    ignore_case, sub_query))
-                {
+                Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryMatching>();
+                bool var_found = EncodedVariableInterpreter::wildcard_search_dictionary_and_get_encoded_matches(query_token.get_value(),
+                                                                                                                archive.get_var_dictionary(),
+                                                                                                                ignore_case, sub_query);
+                Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryMatching>();
+                if (false == var_found) {
                     // Variable doesn't exist in dictionary
                     return false;
                 }
@@ -333,11 +352,19 @@ static bool find_matching_message (const Query& query, Archive& archive, const S
     return true;
 }
 
+static bool is_wildcard_match_required (const Query& query, const SubQuery* matching_sub_query) {
+    if (query.contains_sub_queries()) {
+        return matching_sub_query->wildcard_match_required();
+    } else {
+        return query.search_string_matches_all() == false;
+    }
+}
+
 SubQueryMatchabilityResult generate_logtypes_and_vars_for_subquery (const Archive& archive, string& processed_search_string, vector<QueryToken>& query_tokens,
-                                                                    bool ignore_case, SubQuery& sub_query)
+                                                                    bool ignore_case, SubQuery& sub_query, string& logtype)
 {
     size_t last_token_end_pos = 0;
-    string logtype;
+    logtype.clear();
     for (const auto& query_token : query_tokens) {
         // Append from end of last token to beginning of this token, to logtype
         logtype.append(processed_search_string, last_token_end_pos, query_token.get_begin_pos() - last_token_end_pos);
@@ -376,17 +403,6 @@ SubQueryMatchabilityResult generate_logtypes_and_vars_for_subquery (const Archiv
         return SubQueryMatchabilityResult::SupercedesAllSubQueries;
     }
 
-    // Find matching logtypes
-    std::unordered_set<const LogTypeDictionaryEntry*> possible_logtype_entries;
-    archive.get_logtype_dictionary().get_entries_matching_wildcard_string(logtype, ignore_case, possible_logtype_entries);
-    if (possible_logtype_entries.empty()) {
-        return SubQueryMatchabilityResult::WontMatch;
-    }
-    sub_query.set_possible_logtypes(possible_logtype_entries);
-
-    // Calculate the IDs of the segments that may contain results for the sub-query now that we've calculated the matching logtypes and variables
-    sub_query.calculate_ids_of_matching_segments();
-
     return SubQueryMatchabilityResult::MayMatch;
 }
 
@@ -442,6 +458,11 @@ bool Grep::process_raw_query (const Archive& archive, const string& search_strin
     // - (token1 as logtype) (token2 as var)
     // - (token1 as var) (token2 as logtype)
     // - (token1 as var) (token2 as var)
+    // NOTE: The logtypes matching each sub-query are found afterwards, in a single pass over the logtype dictionary for all sub-queries
+    vector<SubQuery> sub_queries;
+    vector<string> distinct_logtypes;
+    vector<size_t> sub_query_logtype_ixs;
+    std::unordered_map<string, size_t> logtype_to_ix;
     SubQuery sub_query;
     string logtype;
     bool type_of_one_token_changed = true;
@@ -449,7 +470,8 @@ bool Grep::process_raw_query (const Archive& archive, const string& search_strin
         sub_query.clear();
 
         // Compute logtypes and variables for query
-        auto matchability = generate_logtypes_and_vars_for_subquery(archive, processed_search_string, query_tokens, query.get_ignore_case(), sub_query);
+        auto matchability = generate_logtypes_and_vars_for_subquery(archive, processed_search_string, query_tokens, query.get_ignore_case(), sub_query,
+                                                                    logtype);
         switch (matchability) {
             case SubQueryMatchabilityResult::SupercedesAllSubQueries:
                 // Clear all sub-queries since they will be superceded by this sub-query
@@ -457,9 +479,15 @@ bool Grep::process_raw_query (const Archive& archive, const string& search_strin
 
                 // Since other sub-queries will be superceded by this one, we can stop processing now
                 return true;
-            case SubQueryMatchabilityResult::MayMatch:
-                query.add_sub_query(sub_query);
+            case SubQueryMatchabilityResult::MayMatch: {
+                auto [logtype_it, is_new_logtype] = logtype_to_ix.emplace(logtype, distinct_logtypes.size());
+                if (is_new_logtype) {
+                    distinct_logtypes.push_back(logtype);
+                }
+                sub_query_logtype_ixs.push_back(logtype_it->second);
+                sub_queries.push_back(sub_query);
                 break;
+            }
             case SubQueryMatchabilityResult::WontMatch:
             default:
                 // Do nothing
@@ -476,9 +504,52 @@ bool Grep::process_raw_query (const Archive& archive, const string& search_strin
         }
     }
 
+    // Find matching logtypes
+    vector<std::unordered_set<const LogTypeDictionaryEntry*>> possible_logtype_entries;
+    Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryMatching>();
+    archive.get_logtype_dictionary().get_entries_matching_wildcard_strings(distinct_logtypes, query.get_ignore_case(), possible_logtype_entries);
+    Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryMatching>();
+    for (size_t i = 0; i < sub_queries.size(); ++i) {
+        const auto& sub_query_possible_logtype_entries = possible_logtype_entries[sub_query_logtype_ixs[i]];
+        if (sub_query_possible_logtype_entries.empty()) {
+            continue;
+        }
+        auto& possible_sub_query = sub_queries[i];
+        possible_sub_query.set_possible_logtypes(sub_query_possible_logtype_entries);
+
+        // Calculate the IDs of the segments that may contain results for the sub-query now that we've calculated the matching logtypes and variables
+        possible_sub_query.calculate_ids_of_matching_segments();
+
+        query.add_sub_query(possible_sub_query);
+    }
+
     return query.contains_sub_queries();
 }
 
+void Grep::get_dictionary_vars_required_by_query (const string& search_string, vector<string>& dict_vars) {
+    // Process the search string the same way as process_raw_query, so that we find the same tokens
+    string processed_search_string = "*";
+    processed_search_string += search_string;
+    processed_search_string += '*';
+    processed_search_string = clean_up_wildcard_search_string(processed_search_string);
+    std::replace(processed_search_string.begin(), processed_search_string.end(), '?', '*');
+    processed_search_string = clean_up_wildcard_search_string(processed_search_string);
+
+    size_t begin_pos = 0;
+    size_t end_pos = 0;
+    bool is_var;
+    while (get_bounds_of_next_potential_var(processed_search_string, begin_pos, end_pos, is_var)) {
+        QueryToken query_token(processed_search_string, begin_pos, end_pos, is_var);
+        // Every sub-query looks such a token up in the variable dictionary as-is (see process_var_token). We skip tokens with escapes to avoid
+        // depending on how they're stored.
+        if (query_token.is_var() && false == query_token.contains_wildcards() && query_token.cannot_convert_to_non_dict_var() &&
+            string::npos == query_token.get_value().find('\\'))
+        {
+            dict_vars.push_back(query_token.get_value());
+        }
+    }
+}
+
 bool Grep::get_bounds_of_next_potential_var (const string& value, size_t& begin_pos, size_t& end_pos, bool& is_var) {
     const auto value_length = value.length();
     if (end_pos >= value_length) {
@@ -713,7 +784,71 @@ void Grep::calculate_sub_queries_relevant_to_file (const File& compressed_file,
     }
 }
 
-size_t Grep::search_and_output (const Query& query, size_t limit, Archive& archive, File& compressed_file, OutputFunc output_func, void* output_func_arg) {
+void Grep::find_matches_of_queries (const vector<const Query*>& queries, epochtime_t search_begin_ts, epochtime_t search_end_ts, Archive& archive,
+                                    File& compressed_file, Bitmap& messages_in_time_range, vector<Bitmap>& matches, vector<Bitmap>& possible_matches,
+                                    size_t& num_full_decodes_avoided)
+{
+    auto num_messages = compressed_file.get_num_messages();
+    messages_in_time_range.resize_and_clear(num_messages);
+    matches.resize(queries.size());
+    possible_matches.resize(queries.size());
+    for (size_t query_ix = 0; query_ix < queries.size(); ++query_ix) {
+        matches[query_ix].resize_and_clear(num_messages);
+        possible_matches[query_ix].resize_and_clear(num_messages);
+    }
+
+    archive.reset_file_indices(compressed_file);
+    Message compressed_msg;
+    while (archive.get_next_message(compressed_file, compressed_msg)) {
+        auto timestamp = compressed_msg.get_ts_in_milli();
+        if (timestamp < search_begin_ts || timestamp > search_end_ts) {
+            continue;
+        }
+        auto msg_ix = compressed_msg.get_message_number();
+        messages_in_time_range.set(msg_ix);
+
+        for (size_t query_ix = 0; query_ix < queries.size(); ++query_ix) {
+            const auto* query = queries[query_ix];
+            if (nullptr == query) {
+                continue;
+            }
+
+            bool wildcard_match_required;
+            if (query->contains_sub_queries()) {
+                // Prefer a sub-query that doesn't require wildcard matching
+                const SubQuery* matching_sub_query = nullptr;
+                for (auto sub_query : query->get_relevant_sub_queries()) {
+                    if (sub_query->matches_logtype(compressed_msg.get_logtype_id()) && sub_query->matches_vars(compressed_msg.get_vars())) {
+                        matching_sub_query = sub_query;
+                        if (false == sub_query->wildcard_match_required()) {
+                            break;
+                        }
+                    }
+                }
+                if (nullptr == matching_sub_query) {
+                    continue;
+                }
+                wildcard_match_required = matching_sub_query->wildcard_match_required();
+            } else {
+                wildcard_match_required = (false == query->search_string_matches_all());
+            }
+
+            if (wildcard_match_required) {
+                if (false == archive.message_may_match(compressed_file, compressed_msg, query->get_message_filter())) {
+                    ++num_full_decodes_avoided;
+                    continue;
+                }
+            } else {
+                matches[query_ix].set(msg_ix);
+            }
+            possible_matches[query_ix].set(msg_ix);
+        }
+    }
+}
+
+size_t Grep::search_and_output (const Query& query, size_t limit, Archive& archive, File& compressed_file, OutputFunc output_func, void* output_func_arg,
+                                size_t& num_full_decodes_avoided)
+{
     size_t num_matches = 0;
 
     Message compressed_msg;
@@ -726,6 +861,13 @@ size_t Grep::search_and_output (const Query& query, size_t limit, Archive& archi
             break;
         }
 
+        // Skip messages which can't match before decompressing them
+        bool wildcard_match_required = is_wildcard_match_required(query, matching_sub_query);
+        if (wildcard_match_required && false == archive.message_may_match(compressed_file, compressed_msg, query.get_message_filter())) {
+            ++num_full_decodes_avoided;
+            continue;
+        }
+
         // Decompress match
         bool decompress_successful = archive.decompress_message(compressed_file, compressed_msg, decompressed_msg);
         if (!decompress_successful) {
@@ -733,12 +875,7 @@ size_t Grep::search_and_output (const Query& query, size_t limit, Archive& archi
         }
 
         // Perform wildcard match if required
-        // Check if:
-        // - Sub-query requires wildcard match, or
-        // - no subqueries exist and the search string is not a match-all
-        if ((query.contains_sub_queries() && matching_sub_query->wildcard_match_required()) ||
-            (query.contains_sub_queries() == false && query.search_string_matches_all() == false))
-        {
+        if (wildcard_match_required) {
             bool matched = wildcard_match_unsafe(decompressed_msg, query.get_search_string(),
                                                  query.get_ignore_case() == false);
             if (!matched) {
@@ -766,6 +903,12 @@ bool Grep::search_and_decompress (const Query& query, Archive& archive, File& co
             return false;
         }
 
+        // Skip messages which can't match before decompressing them
+        bool wildcard_match_required = is_wildcard_match_required(query, matching_sub_query);
+        if (wildcard_match_required && false == archive.message_may_match(compressed_file, compressed_msg, query.get_message_filter())) {
+            continue;
+        }
+
         // Decompress match
         bool decompress_successful = archive.decompress_message(compressed_file, compressed_msg, decompressed_msg);
         if (false == decompress_successful) {
@@ -773,12 +916,7 @@ bool Grep::search_and_decompress (const Query& query, Archive& archive, File& co
         }
 
         // Perform wildcard match if required
-        // Check if:
-        // - Sub-query requires wildcard match, or
-        // - no subqueries exist and the search string is not a match-all
-        if ((query.contains_sub_queries() && matching_sub_query->wildcard_match_required()) ||
-            (query.contains_sub_queries() == false && query.search_string_matches_all() == false))
-        {
+        if (wildcard_match_required) {
             matched = wildcard_match_unsafe(decompressed_msg, query.get_search_string(),
                                             query.get_ignore_case() == false);
         } else {
@@ -789,7 +927,7 @@ bool Grep::search_and_decompress (const Query& query, Archive& archive, File& co
     return true;
 }
 
-size_t Grep::search (const Query& query, size_t limit, Archive& archive, File& compressed_file) {
+size_t Grep::search (const Query& query, size_t limit, Archive& archive, File& compressed_file, size_t& num_full_decodes_avoided) {
     size_t num_matches = 0;
 
     Message compressed_msg;
@@ -803,12 +941,67 @@ size_t Grep::search (const Query& query, size_t limit, Archive& archive, File& c
         }
 
         // Perform wildcard match if required
-        // Check if:
-        // - Sub-query requires wildcard match, or
-        // - no subqueries exist and the search string is not a match-all
-        if ((query.contains_sub_queries() && matching_sub_query->wildcard_match_required()) ||
-            (query.contains_sub_queries() == false && query.search_string_matches_all() == false))
+        if (is_wildcard_match_required(query, matching_sub_query)) {
+            // Skip messages which can't match before decompressing them
+            if (false == archive.message_may_match(compressed_file, compressed_msg, query.get_message_filter())) {
+                ++num_full_decodes_avoided;
+                continue;
+            }
+
+            // Decompress match
+            bool decompress_successful = archive.decompress_message(compressed_file, compressed_msg, decompressed_msg);
+            if (!decompress_successful) {
+                break;
+            }
+
+            bool matched = wildcard_match_unsafe(decompressed_msg, query.get_search_string(),
+                                                 query.get_ignore_case() == false);
+            if (!matched) {
+                continue;
+            }
+        }
+
+        ++num_matches;
+    }
+
+    return num_matches;
+}
+
+size_t Grep::search_and_aggregate (const Query& query, Archive& archive, File& compressed_file, AggregateFunc aggregate_func,
+                                   void* aggregate_func_arg, size_t& num_full_decodes_avoided)
+{
+    size_t num_matches = 0;
+
+    if (false == query.contains_sub_queries() && query.search_string_matches_all()) {
+        // Every message in the time range matches, so there's no need to read the messages' variables
+        epochtime_t timestamp;
+        logtype_dictionary_id_t logtype_id;
+        while (archive.find_timestamp_and_logtype_in_time_range(compressed_file, query.get_search_begin_timestamp(),
+                                                                query.get_search_end_timestamp(), timestamp, logtype_id))
         {
+            aggregate_func(timestamp, logtype_id, aggregate_func_arg);
+            ++num_matches;
+        }
+        return num_matches;
+    }
+
+    Message compressed_msg;
+    string decompressed_msg;
+    while (true) {
+        // Find matching message
+        const SubQuery* matching_sub_query = nullptr;
+        if (find_matching_message(query, archive, matching_sub_query, compressed_file, compressed_msg) == false) {
+            break;
+        }
+
+        // Perform wildcard match if required
+        if (is_wildcard_match_required(query, matching_sub_query)) {
+            // Skip messages which can't match before decompressing them
+            if (false == archive.message_may_match(compressed_file, compressed_msg, query.get_message_filter())) {
+                ++num_full_decodes_avoided;
+                continue;
+            }
+
             // Decompress match
             bool decompress_successful = archive.decompress_message(compressed_file, compressed_msg, decompressed_msg);
             if (!decompress_successful) {
@@ -822,6 +1015,7 @@ size_t Grep::search (const Query& query, size_t limit, Archive& archive, File& c
             }
         }
 
+        aggregate_func(compressed_msg.get_ts_in_milli(), compressed_msg.get_logtype_id(), aggregate_func_arg);
         ++num_matches;
     }
 
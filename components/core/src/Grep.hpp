@@ -3,8 +3,10 @@
 
 // C++ libraries
 #include <string>
+#include <vector>
 
 // Project headers
+#include "Bitmap.hpp"
 #include "Defs.h"
 #include "Query.hpp"
 #include "streaming_archive/reader/Archive.hpp"
@@ -24,6 +26,13 @@ public:
      */
     typedef void (*OutputFunc) (const std::string& orig_file_path, const streaming_archive::reader::Message& compressed_msg,
             const std::string& decompressed_msg, void* custom_arg);
+    /**
+     * Handles a search result that's being aggregated rather than output
+     * @param timestamp
+     * @param logtype_id
+     * @param custom_arg Custom argument for the aggregation function
+     */
+    typedef void (*AggregateFunc) (epochtime_t timestamp, logtype_dictionary_id_t logtype_id, void* custom_arg);
 
     // Methods
     /**
@@ -40,6 +49,15 @@ public:
                                    epochtime_t search_end_ts, bool ignore_case, Query& query, compressor_frontend::lexers::ByteLexer& forward_lexer,
                                    compressor_frontend::lexers::ByteLexer& reverse_lexer, bool use_heuristic);
 
+    /**
+     * Gets the dictionary variables that every message matching the given search string must contain, i.e., the tokens (found using
+     * heuristics) that are variables without wildcards and that can't be encoded as integer or float variables. An archive whose variable
+     * dictionary doesn't contain all of them (case-sensitively) can't contain any match.
+     * @param search_string
+     * @param dict_vars Returns the dictionary variables
+     */
+    static void get_dictionary_vars_required_by_query (const std::string& search_string, std::vector<std::string>& dict_vars);
+
     /**
      * Returns bounds of next potential variable (either a definite variable or a token with wildcards)
      * @param value String containing token
@@ -70,6 +88,25 @@ public:
      */
     static void calculate_sub_queries_relevant_to_file (const streaming_archive::reader::File& compressed_file, std::vector<Query>& queries);
 
+    /**
+     * Finds the messages in a file that match each of the given queries, in a single scan of the file's columns. Messages are never
+     * decompressed, so a message which may only match a query after wildcard matching is marked as a possible match of the query.
+     * NOTE: The sub-queries relevant to the file must already have been calculated, and the queries' own time ranges are ignored.
+     * @param queries The queries, where nullptr is a query that can't match any message
+     * @param search_begin_ts
+     * @param search_end_ts
+     * @param archive
+     * @param compressed_file
+     * @param messages_in_time_range Returns the messages (by message number) in the search time range
+     * @param matches Returns, for each query, the messages that match it
+     * @param possible_matches Returns, for each query, the messages that may match it (a superset of its matches)
+     * @param num_full_decodes_avoided Incremented for every possible match that was rejected without decompressing it
+     */
+    static void find_matches_of_queries (const std::vector<const Query*>& queries, epochtime_t search_begin_ts, epochtime_t search_end_ts,
+                                         streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                                         Bitmap& messages_in_time_range, std::vector<Bitmap>& matches, std::vector<Bitmap>& possible_matches,
+                                         size_t& num_full_decodes_avoided);
+
     /**
      * Searches a file with the given query and outputs any results using the given method
      * @param query
@@ -78,12 +115,14 @@ public:
      * @param compressed_file
      * @param output_func
      * @param output_func_arg
+     * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
      * @return Number of matches found
      * @throw streaming_archive::reader::Archive::OperationFailed if decompression unexpectedly fails
      * @throw TimestampPattern::OperationFailed if failed to insert timestamp into message
      */
     static size_t search_and_output (const Query& query, size_t limit, streaming_archive::reader::Archive& archive,
-                                     streaming_archive::reader::File& compressed_file, OutputFunc output_func, void* output_func_arg);
+                                     streaming_archive::reader::File& compressed_file, OutputFunc output_func, void* output_func_arg,
+                                     size_t& num_full_decodes_avoided);
     static bool search_and_decompress (const Query& query, streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
             streaming_archive::reader::Message& compressed_msg, std::string& decompressed_msg);
     /**
@@ -92,11 +131,30 @@ public:
      * @param limit
      * @param archive
      * @param compressed_file
+     * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
+     * @return Number of matches found
+     * @throw streaming_archive::reader::Archive::OperationFailed if decompression unexpectedly fails
+     * @throw TimestampPattern::OperationFailed if failed to insert timestamp into message
+     */
+    static size_t search (const Query& query, size_t limit, streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                          size_t& num_full_decodes_avoided);
+    /**
+     * Searches a file with the given query and passes the timestamp and logtype of each result to the given aggregation function. Results are
+     * only decompressed when they must be wildcard-matched; if every message in the query's time range matches, only the timestamp and logtype
+     * columns are read.
+     * @param query
+     * @param archive
+     * @param compressed_file
+     * @param aggregate_func
+     * @param aggregate_func_arg
+     * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
      * @return Number of matches found
      * @throw streaming_archive::reader::Archive::OperationFailed if decompression unexpectedly fails
      * @throw TimestampPattern::OperationFailed if failed to insert timestamp into message
      */
-    static size_t search (const Query& query, size_t limit, streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file);
+    static size_t search_and_aggregate (const Query& query, streaming_archive::reader::Archive& archive,
+                                        streaming_archive::reader::File& compressed_file, AggregateFunc aggregate_func, void* aggregate_func_arg,
+                                        size_t& num_full_decodes_avoided);
 };
 
 #endif // GREP_HPP
@@ -0,0 +1,137 @@
+#include "LibarchiveDataBlockPrefetcher.hpp"
+
+// Project headers
+#include "spdlog_with_specializations.hpp"
+
+using std::lock_guard;
+using std::mutex;
+using std::unique_lock;
+
+LibarchiveDataBlockPrefetcher::~LibarchiveDataBlockPrefetcher () {
+    if (false == m_is_open) {
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_state_changed.notify_all();
+    // NOTE: We must join here rather than in Thread's destructor since the thread uses this object's members
+    try {
+        join();
+    } catch (const Thread::OperationFailed& e) {
+        SPDLOG_ERROR("LibarchiveDataBlockPrefetcher: Failed to join thread - {}", e.what());
+    }
+}
+
+void LibarchiveDataBlockPrefetcher::open (struct archive* archive, size_t num_buffers) {
+    if (m_is_open) {
+        throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+    }
+    if (nullptr == archive) {
+        throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
+    }
+    // The consumer holds one block while the producer fills another
+    if (num_buffers < 2) {
+        throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
+    }
+
+    m_archive = archive;
+    // NOTE: Buffers are kept across entries so that their capacity can be reused
+    m_blocks.resize(num_buffers);
+    m_begin_ix = 0;
+    m_num_filled_blocks = 0;
+    m_consumer_holds_block = false;
+    m_producer_error_code = ErrorCode_Success;
+    m_stop = false;
+
+    start();
+    m_is_open = true;
+}
+
+void LibarchiveDataBlockPrefetcher::close () {
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_state_changed.notify_all();
+    join();
+    m_is_open = false;
+    m_archive = nullptr;
+}
+
+ErrorCode LibarchiveDataBlockPrefetcher::try_get_next_data_block (const void*& data_block, size_t& data_block_length,
+                                                                  la_int64_t& data_block_pos_in_file)
+{
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+
+    unique_lock<mutex> lock(m_mutex);
+    if (m_consumer_holds_block) {
+        m_begin_ix = (m_begin_ix + 1) % m_blocks.size();
+        --m_num_filled_blocks;
+        m_consumer_holds_block = false;
+        m_state_changed.notify_all();
+    }
+
+    m_state_changed.wait(lock, [this] { return m_num_filled_blocks > 0 || ErrorCode_Success != m_producer_error_code; });
+    if (0 == m_num_filled_blocks) {
+        return m_producer_error_code;
+    }
+
+    const auto& block = m_blocks[m_begin_ix];
+    data_block = block.data.data();
+    data_block_length = block.data.size();
+    data_block_pos_in_file = block.pos_in_file;
+    m_consumer_holds_block = true;
+
+    return ErrorCode_Success;
+}
+
+void LibarchiveDataBlockPrefetcher::thread_method () {
+    while (true) {
+        unique_lock<mutex> lock(m_mutex);
+        m_state_changed.wait(lock, [this] { return m_stop || m_num_filled_blocks < m_blocks.size(); });
+        if (m_stop) {
+            break;
+        }
+        // NOTE: The consumer never accesses blocks past the filled ones, so this block can be filled without holding the lock
+        auto& block = m_blocks[(m_begin_ix + m_num_filled_blocks) % m_blocks.size()];
+        lock.unlock();
+
+        const void* data_block;
+        size_t data_block_length;
+        la_int64_t data_block_pos_in_file;
+        auto error_code = ErrorCode_Success;
+        auto return_value = archive_read_data_block(m_archive, &data_block, &data_block_length, &data_block_pos_in_file);
+        if (ARCHIVE_OK != return_value) {
+            if (ARCHIVE_EOF == return_value) {
+                error_code = ErrorCode_EndOfFile;
+            } else {
+                SPDLOG_DEBUG("Failed to read data block from libarchive - {}", archive_error_string(m_archive));
+                error_code = ErrorCode_Failure;
+            }
+        } else {
+            const auto* data = static_cast<const char*>(data_block);
+            block.data.assign(data, data + data_block_length);
+            block.pos_in_file = data_block_pos_in_file;
+        }
+
+        lock.lock();
+        if (ErrorCode_Success != error_code) {
+            m_producer_error_code = error_code;
+        } else {
+            ++m_num_filled_blocks;
+        }
+        m_state_changed.notify_all();
+        if (ErrorCode_Success != error_code) {
+            break;
+        }
+    }
+}
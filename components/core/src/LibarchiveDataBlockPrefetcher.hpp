@@ -0,0 +1,100 @@
+#ifndef LIBARCHIVEDATABLOCKPREFETCHER_HPP
+#define LIBARCHIVEDATABLOCKPREFETCHER_HPP
+
+// C++ standard libraries
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// libarchive
+#include <archive.h>
+
+// Project headers
+#include "ErrorCode.hpp"
+#include "Thread.hpp"
+#include "TraceableException.hpp"
+
+/**
+ * A thread that reads (and thereby decompresses) the data blocks of the current archive entry through libarchive, ahead of the thread consuming
+ * them. Blocks are copied into a fixed ring of reusable buffers, so the consumer can read a block in place while the next ones are being
+ * decompressed. The producer blocks when all buffers are filled.
+ *
+ * NOTE: While the prefetcher is open, the archive must not be accessed by any other thread.
+ */
+class LibarchiveDataBlockPrefetcher : public Thread {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException (error_code, filename, line_number) {}
+
+        // Methods
+        const char* what () const noexcept override {
+            return "LibarchiveDataBlockPrefetcher operation failed";
+        }
+    };
+
+    // Constructors
+    LibarchiveDataBlockPrefetcher () : m_archive(nullptr), m_is_open(false), m_begin_ix(0), m_num_filled_blocks(0), m_consumer_holds_block(false),
+                                       m_producer_error_code(ErrorCode_Success), m_stop(false) {}
+
+    // Destructor
+    ~LibarchiveDataBlockPrefetcher () override;
+
+    // Methods
+    /**
+     * Starts prefetching the data blocks of the archive's current entry
+     * @param archive
+     * @param num_buffers Number of data blocks that can be buffered ahead of the consumer (must be at least 2)
+     * @throw LibarchiveDataBlockPrefetcher::OperationFailed if the prefetcher is already open or num_buffers is too small
+     * @throw Same as Thread::start
+     */
+    void open (struct archive* archive, size_t num_buffers);
+    /**
+     * Stops prefetching, discarding any data blocks that haven't been consumed
+     * @throw LibarchiveDataBlockPrefetcher::OperationFailed if the prefetcher isn't open
+     * @throw Same as Thread::join
+     */
+    void close ();
+
+    /**
+     * Releases the previously returned data block (if any) and waits for the next one
+     * @param data_block Returns a pointer to the block's data, valid until the next call to this method or close
+     * @param data_block_length
+     * @param data_block_pos_in_file
+     * @return ErrorCode_EndOfFile on EOF
+     * @return ErrorCode_Failure on failure
+     * @return ErrorCode_Success on success
+     * @throw LibarchiveDataBlockPrefetcher::OperationFailed if the prefetcher isn't open
+     */
+    ErrorCode try_get_next_data_block (const void*& data_block, size_t& data_block_length, la_int64_t& data_block_pos_in_file);
+
+protected:
+    // Methods
+    void thread_method () override;
+
+private:
+    // Types
+    struct DataBlock {
+        std::vector<char> data;
+        la_int64_t pos_in_file;
+    };
+
+    // Variables
+    struct archive* m_archive;
+    bool m_is_open;
+
+    std::mutex m_mutex;
+    std::condition_variable m_state_changed;
+    std::vector<DataBlock> m_blocks;
+    size_t m_begin_ix;
+    // NOTE: This includes the block being read by the consumer
+    size_t m_num_filled_blocks;
+    bool m_consumer_holds_block;
+    // Set by the producer once it reaches EOF or fails
+    ErrorCode m_producer_error_code;
+    bool m_stop;
+};
+
+#endif // LIBARCHIVEDATABLOCKPREFETCHER_HPP
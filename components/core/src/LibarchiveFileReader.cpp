@@ -167,7 +167,7 @@ ErrorCode LibarchiveFileReader::try_read_to_delimiter (char delim, bool keep_del
     return ErrorCode_Success;
 }
 
-void LibarchiveFileReader::open (struct archive* archive, struct archive_entry* archive_entry) {
+void LibarchiveFileReader::open (struct archive* archive, struct archive_entry* archive_entry, size_t num_prefetched_data_blocks) {
     if (nullptr == archive) {
         throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
     }
@@ -180,6 +180,12 @@ void LibarchiveFileReader::open (struct archive* archive, struct archive_entry*
 
     m_archive = archive;
     m_archive_entry = archive_entry;
+
+    if (num_prefetched_data_blocks > 0) {
+        // One more buffer is needed for the block being read
+        m_data_block_prefetcher.open(m_archive, num_prefetched_data_blocks + 1);
+        m_is_prefetching = true;
+    }
 }
 
 void LibarchiveFileReader::close () {
@@ -187,6 +193,12 @@ void LibarchiveFileReader::close () {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
+    if (m_is_prefetching) {
+        // NOTE: This must happen before the archive is used again
+        m_data_block_prefetcher.close();
+        m_is_prefetching = false;
+    }
+
     m_archive = nullptr;
     m_archive_entry = nullptr;
 
@@ -237,6 +249,19 @@ void LibarchiveFileReader::peek_buffered_data(char const*& buf, size_t& buf_size
 }
 
 ErrorCode LibarchiveFileReader::read_next_data_block () {
+    if (m_is_prefetching) {
+        auto error_code = m_data_block_prefetcher.try_get_next_data_block(m_data_block, m_data_block_length, m_data_block_pos_in_file);
+        if (ErrorCode_Success != error_code) {
+            if (ErrorCode_EndOfFile == error_code) {
+                m_reached_eof = true;
+            }
+            m_data_block = nullptr;
+            return error_code;
+        }
+        m_pos_in_data_block = 0;
+        return ErrorCode_Success;
+    }
+
     auto return_value = archive_read_data_block(m_archive, &m_data_block, &m_data_block_length, &m_data_block_pos_in_file);
     if (ARCHIVE_OK != return_value) {
         if (ARCHIVE_EOF == return_value) {
@@ -10,6 +10,7 @@
 
 // Project headers
 #include "ErrorCode.hpp"
+#include "LibarchiveDataBlockPrefetcher.hpp"
 #include "ReaderInterface.hpp"
 #include "TraceableException.hpp"
 
@@ -31,7 +32,8 @@ public:
     };
 
     // Constructors
-    LibarchiveFileReader () : m_archive(nullptr), m_archive_entry(nullptr), m_data_block(nullptr), m_reached_eof(false), m_pos_in_file(0) {}
+    LibarchiveFileReader () : m_archive(nullptr), m_archive_entry(nullptr), m_data_block(nullptr), m_reached_eof(false), m_pos_in_file(0),
+                              m_is_prefetching(false) {}
 
     // Methods implementing the ReaderInterface
     /**
@@ -75,8 +77,10 @@ public:
      * Opens the file reader
      * @param archive
      * @param archive_entry
+     * @param num_prefetched_data_blocks Number of data blocks to decompress ahead of the reader on a separate thread, or 0 to decompress each
+     * block when it's read. While prefetching, the archive must not be accessed until the reader is closed.
      */
-    void open (struct archive* archive, struct archive_entry* archive_entry);
+    void open (struct archive* archive, struct archive_entry* archive_entry, size_t num_prefetched_data_blocks = 0);
     /**
      * Closes the file reader
      */
@@ -122,6 +126,9 @@ private:
 
     size_t m_pos_in_file;
 
+    bool m_is_prefetching;
+    LibarchiveDataBlockPrefetcher m_data_block_prefetcher;
+
     // Nulls for peek
     std::array<char, 4096> m_nulls_for_peek{0};
 };
@@ -76,7 +76,7 @@ ErrorCode LibarchiveReader::try_read_next_header () {
     return ErrorCode_Success;
 }
 
-void LibarchiveReader::open_file_reader (LibarchiveFileReader& libarchive_file_reader) {
+void LibarchiveReader::open_file_reader (LibarchiveFileReader& libarchive_file_reader, size_t num_prefetched_data_blocks) {
     if (nullptr == m_archive) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
@@ -84,7 +84,7 @@ void LibarchiveReader::open_file_reader (LibarchiveFileReader& libarchive_file_r
         throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
     }
 
-    libarchive_file_reader.open(m_archive, m_archive_entry);
+    libarchive_file_reader.open(m_archive, m_archive_entry, num_prefetched_data_blocks);
 }
 
 mode_t LibarchiveReader::get_entry_file_type () const {
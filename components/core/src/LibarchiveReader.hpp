@@ -65,8 +65,9 @@ public:
     /**
      * Opens the current entry within the given reader
      * @param libarchive_file_reader
+     * @param num_prefetched_data_blocks See LibarchiveFileReader::open
      */
-    void open_file_reader (LibarchiveFileReader& libarchive_file_reader);
+    void open_file_reader (LibarchiveFileReader& libarchive_file_reader, size_t num_prefetched_data_blocks = 0);
 
     /**
      * Gets the type of the current entry
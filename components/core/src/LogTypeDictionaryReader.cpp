@@ -1 +1,21 @@
 #include "LogTypeDictionaryReader.hpp"
+
+using std::make_unique;
+
+void LogTypeDictionaryReader::close () {
+    m_render_templates.clear();
+    DictionaryReader::close();
+}
+
+const LogTypeRenderTemplate& LogTypeDictionaryReader::get_render_template (logtype_dictionary_id_t id) {
+    const auto& entry = get_entry(id);
+    if (id >= m_render_templates.size()) {
+        m_render_templates.resize(m_entries.size());
+    }
+
+    auto& render_template = m_render_templates[id];
+    if (nullptr == render_template) {
+        render_template = make_unique<LogTypeRenderTemplate>(entry);
+    }
+    return *render_template;
+}
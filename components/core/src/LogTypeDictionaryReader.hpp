@@ -1,14 +1,38 @@
 #ifndef LOGTYPEDICTIONARYREADER_HPP
 #define LOGTYPEDICTIONARYREADER_HPP
 
+// C++ standard libraries
+#include <memory>
+#include <vector>
+
 // Project headers
 #include "Defs.h"
 #include "DictionaryReader.hpp"
 #include "LogTypeDictionaryEntry.hpp"
+#include "LogTypeRenderTemplate.hpp"
 
 /**
  * Class for reading logtype dictionaries from disk and performing operations on them
  */
-class LogTypeDictionaryReader : public DictionaryReader<logtype_dictionary_id_t, LogTypeDictionaryEntry> {};
+class LogTypeDictionaryReader : public DictionaryReader<logtype_dictionary_id_t, LogTypeDictionaryEntry> {
+public:
+    // Methods
+    /**
+     * Closes the dictionary and discards any compiled render templates
+     */
+    void close ();
+
+    /**
+     * Gets the render template of the entry with the given ID, compiling it on first use
+     * @param id
+     * @return The entry's render template
+     */
+    const LogTypeRenderTemplate& get_render_template (logtype_dictionary_id_t id);
+
+private:
+    // Variables
+    // Render templates indexed by entry ID, or nullptr if the entry hasn't been compiled yet
+    std::vector<std::unique_ptr<LogTypeRenderTemplate>> m_render_templates;
+};
 
 #endif // LOGTYPEDICTIONARYREADER_HPP
@@ -9,11 +9,7 @@ bool LogTypeDictionaryWriter::add_entry (LogTypeDictionaryEntry& logtype_entry,
     bool is_new_entry = false;
 
     const string& value = logtype_entry.get_value();
-    const auto ix = m_value_to_id.find(value);
-    if (m_value_to_id.end() != ix) {
-        // Entry exists so get its ID
-        logtype_id = ix->second;
-    } else {
+    if (false == try_get_id(value, logtype_id)) {
         // Dictionary entry doesn't exist so create it
 
         // Assign ID
@@ -22,7 +18,7 @@ bool LogTypeDictionaryWriter::add_entry (LogTypeDictionaryEntry& logtype_entry,
         logtype_entry.set_id(logtype_id);
 
         // Insert new entry into dictionary
-        m_value_to_id[value] = logtype_id;
+        add_value_to_id_mapping(value, logtype_id);
 
         is_new_entry = true;
 
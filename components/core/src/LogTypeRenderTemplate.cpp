@@ -0,0 +1,22 @@
+#include "LogTypeRenderTemplate.hpp"
+
+LogTypeRenderTemplate::LogTypeRenderTemplate (const LogTypeDictionaryEntry& logtype_entry) {
+    const auto& logtype_value = logtype_entry.get_value();
+    auto num_vars = logtype_entry.get_num_vars();
+    m_constants.reserve(logtype_value.length() - num_vars);
+    m_variable_slots.reserve(num_vars);
+
+    ir::VariablePlaceholder var_placeholder;
+    size_t constant_begin_pos = 0;
+    for (size_t i = 0; i < num_vars; ++i) {
+        size_t var_position = logtype_entry.get_var_info(i, var_placeholder);
+        auto constant_length = var_position - constant_begin_pos;
+        m_constants.append(logtype_value, constant_begin_pos, constant_length);
+        m_variable_slots.push_back({constant_length, var_placeholder});
+
+        // Move past the variable placeholder
+        constant_begin_pos = var_position + 1;
+    }
+    m_trailing_constant_length = logtype_value.length() - constant_begin_pos;
+    m_constants.append(logtype_value, constant_begin_pos, m_trailing_constant_length);
+}
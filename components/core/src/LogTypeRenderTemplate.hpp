@@ -0,0 +1,44 @@
+#ifndef LOGTYPERENDERTEMPLATE_HPP
+#define LOGTYPERENDERTEMPLATE_HPP
+
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Project headers
+#include "ir/parsing.hpp"
+#include "LogTypeDictionaryEntry.hpp"
+
+/**
+ * A logtype compiled for fast message reconstruction. The logtype's constants are stored contiguously and each variable is stored as a typed slot that
+ * records the length of the constant preceding it, so rendering a message is a sequence of appends rather than a walk over the logtype's value.
+ */
+class LogTypeRenderTemplate {
+public:
+    // Types
+    struct VariableSlot {
+        // Length of the constant between the previous variable (or the start of the logtype) and this variable
+        size_t preceding_constant_length;
+        ir::VariablePlaceholder placeholder;
+    };
+
+    // Constructors
+    explicit LogTypeRenderTemplate (const LogTypeDictionaryEntry& logtype_entry);
+
+    // Methods
+    const std::string& get_constants () const { return m_constants; }
+    const std::vector<VariableSlot>& get_variable_slots () const { return m_variable_slots; }
+    size_t get_num_vars () const { return m_variable_slots.size(); }
+    /**
+     * @return The length of the constant after the last variable
+     */
+    size_t get_trailing_constant_length () const { return m_trailing_constant_length; }
+
+private:
+    // Variables
+    std::string m_constants;
+    std::vector<VariableSlot> m_variable_slots;
+    size_t m_trailing_constant_length;
+};
+
+#endif // LOGTYPERENDERTEMPLATE_HPP
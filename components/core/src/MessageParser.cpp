@@ -2,6 +2,7 @@
 
 // Project headers
 #include "Defs.h"
+#include "Profiler.hpp"
 #include "TimestampPattern.hpp"
 
 // Constants
@@ -86,6 +87,7 @@ bool MessageParser::parse_line (ParsedMessage& message) {
     bool message_completed = false;
 
     // Parse timestamp and content
+    Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::TimestampParsing>();
     const TimestampPattern* timestamp_pattern = message.get_ts_patt();
     epochtime_t timestamp = 0;
     size_t timestamp_begin_pos;
@@ -93,6 +95,7 @@ bool MessageParser::parse_line (ParsedMessage& message) {
     if (nullptr == timestamp_pattern || false == timestamp_pattern->parse_timestamp(m_line, timestamp, timestamp_begin_pos, timestamp_end_pos)) {
         timestamp_pattern = TimestampPattern::search_known_ts_patterns(m_line, timestamp, timestamp_begin_pos, timestamp_end_pos);
     }
+    Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::TimestampParsing>();
 
     if (nullptr != timestamp_pattern) {
         // A timestamp was parsed
@@ -0,0 +1,51 @@
+#include "MinHashSignature.hpp"
+
+// C++ standard libraries
+#include <algorithm>
+#include <limits>
+
+// Local prototypes
+/**
+ * Mixes the bits of the given value using the splitmix64 finalizer
+ * @param value
+ * @return The mixed value
+ */
+static uint64_t mix_bits (uint64_t value);
+
+static uint64_t mix_bits (uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+MinHashSignature::MinHashSignature () {
+    m_min_hashes.fill(std::numeric_limits<uint64_t>::max());
+}
+
+void MinHashSignature::add (uint64_t value) {
+    // Each hash function is the mixer applied to the value offset by a different multiple of the golden ratio
+    constexpr uint64_t cGoldenRatio = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < cNumHashes; ++i) {
+        auto hash = mix_bits(value + (i + 1) * cGoldenRatio);
+        m_min_hashes[i] = std::min(m_min_hashes[i], hash);
+    }
+}
+
+void MinHashSignature::merge (const MinHashSignature& other) {
+    for (size_t i = 0; i < cNumHashes; ++i) {
+        m_min_hashes[i] = std::min(m_min_hashes[i], other.m_min_hashes[i]);
+    }
+}
+
+double MinHashSignature::estimate_similarity (const MinHashSignature& other) const {
+    size_t num_matching_hashes = 0;
+    for (size_t i = 0; i < cNumHashes; ++i) {
+        if (m_min_hashes[i] == other.m_min_hashes[i]) {
+            ++num_matching_hashes;
+        }
+    }
+    return static_cast<double>(num_matching_hashes) / cNumHashes;
+}
@@ -0,0 +1,55 @@
+#ifndef MINHASHSIGNATURE_HPP
+#define MINHASHSIGNATURE_HPP
+
+// C++ standard libraries
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A MinHash signature of a set of integers, which can be used to cheaply estimate the Jaccard similarity of two sets without comparing their
+ * elements. Signatures of two sets can be merged to produce the signature of their union.
+ */
+class MinHashSignature {
+public:
+    // Constants
+    static constexpr size_t cNumHashes = 32;
+
+    // Constructors
+    MinHashSignature ();
+
+    // Methods
+    /**
+     * Adds the given value to the signed set
+     * @param value
+     */
+    void add (uint64_t value);
+    /**
+     * Adds all values in the given container to the signed set
+     * @tparam Container
+     * @param values
+     */
+    template <typename Container>
+    void add_all (const Container& values) {
+        for (const auto value : values) {
+            add(value);
+        }
+    }
+    /**
+     * Updates this signature to be the signature of the union of this set and the other set
+     * @param other
+     */
+    void merge (const MinHashSignature& other);
+
+    /**
+     * @param other
+     * @return An estimate, in [0, 1], of the Jaccard similarity between this set and the other set
+     */
+    double estimate_similarity (const MinHashSignature& other) const;
+
+private:
+    // Variables
+    std::array<uint64_t, cNumHashes> m_min_hashes;
+};
+
+#endif // MINHASHSIGNATURE_HPP
@@ -0,0 +1,161 @@
+#include "MultiWildcardMatcher.hpp"
+
+// C++ standard libraries
+#include <algorithm>
+#include <cctype>
+#include <queue>
+
+// Project headers
+#include "string_utils.hpp"
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+// NOTE: Since the root can't be the child of any state, a transition to it also marks the absence of a child while the trie is being built
+static constexpr uint32_t cRootState = 0;
+
+MultiWildcardMatcher::MultiWildcardMatcher (const vector<string>& wildcard_strings, bool ignore_case) :
+        m_wildcard_strings(wildcard_strings), m_ignore_case(ignore_case), m_value_num(0)
+{
+    m_states.emplace_back();
+    m_states[cRootState].next_states.fill(cRootState);
+    m_states[cRootState].failure_state = cRootState;
+
+    m_wildcard_string_fragment_ixs.resize(m_wildcard_strings.size());
+    for (size_t wildcard_string_ix = 0; wildcard_string_ix < m_wildcard_strings.size(); ++wildcard_string_ix) {
+        auto& fragment_ixs = m_wildcard_string_fragment_ixs[wildcard_string_ix];
+        auto add_fragment_to_wildcard_string = [&] (string& fragment) {
+            if (fragment.empty()) {
+                return;
+            }
+            auto fragment_ix = add_fragment(fragment);
+            if (fragment_ixs.cend() == std::find(fragment_ixs.cbegin(), fragment_ixs.cend(), fragment_ix)) {
+                fragment_ixs.push_back(fragment_ix);
+                m_fragment_wildcard_string_ixs[fragment_ix].push_back(wildcard_string_ix);
+            }
+            fragment.clear();
+        };
+
+        // Split the wildcard string into the literal fragments between its wildcards
+        string fragment;
+        bool is_escaped = false;
+        for (auto c : m_wildcard_strings[wildcard_string_ix]) {
+            if (is_escaped) {
+                fragment += static_cast<char>(fold_case(c));
+                is_escaped = false;
+            } else if ('\\' == c) {
+                is_escaped = true;
+            } else if ('*' == c || '?' == c) {
+                add_fragment_to_wildcard_string(fragment);
+            } else {
+                fragment += static_cast<char>(fold_case(c));
+            }
+        }
+        add_fragment_to_wildcard_string(fragment);
+    }
+
+    build_automaton();
+
+    m_fragment_found_value_num.resize(m_fragment_wildcard_string_ixs.size(), 0);
+    m_wildcard_string_value_num.resize(m_wildcard_strings.size(), 0);
+    m_wildcard_string_num_fragments_found.resize(m_wildcard_strings.size(), 0);
+}
+
+void MultiWildcardMatcher::get_matching_wildcard_strings (string_view value, vector<size_t>& matching_wildcard_string_ixs) {
+    matching_wildcard_string_ixs.clear();
+    ++m_value_num;
+
+    // Find the fragments in the value, counting how many distinct fragments of each wildcard string were found
+    uint32_t state = cRootState;
+    for (auto c : value) {
+        state = m_states[state].next_states[fold_case(c)];
+        for (auto fragment_ix : m_states[state].fragment_ixs) {
+            if (m_value_num == m_fragment_found_value_num[fragment_ix]) {
+                continue;
+            }
+            m_fragment_found_value_num[fragment_ix] = m_value_num;
+            for (auto wildcard_string_ix : m_fragment_wildcard_string_ixs[fragment_ix]) {
+                if (m_value_num != m_wildcard_string_value_num[wildcard_string_ix]) {
+                    m_wildcard_string_value_num[wildcard_string_ix] = m_value_num;
+                    m_wildcard_string_num_fragments_found[wildcard_string_ix] = 0;
+                }
+                ++m_wildcard_string_num_fragments_found[wildcard_string_ix];
+            }
+        }
+    }
+
+    // Only wildcard strings whose fragments were all found can match
+    for (size_t wildcard_string_ix = 0; wildcard_string_ix < m_wildcard_strings.size(); ++wildcard_string_ix) {
+        size_t num_fragments_found = 0;
+        if (m_value_num == m_wildcard_string_value_num[wildcard_string_ix]) {
+            num_fragments_found = m_wildcard_string_num_fragments_found[wildcard_string_ix];
+        }
+        if (num_fragments_found == m_wildcard_string_fragment_ixs[wildcard_string_ix].size() &&
+            wildcard_match_unsafe(value, m_wildcard_strings[wildcard_string_ix], false == m_ignore_case))
+        {
+            matching_wildcard_string_ixs.push_back(wildcard_string_ix);
+        }
+    }
+}
+
+size_t MultiWildcardMatcher::add_fragment (const string& fragment) {
+    uint32_t state = cRootState;
+    for (auto c : fragment) {
+        auto next_state = m_states[state].next_states[static_cast<unsigned char>(c)];
+        if (cRootState == next_state) {
+            next_state = m_states.size();
+            m_states.emplace_back();
+            m_states[next_state].next_states.fill(cRootState);
+            m_states[next_state].failure_state = cRootState;
+            m_states[state].next_states[static_cast<unsigned char>(c)] = next_state;
+        }
+        state = next_state;
+    }
+
+    // NOTE: Before the automaton is built, a state's fragments are only the one ending at it
+    auto& fragment_ixs = m_states[state].fragment_ixs;
+    if (fragment_ixs.empty()) {
+        fragment_ixs.push_back(m_fragment_wildcard_string_ixs.size());
+        m_fragment_wildcard_string_ixs.emplace_back();
+    }
+    return fragment_ixs.front();
+}
+
+void MultiWildcardMatcher::build_automaton () {
+    // Visit the states in breadth-first order so that a state's failure state is complete before the state itself is visited
+    std::queue<uint32_t> states_to_visit;
+    for (auto child_state : m_states[cRootState].next_states) {
+        if (cRootState != child_state) {
+            states_to_visit.push(child_state);
+        }
+    }
+    while (false == states_to_visit.empty()) {
+        auto state = states_to_visit.front();
+        states_to_visit.pop();
+
+        auto failure_state = m_states[state].failure_state;
+        for (size_t c = 0; c < m_states[state].next_states.size(); ++c) {
+            auto child_state = m_states[state].next_states[c];
+            auto failure_state_next_state = m_states[failure_state].next_states[c];
+            if (cRootState == child_state) {
+                // Follow the failure link instead
+                m_states[state].next_states[c] = failure_state_next_state;
+                continue;
+            }
+
+            auto& child = m_states[child_state];
+            child.failure_state = failure_state_next_state;
+            const auto& inherited_fragment_ixs = m_states[failure_state_next_state].fragment_ixs;
+            child.fragment_ixs.insert(child.fragment_ixs.end(), inherited_fragment_ixs.cbegin(), inherited_fragment_ixs.cend());
+            states_to_visit.push(child_state);
+        }
+    }
+}
+
+unsigned char MultiWildcardMatcher::fold_case (char c) const {
+    if (m_ignore_case) {
+        return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return static_cast<unsigned char>(c);
+}
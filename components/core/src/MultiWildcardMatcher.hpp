@@ -0,0 +1,79 @@
+#ifndef MULTIWILDCARDMATCHER_HPP
+#define MULTIWILDCARDMATCHER_HPP
+
+// C++ standard libraries
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Class to match a value against a set of wildcard strings at once. The literal fragments between the wildcards of every wildcard string are
+ * compiled into a single Aho-Corasick automaton, so one scan of a value finds which fragments it contains. Only the wildcard strings whose
+ * fragments were all found are then fully matched against the value.
+ */
+class MultiWildcardMatcher {
+public:
+    // Constructors
+    /**
+     * @param wildcard_strings Wildcard strings where '*' matches zero or more characters, '?' matches any single character, and '\' escapes
+     * the following character
+     * @param ignore_case
+     */
+    MultiWildcardMatcher (const std::vector<std::string>& wildcard_strings, bool ignore_case);
+
+    // Methods
+    /**
+     * Gets the wildcard strings that match the given value
+     * @param value
+     * @param matching_wildcard_string_ixs Returns the indices (in the order they were given to the constructor) of the matching wildcard
+     * strings
+     */
+    void get_matching_wildcard_strings (std::string_view value, std::vector<size_t>& matching_wildcard_string_ixs);
+
+private:
+    // Types
+    struct State {
+        std::array<uint32_t, 256> next_states;
+        uint32_t failure_state;
+        // Fragments which end at this state, including those which end at the states reachable through its failure links
+        std::vector<size_t> fragment_ixs;
+    };
+
+    // Methods
+    /**
+     * Adds the given fragment to the automaton's trie
+     * @param fragment
+     * @return The fragment's index
+     */
+    size_t add_fragment (const std::string& fragment);
+    /**
+     * Computes the failure links and transitions of the automaton once all fragments have been added
+     */
+    void build_automaton ();
+
+    /**
+     * @param c
+     * @return The character that the automaton expects in place of c
+     */
+    unsigned char fold_case (char c) const;
+
+    // Variables
+    std::vector<std::string> m_wildcard_strings;
+    bool m_ignore_case;
+
+    std::vector<State> m_states;
+    // The distinct fragments in each wildcard string
+    std::vector<std::vector<size_t>> m_wildcard_string_fragment_ixs;
+    // The wildcard strings which contain each fragment
+    std::vector<std::vector<size_t>> m_fragment_wildcard_string_ixs;
+
+    // Per-value scratch space, stamped with the number of the value being matched so that it doesn't need to be cleared between values
+    uint64_t m_value_num;
+    std::vector<uint64_t> m_fragment_found_value_num;
+    std::vector<uint64_t> m_wildcard_string_value_num;
+    std::vector<size_t> m_wildcard_string_num_fragments_found;
+};
+
+#endif // MULTIWILDCARDMATCHER_HPP
@@ -0,0 +1,300 @@
+#include "OnDiskValueToIdMap.hpp"
+
+// C standard libraries
+#include <unistd.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+// Project headers
+#include "FileWriter.hpp"
+
+using std::pair;
+using std::string;
+using std::string_view;
+using std::unique_ptr;
+using std::vector;
+
+// Constants
+// Each entry is stored as its hash, ID, and value length, followed by its value
+static constexpr size_t cEntryHeaderSize = sizeof(uint64_t) + sizeof(uint64_t) + sizeof(uint32_t);
+static constexpr size_t cNumEntriesPerBlock = 32;
+// Runs are merged once there are this many of a similar size (i.e., in the same tier)
+static constexpr size_t cNumRunsPerMerge = 4;
+static constexpr double cFilterFalsePositiveRate = 0.01;
+
+// Local prototypes
+/**
+ * @param num_entries
+ * @return The size tier of a run with the given number of entries, i.e., floor(log_{cNumRunsPerMerge}(num_entries))
+ */
+static size_t get_run_tier (size_t num_entries);
+
+static size_t get_run_tier (size_t num_entries) {
+    size_t tier = 0;
+    for (; num_entries >= cNumRunsPerMerge; num_entries /= cNumRunsPerMerge) {
+        ++tier;
+    }
+    return tier;
+}
+
+OnDiskValueToIdMap::~OnDiskValueToIdMap () {
+    // NOTE: We can't throw from the destructor, so failing to delete a run's file is ignored
+    for (const auto& run : m_runs) {
+        unlink(run->path.c_str());
+    }
+}
+
+void OnDiskValueToIdMap::open (const string& path_prefix) {
+    if (m_is_open) {
+        throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+    }
+
+    m_path_prefix = path_prefix;
+    m_next_run_number = 0;
+    m_num_entries = 0;
+
+    m_is_open = true;
+}
+
+void OnDiskValueToIdMap::close () {
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+
+    for (auto& run : m_runs) {
+        delete_run(*run);
+    }
+    m_runs.clear();
+    m_num_entries = 0;
+
+    m_is_open = false;
+}
+
+void OnDiskValueToIdMap::add_mappings (vector<pair<string_view, uint64_t>>& mappings) {
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+    if (mappings.empty()) {
+        return;
+    }
+
+    vector<pair<uint64_t, size_t>> hash_and_mapping_ixs;
+    hash_and_mapping_ixs.reserve(mappings.size());
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        hash_and_mapping_ixs.emplace_back(BloomFilter::hash(mappings[i].first), i);
+    }
+    std::sort(hash_and_mapping_ixs.begin(), hash_and_mapping_ixs.end(), [&mappings] (const auto& lhs, const auto& rhs) {
+        return std::tie(lhs.first, mappings[lhs.second].first) < std::tie(rhs.first, mappings[rhs.second].first);
+    });
+
+    size_t next_ix = 0;
+    auto run = write_run(mappings.size(), [&] (uint64_t& hash, uint64_t& id, string_view& value) {
+        if (next_ix == hash_and_mapping_ixs.size()) {
+            return false;
+        }
+        const auto& [entry_hash, mapping_ix] = hash_and_mapping_ixs[next_ix++];
+        hash = entry_hash;
+        value = mappings[mapping_ix].first;
+        id = mappings[mapping_ix].second;
+        return true;
+    });
+    m_num_entries += run->num_entries;
+    m_runs.push_back(std::move(run));
+
+    // Merge runs of a similar size rather than merging every run, so that each entry is only rewritten once per tier it moves up. Since a
+    // merged run is usually in a higher tier than the runs it was merged from, this may cascade.
+    vector<size_t> run_ixs_in_tier;
+    while (true) {
+        auto tier = get_run_tier(m_runs.back()->num_entries);
+        run_ixs_in_tier.clear();
+        for (size_t i = 0; i < m_runs.size(); ++i) {
+            if (get_run_tier(m_runs[i]->num_entries) == tier) {
+                run_ixs_in_tier.push_back(i);
+            }
+        }
+        if (run_ixs_in_tier.size() < cNumRunsPerMerge) {
+            break;
+        }
+        merge_runs(run_ixs_in_tier);
+    }
+}
+
+bool OnDiskValueToIdMap::find (string_view value, uint64_t& id) const {
+    if (empty()) {
+        return false;
+    }
+
+    const auto hash = BloomFilter::hash(value);
+    vector<char> block;
+    // Search from newest to oldest since recently spilled values are more likely to be looked up again
+    for (auto run_it = m_runs.crbegin(); m_runs.crend() != run_it; ++run_it) {
+        const auto& run = **run_it;
+        if (false == run.filter.possibly_contains(hash)) {
+            continue;
+        }
+
+        // Entries with the given hash may start in the block before the first block whose first hash isn't less than the given hash
+        const auto& block_first_hashes = run.block_first_hashes;
+        size_t block_ix = std::lower_bound(block_first_hashes.cbegin(), block_first_hashes.cend(), hash) - block_first_hashes.cbegin();
+        if (block_ix > 0) {
+            --block_ix;
+        }
+        bool passed_hash = false;
+        for (; false == passed_hash && block_ix < block_first_hashes.size() && block_first_hashes[block_ix] <= hash; ++block_ix) {
+            const auto block_begin_pos = run.block_offsets[block_ix];
+            block.resize(run.block_offsets[block_ix + 1] - block_begin_pos);
+            auto error_code = run.reader.try_read_exact_length_at(block_begin_pos, block.data(), block.size());
+            if (ErrorCode_Success != error_code) {
+                throw OperationFailed(error_code, __FILENAME__, __LINE__);
+            }
+
+            for (size_t pos = 0; pos < block.size();) {
+                uint64_t entry_hash;
+                uint64_t entry_id;
+                uint32_t entry_value_length;
+                memcpy(&entry_hash, block.data() + pos, sizeof(entry_hash));
+                memcpy(&entry_id, block.data() + pos + sizeof(entry_hash), sizeof(entry_id));
+                memcpy(&entry_value_length, block.data() + pos + sizeof(entry_hash) + sizeof(entry_id), sizeof(entry_value_length));
+                pos += cEntryHeaderSize;
+                if (entry_hash > hash) {
+                    passed_hash = true;
+                    break;
+                }
+                if (entry_hash == hash && string_view(block.data() + pos, entry_value_length) == value) {
+                    id = entry_id;
+                    return true;
+                }
+                pos += entry_value_length;
+            }
+        }
+    }
+    return false;
+}
+
+size_t OnDiskValueToIdMap::get_in_memory_size () const {
+    size_t size = 0;
+    for (const auto& run : m_runs) {
+        size += sizeof(Run) + run->path.capacity() + run->filter.get_size_in_bytes() + run->block_first_hashes.capacity() * sizeof(uint64_t) +
+                run->block_offsets.capacity() * sizeof(size_t);
+    }
+    return size;
+}
+
+template <typename EntryGenerator>
+unique_ptr<OnDiskValueToIdMap::Run> OnDiskValueToIdMap::write_run (size_t num_entries, EntryGenerator entry_generator) {
+    auto run = std::make_unique<Run>();
+    run->path = m_path_prefix + '.' + std::to_string(m_next_run_number++);
+    run->num_entries = 0;
+    run->filter = BloomFilter(num_entries, cFilterFalsePositiveRate);
+
+    FileWriter writer;
+    writer.open(run->path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+    uint64_t hash;
+    uint64_t id;
+    string_view value;
+    while (entry_generator(hash, id, value)) {
+        if (run->num_entries % cNumEntriesPerBlock == 0) {
+            run->block_first_hashes.push_back(hash);
+            run->block_offsets.push_back(writer.get_pos());
+        }
+        writer.write_numeric_value(hash);
+        writer.write_numeric_value(id);
+        writer.write_numeric_value<uint32_t>(value.length());
+        writer.write(value.data(), value.length());
+
+        run->filter.add(hash);
+        ++run->num_entries;
+    }
+    run->block_offsets.push_back(writer.get_pos());
+    writer.close();
+
+    run->block_first_hashes.shrink_to_fit();
+    run->block_offsets.shrink_to_fit();
+    run->reader.open(run->path);
+
+    return run;
+}
+
+void OnDiskValueToIdMap::merge_runs (const vector<size_t>& run_ixs) {
+    // Read every run sequentially, always emitting the smallest (hash, value) among the runs' current entries
+    struct RunCursor {
+        FileReader* reader;
+        size_t num_remaining_entries;
+        uint64_t hash;
+        uint64_t id;
+        string value;
+
+        bool advance () {
+            if (0 == num_remaining_entries) {
+                return false;
+            }
+            --num_remaining_entries;
+
+            uint32_t value_length;
+            reader->read_numeric_value(hash, false);
+            reader->read_numeric_value(id, false);
+            reader->read_numeric_value(value_length, false);
+            auto error_code = reader->try_read_string(value_length, value);
+            if (ErrorCode_Success != error_code) {
+                throw OperationFailed(error_code, __FILENAME__, __LINE__);
+            }
+            return true;
+        }
+    };
+
+    vector<RunCursor> cursors;
+    size_t num_entries = 0;
+    for (auto run_ix : run_ixs) {
+        auto& run = m_runs[run_ix];
+        num_entries += run->num_entries;
+        run->reader.seek_from_begin(0);
+        RunCursor cursor{&run->reader, run->num_entries, 0, 0, {}};
+        if (cursor.advance()) {
+            cursors.push_back(std::move(cursor));
+        }
+    }
+
+    string merged_value;
+    auto merged_run = write_run(num_entries, [&] (uint64_t& hash, uint64_t& id, string_view& value) {
+        if (cursors.empty()) {
+            return false;
+        }
+
+        auto min_it = std::min_element(cursors.begin(), cursors.end(), [] (const RunCursor& lhs, const RunCursor& rhs) {
+            return std::tie(lhs.hash, lhs.value) < std::tie(rhs.hash, rhs.value);
+        });
+        hash = min_it->hash;
+        id = min_it->id;
+        merged_value = min_it->value;
+        value = merged_value;
+
+        // Advance every cursor at this entry, so that duplicates of it are dropped
+        for (size_t i = 0; i < cursors.size();) {
+            if (cursors[i].hash == hash && cursors[i].value == merged_value && false == cursors[i].advance()) {
+                cursors.erase(cursors.begin() + i);
+            } else {
+                ++i;
+            }
+        }
+        return true;
+    });
+
+    // Delete the merged runs, keeping the order of the others
+    for (auto run_ix : run_ixs) {
+        delete_run(*m_runs[run_ix]);
+        m_runs[run_ix].reset();
+    }
+    m_runs.erase(std::remove(m_runs.begin(), m_runs.end(), nullptr), m_runs.end());
+    m_num_entries = m_num_entries - num_entries + merged_run->num_entries;
+    m_runs.push_back(std::move(merged_run));
+}
+
+void OnDiskValueToIdMap::delete_run (Run& run) {
+    run.reader.close();
+    if (0 != unlink(run.path.c_str())) {
+        throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+    }
+}
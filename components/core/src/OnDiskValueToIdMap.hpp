@@ -0,0 +1,130 @@
+#ifndef ONDISKVALUETOIDMAP_HPP
+#define ONDISKVALUETOIDMAP_HPP
+
+// C++ standard libraries
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Project headers
+#include "BloomFilter.hpp"
+#include "FileReader.hpp"
+#include "TraceableException.hpp"
+
+/**
+ * A map from string values to IDs that's stored on disk, for dictionaries whose value-to-ID mappings don't fit within the compressor's memory
+ * budget. Mappings are added in batches, each of which is written as an immutable run of entries sorted by (hash, value). Only a Bloom filter and
+ * a sparse index (the first hash and offset of each block of entries) of each run are kept in memory, so a lookup reads at most a few blocks from
+ * each run whose filter doesn't rule out the value. To bound the number of runs a lookup has to check, runs of a similar size are merged once
+ * there are several of them. So a map with N entries has O(log N) runs, and each entry is rewritten O(log N) times.
+ *
+ * The runs are temporary files named `<path prefix>.<run number>` which are deleted when the map is closed.
+ */
+class OnDiskValueToIdMap {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException (error_code, filename, line_number) {}
+
+        // Methods
+        const char* what () const noexcept override {
+            return "OnDiskValueToIdMap operation failed";
+        }
+    };
+
+    // Constructors
+    OnDiskValueToIdMap () : m_is_open(false), m_next_run_number(0), m_num_entries(0) {}
+
+    ~OnDiskValueToIdMap ();
+
+    // Delete copy constructor and assignment operator
+    OnDiskValueToIdMap (const OnDiskValueToIdMap&) = delete;
+    OnDiskValueToIdMap& operator= (const OnDiskValueToIdMap&) = delete;
+
+    // Methods
+    /**
+     * Opens an empty map
+     * @param path_prefix Prefix of the paths of the map's run files
+     */
+    void open (const std::string& path_prefix);
+    /**
+     * Closes the map and deletes its run files
+     */
+    void close ();
+
+    /**
+     * Adds the given mappings to the map as a new run. The values must not already be in the map with a different ID.
+     * @param mappings The mappings, which are reordered by this method
+     * @throw OnDiskValueToIdMap::OperationFailed if the map isn't open or the run couldn't be written
+     */
+    void add_mappings (std::vector<std::pair<std::string_view, uint64_t>>& mappings);
+
+    /**
+     * Finds the ID of the given value
+     * @param value
+     * @param id Returns the ID if found
+     * @return true if the value is in the map, false otherwise
+     * @throw OnDiskValueToIdMap::OperationFailed if a run couldn't be read
+     */
+    bool find (std::string_view value, uint64_t& id) const;
+
+    bool empty () const { return 0 == m_num_entries; }
+    size_t get_num_runs () const { return m_runs.size(); }
+    /**
+     * @return The approximate number of bytes of memory used by the map (i.e., its runs' filters and indexes)
+     */
+    size_t get_in_memory_size () const;
+
+private:
+    // Types
+    struct Run {
+        std::string path;
+        // NOTE: Mutable since lookups only read at fixed positions (which doesn't change the reader's state)
+        mutable FileReader reader;
+        size_t num_entries;
+        BloomFilter filter;
+        // The hash of the first entry in each block, and the offset of each block (plus the size of the file)
+        std::vector<uint64_t> block_first_hashes;
+        std::vector<size_t> block_offsets;
+    };
+
+    // Methods
+    /**
+     * Writes the given sorted entries to a new run
+     * @tparam EntryGenerator Callable which returns false once there are no more entries, or true after setting its three arguments to the
+     * next entry's hash, ID, and value.
+     * @param num_entries An upper bound on the number of entries, used to size the run's filter
+     * @param entry_generator
+     * @return The run
+     */
+    template <typename EntryGenerator>
+    std::unique_ptr<Run> write_run (size_t num_entries, EntryGenerator entry_generator);
+
+    /**
+     * Merges the given runs into a single new run, dropping duplicate entries
+     * @param run_ixs Indices of the runs to merge, in ascending order
+     */
+    void merge_runs (const std::vector<size_t>& run_ixs);
+
+    /**
+     * Closes and deletes the given run's file
+     * @param run
+     */
+    static void delete_run (Run& run);
+
+    // Variables
+    bool m_is_open;
+    std::string m_path_prefix;
+    size_t m_next_run_number;
+    // Number of entries in all runs, including duplicates
+    size_t m_num_entries;
+    // Runs in the order they were written, where a merged run is written after all the runs it was merged from
+    std::vector<std::unique_ptr<Run>> m_runs;
+};
+
+#endif // ONDISKVALUETOIDMAP_HPP
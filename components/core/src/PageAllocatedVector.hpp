@@ -7,6 +7,7 @@
 #include <sys/mman.h>
 
 // C++ standard libraries
+#include <algorithm>
 #include <cstring>
 #include <vector>
 
@@ -44,9 +45,10 @@ public:
     // Constructors
     /**
      * Constructor
+     * @param use_huge_pages Whether to advise the kernel to back the vector with transparent huge pages
      * @throw PageAllocatedVector::OperationFailed if could not determine page size or if type of value does not fit within a page
      */
-    PageAllocatedVector ();
+    explicit PageAllocatedVector (bool use_huge_pages = false);
 
     // Destructor
     ~PageAllocatedVector ();
@@ -74,6 +76,14 @@ public:
      * Clears the vector
      */
     void clear () noexcept;
+    /**
+     * Empties the vector without unmapping its memory, so that it can be refilled without remapping it or faulting its pages in again. Any
+     * resident pages beyond the first max_num_resident_bytes are returned to the kernel to bound the memory held by an empty vector.
+     * @param max_num_resident_bytes
+     * @return The number of pages used since the vector was last emptied that were already resident, i.e., the page faults avoided
+     * @throw PageAllocatedVector::OperationFailed if the pages couldn't be returned to the kernel
+     */
+    size_t recycle (size_t max_num_resident_bytes);
 
     /**
      * Gets underlying array
@@ -101,6 +111,11 @@ public:
      * @return Vector's size in bytes
      */
     size_t size_in_bytes () const noexcept;
+    /**
+     * Gets the number of bytes of the vector's memory that were resident when it was last recycled
+     * @return The number of resident bytes
+     */
+    size_t get_num_resident_bytes () const noexcept;
 
 private:
     // Methods
@@ -114,6 +129,12 @@ private:
      * Unmaps the existing region
      */
     static void unmap_region (void* region, size_t region_size);
+    /**
+     * Advises the kernel to back the given region with transparent huge pages, if supported
+     * @param region
+     * @param region_size
+     */
+    static void advise_huge_pages (void* region, size_t region_size);
 
     /**
      * Increases the vector's capacity to the given value
@@ -124,9 +145,13 @@ private:
 
     // Variables
     long m_page_size;
+    bool m_use_huge_pages;
 
     ValueType* m_values;
 
+    // The number of bytes at the start of the vector's region that have been faulted in
+    size_t m_num_resident_bytes;
+
     // The capacity of the vector in bytes
     size_t m_capacity_in_bytes;
     // The number of values the vector can contain without reallocation
@@ -136,7 +161,9 @@ private:
 };
 
 template <typename ValueType>
-PageAllocatedVector<ValueType>::PageAllocatedVector () : m_values(nullptr), m_capacity_in_bytes(0), m_capacity(0), m_size(0) {
+PageAllocatedVector<ValueType>::PageAllocatedVector (bool use_huge_pages) :
+        m_use_huge_pages(use_huge_pages), m_values(nullptr), m_num_resident_bytes(0), m_capacity_in_bytes(0), m_capacity(0), m_size(0)
+{
     m_page_size = sysconf(_SC_PAGESIZE);
     if (-1 == m_page_size) {
         throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
@@ -184,11 +211,33 @@ void PageAllocatedVector<ValueType>::push_back (ValueType& value) {
 template <typename ValueType>
 void PageAllocatedVector<ValueType>::clear () noexcept {
     unmap_region(m_values, m_capacity_in_bytes);
+    m_values = nullptr;
+    m_num_resident_bytes = 0;
     m_capacity_in_bytes = 0;
     m_capacity = 0;
     m_size = 0;
 }
 
+template <typename ValueType>
+size_t PageAllocatedVector<ValueType>::recycle (size_t max_num_resident_bytes) {
+    size_t num_used_bytes = ROUND_UP_TO_MULTIPLE(size_in_bytes(), m_page_size);
+    size_t num_reused_bytes = std::min(num_used_bytes, m_num_resident_bytes);
+    m_num_resident_bytes = std::max(m_num_resident_bytes, num_used_bytes);
+
+    max_num_resident_bytes = ROUND_UP_TO_MULTIPLE(max_num_resident_bytes, m_page_size);
+    if (m_num_resident_bytes > max_num_resident_bytes) {
+        // The mapping stays valid; the released pages are faulted in as zeroed pages if they're used again
+        char* first_released_page = reinterpret_cast<char*>(m_values) + max_num_resident_bytes;
+        if (0 != madvise(first_released_page, m_num_resident_bytes - max_num_resident_bytes, MADV_DONTNEED)) {
+            throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+        }
+        m_num_resident_bytes = max_num_resident_bytes;
+    }
+    m_size = 0;
+
+    return num_reused_bytes / m_page_size;
+}
+
 template <typename ValueType>
 const ValueType* PageAllocatedVector<ValueType>::data () const noexcept {
     return m_values;
@@ -214,6 +263,11 @@ size_t PageAllocatedVector<ValueType>::size_in_bytes () const noexcept {
     return m_size*sizeof(ValueType);
 }
 
+template <typename ValueType>
+size_t PageAllocatedVector<ValueType>::get_num_resident_bytes () const noexcept {
+    return m_num_resident_bytes;
+}
+
 template <typename ValueType>
 void* PageAllocatedVector<ValueType>::map_new_region (size_t new_size) {
     // NOTE: Regions with the MAP_SHARED flag cannot be remapped for some reason
@@ -237,6 +291,14 @@ void PageAllocatedVector<ValueType>::unmap_region (void* region, size_t region_s
     }
 }
 
+template <typename ValueType>
+void PageAllocatedVector<ValueType>::advise_huge_pages (void* region, size_t region_size) {
+#ifdef MADV_HUGEPAGE
+    // NOTE: This is only advice, so failures (e.g., from kernels without transparent huge page support) are ignored
+    madvise(region, region_size, MADV_HUGEPAGE);
+#endif
+}
+
 /*
  * To lower the number of calls necessary to increase the vector's capacity, we use a heuristic to grow to max(2*m_capacity, required_capacity)
  */
@@ -271,6 +333,9 @@ void PageAllocatedVector<ValueType>::increase_capacity (size_t required_capacity
             }
         }
     }
+    if (m_use_huge_pages) {
+        advise_huge_pages(new_region, new_size);
+    }
     m_values = static_cast<ValueType*>(new_region);
     m_capacity_in_bytes = new_size;
     m_capacity = m_capacity_in_bytes / sizeof(ValueType);
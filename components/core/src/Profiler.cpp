@@ -3,8 +3,75 @@
 // C++ standard libraries
 #include <memory>
 
+// json
+#include <json/single_include/nlohmann/json.hpp>
+
+// Project headers
+#include "FileWriter.hpp"
+#include "spdlog_with_specializations.hpp"
+
+using std::lock_guard;
+using std::mutex;
+using std::string;
 using std::unique_ptr;
 using std::vector;
 
-vector<Stopwatch>* Profiler::m_fragmented_measurements = nullptr;
 vector<Stopwatch>* Profiler::m_continuous_measurements = nullptr;
+mutex Profiler::m_thread_measurements_mutex;
+vector<unique_ptr<Profiler::ThreadMeasurements>>* Profiler::m_thread_measurements = new vector<unique_ptr<Profiler::ThreadMeasurements>>();
+
+void Profiler::write_report (const string& path) {
+    nlohmann::json report = nlohmann::json::object();
+    if constexpr (PROF_ENABLED) {
+        auto& continuous_measurements = report["continuous_measurements"] = nlohmann::json::object();
+        for (size_t i = 0; i < cContinuousMeasurementNames.size(); ++i) {
+            if (cContinuousMeasurementEnabled[i]) {
+                continuous_measurements[cContinuousMeasurementNames[i]] = (*m_continuous_measurements)[i].get_time_taken_in_seconds();
+            }
+        }
+        auto& fragmented_measurements = report["fragmented_measurements"] = nlohmann::json::object();
+        for (size_t i = 0; i < cFragmentedMeasurementNames.size(); ++i) {
+            if (cFragmentedMeasurementEnabled[i]) {
+                fragmented_measurements[cFragmentedMeasurementNames[i]] = get_fragmented_measurement_in_seconds(i);
+            }
+        }
+        auto& counters = report["counters"] = nlohmann::json::object();
+        for (size_t i = 0; i < cCounterNames.size(); ++i) {
+            if (cCounterEnabled[i]) {
+                counters[cCounterNames[i]] = get_counter(i);
+            }
+        }
+    } else {
+        SPDLOG_WARN("Profiling wasn't compiled in (configure with -DCLP_ENABLE_PROFILING=ON), so the profiling report will be empty.");
+    }
+
+    FileWriter file_writer;
+    file_writer.open(path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+    file_writer.write_string(report.dump(4));
+    file_writer.write_char('\n');
+    file_writer.close();
+}
+
+Profiler::ThreadMeasurements* Profiler::add_thread_measurements () {
+    lock_guard<mutex> lock(m_thread_measurements_mutex);
+    m_thread_measurements->emplace_back(std::make_unique<ThreadMeasurements>());
+    return m_thread_measurements->back().get();
+}
+
+double Profiler::get_fragmented_measurement_in_seconds (size_t index) {
+    lock_guard<mutex> lock(m_thread_measurements_mutex);
+    double time_taken_in_seconds = 0;
+    for (auto& thread_measurements : *m_thread_measurements) {
+        time_taken_in_seconds += thread_measurements->fragmented_measurements[index].get_time_taken_in_seconds();
+    }
+    return time_taken_in_seconds;
+}
+
+size_t Profiler::get_counter (size_t index) {
+    lock_guard<mutex> lock(m_thread_measurements_mutex);
+    size_t total = 0;
+    for (auto& thread_measurements : *m_thread_measurements) {
+        total += thread_measurements->counters[index];
+    }
+    return total;
+}
@@ -3,6 +3,9 @@
 
 // C++ libraries
 #include <array>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 // Project headers
@@ -10,7 +13,7 @@
 #include "type_utils.hpp"
 
 /**
- * Class to time code.
+ * Class to time code and count events.
  *
  * There are two types of measurements:
  * - Continuous measurements where a user needs to time a single, continuous
@@ -30,6 +33,18 @@
  * To log a measurement, use LOG_CONTINUOUS_MEASUREMENT or
  * LOG_FRAGMENTED_MEASUREMENT, passing in the relevant measurement index enum.
  *
+ * Counters (e.g., of avoided page faults) work the same way, using the
+ * CounterIndex enum, cCounterEnabled, and LOG_COUNTER. Each measurement and
+ * counter also needs a name in the corresponding c*Names array, which is used
+ * when the measurements are written to a report with write_report.
+ *
+ * Continuous measurements should only be used from the main thread.
+ * Fragmented measurements and counters may be used from any thread: each
+ * thread updates its own copy, and the copies are summed when a measurement
+ * is read. The time of a fragmented measurement is therefore the total time
+ * spent in the operation across all threads. Fragmented measurements may be
+ * nested (e.g., TimestampParsing happens during MessageParsing).
+ *
  * Two implementation details allow this class to avoid inducing overhead
  * when profiling is disabled:
  * - All methods bodies are defined in the header, guarded by
@@ -53,6 +68,26 @@ public:
         Length
     };
     enum class FragmentedMeasurementIndex : size_t {
+        QueryPlanning = 0,
+        MessageParsing,
+        TimestampParsing,
+        VariableEncoding,
+        DictionaryInsertion,
+        SegmentCompression,
+        MetadataPersistence,
+        SegmentDecompression,
+        DictionaryMatching,
+        MessageDecoding,
+        Length
+    };
+    enum class CounterIndex : size_t {
+        ColumnBufferPageFaultsAvoided = 0,
+        EncodedMessages,
+        CompressedSegments,
+        DictionarySpills,
+        DecodedMessages,
+        DecompressedSegments,
+        ArchivesSkippedByFilter,
         Length
     };
 
@@ -67,19 +102,67 @@ public:
     }();
     static constexpr auto cFragmentedMeasurementEnabled = []() {
         std::array<bool, enum_to_underlying_type(FragmentedMeasurementIndex::Length)> enabled{};
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::QueryPlanning)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::MessageParsing)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::TimestampParsing)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::VariableEncoding)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::DictionaryInsertion)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::SegmentCompression)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::MetadataPersistence)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::SegmentDecompression)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::DictionaryMatching)] = true;
+        enabled[enum_to_underlying_type(FragmentedMeasurementIndex::MessageDecoding)] = true;
+        return enabled;
+    }();
+    static constexpr auto cCounterEnabled = []() {
+        std::array<bool, enum_to_underlying_type(CounterIndex::Length)> enabled{};
+        enabled[enum_to_underlying_type(CounterIndex::ColumnBufferPageFaultsAvoided)] = true;
+        enabled[enum_to_underlying_type(CounterIndex::EncodedMessages)] = true;
+        enabled[enum_to_underlying_type(CounterIndex::CompressedSegments)] = true;
+        enabled[enum_to_underlying_type(CounterIndex::DictionarySpills)] = true;
+        enabled[enum_to_underlying_type(CounterIndex::DecodedMessages)] = true;
+        enabled[enum_to_underlying_type(CounterIndex::DecompressedSegments)] = true;
+        enabled[enum_to_underlying_type(CounterIndex::ArchivesSkippedByFilter)] = true;
         return enabled;
     }();
 
+    static constexpr std::array<const char*, enum_to_underlying_type(ContinuousMeasurementIndex::Length)> cContinuousMeasurementNames = {
+        "Compression",
+        "ParseLogFile",
+        "Search",
+    };
+    static constexpr std::array<const char*, enum_to_underlying_type(FragmentedMeasurementIndex::Length)> cFragmentedMeasurementNames = {
+        "QueryPlanning",
+        "MessageParsing",
+        "TimestampParsing",
+        "VariableEncoding",
+        "DictionaryInsertion",
+        "SegmentCompression",
+        "MetadataPersistence",
+        "SegmentDecompression",
+        "DictionaryMatching",
+        "MessageDecoding",
+    };
+    static constexpr std::array<const char*, enum_to_underlying_type(CounterIndex::Length)> cCounterNames = {
+        "ColumnBufferPageFaultsAvoided",
+        "EncodedMessages",
+        "CompressedSegments",
+        "DictionarySpills",
+        "DecodedMessages",
+        "DecompressedSegments",
+        "ArchivesSkippedByFilter",
+    };
+
     // Methods
     /**
-     * Static initializer for class. This must be called before using the class.
+     * Static initializer for class. This must be called before using continuous measurements; calling it more than once has no effect.
      */
     static void init () {
         if constexpr (PROF_ENABLED) {
-            m_continuous_measurements = new std::vector<Stopwatch>(
-                    enum_to_underlying_type(ContinuousMeasurementIndex::Length));
-            m_fragmented_measurements = new std::vector<Stopwatch>(
-                    enum_to_underlying_type(FragmentedMeasurementIndex::Length));
+            if (nullptr == m_continuous_measurements) {
+                m_continuous_measurements = new std::vector<Stopwatch>(
+                        enum_to_underlying_type(ContinuousMeasurementIndex::Length));
+            }
         }
     }
 
@@ -115,7 +198,7 @@ public:
     static void start_fragmented_measurement () {
         if constexpr (PROF_ENABLED && cFragmentedMeasurementEnabled[enum_to_underlying_type(index)])
         {
-            (*m_fragmented_measurements)[enum_to_underlying_type(index)].start();
+            get_thread_measurements().fragmented_measurements[enum_to_underlying_type(index)].start();
         }
     }
 
@@ -123,31 +206,98 @@ public:
     static void stop_fragmented_measurement () {
         if constexpr (PROF_ENABLED && cFragmentedMeasurementEnabled[enum_to_underlying_type(index)])
         {
-            (*m_fragmented_measurements)[enum_to_underlying_type(index)].stop();
+            get_thread_measurements().fragmented_measurements[enum_to_underlying_type(index)].stop();
         }
     }
 
+    /**
+     * Resets the given measurement in every thread. This should only be called while no other thread is using the measurement.
+     */
     template<FragmentedMeasurementIndex index>
     static void reset_fragmented_measurement () {
         if constexpr (PROF_ENABLED && cFragmentedMeasurementEnabled[enum_to_underlying_type(index)])
         {
-            (*m_fragmented_measurements)[enum_to_underlying_type(index)].reset();
+            std::lock_guard<std::mutex> lock(m_thread_measurements_mutex);
+            for (auto& thread_measurements : *m_thread_measurements) {
+                thread_measurements->fragmented_measurements[enum_to_underlying_type(index)].reset();
+            }
         }
     }
 
+    /**
+     * @return The total time of the given measurement across all threads. This should only be called while no other thread is using the
+     * measurement.
+     */
     template<FragmentedMeasurementIndex index>
     static double get_fragmented_measurement_in_seconds () {
         if constexpr (PROF_ENABLED) {
-            return (*m_fragmented_measurements)[enum_to_underlying_type(index)]
-                    .get_time_taken_in_seconds();
+            return get_fragmented_measurement_in_seconds(enum_to_underlying_type(index));
+        } else {
+            return 0;
+        }
+    }
+
+    template<CounterIndex index>
+    static void increment_counter (size_t value) {
+        if constexpr (PROF_ENABLED && cCounterEnabled[enum_to_underlying_type(index)]) {
+            get_thread_measurements().counters[enum_to_underlying_type(index)] += value;
+        }
+    }
+
+    /**
+     * @return The total of the given counter across all threads. This should only be called while no other thread is using the counter.
+     */
+    template<CounterIndex index>
+    static size_t get_counter () {
+        if constexpr (PROF_ENABLED) {
+            return get_counter(enum_to_underlying_type(index));
         } else {
             return 0;
         }
     }
 
+    /**
+     * Writes every enabled measurement and counter to the given path as a JSON object of the form
+     * {"continuous_measurements": {NAME: SECONDS, ...}, "fragmented_measurements": {NAME: SECONDS, ...}, "counters": {NAME: VALUE, ...}}.
+     * If profiling is disabled, the object is empty. This should only be called once all other threads are done being profiled.
+     * @param path
+     * @throw FileWriter::OperationFailed if the report couldn't be written
+     */
+    static void write_report (const std::string& path);
+
 private:
-    static std::vector<Stopwatch>* m_fragmented_measurements;
+    // Types
+    /**
+     * The measurements made by a single thread
+     */
+    struct ThreadMeasurements {
+        std::array<Stopwatch, enum_to_underlying_type(FragmentedMeasurementIndex::Length)> fragmented_measurements;
+        std::array<size_t, enum_to_underlying_type(CounterIndex::Length)> counters{};
+    };
+
+    // Methods
+    /**
+     * @return The calling thread's measurements
+     */
+    static ThreadMeasurements& get_thread_measurements () {
+        thread_local ThreadMeasurements* thread_measurements = add_thread_measurements();
+        return *thread_measurements;
+    }
+    /**
+     * Adds measurements for a new thread
+     * @return The new measurements
+     */
+    static ThreadMeasurements* add_thread_measurements ();
+
+    static double get_fragmented_measurement_in_seconds (size_t index);
+    static size_t get_counter (size_t index);
+
+    // Variables
     static std::vector<Stopwatch>* m_continuous_measurements;
+    // NOTE: Measurements are owned here rather than by each thread so that they outlive threads which exit before they're read. The list is
+    // allocated during static initialization (and never freed), so threads can add their measurements without the class being initialized.
+    static std::mutex m_thread_measurements_mutex;
+    static std::vector<std::unique_ptr<ThreadMeasurements>>* m_thread_measurements;
 };
 
 // Macros to log the measurements
@@ -163,6 +313,10 @@ private:
         SPDLOG_INFO("{} took {} s", #x, \
                     Profiler::get_fragmented_measurement_in_seconds<x>()); \
     }
+#define LOG_COUNTER(x) \
+    if (PROF_ENABLED && Profiler::cCounterEnabled[enum_to_underlying_type(x)]) { \
+        SPDLOG_INFO("{} = {}", #x, Profiler::get_counter<x>()); \
+    }
 #define PROFILER_SPDLOG_INFO(...) \
     if (PROF_ENABLED) { \
         SPDLOG_INFO(__VA_ARGS__); \
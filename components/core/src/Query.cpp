@@ -6,22 +6,23 @@ using std::unordered_set;
 
 // Local function prototypes
 /**
- * Performs a set intersection of a & b, storing the result in b
- * @tparam SetType
- * @param a
- * @param b
+ * Sets the bits of the given segment IDs in the given bitmap, growing it if necessary
+ * @param segment_ids
+ * @param bitmap
  */
-template<typename SetType>
-static void inplace_set_intersection (const SetType& a, SetType& b);
-
-template<typename SetType>
-static void inplace_set_intersection (const SetType& a, SetType& b) {
-    for (auto ix = b.cbegin(); ix != b.cend();) {
-        if (a.count(*ix) == 0) {
-            ix = b.erase(ix);
-        } else {
-            ++ix;
-        }
+static void add_segment_ids_to_bitmap (const set<segment_id_t>& segment_ids, Bitmap& bitmap);
+
+static void add_segment_ids_to_bitmap (const set<segment_id_t>& segment_ids, Bitmap& bitmap) {
+    if (segment_ids.empty()) {
+        return;
+    }
+    // The set is ordered, so the bitmap only needs to be grown once
+    auto max_segment_id = *segment_ids.crbegin();
+    if (max_segment_id >= bitmap.size()) {
+        bitmap.resize(max_segment_id + 1);
+    }
+    for (auto segment_id : segment_ids) {
+        bitmap.set(segment_id);
     }
 }
 
@@ -58,23 +59,21 @@ bool QueryVar::matches (encoded_variable_t var) const {
     return (m_is_precise_var && m_precise_var == var) || (!m_is_precise_var && m_possible_dict_vars.count(var) > 0);
 }
 
-void QueryVar::remove_segments_that_dont_contain_dict_var (set<segment_id_t>& segment_ids) const {
+void QueryVar::remove_segments_that_dont_contain_dict_var (Bitmap& segment_ids) const {
     if (false == m_is_dict_var) {
         // Not a dictionary variable, so do nothing
         return;
     }
 
+    Bitmap ids_of_segments_containing_query_var;
     if (m_is_precise_var) {
-        auto& ids_of_segments_containing_query_var = m_var_dict_entry->get_ids_of_segments_containing_entry();
-        inplace_set_intersection(ids_of_segments_containing_query_var, segment_ids);
+        add_segment_ids_to_bitmap(m_var_dict_entry->get_ids_of_segments_containing_entry(), ids_of_segments_containing_query_var);
     } else {
-        set<segment_id_t> ids_of_segments_containing_query_var;
         for (auto entry : m_possible_var_dict_entries) {
-            auto& ids_of_segments_containing_var = entry->get_ids_of_segments_containing_entry();
-            ids_of_segments_containing_query_var.insert(ids_of_segments_containing_var.cbegin(), ids_of_segments_containing_var.cend());
+            add_segment_ids_to_bitmap(entry->get_ids_of_segments_containing_entry(), ids_of_segments_containing_query_var);
         }
-        inplace_set_intersection(ids_of_segments_containing_query_var, segment_ids);
     }
+    segment_ids &= ids_of_segments_containing_query_var;
 }
 
 void SubQuery::add_non_dict_var (encoded_variable_t precise_non_dict_var) {
@@ -92,7 +91,7 @@ void SubQuery::add_imprecise_dict_var (const unordered_set<encoded_variable_t>&
 }
 
 void SubQuery::set_possible_logtypes (const unordered_set<const LogTypeDictionaryEntry*>& logtype_entries) {
-    m_possible_logtype_ids.clear();
+    m_possible_logtype_ids.resize_and_clear(0);
     for (auto entry : logtype_entries) {
         m_possible_logtype_ids.insert(entry->get_id());
     }
@@ -105,10 +104,9 @@ void SubQuery::mark_wildcard_match_required () {
 
 void SubQuery::calculate_ids_of_matching_segments () {
     // Get IDs of segments containing logtypes
-    m_ids_of_matching_segments.clear();
+    m_ids_of_matching_segments.resize_and_clear(0);
     for (auto entry : m_possible_logtype_entries) {
-        auto& ids_of_segments_containing_logtype = entry->get_ids_of_segments_containing_entry();
-        m_ids_of_matching_segments.insert(ids_of_segments_containing_logtype.cbegin(), ids_of_segments_containing_logtype.cend());
+        add_segment_ids_to_bitmap(entry->get_ids_of_segments_containing_entry(), m_ids_of_matching_segments);
     }
 
     // Intersect with IDs of segments containing variables
@@ -119,12 +117,12 @@ void SubQuery::calculate_ids_of_matching_segments () {
 
 void SubQuery::clear () {
     m_vars.clear();
-    m_possible_logtype_ids.clear();
+    m_possible_logtype_ids.resize_and_clear(0);
     m_wildcard_match_required = false;
 }
 
 bool SubQuery::matches_logtype (const logtype_dictionary_id_t logtype) const {
-    return m_possible_logtype_ids.count(logtype) > 0;
+    return m_possible_logtype_ids.contains(logtype);
 }
 
 bool SubQuery::matches_vars (const std::vector<encoded_variable_t>& vars) const {
@@ -152,16 +150,22 @@ bool SubQuery::matches_vars (const std::vector<encoded_variable_t>& vars) const
     return (num_possible_vars == possible_vars_ix);
 }
 
+void Query::set_ignore_case (bool ignore_case) {
+    m_ignore_case = ignore_case;
+    m_message_filter = EncodedMessageFilter(m_search_string, m_ignore_case);
+}
+
 void Query::set_search_string (const string& search_string) {
     m_search_string = search_string;
     m_search_string_matches_all = (m_search_string.empty() || "*" == m_search_string);
+    m_message_filter = EncodedMessageFilter(m_search_string, m_ignore_case);
 }
 
 void Query::add_sub_query (const SubQuery& sub_query) {
     m_sub_queries.push_back(sub_query);
 
     // Add to relevant sub-queries if necessary
-    if (sub_query.get_ids_of_matching_segments().count(m_prev_segment_id)) {
+    if (sub_query.get_ids_of_matching_segments().contains(m_prev_segment_id)) {
         m_relevant_sub_queries.push_back(&m_sub_queries.back());
     }
 }
@@ -180,7 +184,7 @@ void Query::make_sub_queries_relevant_to_segment (segment_id_t segment_id) {
     // Make sub-queries relevant to segment
     m_relevant_sub_queries.clear();
     for (auto& sub_query : m_sub_queries) {
-        if (sub_query.get_ids_of_matching_segments().count(segment_id)) {
+        if (sub_query.get_ids_of_matching_segments().contains(segment_id)) {
             m_relevant_sub_queries.push_back(&sub_query);
         }
     }
@@ -8,7 +8,9 @@
 #include <vector>
 
 // Project headers
+#include "Bitmap.hpp"
 #include "Defs.h"
+#include "EncodedMessageFilter.hpp"
 #include "LogTypeDictionaryEntry.hpp"
 #include "VariableDictionaryEntry.hpp"
 
@@ -33,10 +35,10 @@ public:
     bool matches (encoded_variable_t var) const;
 
     /**
-     * Removes segments from the given set that don't contain the given variable
+     * Removes segments from the given set of segment IDs that don't contain the given variable
      * @param segment_ids
      */
-    void remove_segments_that_dont_contain_dict_var (std::set<segment_id_t>& segment_ids) const;
+    void remove_segments_that_dont_contain_dict_var (Bitmap& segment_ids) const;
 
     bool is_precise_var () const { return m_is_precise_var; }
     bool is_dict_var () const { return m_is_dict_var; }
@@ -97,11 +99,11 @@ public:
     void clear ();
 
     bool wildcard_match_required () const { return m_wildcard_match_required; }
-    size_t get_num_possible_logtypes () const { return m_possible_logtype_ids.size(); }
+    size_t get_num_possible_logtypes () const { return m_possible_logtype_entries.size(); }
     const std::unordered_set<const LogTypeDictionaryEntry*>& get_possible_logtype_entries () const { return m_possible_logtype_entries; };
     size_t get_num_possible_vars () const { return m_vars.size(); }
     const std::vector<QueryVar>& get_vars () const { return m_vars; }
-    const std::set<segment_id_t>& get_ids_of_matching_segments () const { return m_ids_of_matching_segments; }
+    const Bitmap& get_ids_of_matching_segments () const { return m_ids_of_matching_segments; }
 
     /**
      * Whether the given logtype ID matches one of the possible logtypes in this subquery
@@ -119,8 +121,10 @@ public:
 private:
     // Variables
     std::unordered_set<const LogTypeDictionaryEntry*> m_possible_logtype_entries;
-    std::unordered_set<logtype_dictionary_id_t> m_possible_logtype_ids;
-    std::set<segment_id_t> m_ids_of_matching_segments;
+    // Indexed by logtype ID
+    Bitmap m_possible_logtype_ids;
+    // Indexed by segment ID
+    Bitmap m_ids_of_matching_segments;
     std::vector<QueryVar> m_vars;
     bool m_wildcard_match_required;
 };
@@ -138,7 +142,11 @@ public:
     // Methods
     void set_search_begin_timestamp (epochtime_t timestamp) { m_search_begin_timestamp = timestamp; }
     void set_search_end_timestamp (epochtime_t timestamp) { m_search_end_timestamp = timestamp; }
-    void set_ignore_case (bool ignore_case) { m_ignore_case = ignore_case; }
+    void set_ignore_case (bool ignore_case);
+    /**
+     * Sets the search string and builds the filter used to reject messages before decompressing them
+     * @param search_string
+     */
     void set_search_string (const std::string& search_string);
     void add_sub_query (const SubQuery& sub_query);
     void clear_sub_queries ();
@@ -167,6 +175,7 @@ public:
      * @return false otherwise
      */
     bool search_string_matches_all () const { return m_search_string_matches_all; }
+    const EncodedMessageFilter& get_message_filter () const { return m_message_filter; }
     const std::vector<SubQuery>& get_sub_queries () const { return m_sub_queries; }
     bool contains_sub_queries () const { return m_sub_queries.empty() == false; }
     const std::vector<const SubQuery*>& get_relevant_sub_queries () const { return m_relevant_sub_queries; }
@@ -180,6 +189,7 @@ private:
     bool m_ignore_case;
     std::string m_search_string;
     bool m_search_string_matches_all;
+    EncodedMessageFilter m_message_filter;
     std::vector<SubQuery> m_sub_queries;
     std::vector<const SubQuery*> m_relevant_sub_queries;
     segment_id_t m_prev_segment_id;
@@ -6,6 +6,11 @@
 
 using std::string;
 
+// Constants
+// How long to retry when the database is locked by another connection (e.g., a reader of an archive that's still being written) before
+// failing with SQLITE_BUSY
+static constexpr int cBusyTimeoutMs = 10'000;
+
 void SQLiteDB::open (const string& path) {
     auto return_value = sqlite3_open(path.c_str(), &m_db_handle);
     if (SQLITE_OK != return_value) {
@@ -13,6 +18,7 @@ void SQLiteDB::open (const string& path) {
         close();
         throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
     }
+    sqlite3_busy_timeout(m_db_handle, cBusyTimeoutMs);
 }
 
 bool SQLiteDB::close () {
@@ -0,0 +1,42 @@
+#include "StringArena.hpp"
+
+// C++ standard libraries
+#include <cstring>
+
+using std::string_view;
+
+string_view StringArena::add (string_view value) {
+    auto length = value.length();
+    if (0 == length) {
+        return {};
+    }
+
+    if (length > m_current_block_remaining_size) {
+        if (length > m_block_size / 2) {
+            // Give large values their own block so that we don't waste the remainder of the current block (which we continue appending to)
+            m_blocks.emplace_back(new char[length]);
+            m_allocated_size += length;
+            char* dest = m_blocks.back().get();
+            memcpy(dest, value.data(), length);
+            return {dest, length};
+        }
+
+        m_blocks.emplace_back(new char[m_block_size]);
+        m_allocated_size += m_block_size;
+        m_current_block_pos = m_blocks.back().get();
+        m_current_block_remaining_size = m_block_size;
+    }
+
+    char* dest = m_current_block_pos;
+    memcpy(dest, value.data(), length);
+    m_current_block_pos += length;
+    m_current_block_remaining_size -= length;
+    return {dest, length};
+}
+
+void StringArena::clear () {
+    m_blocks.clear();
+    m_current_block_pos = nullptr;
+    m_current_block_remaining_size = 0;
+    m_allocated_size = 0;
+}
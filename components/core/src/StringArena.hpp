@@ -0,0 +1,55 @@
+#ifndef STRINGARENA_HPP
+#define STRINGARENA_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * An append-only store for strings. Strings are copied into large blocks so that each stored string doesn't need its own heap allocation, and views
+ * returned by the arena remain valid until the arena is cleared or destroyed.
+ */
+class StringArena {
+public:
+    // Constants
+    static constexpr size_t cDefaultBlockSize = 1024 * 1024; // 1 MB
+
+    // Constructors
+    StringArena () : StringArena(cDefaultBlockSize) {}
+    explicit StringArena (size_t block_size) : m_block_size(block_size), m_current_block_pos(nullptr), m_current_block_remaining_size(0),
+                                               m_allocated_size(0) {}
+
+    // Delete copy constructor and assignment operator since views into the arena would be invalidated
+    StringArena (const StringArena&) = delete;
+    StringArena& operator= (const StringArena&) = delete;
+
+    // Methods
+    /**
+     * Copies the given string into the arena
+     * @param value
+     * @return A view of the copy stored in the arena
+     */
+    std::string_view add (std::string_view value);
+
+    /**
+     * Frees all strings in the arena, invalidating any views returned by the arena
+     */
+    void clear ();
+
+    /**
+     * @return The number of bytes allocated by the arena
+     */
+    size_t get_allocated_size () const { return m_allocated_size; }
+
+private:
+    // Variables
+    size_t m_block_size;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char* m_current_block_pos;
+    size_t m_current_block_remaining_size;
+    size_t m_allocated_size;
+};
+
+#endif // STRINGARENA_HPP
@@ -782,6 +782,67 @@ void TimestampPattern::insert_formatted_timestamp (const epochtime_t timestamp,
     msg = new_msg;
 }
 
+string TimestampPattern::get_possible_formatted_timestamp_chars () const {
+    // NOTE: Numeric fields include '-' and ' ' since they may be negative or space-padded
+    constexpr char cNumericFieldChars[] = "-0123456789 ";
+
+    string chars;
+    const size_t format_length = m_format.length();
+    ParserState state = ParserState::Literal;
+    for (size_t format_ix = 0; format_ix < format_length; ++format_ix) {
+        auto c = m_format[format_ix];
+        switch (state) {
+            case (ParserState::Literal):
+                if ('%' == c) {
+                    state = ParserState::FormatSpecifier;
+                } else {
+                    chars += c;
+                }
+                break;
+            case (ParserState::FormatSpecifier):
+                state = ParserState::Literal;
+                switch (c) {
+                    case '%':
+                        chars += c;
+                        break;
+                    case 'B':
+                        for (auto month_name : cMonthNames) {
+                            chars += month_name;
+                        }
+                        break;
+                    case 'b':
+                        for (auto month_name : cAbbrevMonthNames) {
+                            chars += month_name;
+                        }
+                        break;
+                    case 'a':
+                        for (auto day_name : cAbbrevDaysOfWeek) {
+                            chars += day_name;
+                        }
+                        break;
+                    case 'p':
+                        chars += "AMP";
+                        break;
+                    case '#':
+                        state = ParserState::RelativeTimestampUnit;
+                        break;
+                    default:
+                        // NOTE: Unsupported specifiers fail when formatting, so any characters they'd produce are irrelevant
+                        chars += cNumericFieldChars;
+                        break;
+                }
+                break;
+            case (ParserState::RelativeTimestampUnit):
+                chars += cNumericFieldChars;
+                state = ParserState::Literal;
+                break;
+            default:
+                break;
+        }
+    }
+    return chars;
+}
+
 bool operator== (const TimestampPattern& lhs, const TimestampPattern& rhs) {
     return (lhs.m_num_spaces_before_ts == rhs.m_num_spaces_before_ts && lhs.m_format == rhs.m_format);
 }
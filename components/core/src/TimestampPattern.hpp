@@ -116,6 +116,11 @@ public:
      * @throw TimestampPattern::OperationFailed if the the pattern contains unsupported format specifiers or the message cannot fit the timestamp pattern
      */
     void insert_formatted_timestamp (epochtime_t timestamp, std::string& msg) const;
+    /**
+     * Gets every character that may appear in a timestamp formatted using this pattern
+     * @return The characters (possibly with duplicates)
+     */
+    std::string get_possible_formatted_timestamp_chars () const;
 
     /**
      * Compares two timestamp patterns for equality
@@ -1,16 +1,20 @@
 #include "VariableDictionaryWriter.hpp"
 
+// C standard libraries
+#include <cstdio>
+
 // Project headers
+#include "BloomFilter.hpp"
 #include "dictionary_utils.hpp"
 #include "spdlog_with_specializations.hpp"
 
-bool VariableDictionaryWriter::add_entry (const std::string& value, variable_dictionary_id_t& id) {
+using std::string;
+using std::string_view;
+
+bool VariableDictionaryWriter::add_entry (string_view value, variable_dictionary_id_t& id) {
     bool new_entry = false;
 
-    const auto ix = m_value_to_id.find(value);
-    if (m_value_to_id.end() != ix) {
-        id = ix->second;
-    } else {
+    if (false == try_get_id(value, id)) {
         // Entry doesn't exist so create it
 
         if (m_next_id > m_max_id) {
@@ -23,8 +27,8 @@ bool VariableDictionaryWriter::add_entry (const std::string& value, variable_dic
         ++m_next_id;
 
         // Insert the ID obtained from the database into the dictionary
-        auto entry = VariableDictionaryEntry(value, id);
-        m_value_to_id[value] = id;
+        auto entry = VariableDictionaryEntry(string(value), id);
+        add_value_to_id_mapping(value, id);
 
         new_entry = true;
 
@@ -35,3 +39,54 @@ bool VariableDictionaryWriter::add_entry (const std::string& value, variable_dic
     }
     return new_entry;
 }
+
+void VariableDictionaryWriter::write_value_filter (const string& path) {
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+
+    // Ensure every entry is on disk
+    write_header_and_flush_to_disk();
+
+    FileReader dictionary_file_reader;
+#if USE_PASSTHROUGH_COMPRESSION
+    streaming_compression::passthrough::Decompressor dictionary_decompressor;
+#elif USE_ZSTD_COMPRESSION
+    streaming_compression::zstd::Decompressor dictionary_decompressor;
+#else
+    static_assert(false, "Unsupported compression mode.");
+#endif
+    dictionary_file_reader.open(m_dictionary_path);
+    // Skip header
+    dictionary_file_reader.seek_from_begin(sizeof(uint64_t));
+    constexpr size_t cDecompressorFileReadBufferCapacity = 64 * 1024; // 64 KB
+    dictionary_decompressor.open(dictionary_file_reader, cDecompressorFileReadBufferCapacity);
+
+    auto num_dictionary_entries = read_dictionary_header(dictionary_file_reader);
+    if (num_dictionary_entries != m_next_id) {
+        throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+    }
+
+    constexpr double cFalsePositiveRate = 0.01;
+    BloomFilter filter(num_dictionary_entries, cFalsePositiveRate);
+    VariableDictionaryEntry entry;
+    for (size_t i = 0; i < num_dictionary_entries; ++i) {
+        entry.clear();
+        entry.read_from_file(dictionary_decompressor);
+        filter.add(BloomFilter::hash(entry.get_value()));
+    }
+
+    dictionary_decompressor.close();
+    dictionary_file_reader.close();
+
+    // Write the filter to a temporary file and then rename it into place
+    auto temp_path = path + ".tmp";
+    FileWriter file_writer;
+    file_writer.open(temp_path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+    filter.write_to_file(file_writer);
+    file_writer.close();
+    if (0 != rename(temp_path.c_str(), path.c_str())) {
+        SPDLOG_ERROR("Failed to rename {} to {}, errno={}", temp_path.c_str(), path.c_str(), errno);
+        throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+    }
+}
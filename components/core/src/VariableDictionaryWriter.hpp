@@ -1,6 +1,10 @@
 #ifndef VARIABLEDICTIONARYWRITER_HPP
 #define VARIABLEDICTIONARYWRITER_HPP
 
+// C++ standard libraries
+#include <string>
+#include <string_view>
+
 // Project headers
 #include "Defs.h"
 #include "DictionaryWriter.hpp"
@@ -23,12 +27,26 @@ public:
         }
     };
 
+    // Methods
     /**
      * Adds the given variable to the dictionary if it doesn't exist.
      * @param value
      * @param id ID of the variable matching the given entry
      */
-    bool add_entry (const std::string& value, variable_dictionary_id_t& id);
+    bool add_entry (std::string_view value, variable_dictionary_id_t& id);
+
+    /**
+     * Writes a Bloom filter of the dictionary's values to the given path, so that readers can rule out that the dictionary contains a value
+     * without loading the dictionary. The values are read back from the dictionary on disk, so building the filter doesn't require keeping them
+     * in memory, and the filter is written to a temporary file that's then renamed into place, so readers never see a partial filter.
+     * @param path
+     * @throw VariableDictionaryWriter::OperationFailed if the dictionary isn't open or is corrupt
+     * @throw Same as DictionaryWriter::write_header_and_flush_to_disk
+     * @throw FileReader::OperationFailed if the dictionary couldn't be read
+     * @throw FileWriter::OperationFailed if the filter couldn't be written
+     * @throw VariableDictionaryWriter::OperationFailed if the filter couldn't be renamed into place
+     */
+    void write_value_filter (const std::string& path);
 };
 
 #endif // VARIABLEDICTIONARYWRITER_HPP
@@ -0,0 +1,332 @@
+#include "BooleanQuery.hpp"
+
+// C++ standard libraries
+#include <functional>
+
+// ANTLR libraries
+#include <antlr4-runtime.h>
+
+// KQL parser (generated from grammar/kql/KQL.g4)
+#include <KQLLexer.h>
+#include <KQLParser.h>
+
+// Project headers
+#include "../string_utils.hpp"
+
+using kql::KQLLexer;
+using kql::KQLParser;
+using std::string;
+using std::vector;
+using streaming_archive::reader::Archive;
+using streaming_archive::reader::File;
+using streaming_archive::reader::Message;
+
+namespace clg {
+    // Local types
+    /**
+     * Records the first syntax error encountered while lexing or parsing an expression
+     */
+    class SyntaxErrorListener : public antlr4::BaseErrorListener {
+    public:
+        // Methods
+        void syntaxError (antlr4::Recognizer* recognizer, antlr4::Token* offending_symbol, size_t line, size_t char_position_in_line,
+                          const string& msg, std::exception_ptr e) override
+        {
+            if (m_error.empty()) {
+                m_error = "Column " + std::to_string(char_position_in_line) + ": " + msg;
+            }
+        }
+
+        const string& get_error () const { return m_error; }
+
+    private:
+        // Variables
+        string m_error;
+    };
+
+    // Local prototypes
+    /**
+     * Converts a KQL literal into a wildcard string. Unquoted literals may contain wildcards while quoted literals are matched exactly.
+     * @param literal
+     * @return The wildcard string
+     */
+    static string convert_literal_to_wildcard_string (const string& literal);
+
+    static string convert_literal_to_wildcard_string (const string& literal) {
+        string wildcard_string;
+        bool is_quoted = (literal.length() >= 2 && '"' == literal.front() && '"' == literal.back());
+        size_t begin_pos = is_quoted ? 1 : 0;
+        size_t end_pos = is_quoted ? literal.length() - 1 : literal.length();
+        for (size_t i = begin_pos; i < end_pos; ++i) {
+            auto c = literal[i];
+            if ('\\' == c && i + 1 < end_pos) {
+                ++i;
+                c = literal[i];
+                switch (c) {
+                    case 't':
+                        wildcard_string += '\t';
+                        break;
+                    case 'r':
+                        wildcard_string += '\r';
+                        break;
+                    case 'n':
+                        wildcard_string += '\n';
+                        break;
+                    case '\\':
+                    case '*':
+                    case '?':
+                        // Keep the character escaped so that it's matched literally
+                        wildcard_string += '\\';
+                        wildcard_string += c;
+                        break;
+                    default:
+                        wildcard_string += c;
+                        break;
+                }
+            } else if (is_quoted && ('*' == c || '?' == c || '\\' == c)) {
+                wildcard_string += '\\';
+                wildcard_string += c;
+            } else {
+                wildcard_string += c;
+            }
+        }
+        return wildcard_string;
+    }
+
+    BooleanQuery::BooleanQuery (const string& kql_expression) : m_search_begin_ts(cEpochTimeMin), m_search_end_ts(cEpochTimeMax),
+                                                                m_ignore_case(false)
+    {
+        antlr4::ANTLRInputStream input(kql_expression);
+        KQLLexer lexer(&input);
+        SyntaxErrorListener syntax_error_listener;
+        lexer.removeErrorListeners();
+        lexer.addErrorListener(&syntax_error_listener);
+        antlr4::CommonTokenStream tokens(&lexer);
+        KQLParser parser(&tokens);
+        parser.removeErrorListeners();
+        parser.addErrorListener(&syntax_error_listener);
+
+        auto start_context = parser.start();
+        if (false == syntax_error_listener.get_error().empty()) {
+            throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__, syntax_error_listener.get_error());
+        }
+
+        // NOTE: The parse tree is owned by the parser, so it must be converted before the parser goes out of scope
+        std::function<size_t (KQLParser::QueryContext*)> add_nodes = [&] (KQLParser::QueryContext* query_context) -> size_t {
+            Node node = {};
+            if (auto sub_query_context = dynamic_cast<KQLParser::SubQueryContext*>(query_context)) {
+                return add_nodes(sub_query_context->q);
+            } else if (auto not_query_context = dynamic_cast<KQLParser::NotQueryContext*>(query_context)) {
+                node.type = NodeType::Not;
+                node.operand_ixs[0] = add_nodes(not_query_context->q);
+            } else if (auto or_and_query_context = dynamic_cast<KQLParser::OrAndQueryContext*>(query_context)) {
+                node.type = (KQLParser::AND == or_and_query_context->op->getType()) ? NodeType::And : NodeType::Or;
+                node.operand_ixs[0] = add_nodes(or_and_query_context->lhs);
+                node.operand_ixs[1] = add_nodes(or_and_query_context->rhs);
+            } else if (auto expr_context = dynamic_cast<KQLParser::ExprContext*>(query_context)) {
+                auto value_expression_context = expr_context->expression()->value_expression();
+                if (nullptr == value_expression_context) {
+                    throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__,
+                                          "Column expressions aren't supported since log messages have no columns");
+                }
+                node.type = NodeType::WildcardString;
+                node.wildcard_string_ix = m_wildcard_strings.size();
+                m_wildcard_strings.push_back(convert_literal_to_wildcard_string(value_expression_context->LITERAL()->getText()));
+            } else {
+                throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__,
+                                      "Nested queries aren't supported since log messages have no columns");
+            }
+            m_nodes.push_back(node);
+            return m_nodes.size() - 1;
+        };
+        add_nodes(start_context->query());
+
+        m_queries.resize(m_wildcard_strings.size());
+        m_query_ptrs.resize(m_wildcard_strings.size(), nullptr);
+        m_node_matches.resize(m_nodes.size());
+        m_node_possible_matches.resize(m_nodes.size());
+    }
+
+    bool BooleanQuery::process (const Archive& archive, epochtime_t search_begin_ts, epochtime_t search_end_ts, bool ignore_case,
+                                compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer,
+                                bool use_heuristic)
+    {
+        m_search_begin_ts = search_begin_ts;
+        m_search_end_ts = search_end_ts;
+        m_ignore_case = ignore_case;
+        for (size_t i = 0; i < m_wildcard_strings.size(); ++i) {
+            auto& query = m_queries[i];
+            query = Query();
+            if (Grep::process_raw_query(archive, m_wildcard_strings[i], search_begin_ts, search_end_ts, ignore_case, query, forward_lexer,
+                                        reverse_lexer, use_heuristic))
+            {
+                m_query_ptrs[i] = &query;
+            } else {
+                m_query_ptrs[i] = nullptr;
+            }
+        }
+
+        return node_may_match(m_nodes.size() - 1);
+    }
+
+    size_t BooleanQuery::search_and_output (size_t limit, Archive& archive, File& compressed_file, Grep::OutputFunc output_func,
+                                            void* output_func_arg, size_t& num_full_decodes_avoided)
+    {
+        size_t num_matches = 0;
+
+        find_matches(archive, compressed_file, num_full_decodes_avoided);
+        auto root_ix = m_nodes.size() - 1;
+        const auto& matches = get_matches();
+        const auto& possible_matches = get_possible_matches();
+        if (possible_matches.none()) {
+            return num_matches;
+        }
+
+        archive.reset_file_indices(compressed_file);
+        Message compressed_msg;
+        string decompressed_msg;
+        const string& orig_file_path = compressed_file.get_orig_path();
+        while (num_matches < limit && archive.get_next_message(compressed_file, compressed_msg)) {
+            auto msg_ix = compressed_msg.get_message_number();
+            if (false == possible_matches.test(msg_ix)) {
+                continue;
+            }
+
+            // Decompress match
+            bool decompress_successful = archive.decompress_message(compressed_file, compressed_msg, decompressed_msg);
+            if (!decompress_successful) {
+                break;
+            }
+
+            if (false == matches.test(msg_ix) && false == node_matches(root_ix, msg_ix, decompressed_msg)) {
+                continue;
+            }
+
+            output_func(orig_file_path, compressed_msg, decompressed_msg, output_func_arg);
+            ++num_matches;
+        }
+
+        return num_matches;
+    }
+
+    size_t BooleanQuery::search_and_aggregate (Archive& archive, File& compressed_file, Grep::AggregateFunc aggregate_func,
+                                               void* aggregate_func_arg, size_t& num_full_decodes_avoided)
+    {
+        size_t num_matches = 0;
+
+        find_matches(archive, compressed_file, num_full_decodes_avoided);
+        auto root_ix = m_nodes.size() - 1;
+        const auto& matches = get_matches();
+        const auto& possible_matches = get_possible_matches();
+        if (possible_matches.none()) {
+            return num_matches;
+        }
+
+        archive.reset_file_indices(compressed_file);
+        Message compressed_msg;
+        string decompressed_msg;
+        while (archive.get_next_message(compressed_file, compressed_msg)) {
+            auto msg_ix = compressed_msg.get_message_number();
+            if (false == possible_matches.test(msg_ix)) {
+                continue;
+            }
+
+            if (false == matches.test(msg_ix)) {
+                bool decompress_successful = archive.decompress_message(compressed_file, compressed_msg, decompressed_msg);
+                if (!decompress_successful) {
+                    break;
+                }
+                if (false == node_matches(root_ix, msg_ix, decompressed_msg)) {
+                    continue;
+                }
+            }
+
+            aggregate_func(compressed_msg.get_ts_in_milli(), compressed_msg.get_logtype_id(), aggregate_func_arg);
+            ++num_matches;
+        }
+
+        return num_matches;
+    }
+
+    bool BooleanQuery::node_may_match (size_t node_ix) const {
+        const auto& node = m_nodes[node_ix];
+        switch (node.type) {
+            case NodeType::WildcardString:
+                return nullptr != m_query_ptrs[node.wildcard_string_ix];
+            case NodeType::And:
+                return node_may_match(node.operand_ixs[0]) && node_may_match(node.operand_ixs[1]);
+            case NodeType::Or:
+                return node_may_match(node.operand_ixs[0]) || node_may_match(node.operand_ixs[1]);
+            case NodeType::Not:
+            default:
+                // Whether the operand matches every message can't be known without searching
+                return true;
+        }
+    }
+
+    void BooleanQuery::find_matches (Archive& archive, File& compressed_file, size_t& num_full_decodes_avoided) {
+        Grep::calculate_sub_queries_relevant_to_file(compressed_file, m_queries);
+        Grep::find_matches_of_queries(m_query_ptrs, m_search_begin_ts, m_search_end_ts, archive, compressed_file, m_messages_in_time_range,
+                                      m_query_matches, m_query_possible_matches, num_full_decodes_avoided);
+        combine_matches(m_messages_in_time_range, m_query_matches, m_query_possible_matches);
+    }
+
+    void BooleanQuery::combine_matches (const Bitmap& messages_in_time_range, const vector<Bitmap>& query_matches,
+                                        const vector<Bitmap>& query_possible_matches)
+    {
+        // Since the nodes are in post-order, each node's operands are evaluated before the node itself
+        // NOTE: Each node's matches are the messages it definitely matches, while its possible matches also include the messages which can only
+        // be decided by wildcard matching. So a message definitely matches NOT x if it can't possibly match x, and vice versa.
+        for (size_t node_ix = 0; node_ix < m_nodes.size(); ++node_ix) {
+            const auto& node = m_nodes[node_ix];
+            auto& matches = m_node_matches[node_ix];
+            auto& possible_matches = m_node_possible_matches[node_ix];
+            switch (node.type) {
+                case NodeType::WildcardString:
+                    matches = query_matches[node.wildcard_string_ix];
+                    possible_matches = query_possible_matches[node.wildcard_string_ix];
+                    break;
+                case NodeType::And:
+                    matches = m_node_matches[node.operand_ixs[0]];
+                    matches &= m_node_matches[node.operand_ixs[1]];
+                    possible_matches = m_node_possible_matches[node.operand_ixs[0]];
+                    possible_matches &= m_node_possible_matches[node.operand_ixs[1]];
+                    break;
+                case NodeType::Or:
+                    matches = m_node_matches[node.operand_ixs[0]];
+                    matches |= m_node_matches[node.operand_ixs[1]];
+                    possible_matches = m_node_possible_matches[node.operand_ixs[0]];
+                    possible_matches |= m_node_possible_matches[node.operand_ixs[1]];
+                    break;
+                case NodeType::Not:
+                    matches = messages_in_time_range;
+                    matches.subtract(m_node_possible_matches[node.operand_ixs[0]]);
+                    possible_matches = messages_in_time_range;
+                    possible_matches.subtract(m_node_matches[node.operand_ixs[0]]);
+                    break;
+            }
+        }
+    }
+
+    bool BooleanQuery::node_matches (size_t node_ix, size_t msg_ix, const string& decompressed_msg) const {
+        if (m_node_matches[node_ix].test(msg_ix)) {
+            return true;
+        }
+        if (false == m_node_possible_matches[node_ix].test(msg_ix)) {
+            return false;
+        }
+
+        const auto& node = m_nodes[node_ix];
+        switch (node.type) {
+            case NodeType::WildcardString:
+                return wildcard_match_unsafe(decompressed_msg, m_queries[node.wildcard_string_ix].get_search_string(), false == m_ignore_case);
+            case NodeType::And:
+                return node_matches(node.operand_ixs[0], msg_ix, decompressed_msg) && node_matches(node.operand_ixs[1], msg_ix, decompressed_msg);
+            case NodeType::Or:
+                return node_matches(node.operand_ixs[0], msg_ix, decompressed_msg) || node_matches(node.operand_ixs[1], msg_ix, decompressed_msg);
+            case NodeType::Not:
+            default:
+                return false == node_matches(node.operand_ixs[0], msg_ix, decompressed_msg);
+        }
+    }
+}
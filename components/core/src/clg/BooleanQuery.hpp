@@ -0,0 +1,178 @@
+#ifndef CLG_BOOLEANQUERY_HPP
+#define CLG_BOOLEANQUERY_HPP
+
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Project headers
+#include "../Bitmap.hpp"
+#include "../Defs.h"
+#include "../Grep.hpp"
+#include "../Query.hpp"
+#include "../TraceableException.hpp"
+
+namespace clg {
+    /**
+     * Class representing a boolean combination (using AND, OR, and NOT) of wildcard strings, parsed from a KQL expression. Each wildcard string
+     * is processed into a Query. When a file is searched, the messages matching every wildcard string are found in a single scan of the file's
+     * columns and then combined as bitmaps, so that a message is only decompressed if it's a result or if deciding whether it's a result
+     * requires wildcard matching it.
+     */
+    class BooleanQuery {
+    public:
+        // Types
+        class OperationFailed : public TraceableException {
+        public:
+            // Constructors
+            OperationFailed (ErrorCode error_code, const char* const filename, int line_number, std::string message) :
+                    TraceableException(error_code, filename, line_number), m_message(std::move(message)) {}
+
+            // Methods
+            const char* what () const noexcept override {
+                return m_message.c_str();
+            }
+
+        private:
+            std::string m_message;
+        };
+
+        // Constructors
+        /**
+         * @param kql_expression
+         * @throw BooleanQuery::OperationFailed if the expression is invalid or uses KQL features that aren't supported
+         */
+        explicit BooleanQuery (const std::string& kql_expression);
+
+        // Methods
+        const std::vector<std::string>& get_wildcard_strings () const { return m_wildcard_strings; }
+
+        /**
+         * Processes the query's wildcard strings against the given archive
+         * @param archive
+         * @param search_begin_ts
+         * @param search_end_ts
+         * @param ignore_case
+         * @param forward_lexer
+         * @param reverse_lexer
+         * @param use_heuristic
+         * @return true if the query may match messages in the archive, false otherwise
+         */
+        bool process (const streaming_archive::reader::Archive& archive, epochtime_t search_begin_ts, epochtime_t search_end_ts, bool ignore_case,
+                      compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer,
+                      bool use_heuristic);
+
+        void set_search_begin_timestamp (epochtime_t timestamp) { m_search_begin_ts = timestamp; }
+        epochtime_t get_search_begin_timestamp () const { return m_search_begin_ts; }
+
+        /**
+         * Searches a file with the query and outputs any results using the given method
+         * @param limit
+         * @param archive
+         * @param compressed_file
+         * @param output_func
+         * @param output_func_arg
+         * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
+         * @return Number of matches found
+         * @throw streaming_archive::reader::Archive::OperationFailed if decompression unexpectedly fails
+         * @throw TimestampPattern::OperationFailed if failed to insert timestamp into message
+         */
+        size_t search_and_output (size_t limit, streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                                  Grep::OutputFunc output_func, void* output_func_arg, size_t& num_full_decodes_avoided);
+        /**
+         * Searches a file with the query and passes the timestamp and logtype of each result to the given aggregation function. Results are
+         * only decompressed when they must be wildcard-matched.
+         * @param archive
+         * @param compressed_file
+         * @param aggregate_func
+         * @param aggregate_func_arg
+         * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
+         * @return Number of matches found
+         * @throw streaming_archive::reader::Archive::OperationFailed if decompression unexpectedly fails
+         * @throw TimestampPattern::OperationFailed if failed to insert timestamp into message
+         */
+        size_t search_and_aggregate (streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                                     Grep::AggregateFunc aggregate_func, void* aggregate_func_arg, size_t& num_full_decodes_avoided);
+
+        /**
+         * Combines the matches of each of the query's wildcard strings in a file into the matches of the whole query
+         * @param messages_in_time_range The messages (by message number) in the search time range
+         * @param query_matches The messages that match each wildcard string
+         * @param query_possible_matches The messages that may match each wildcard string (a superset of its matches)
+         */
+        void combine_matches (const Bitmap& messages_in_time_range, const std::vector<Bitmap>& query_matches,
+                              const std::vector<Bitmap>& query_possible_matches);
+        /**
+         * @return The messages that match the query, as of the last call to combine_matches
+         */
+        const Bitmap& get_matches () const { return m_node_matches.back(); }
+        /**
+         * @return The messages that may match the query (a superset of its matches), as of the last call to combine_matches. The messages
+         * in between must be decompressed to decide whether they match.
+         */
+        const Bitmap& get_possible_matches () const { return m_node_possible_matches.back(); }
+
+    private:
+        // Types
+        enum class NodeType {
+            WildcardString,
+            And,
+            Or,
+            Not,
+        };
+
+        struct Node {
+            NodeType type;
+            // Only used by WildcardString nodes
+            size_t wildcard_string_ix;
+            // Only used by And, Or, and Not nodes (which only use the first operand)
+            size_t operand_ixs[2];
+        };
+
+        // Methods
+        /**
+         * @param node_ix
+         * @return Whether the given node may match any message in the archive that was last processed
+         */
+        bool node_may_match (size_t node_ix) const;
+        /**
+         * Finds the matches and possible matches of every node in the given file
+         * @param archive
+         * @param compressed_file
+         * @param num_full_decodes_avoided
+         */
+        void find_matches (streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                           size_t& num_full_decodes_avoided);
+        /**
+         * Decides whether a message that may match the given node does so, using its decompressed form only if the node's operands' matches
+         * can't decide it
+         * @param node_ix
+         * @param msg_ix
+         * @param decompressed_msg
+         * @return Whether the message matches
+         */
+        bool node_matches (size_t node_ix, size_t msg_ix, const std::string& decompressed_msg) const;
+
+        // Variables
+        std::vector<std::string> m_wildcard_strings;
+        // Nodes of the expression in post-order, so the last node is the root
+        std::vector<Node> m_nodes;
+
+        epochtime_t m_search_begin_ts;
+        epochtime_t m_search_end_ts;
+        bool m_ignore_case;
+        std::vector<Query> m_queries;
+        // The query for each wildcard string, or nullptr if it can't match any message in the archive that was last processed
+        std::vector<const Query*> m_query_ptrs;
+
+        // Matches of the file being searched, by message number. Each node's possible matches are a superset of its matches, and the messages
+        // in between must be decompressed to decide whether they match.
+        Bitmap m_messages_in_time_range;
+        std::vector<Bitmap> m_query_matches;
+        std::vector<Bitmap> m_query_possible_matches;
+        std::vector<Bitmap> m_node_matches;
+        std::vector<Bitmap> m_node_possible_matches;
+    };
+}
+
+#endif // CLG_BOOLEANQUERY_HPP
@@ -50,12 +50,21 @@ namespace clg {
                 ("db-config-file",
                         po::value<string>(&global_metadata_db_config_file_path)->value_name("FILE")->default_value(global_metadata_db_config_file_path),
                         "Global metadata DB YAML config")
+                ("profile-output", po::value<string>(&m_profile_output_path)->value_name("FILE"),
+                        "Write a JSON report of the time spent in each phase and of other profiling counters to FILE (requires a build with"
+                        " profiling enabled)")
                 ;
 
         // Define input options
         po::options_description options_input("Input Options");
         options_input.add_options()
                 ("file,f", po::value<string>(&m_search_strings_file_path)->value_name("FILE"), "Obtain wildcard strings from FILE, one per line")
+                ("batch", po::value<string>(&m_query_batch_file_path)->value_name("FILE"),
+                        "Search for a batch of queries from FILE in a single pass, where each line is a query ID and a wildcard string separated by a"
+                        " tab. Each result is output with the ID of the query it matches, and --max-results applies to each query. With --count,"
+                        " each query's ID is output with its number of results instead.")
+                ("follow", po::bool_switch(&m_follow),
+                        "Keep searching archives (including ones still being written) as new data becomes searchable, until interrupted")
                 ;
 
         // Define output options
@@ -64,6 +73,13 @@ namespace clg {
         options_output.add_options()
                 ("output-method", po::value<char>(&output_method_input)->value_name("CHAR")->default_value(output_method_input),
                  "Use output method specified by CHAR (s - stdout, b - binary)")
+                ("max-results", po::value<size_t>(&m_max_num_results)->value_name("N"), "Stop searching after outputting N results")
+                ("latest", po::value<size_t>(&m_num_latest_results)->value_name("N"),
+                        "Only output the N results with the latest timestamps (in chronological order)")
+                ("count", po::bool_switch(&m_count), "Only output the number of results")
+                ("count-by-logtype", po::bool_switch(&m_count_by_logtype), "Only output the number of results with each logtype")
+                ("count-by-time", po::value<epochtime_t>(&m_count_by_time_bucket_size)->value_name("MS"),
+                        "Only output the number of results in each MS-long time bucket (buckets without results are omitted)")
                 ;
 
         // Define match controls
@@ -75,6 +91,8 @@ namespace clg {
                 ("tlt", po::value<epochtime_t>()->value_name("TS"), "Find messages with UNIX timestamp <  TS ms")
                 ("tle", po::value<epochtime_t>()->value_name("TS"), "Find messages with UNIX timestamp <= TS ms")
                 ("ignore-case,i", po::bool_switch(&m_ignore_case), "Ignore case distinctions in both WILDCARD STRING and the input files")
+                ("kql", po::bool_switch(&m_kql),
+                        "Interpret WILDCARD STRING as a KQL expression which combines wildcard strings with AND, OR, NOT, and parentheses")
                 ;
 
         // Define visible options
@@ -142,6 +160,27 @@ namespace clg {
                 cerr << "  " << get_program_name() << R"( archives-dir " ERROR ")" << endl;
                 cerr << endl;
 
+                cerr << R"(  # Search archives-dir for " ERROR ", including messages that are compressed after the search starts)" << endl;
+                cerr << "  " << get_program_name() << R"( --follow archives-dir " ERROR ")" << endl;
+                cerr << endl;
+
+                cerr << R"(  # Search archives-dir for the 100 latest messages containing " ERROR ")" << endl;
+                cerr << "  " << get_program_name() << R"( --latest 100 archives-dir " ERROR ")" << endl;
+                cerr << endl;
+
+                cerr << R"(  # Search archives-dir for messages containing "ERROR" but not "retrying")" << endl;
+                cerr << "  " << get_program_name() << R"( --kql archives-dir "ERROR AND NOT retrying")" << endl;
+                cerr << endl;
+
+                cerr << R"(  # Search archives-dir for every query in queries.tsv, outputting each result with its query's ID)" << endl;
+                cerr << "  " << get_program_name() << R"( --batch queries.tsv archives-dir)" << endl;
+                cerr << endl;
+
+                cerr << R"(  # Count the messages containing " timeout " in each minute of the given day)" << endl;
+                cerr << "  " << get_program_name() << R"( --count-by-time 60000 --tge 1672531200000 --tlt 1672617600000 archives-dir " timeout ")"
+                     << endl;
+                cerr << endl;
+
                 cerr << "Options can be specified on the command line or through a configuration file." << endl;
                 cerr << visible_options << endl;
                 return ParsingResult::InfoCommand;
@@ -169,13 +208,32 @@ namespace clg {
             }
 
             // Validate at least one wildcard string exists
-            if (m_search_strings_file_path.empty() == false) {
+            if (false == m_query_batch_file_path.empty()) {
+                if (false == m_search_string.empty() || false == m_search_strings_file_path.empty()) {
+                    throw invalid_argument("Wildcard strings cannot be specified along with --batch.");
+                }
+                if (m_kql) {
+                    throw invalid_argument("--batch cannot be used with --kql.");
+                }
+                if (parsed_command_line_options.count("latest") || m_follow) {
+                    throw invalid_argument("--batch cannot be used with --latest or --follow.");
+                }
+                if (m_count_by_logtype || parsed_command_line_options.count("count-by-time")) {
+                    throw invalid_argument("--batch can only be used with --count, not --count-by-logtype or --count-by-time.");
+                }
+                if ((char)OutputMethod::StdoutText != output_method_input) {
+                    throw invalid_argument("--batch can only be used with the stdout output method.");
+                }
+            } else if (m_search_strings_file_path.empty() == false) {
                 if (m_search_string.empty() == false) {
                     throw invalid_argument("Wildcard strings cannot be specified both through the command line and a file.");
                 }
             } else if (m_search_string.empty()) {
                 throw invalid_argument("Wildcard string not specified or empty.");
             }
+            if (m_kql && false == m_search_strings_file_path.empty()) {
+                throw invalid_argument("--kql cannot be used with --file.");
+            }
 
             // Validate timestamp range and compute m_search_begin_ts and m_search_end_ts
             if (parsed_command_line_options.count("teq")) {
@@ -215,6 +273,39 @@ namespace clg {
                 }
             }
 
+            if (parsed_command_line_options.count("max-results") && 0 == m_max_num_results) {
+                throw invalid_argument("--max-results must be greater than 0.");
+            }
+            if (parsed_command_line_options.count("latest")) {
+                if (0 == m_num_latest_results) {
+                    throw invalid_argument("--latest must be greater than 0.");
+                }
+                if (parsed_command_line_options.count("max-results")) {
+                    throw invalid_argument("--latest cannot be used with --max-results.");
+                }
+                if (m_follow) {
+                    throw invalid_argument("--latest cannot be used with --follow.");
+                }
+            }
+
+            if (parsed_command_line_options.count("count-by-time") && m_count_by_time_bucket_size <= 0) {
+                throw invalid_argument("--count-by-time must be greater than 0.");
+            }
+            if (aggregate()) {
+                if (m_count + m_count_by_logtype + parsed_command_line_options.count("count-by-time") > 1) {
+                    throw invalid_argument("Only one of --count, --count-by-logtype, and --count-by-time can be specified.");
+                }
+                if (parsed_command_line_options.count("max-results") || parsed_command_line_options.count("latest")) {
+                    throw invalid_argument("Results cannot be counted when using --max-results or --latest.");
+                }
+                if (m_follow) {
+                    throw invalid_argument("Results cannot be counted when using --follow.");
+                }
+                if ((char)OutputMethod::StdoutText != output_method_input) {
+                    throw invalid_argument("Results can only be counted with the stdout output method.");
+                }
+            }
+
             switch (output_method_input) {
                 case (char)OutputMethod::StdoutText:
                 case (char)OutputMethod::StdoutBinary:
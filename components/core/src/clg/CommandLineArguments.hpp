@@ -23,21 +23,46 @@ namespace clg {
         };
 
         // Constructors
-        explicit CommandLineArguments (const std::string& program_name) : CommandLineArgumentsBase(program_name), m_ignore_case(false),
-                m_output_method(OutputMethod::StdoutText), m_search_begin_ts(cEpochTimeMin), m_search_end_ts(cEpochTimeMax) {}
+        explicit CommandLineArguments (const std::string& program_name) : CommandLineArgumentsBase(program_name), m_follow(false), m_ignore_case(false),
+                m_kql(false), m_output_method(OutputMethod::StdoutText), m_max_num_results(SIZE_MAX), m_num_latest_results(0), m_count(false),
+                m_count_by_logtype(false), m_count_by_time_bucket_size(0), m_search_begin_ts(cEpochTimeMin), m_search_end_ts(cEpochTimeMax) {}
 
         // Methods
         ParsingResult parse_arguments (int argc, const char* argv[]) override;
 
         const std::string& get_search_strings_file_path () const { return m_search_strings_file_path; }
+        /**
+         * @return The path of the file containing the batch of queries to search for, or an empty string if not searching for a batch of queries
+         */
+        const std::string& get_query_batch_file_path () const { return m_query_batch_file_path; }
+        bool follow () const { return m_follow; }
         bool ignore_case () const { return m_ignore_case; }
+        /**
+         * @return Whether the search string is a KQL expression (rather than a single wildcard string)
+         */
+        bool kql () const { return m_kql; }
         const std::string& get_archives_dir () const { return m_archives_dir; }
         const std::string& get_search_string () const { return m_search_string; }
         const std::string& get_file_path () const { return m_file_path; }
         OutputMethod get_output_method () const { return m_output_method; }
+        size_t get_max_num_results () const { return m_max_num_results; }
+        /**
+         * @return The number of results with the latest timestamps to output, or 0 if all results should be output
+         */
+        size_t get_num_latest_results () const { return m_num_latest_results; }
+        /**
+         * @return Whether only aggregates of the results (rather than the results themselves) should be output
+         */
+        bool aggregate () const { return m_count || m_count_by_logtype || m_count_by_time_bucket_size > 0; }
+        bool count_by_logtype () const { return m_count_by_logtype; }
+        /**
+         * @return The size of the time buckets (in ms) to count results in, or 0 if results shouldn't be counted by time
+         */
+        epochtime_t get_count_by_time_bucket_size () const { return m_count_by_time_bucket_size; }
         epochtime_t get_search_begin_ts () const { return m_search_begin_ts; }
         epochtime_t get_search_end_ts () const { return m_search_end_ts; }
         const GlobalMetadataDBConfig& get_metadata_db_config () const { return m_metadata_db_config; }
+        const std::string& get_profile_output_path () const { return m_profile_output_path; }
 
     private:
         // Methods
@@ -45,13 +70,22 @@ namespace clg {
 
         // Variables
         std::string m_search_strings_file_path;
+        std::string m_query_batch_file_path;
+        bool m_follow;
         bool m_ignore_case;
+        bool m_kql;
         std::string m_archives_dir;
         std::string m_search_string;
         std::string m_file_path;
         OutputMethod m_output_method;
+        size_t m_max_num_results;
+        size_t m_num_latest_results;
+        bool m_count;
+        bool m_count_by_logtype;
+        epochtime_t m_count_by_time_bucket_size;
         epochtime_t m_search_begin_ts, m_search_end_ts;
         GlobalMetadataDBConfig m_metadata_db_config;
+        std::string m_profile_output_path;
     };
 }
 
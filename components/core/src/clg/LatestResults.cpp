@@ -0,0 +1,42 @@
+#include "LatestResults.hpp"
+
+// C++ standard libraries
+#include <algorithm>
+
+using std::string;
+using streaming_archive::reader::Message;
+
+namespace clg {
+    LatestResults::LatestResults (size_t max_num_results) : m_max_num_results(max_num_results) {
+        m_results.reserve(max_num_results);
+    }
+
+    void LatestResults::add (const string& orig_file_path, const Message& compressed_msg, const string& decompressed_msg) {
+        auto timestamp = compressed_msg.get_ts_in_milli();
+        if (is_full()) {
+            if (0 == m_max_num_results || timestamp <= get_earliest_timestamp()) {
+                return;
+            }
+            // Move the earliest result to the back and overwrite it, reusing its buffers
+            std::pop_heap(m_results.begin(), m_results.end(), is_later);
+        } else {
+            m_results.emplace_back();
+        }
+
+        auto& result = m_results.back();
+        result.timestamp = timestamp;
+        result.orig_file_path = orig_file_path;
+        result.compressed_msg = compressed_msg;
+        result.decompressed_msg = decompressed_msg;
+        std::push_heap(m_results.begin(), m_results.end(), is_later);
+    }
+
+    void LatestResults::output_and_clear (Grep::OutputFunc output_func, void* output_func_arg) {
+        // NOTE: Sorting the heap with its comparator orders the results from latest to earliest
+        std::sort_heap(m_results.begin(), m_results.end(), is_later);
+        for (auto result_it = m_results.crbegin(); m_results.crend() != result_it; ++result_it) {
+            output_func(result_it->orig_file_path, result_it->compressed_msg, result_it->decompressed_msg, output_func_arg);
+        }
+        m_results.clear();
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef CLG_LATESTRESULTS_HPP
+#define CLG_LATESTRESULTS_HPP
+
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Project headers
+#include "../Defs.h"
+#include "../Grep.hpp"
+#include "../streaming_archive/reader/Message.hpp"
+
+namespace clg {
+    /**
+     * Class to keep the K search results with the latest timestamps. The results are kept in a min-heap on their timestamps, so a new result
+     * only needs to be compared with the earliest result kept to determine whether it's one of the latest K.
+     */
+    class LatestResults {
+    public:
+        // Constructors
+        explicit LatestResults (size_t max_num_results);
+
+        // Methods
+        bool is_full () const { return m_results.size() >= m_max_num_results; }
+        /**
+         * @return The timestamp of the earliest result kept
+         */
+        epochtime_t get_earliest_timestamp () const { return m_results.front().timestamp; }
+
+        /**
+         * Adds the given result if fewer than K results have been added so far or if it's later than the earliest result kept, in which case
+         * the earliest result is discarded
+         * @param orig_file_path
+         * @param compressed_msg
+         * @param decompressed_msg
+         */
+        void add (const std::string& orig_file_path, const streaming_archive::reader::Message& compressed_msg, const std::string& decompressed_msg);
+
+        /**
+         * Outputs the results kept in chronological order and then discards them
+         * @param output_func
+         * @param output_func_arg
+         */
+        void output_and_clear (Grep::OutputFunc output_func, void* output_func_arg);
+
+    private:
+        // Types
+        struct Result {
+            epochtime_t timestamp;
+            std::string orig_file_path;
+            streaming_archive::reader::Message compressed_msg;
+            std::string decompressed_msg;
+        };
+
+        // Methods
+        /**
+         * Comparator which puts the earliest result at the top of the heap
+         * @param lhs
+         * @param rhs
+         * @return Whether lhs is later than rhs
+         */
+        static bool is_later (const Result& lhs, const Result& rhs) { return lhs.timestamp > rhs.timestamp; }
+
+        // Variables
+        size_t m_max_num_results;
+        std::vector<Result> m_results;
+    };
+}
+
+#endif // CLG_LATESTRESULTS_HPP
@@ -0,0 +1,115 @@
+#include "MatchAggregates.hpp"
+
+// C standard libraries
+#include <cinttypes>
+#include <cstdio>
+
+// C++ standard libraries
+#include <algorithm>
+#include <vector>
+
+// Project headers
+#include "../ir/parsing.hpp"
+#include "../string_utils.hpp"
+
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace clg {
+    // Local prototypes
+    /**
+     * Gets a human-readable form of the given logtype, with variable placeholders replaced by \i (integer), \f (float), or \d (dictionary
+     * variable) and newlines escaped
+     * @param entry
+     * @param human_readable_logtype
+     */
+    static void get_human_readable_logtype (const LogTypeDictionaryEntry& entry, string& human_readable_logtype);
+
+    static void get_human_readable_logtype (const LogTypeDictionaryEntry& entry, string& human_readable_logtype) {
+        const auto& value = entry.get_value();
+        string logtype;
+
+        size_t constant_begin_pos = 0;
+        for (size_t var_ix = 0; var_ix < entry.get_num_vars(); ++var_ix) {
+            ir::VariablePlaceholder var_placeholder;
+            size_t var_pos = entry.get_var_info(var_ix, var_placeholder);
+
+            // Add the constant that's between the last variable and this one
+            logtype.append(value, constant_begin_pos, var_pos - constant_begin_pos);
+
+            switch (var_placeholder) {
+                case ir::VariablePlaceholder::Integer:
+                    logtype += "\\i";
+                    break;
+                case ir::VariablePlaceholder::Float:
+                    logtype += "\\f";
+                    break;
+                case ir::VariablePlaceholder::Dictionary:
+                default:
+                    logtype += "\\d";
+                    break;
+            }
+            // Move past the variable placeholder
+            constant_begin_pos = var_pos + 1;
+        }
+        // Append remainder of value, if any
+        if (constant_begin_pos < value.length()) {
+            logtype.append(value, constant_begin_pos, string::npos);
+        }
+
+        human_readable_logtype = replace_characters("\n", "n", logtype, true);
+    }
+
+    void MatchAggregates::add (epochtime_t timestamp, logtype_dictionary_id_t logtype_id) {
+        ++m_num_matches;
+
+        if (m_count_by_logtype) {
+            ++m_archive_logtype_id_to_num_matches[logtype_id];
+        }
+
+        if (m_time_bucket_size > 0) {
+            // NOTE: We round down (rather than towards zero) so that timestamps before the epoch fall in the correct bucket
+            auto offset_in_bucket = timestamp % m_time_bucket_size;
+            if (offset_in_bucket < 0) {
+                offset_in_bucket += m_time_bucket_size;
+            }
+            ++m_time_bucket_to_num_matches[timestamp - offset_in_bucket];
+        }
+    }
+
+    void MatchAggregates::merge_archive_logtype_counts (const LogTypeDictionaryReader& logtype_dict) {
+        string logtype;
+        for (const auto& [logtype_id, num_matches] : m_archive_logtype_id_to_num_matches) {
+            get_human_readable_logtype(logtype_dict.get_entry(logtype_id), logtype);
+            m_logtype_to_num_matches[logtype] += num_matches;
+        }
+        m_archive_logtype_id_to_num_matches.clear();
+    }
+
+    void MatchAggregates::print () const {
+        if (false == m_count_by_logtype && 0 == m_time_bucket_size) {
+            printf("%zu\n", m_num_matches);
+            return;
+        }
+
+        if (m_count_by_logtype) {
+            // Print the logtypes with the most matches first
+            vector<pair<const string*, size_t>> logtypes_and_num_matches;
+            logtypes_and_num_matches.reserve(m_logtype_to_num_matches.size());
+            for (const auto& [logtype, num_matches] : m_logtype_to_num_matches) {
+                logtypes_and_num_matches.emplace_back(&logtype, num_matches);
+            }
+            std::sort(logtypes_and_num_matches.begin(), logtypes_and_num_matches.end(), [] (const auto& lhs, const auto& rhs) {
+                return lhs.second > rhs.second || (lhs.second == rhs.second && *lhs.first < *rhs.first);
+            });
+            for (const auto& [logtype, num_matches] : logtypes_and_num_matches) {
+                printf("%zu %s\n", num_matches, logtype->c_str());
+            }
+        }
+
+        for (const auto& [time_bucket_begin_ts, num_matches] : m_time_bucket_to_num_matches) {
+            printf("%" PRId64 " %zu\n", static_cast<int64_t>(time_bucket_begin_ts), num_matches);
+        }
+    }
+}
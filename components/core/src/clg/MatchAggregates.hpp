@@ -0,0 +1,70 @@
+#ifndef CLG_MATCHAGGREGATES_HPP
+#define CLG_MATCHAGGREGATES_HPP
+
+// C++ standard libraries
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// Project headers
+#include "../Defs.h"
+#include "../LogTypeDictionaryReader.hpp"
+
+namespace clg {
+    /**
+     * Class to aggregate the matches of a search into a total count and, optionally, counts per logtype and counts per time bucket
+     */
+    class MatchAggregates {
+    public:
+        // Constructors
+        /**
+         * @param count_by_logtype Whether to count the matches of each logtype
+         * @param time_bucket_size Size of the time buckets (in ms) to count matches in, or 0 if matches shouldn't be counted by time
+         */
+        MatchAggregates (bool count_by_logtype, epochtime_t time_bucket_size) : m_num_matches(0), m_count_by_logtype(count_by_logtype),
+                                                                                  m_time_bucket_size(time_bucket_size) {}
+
+        // Methods
+        /**
+         * Adds a match from the archive currently being searched
+         * @param timestamp
+         * @param logtype_id
+         */
+        void add (epochtime_t timestamp, logtype_dictionary_id_t logtype_id);
+        /**
+         * Merges the counts per logtype from the archive that was searched into the counts for all archives. This must be called after each
+         * archive is searched since logtype IDs are specific to an archive.
+         * @param logtype_dict The archive's logtype dictionary
+         */
+        void merge_archive_logtype_counts (const LogTypeDictionaryReader& logtype_dict);
+
+        /**
+         * Prints the aggregates to stdout
+         */
+        void print () const;
+
+        size_t get_num_matches () const { return m_num_matches; }
+        /**
+         * @return A map from each (human-readable) logtype to its number of matches, across all archives that were merged
+         */
+        const std::unordered_map<std::string, size_t>& get_logtype_to_num_matches () const { return m_logtype_to_num_matches; }
+        /**
+         * @return A map from the begin timestamp of each time bucket to its number of matches
+         */
+        const std::map<epochtime_t, size_t>& get_time_bucket_to_num_matches () const { return m_time_bucket_to_num_matches; }
+
+    private:
+        // Variables
+        size_t m_num_matches;
+
+        bool m_count_by_logtype;
+        std::unordered_map<logtype_dictionary_id_t, size_t> m_archive_logtype_id_to_num_matches;
+        std::unordered_map<std::string, size_t> m_logtype_to_num_matches;
+
+        epochtime_t m_time_bucket_size;
+        // Maps the begin timestamp of each time bucket to its number of matches
+        std::map<epochtime_t, size_t> m_time_bucket_to_num_matches;
+    };
+}
+
+#endif // CLG_MATCHAGGREGATES_HPP
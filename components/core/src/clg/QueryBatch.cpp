@@ -0,0 +1,197 @@
+#include "QueryBatch.hpp"
+
+// Project headers
+#include "../string_utils.hpp"
+
+using std::string;
+using std::vector;
+using streaming_archive::reader::Archive;
+using streaming_archive::reader::File;
+using streaming_archive::reader::Message;
+
+namespace clg {
+    QueryBatch::QueryBatch (vector<string> query_ids, vector<string> wildcard_strings, size_t max_num_results_per_query) :
+            m_query_ids(std::move(query_ids)), m_wildcard_strings(std::move(wildcard_strings)),
+            m_max_num_results_per_query(max_num_results_per_query), m_search_begin_ts(cEpochTimeMin), m_search_end_ts(cEpochTimeMax),
+            m_ignore_case(false)
+    {
+        m_num_results.resize(m_query_ids.size(), 0);
+        m_num_incomplete_queries = (m_max_num_results_per_query > 0) ? m_query_ids.size() : 0;
+        m_queries.resize(m_query_ids.size());
+        m_query_ptrs.resize(m_query_ids.size(), nullptr);
+    }
+
+    std::unique_ptr<QueryBatch> QueryBatch::parse (ReaderInterface& reader, size_t max_num_results_per_query) {
+        vector<string> query_ids;
+        vector<string> wildcard_strings;
+        string line;
+        size_t line_num = 0;
+        while (reader.read_to_delimiter('\n', false, false, line)) {
+            ++line_num;
+            if (line.empty()) {
+                continue;
+            }
+            auto tab_pos = line.find('\t');
+            if (string::npos == tab_pos || 0 == tab_pos) {
+                throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__,
+                                      "Line " + std::to_string(line_num) + " isn't a query ID and a wildcard string separated by a tab");
+            }
+            query_ids.emplace_back(line, 0, tab_pos);
+            wildcard_strings.emplace_back(line, tab_pos + 1);
+        }
+        if (query_ids.empty()) {
+            throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__, "No queries");
+        }
+
+        return std::make_unique<QueryBatch>(std::move(query_ids), std::move(wildcard_strings), max_num_results_per_query);
+    }
+
+    bool QueryBatch::process (const Archive& archive, epochtime_t search_begin_ts, epochtime_t search_end_ts, bool ignore_case,
+                              compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer,
+                              bool use_heuristic)
+    {
+        m_search_begin_ts = search_begin_ts;
+        m_search_end_ts = search_end_ts;
+        m_ignore_case = ignore_case;
+
+        bool any_query_may_match = false;
+        for (size_t query_ix = 0; query_ix < m_queries.size(); ++query_ix) {
+            auto& query = m_queries[query_ix];
+            query = Query();
+            m_query_ptrs[query_ix] = nullptr;
+            if (m_num_results[query_ix] >= m_max_num_results_per_query) {
+                continue;
+            }
+            if (Grep::process_raw_query(archive, m_wildcard_strings[query_ix], search_begin_ts, search_end_ts, ignore_case, query, forward_lexer,
+                                        reverse_lexer, use_heuristic))
+            {
+                m_query_ptrs[query_ix] = &query;
+                any_query_may_match = true;
+            }
+        }
+
+        return any_query_may_match;
+    }
+
+    size_t QueryBatch::search_and_output (Archive& archive, File& compressed_file, OutputFunc output_func, void* output_func_arg,
+                                          size_t& num_full_decodes_avoided)
+    {
+        size_t num_matches = 0;
+
+        find_matches(archive, compressed_file, num_full_decodes_avoided);
+        if (m_possible_matches.none()) {
+            return num_matches;
+        }
+
+        archive.reset_file_indices(compressed_file);
+        Message compressed_msg;
+        string decompressed_msg;
+        const string& orig_file_path = compressed_file.get_orig_path();
+        while (false == all_queries_complete() && archive.get_next_message(compressed_file, compressed_msg)) {
+            auto msg_ix = compressed_msg.get_message_number();
+            if (false == m_possible_matches.test(msg_ix)) {
+                continue;
+            }
+
+            // Decompress match
+            bool decompress_successful = archive.decompress_message(compressed_file, compressed_msg, decompressed_msg);
+            if (!decompress_successful) {
+                break;
+            }
+
+            for (size_t query_ix = 0; query_ix < m_incomplete_query_ptrs.size(); ++query_ix) {
+                if (nullptr == m_incomplete_query_ptrs[query_ix] || m_num_results[query_ix] >= m_max_num_results_per_query ||
+                    false == query_matches(query_ix, msg_ix, decompressed_msg))
+                {
+                    continue;
+                }
+                output_func(m_query_ids[query_ix], orig_file_path, compressed_msg, decompressed_msg, output_func_arg);
+                add_result(query_ix);
+                ++num_matches;
+            }
+        }
+
+        return num_matches;
+    }
+
+    size_t QueryBatch::search_and_count (Archive& archive, File& compressed_file, size_t& num_full_decodes_avoided) {
+        size_t num_matches = 0;
+
+        find_matches(archive, compressed_file, num_full_decodes_avoided);
+        if (m_possible_matches.none()) {
+            return num_matches;
+        }
+
+        archive.reset_file_indices(compressed_file);
+        Message compressed_msg;
+        string decompressed_msg;
+        while (false == all_queries_complete() && archive.get_next_message(compressed_file, compressed_msg)) {
+            auto msg_ix = compressed_msg.get_message_number();
+            if (false == m_possible_matches.test(msg_ix)) {
+                continue;
+            }
+
+            bool is_decompressed = false;
+            for (size_t query_ix = 0; query_ix < m_incomplete_query_ptrs.size(); ++query_ix) {
+                if (nullptr == m_incomplete_query_ptrs[query_ix] || m_num_results[query_ix] >= m_max_num_results_per_query ||
+                    false == m_query_possible_matches[query_ix].test(msg_ix))
+                {
+                    continue;
+                }
+                if (false == m_query_matches[query_ix].test(msg_ix)) {
+                    // Decompress the message at most once, no matter how many queries must wildcard-match it
+                    if (false == is_decompressed) {
+                        if (false == archive.decompress_message(compressed_file, compressed_msg, decompressed_msg)) {
+                            return num_matches;
+                        }
+                        is_decompressed = true;
+                    }
+                    if (false == query_matches(query_ix, msg_ix, decompressed_msg)) {
+                        continue;
+                    }
+                }
+                add_result(query_ix);
+                ++num_matches;
+            }
+        }
+
+        return num_matches;
+    }
+
+    void QueryBatch::find_matches (Archive& archive, File& compressed_file, size_t& num_full_decodes_avoided) {
+        Grep::calculate_sub_queries_relevant_to_file(compressed_file, m_queries);
+
+        // Don't look for matches of queries that have already found all their results
+        m_incomplete_query_ptrs = m_query_ptrs;
+        for (size_t query_ix = 0; query_ix < m_incomplete_query_ptrs.size(); ++query_ix) {
+            if (m_num_results[query_ix] >= m_max_num_results_per_query) {
+                m_incomplete_query_ptrs[query_ix] = nullptr;
+            }
+        }
+
+        Grep::find_matches_of_queries(m_incomplete_query_ptrs, m_search_begin_ts, m_search_end_ts, archive, compressed_file,
+                                      m_messages_in_time_range, m_query_matches, m_query_possible_matches, num_full_decodes_avoided);
+
+        m_possible_matches.resize_and_clear(compressed_file.get_num_messages());
+        for (const auto& query_possible_matches : m_query_possible_matches) {
+            m_possible_matches |= query_possible_matches;
+        }
+    }
+
+    bool QueryBatch::query_matches (size_t query_ix, size_t msg_ix, const string& decompressed_msg) const {
+        if (m_query_matches[query_ix].test(msg_ix)) {
+            return true;
+        }
+        if (false == m_query_possible_matches[query_ix].test(msg_ix)) {
+            return false;
+        }
+        return wildcard_match_unsafe(decompressed_msg, m_queries[query_ix].get_search_string(), false == m_ignore_case);
+    }
+
+    void QueryBatch::add_result (size_t query_ix) {
+        ++m_num_results[query_ix];
+        if (m_num_results[query_ix] == m_max_num_results_per_query) {
+            --m_num_incomplete_queries;
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#ifndef CLG_QUERYBATCH_HPP
+#define CLG_QUERYBATCH_HPP
+
+// C++ standard libraries
+#include <memory>
+#include <string>
+#include <vector>
+
+// Project headers
+#include "../Bitmap.hpp"
+#include "../Defs.h"
+#include "../Grep.hpp"
+#include "../Query.hpp"
+#include "../ReaderInterface.hpp"
+#include "../TraceableException.hpp"
+
+namespace clg {
+    /**
+     * Class representing a batch of independent queries, each identified by an ID, which are searched for together. The queries are processed
+     * against an archive's dictionaries once and the messages matching each query are found in a single scan of each file's columns, so each
+     * message is decompressed at most once no matter how many queries it matches.
+     */
+    class QueryBatch {
+    public:
+        // Types
+        class OperationFailed : public TraceableException {
+        public:
+            // Constructors
+            OperationFailed (ErrorCode error_code, const char* const filename, int line_number, std::string message) :
+                    TraceableException(error_code, filename, line_number), m_message(std::move(message)) {}
+
+            // Methods
+            const char* what () const noexcept override {
+                return m_message.c_str();
+            }
+
+        private:
+            std::string m_message;
+        };
+
+        /**
+         * Handles a search result
+         * @param query_id ID of the query that the result matches
+         * @param orig_file_path Path of uncompressed file
+         * @param compressed_msg
+         * @param decompressed_msg
+         * @param custom_arg Custom argument for the output function
+         */
+        typedef void (*OutputFunc) (const std::string& query_id, const std::string& orig_file_path,
+                                    const streaming_archive::reader::Message& compressed_msg, const std::string& decompressed_msg, void* custom_arg);
+
+        // Constructors
+        /**
+         * @param query_ids
+         * @param wildcard_strings The wildcard string of each query
+         * @param max_num_results_per_query
+         */
+        QueryBatch (std::vector<std::string> query_ids, std::vector<std::string> wildcard_strings, size_t max_num_results_per_query);
+
+        // Methods
+        /**
+         * Parses a batch of queries from the given reader, where each line is a query ID and a wildcard string separated by a tab. Empty lines
+         * are ignored.
+         * @param reader
+         * @param max_num_results_per_query
+         * @return The query batch
+         * @throw QueryBatch::OperationFailed if a line isn't a non-empty query ID and a wildcard string separated by a tab, or if there are no
+         * queries
+         */
+        static std::unique_ptr<QueryBatch> parse (ReaderInterface& reader, size_t max_num_results_per_query);
+
+        size_t get_num_queries () const { return m_query_ids.size(); }
+        const std::string& get_query_id (size_t query_ix) const { return m_query_ids[query_ix]; }
+        /**
+         * @param query_ix
+         * @return The number of results found for the given query across all files searched
+         */
+        size_t get_num_results (size_t query_ix) const { return m_num_results[query_ix]; }
+        /**
+         * @return Whether every query has found its maximum number of results
+         */
+        bool all_queries_complete () const { return m_num_incomplete_queries == 0; }
+        /**
+         * Records a result for the given query
+         * @param query_ix
+         */
+        void add_result (size_t query_ix);
+
+        /**
+         * Processes the queries against the given archive
+         * @param archive
+         * @param search_begin_ts
+         * @param search_end_ts
+         * @param ignore_case
+         * @param forward_lexer
+         * @param reverse_lexer
+         * @param use_heuristic
+         * @return true if any query may match messages in the archive, false otherwise
+         */
+        bool process (const streaming_archive::reader::Archive& archive, epochtime_t search_begin_ts, epochtime_t search_end_ts, bool ignore_case,
+                      compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer,
+                      bool use_heuristic);
+
+        /**
+         * Searches a file with every query and outputs each result, along with the ID of the query it matches, using the given method. A
+         * message which matches several queries is output once for each.
+         * @param archive
+         * @param compressed_file
+         * @param output_func
+         * @param output_func_arg
+         * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
+         * @return Number of matches found
+         * @throw streaming_archive::reader::Archive::OperationFailed if decompression unexpectedly fails
+         * @throw TimestampPattern::OperationFailed if failed to insert timestamp into message
+         */
+        size_t search_and_output (streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                                  OutputFunc output_func, void* output_func_arg, size_t& num_full_decodes_avoided);
+        /**
+         * Searches a file with every query, only counting the results of each. Results are only decompressed when they must be
+         * wildcard-matched.
+         * @param archive
+         * @param compressed_file
+         * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
+         * @return Number of matches found
+         * @throw streaming_archive::reader::Archive::OperationFailed if decompression unexpectedly fails
+         * @throw TimestampPattern::OperationFailed if failed to insert timestamp into message
+         */
+        size_t search_and_count (streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                                 size_t& num_full_decodes_avoided);
+
+    private:
+        // Methods
+        /**
+         * Finds the matches and possible matches of every query that's still incomplete in the given file
+         * @param archive
+         * @param compressed_file
+         * @param num_full_decodes_avoided
+         */
+        void find_matches (streaming_archive::reader::Archive& archive, streaming_archive::reader::File& compressed_file,
+                           size_t& num_full_decodes_avoided);
+        /**
+         * Decides whether a message that may match the given query does so
+         * @param query_ix
+         * @param msg_ix
+         * @param decompressed_msg
+         * @return Whether the message matches
+         */
+        bool query_matches (size_t query_ix, size_t msg_ix, const std::string& decompressed_msg) const;
+
+        // Variables
+        std::vector<std::string> m_query_ids;
+        std::vector<std::string> m_wildcard_strings;
+        size_t m_max_num_results_per_query;
+        std::vector<size_t> m_num_results;
+        size_t m_num_incomplete_queries;
+
+        epochtime_t m_search_begin_ts;
+        epochtime_t m_search_end_ts;
+        bool m_ignore_case;
+        std::vector<Query> m_queries;
+        // The query for each wildcard string, or nullptr if it can't match any message in the archive that was last processed
+        std::vector<const Query*> m_query_ptrs;
+
+        // Matches of the file being searched, by message number
+        std::vector<const Query*> m_incomplete_query_ptrs;
+        Bitmap m_messages_in_time_range;
+        std::vector<Bitmap> m_query_matches;
+        std::vector<Bitmap> m_query_possible_matches;
+        // Union of all queries' possible matches
+        Bitmap m_possible_matches;
+    };
+}
+
+#endif // CLG_QUERYBATCH_HPP
@@ -2,13 +2,20 @@
 #include <sys/stat.h>
 
 // C++ libraries
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <filesystem>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 // spdlog
 #include <spdlog/sinks/stdout_sinks.h>
 
 // Project headers
+#include "../Bitmap.hpp"
+#include "../BloomFilter.hpp"
 #include "../Defs.h"
 #include "../compressor_frontend/utils.hpp"
 #include "../Grep.hpp"
@@ -17,9 +24,17 @@
 #include "../Profiler.hpp"
 #include "../spdlog_with_specializations.hpp"
 #include "../streaming_archive/Constants.hpp"
+#include "BooleanQuery.hpp"
 #include "CommandLineArguments.hpp"
+#include "LatestResults.hpp"
+#include "MatchAggregates.hpp"
+#include "QueryBatch.hpp"
 
+using clg::BooleanQuery;
 using clg::CommandLineArguments;
+using clg::LatestResults;
+using clg::MatchAggregates;
+using clg::QueryBatch;
 using compressor_frontend::load_lexer_from_file;
 using std::cout;
 using std::cerr;
@@ -32,6 +47,43 @@ using streaming_archive::reader::Archive;
 using streaming_archive::reader::File;
 using streaming_archive::reader::Message;
 
+// Constants
+// How often archives are checked for new data in follow mode
+static constexpr std::chrono::seconds cFollowPollInterval{1};
+
+// Types
+/**
+ * An archive that's kept open in follow mode, so that only the data that's become searchable since the last pass needs to be read
+ */
+struct FollowedArchive {
+    Archive reader;
+    // Lexers for an archive whose schema isn't shared with other archives, since the one-time-use lexers are reloaded for each archive
+    compressor_frontend::lexers::ByteLexer own_forward_lexer;
+    compressor_frontend::lexers::ByteLexer own_reverse_lexer;
+    compressor_frontend::lexers::ByteLexer* forward_lexer;
+    compressor_frontend::lexers::ByteLexer* reverse_lexer;
+    bool use_heuristic;
+};
+
+/**
+ * How the results of a search are handled, shared by the searches of all archives
+ */
+struct SearchResults {
+    // Number of results that can still be output
+    size_t num_results_remaining;
+    // The latest results found so far, or nullptr if all results should be output as they're found
+    LatestResults* latest_results;
+    // Aggregates of the results found so far, or nullptr if the results themselves should be output
+    MatchAggregates* aggregates;
+};
+
+/**
+ * Checks whether the archive may contain matches of any of the search strings, using only the archive's variable dictionary filter
+ * @param archive_path
+ * @param dict_vars_required_by_search_strings The dictionary variables required by each search string
+ * @return false if every search string requires a dictionary variable that the archive doesn't contain, true otherwise
+ */
+static bool archive_may_contain_matches (const string& archive_path, const vector<vector<string>>& dict_vars_required_by_search_strings);
 /**
  * Opens the archive and reads the dictionaries
  * @param archive_path
@@ -39,14 +91,42 @@ using streaming_archive::reader::Message;
  * @return true on success, false otherwise
  */
 static bool open_archive (const string& archive_path, Archive& archive_reader);
+/**
+ * Finds the segments that have become searchable since the archive was last refreshed and reads any new dictionary entries
+ * @param archive_reader
+ * @param new_segment_ids Returns the IDs of the new segments
+ * @return true on success, false otherwise
+ */
+static bool refresh_archive (Archive& archive_reader, vector<segment_id_t>& new_segment_ids);
 /**
  * Searches the archive with the given parameters
  * @param search_strings
+ * @param boolean_query The boolean query to search for instead of the search strings, or nullptr to search for the search strings
+ * @param command_line_args
+ * @param archive
+ * @param forward_lexer
+ * @param reverse_lexer
+ * @param use_heuristic
+ * @param segment_ids_to_search The segments to limit the search to, or nullptr to search the whole archive
+ * @param search_results
+ * @return true on success, false otherwise
+ */
+static bool search (const vector<string>& search_strings, BooleanQuery* boolean_query, CommandLineArguments& command_line_args, Archive& archive,
+                    compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer, bool use_heuristic,
+                    const vector<segment_id_t>* segment_ids_to_search, SearchResults& search_results);
+/**
+ * Searches the archive for a batch of queries, scanning each file once for all of them
+ * @param query_batch
  * @param command_line_args
  * @param archive
+ * @param forward_lexer
+ * @param reverse_lexer
+ * @param use_heuristic
  * @return true on success, false otherwise
  */
-static bool search (const vector<string>& search_strings, CommandLineArguments& command_line_args, Archive& archive, bool use_heuristic);
+static bool search_batch (QueryBatch& query_batch, CommandLineArguments& command_line_args, Archive& archive,
+                          compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer,
+                          bool use_heuristic);
 /**
  * Opens a compressed file or logs any errors if it couldn't be opened
  * @param file_metadata_ix
@@ -56,15 +136,28 @@ static bool search (const vector<string>& search_strings, CommandLineArguments&
  */
 static bool open_compressed_file (MetadataDB::FileIterator& file_metadata_ix, Archive& archive, File& compressed_file);
 /**
- * Searches all files referenced by a given database cursor
+ * Searches all files referenced by a given database cursor, until the result limits are reached. When only the latest results are kept, the
+ * cursor must iterate over the files in descending end-timestamp order.
  * @param queries
+ * @param boolean_query The boolean query to run on each file instead of the queries, or nullptr to run the queries
  * @param output_method
  * @param archive
  * @param file_metadata_ix
+ * @param ids_of_segments_to_search If not nullptr, files in segments other than these (that aren't in the invalid segment) are skipped
+ * @param search_results
+ * @param num_full_decodes_avoided Incremented for every message that was rejected without decompressing it
  * @return The total number of matches found across all files
  */
-static size_t search_files (vector<Query>& queries, CommandLineArguments::OutputMethod output_method, Archive& archive,
-                            MetadataDB::FileIterator& file_metadata_ix);
+static size_t search_files (vector<Query>& queries, BooleanQuery* boolean_query, CommandLineArguments::OutputMethod output_method,
+                            Archive& archive, MetadataDB::FileIterator& file_metadata_ix, const Bitmap* ids_of_segments_to_search,
+                            SearchResults& search_results, size_t& num_full_decodes_avoided);
+/**
+ * Gets the function that outputs results with the given output method
+ * @param output_method
+ * @param output_func Returns the output function
+ * @return true on success, false if the output method is unknown
+ */
+static bool get_output_func (CommandLineArguments::OutputMethod output_method, Grep::OutputFunc& output_func);
 /**
  * Prints search result to stdout in text format
  * @param orig_file_path
@@ -81,6 +174,32 @@ static void print_result_text (const string& orig_file_path, const Message& comp
  * @param custom_arg Unused
  */
 static void print_result_binary (const string& orig_file_path, const Message& compressed_msg, const string& decompressed_msg, void* custom_arg);
+/**
+ * Prints search result of a batch of queries to stdout in text format
+ * @param query_id
+ * @param orig_file_path
+ * @param compressed_msg
+ * @param decompressed_msg
+ * @param custom_arg Unused
+ */
+static void print_batch_result_text (const string& query_id, const string& orig_file_path, const Message& compressed_msg,
+                                     const string& decompressed_msg, void* custom_arg);
+/**
+ * Adds search result to the latest results
+ * @param orig_file_path
+ * @param compressed_msg
+ * @param decompressed_msg
+ * @param custom_arg The LatestResults to add to
+ */
+static void add_result_to_latest_results (const string& orig_file_path, const Message& compressed_msg, const string& decompressed_msg,
+                                          void* custom_arg);
+/**
+ * Adds search result to the aggregates
+ * @param timestamp
+ * @param logtype_id
+ * @param custom_arg The MatchAggregates to add to
+ */
+static void add_result_to_aggregates (epochtime_t timestamp, logtype_dictionary_id_t logtype_id, void* custom_arg);
 
 /**
  * Gets an archive iterator for the given file path or for all files if the file path is empty
@@ -88,12 +207,19 @@ static void print_result_binary (const string& orig_file_path, const Message& co
  * @param file_path
  * @param begin_ts
  * @param end_ts
+ * @param in_descending_end_ts_order Whether to iterate from the archive with the latest end timestamp to the one with the earliest. If so,
+ * the file path isn't used to filter the archives.
  * @return An archive iterator
  */
-static GlobalMetadataDB::ArchiveIterator* get_archive_iterator (GlobalMetadataDB& global_metadata_db, const std::string& file_path, epochtime_t begin_ts, epochtime_t end_ts);
+static GlobalMetadataDB::ArchiveIterator* get_archive_iterator (GlobalMetadataDB& global_metadata_db, const std::string& file_path, epochtime_t begin_ts,
+                                                                epochtime_t end_ts, bool in_descending_end_ts_order);
 
-static GlobalMetadataDB::ArchiveIterator* get_archive_iterator (GlobalMetadataDB& global_metadata_db, const std::string& file_path, epochtime_t begin_ts, epochtime_t end_ts) {
-    if (!file_path.empty()) {
+static GlobalMetadataDB::ArchiveIterator* get_archive_iterator (GlobalMetadataDB& global_metadata_db, const std::string& file_path, epochtime_t begin_ts,
+                                                                epochtime_t end_ts, bool in_descending_end_ts_order)
+{
+    if (in_descending_end_ts_order) {
+        return global_metadata_db.get_archive_iterator_for_time_window_in_descending_end_ts_order(begin_ts, end_ts);
+    } else if (!file_path.empty()) {
         return global_metadata_db.get_archive_iterator_for_file_path(file_path);
     } else if (begin_ts == cEpochTimeMin && end_ts == cEpochTimeMax) {
         return global_metadata_db.get_archive_iterator();
@@ -102,6 +228,30 @@ static GlobalMetadataDB::ArchiveIterator* get_archive_iterator (GlobalMetadataDB
     }
 }
 
+static bool archive_may_contain_matches (const string& archive_path, const vector<vector<string>>& dict_vars_required_by_search_strings) {
+    BloomFilter filter;
+    try {
+        if (false == Archive::read_var_dict_filter(archive_path, filter)) {
+            return true;
+        }
+    } catch (TraceableException& e) {
+        // The filter is only an optimization, so search the archive as usual
+        SPDLOG_WARN("Reading variable dictionary filter failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(),
+                    e.get_error_code());
+        return true;
+    }
+
+    for (const auto& dict_vars : dict_vars_required_by_search_strings) {
+        bool may_contain_all_dict_vars = std::all_of(dict_vars.cbegin(), dict_vars.cend(), [&filter] (const string& dict_var) {
+            return filter.possibly_contains(BloomFilter::hash(dict_var));
+        });
+        if (may_contain_all_dict_vars) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static bool open_archive (const string& archive_path, Archive& archive_reader) {
     ErrorCode error_code;
 
@@ -135,8 +285,25 @@ static bool open_archive (const string& archive_path, Archive& archive_reader) {
     return true;
 }
 
-static bool search (const vector<string>& search_strings, CommandLineArguments& command_line_args, Archive& archive,
-                    compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer, bool use_heuristic) {
+static bool refresh_archive (Archive& archive_reader, vector<segment_id_t>& new_segment_ids) {
+    try {
+        archive_reader.refresh(new_segment_ids);
+    } catch (TraceableException& e) {
+        auto error_code = e.get_error_code();
+        if (ErrorCode_errno == error_code) {
+            SPDLOG_ERROR("Refreshing archive failed: {}:{} {}, errno={}", e.get_filename(), e.get_line_number(), e.what(), errno);
+        } else {
+            SPDLOG_ERROR("Refreshing archive failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(), error_code);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+static bool search (const vector<string>& search_strings, BooleanQuery* boolean_query, CommandLineArguments& command_line_args, Archive& archive,
+                    compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer, bool use_heuristic,
+                    const vector<segment_id_t>* segment_ids_to_search, SearchResults& search_results) {
     ErrorCode error_code;
     auto search_begin_ts = command_line_args.get_search_begin_ts();
     auto search_end_ts = command_line_args.get_search_end_ts();
@@ -144,51 +311,94 @@ static bool search (const vector<string>& search_strings, CommandLineArguments&
     try {
         vector<Query> queries;
         bool no_queries_match = true;
-        std::set<segment_id_t> ids_of_segments_to_search;
+        Bitmap ids_of_segments_to_search;
         bool is_superseding_query = false;
-        for (const auto& search_string : search_strings) {
-            Query query;
-            if (Grep::process_raw_query(archive, search_string, search_begin_ts, search_end_ts, command_line_args.ignore_case(), query, forward_lexer, 
-                                        reverse_lexer, use_heuristic)) {
-            //if (Grep::process_raw_query(archive, search_string, search_begin_ts, search_end_ts, command_line_args.ignore_case(), query, parser)) {
-                no_queries_match = false;
-
-                if (query.contains_sub_queries() == false) {
-                    // Search string supersedes all other possible search strings
-                    is_superseding_query = true;
-                    // Remove existing queries since they are superseded by this one
-                    queries.clear();
-                    // Add this query
-                    queries.push_back(query);
-                    // All other search strings will be superseded by this one, so break
-                    break;
-                }
+        Profiler::reset_fragmented_measurement<Profiler::FragmentedMeasurementIndex::QueryPlanning>();
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::QueryPlanning>();
+        if (nullptr != boolean_query) {
+            no_queries_match = (false == boolean_query->process(archive, search_begin_ts, search_end_ts, command_line_args.ignore_case(),
+                                                                forward_lexer, reverse_lexer, use_heuristic));
+            // NOTE: The segments that may contain a match can't be derived from the segments of the query's wildcard strings (e.g., when they're
+            // negated), so every segment is searched
+            is_superseding_query = true;
+        } else {
+            for (const auto& search_string : search_strings) {
+                Query query;
+                if (Grep::process_raw_query(archive, search_string, search_begin_ts, search_end_ts, command_line_args.ignore_case(), query, forward_lexer, 
+                                            reverse_lexer, use_heuristic)) {
+                //if (Grep::process_raw_query(archive, search_string, search_begin_ts, search_end_ts, command_line_args.ignore_case(), query, parser)) {
+                    no_queries_match = false;
+
+                    if (query.contains_sub_queries() == false) {
+                        // Search string supersedes all other possible search strings
+                        is_superseding_query = true;
+                        // Remove existing queries since they are superseded by this one
+                        queries.clear();
+                        // Add this query
+                        queries.push_back(query);
+                        // All other search strings will be superseded by this one, so break
+                        break;
+                    }
 
-                queries.push_back(query);
+                    queries.push_back(query);
 
-                // Add query's matching segments to segments to search
-                for (auto& sub_query : query.get_sub_queries()) {
-                    auto& ids_of_matching_segments = sub_query.get_ids_of_matching_segments();
-                    ids_of_segments_to_search.insert(ids_of_matching_segments.cbegin(), ids_of_matching_segments.cend());
+                    // Add query's matching segments to segments to search
+                    for (auto& sub_query : query.get_sub_queries()) {
+                        ids_of_segments_to_search |= sub_query.get_ids_of_matching_segments();
+                    }
                 }
             }
         }
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::QueryPlanning>();
+        PROFILER_SPDLOG_INFO("Planning queries for {} took {} s", archive.get_path(),
+                             Profiler::get_fragmented_measurement_in_seconds<Profiler::FragmentedMeasurementIndex::QueryPlanning>())
 
         if (!no_queries_match) {
             size_t num_matches;
-            if (is_superseding_query) {
+            size_t num_full_decodes_avoided = 0;
+            if (nullptr != search_results.latest_results) {
+                // Search from the latest file to the earliest so that the search can stop as soon as no remaining file can contain a result
+                // later than those already found
+                auto file_metadata_ix = archive.get_file_iterator_in_descending_end_ts_order(search_begin_ts, search_end_ts,
+                                                                                             command_line_args.get_file_path());
+                num_matches = search_files(queries, boolean_query, command_line_args.get_output_method(), archive, *file_metadata_ix,
+                                           is_superseding_query ? nullptr : &ids_of_segments_to_search, search_results, num_full_decodes_avoided);
+            } else if (nullptr != segment_ids_to_search) {
+                // NOTE: The queries were processed against the whole dictionaries, so their matching segments may include ones that were
+                // already searched
+                auto file_metadata_ix_ptr = archive.get_file_iterator(search_begin_ts, search_end_ts, command_line_args.get_file_path(), cInvalidSegmentId);
+                auto& file_metadata_ix = *file_metadata_ix_ptr;
+                num_matches = 0;
+                for (auto segment_id : *segment_ids_to_search) {
+                    if (false == is_superseding_query && cInvalidSegmentId != segment_id && false == ids_of_segments_to_search.contains(segment_id)) {
+                        continue;
+                    }
+                    file_metadata_ix.set_segment_id(segment_id);
+                    num_matches += search_files(queries, boolean_query, command_line_args.get_output_method(), archive, file_metadata_ix, nullptr,
+                                                search_results, num_full_decodes_avoided);
+                }
+            } else if (is_superseding_query) {
                 auto file_metadata_ix = archive.get_file_iterator(search_begin_ts, search_end_ts, command_line_args.get_file_path());
-                num_matches = search_files(queries, command_line_args.get_output_method(), archive, *file_metadata_ix);
+                num_matches = search_files(queries, boolean_query, command_line_args.get_output_method(), archive, *file_metadata_ix, nullptr,
+                                           search_results, num_full_decodes_avoided);
             } else {
                 auto file_metadata_ix_ptr = archive.get_file_iterator(search_begin_ts, search_end_ts, command_line_args.get_file_path(), cInvalidSegmentId);
                 auto& file_metadata_ix = *file_metadata_ix_ptr;
-                num_matches = search_files(queries, command_line_args.get_output_method(), archive, file_metadata_ix);
-                for (auto segment_id : ids_of_segments_to_search) {
+                num_matches = search_files(queries, boolean_query, command_line_args.get_output_method(), archive, file_metadata_ix, nullptr,
+                                           search_results, num_full_decodes_avoided);
+                for (auto segment_id = ids_of_segments_to_search.find_next(0); segment_id < ids_of_segments_to_search.size();
+                     segment_id = ids_of_segments_to_search.find_next(segment_id + 1))
+                {
                     file_metadata_ix.set_segment_id(segment_id);
-                    num_matches += search_files(queries, command_line_args.get_output_method(), archive, file_metadata_ix);
+                    num_matches += search_files(queries, boolean_query, command_line_args.get_output_method(), archive, file_metadata_ix, nullptr,
+                                                search_results, num_full_decodes_avoided);
                 }
             }
+            if (nullptr != search_results.aggregates) {
+                search_results.aggregates->merge_archive_logtype_counts(archive.get_logtype_dictionary());
+            }
             SPDLOG_DEBUG("# matches found: {}", num_matches);
+            SPDLOG_DEBUG("# full message decodes avoided: {}", num_full_decodes_avoided);
         }
     } catch (TraceableException& e) {
         error_code = e.get_error_code();
@@ -204,6 +414,55 @@ static bool search (const vector<string>& search_strings, CommandLineArguments&
     return true;
 }
 
+static bool search_batch (QueryBatch& query_batch, CommandLineArguments& command_line_args, Archive& archive,
+                          compressor_frontend::lexers::ByteLexer& forward_lexer, compressor_frontend::lexers::ByteLexer& reverse_lexer,
+                          bool use_heuristic)
+{
+    auto search_begin_ts = command_line_args.get_search_begin_ts();
+    auto search_end_ts = command_line_args.get_search_end_ts();
+
+    try {
+        Profiler::reset_fragmented_measurement<Profiler::FragmentedMeasurementIndex::QueryPlanning>();
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::QueryPlanning>();
+        bool any_query_may_match = query_batch.process(archive, search_begin_ts, search_end_ts, command_line_args.ignore_case(), forward_lexer,
+                                                       reverse_lexer, use_heuristic);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::QueryPlanning>();
+        PROFILER_SPDLOG_INFO("Planning queries for {} took {} s", archive.get_path(),
+                             Profiler::get_fragmented_measurement_in_seconds<Profiler::FragmentedMeasurementIndex::QueryPlanning>())
+        if (false == any_query_may_match) {
+            return true;
+        }
+
+        size_t num_matches = 0;
+        size_t num_full_decodes_avoided = 0;
+        File compressed_file;
+        auto file_metadata_ix = archive.get_file_iterator(search_begin_ts, search_end_ts, command_line_args.get_file_path());
+        for (; file_metadata_ix->has_next() && false == query_batch.all_queries_complete(); file_metadata_ix->next()) {
+            if (open_compressed_file(*file_metadata_ix, archive, compressed_file)) {
+                if (command_line_args.aggregate()) {
+                    num_matches += query_batch.search_and_count(archive, compressed_file, num_full_decodes_avoided);
+                } else {
+                    num_matches += query_batch.search_and_output(archive, compressed_file, print_batch_result_text, nullptr,
+                                                                 num_full_decodes_avoided);
+                }
+            }
+            archive.close_file(compressed_file);
+        }
+        SPDLOG_DEBUG("# matches found: {}", num_matches);
+        SPDLOG_DEBUG("# full message decodes avoided: {}", num_full_decodes_avoided);
+    } catch (TraceableException& e) {
+        auto error_code = e.get_error_code();
+        if (ErrorCode_errno == error_code) {
+            SPDLOG_ERROR("Search failed: {}:{} {}, errno={}", e.get_filename(), e.get_line_number(), e.what(), errno);
+        } else {
+            SPDLOG_ERROR("Search failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(), error_code);
+        }
+        return false;
+    }
+
+    return true;
+}
+
 static bool open_compressed_file (MetadataDB::FileIterator& file_metadata_ix, Archive& archive, File& compressed_file) {
     ErrorCode error_code = archive.open_file(compressed_file, file_metadata_ix);
     if (ErrorCode_Success == error_code) {
@@ -221,8 +480,9 @@ static bool open_compressed_file (MetadataDB::FileIterator& file_metadata_ix, Ar
     return false;
 }
 
-static size_t search_files (vector<Query>& queries, const CommandLineArguments::OutputMethod output_method, Archive& archive,
-                            MetadataDB::FileIterator& file_metadata_ix)
+static size_t search_files (vector<Query>& queries, BooleanQuery* boolean_query, const CommandLineArguments::OutputMethod output_method,
+                            Archive& archive, MetadataDB::FileIterator& file_metadata_ix, const Bitmap* ids_of_segments_to_search,
+                            SearchResults& search_results, size_t& num_full_decodes_avoided)
 {
     size_t num_matches = 0;
 
@@ -230,28 +490,68 @@ static size_t search_files (vector<Query>& queries, const CommandLineArguments::
     // Setup output method
     Grep::OutputFunc output_func;
     void* output_func_arg;
-    switch (output_method) {
-        case CommandLineArguments::OutputMethod::StdoutText:
-            output_func = print_result_text;
-            output_func_arg = nullptr;
-            break;
-        case CommandLineArguments::OutputMethod::StdoutBinary:
-            output_func = print_result_binary;
-            output_func_arg = nullptr;
-            break;
-        default:
-            SPDLOG_ERROR("Unknown output method - {}", (char)output_method);
-            return num_matches;
+    auto latest_results = search_results.latest_results;
+    if (nullptr != latest_results) {
+        output_func = add_result_to_latest_results;
+        output_func_arg = latest_results;
+    } else if (get_output_func(output_method, output_func)) {
+        output_func_arg = nullptr;
+    } else {
+        return num_matches;
     }
 
     // Run all queries on each file
-    for (; file_metadata_ix.has_next(); file_metadata_ix.next()) {
-        if (open_compressed_file(file_metadata_ix, archive, compressed_file)) {
-            Grep::calculate_sub_queries_relevant_to_file(compressed_file, queries);
+    for (; file_metadata_ix.has_next() && search_results.num_results_remaining > 0; file_metadata_ix.next()) {
+        if (nullptr != latest_results && latest_results->is_full()) {
+            auto earliest_result_ts = latest_results->get_earliest_timestamp();
+            if (file_metadata_ix.get_end_ts() <= earliest_result_ts) {
+                // Files are in descending end-timestamp order, so none of the remaining files can contain a later result
+                break;
+            }
+            // Skip messages that can't replace any of the results already found
+            for (auto& query : queries) {
+                query.set_search_begin_timestamp(std::max(query.get_search_begin_timestamp(), earliest_result_ts + 1));
+            }
+            if (nullptr != boolean_query) {
+                boolean_query->set_search_begin_timestamp(std::max(boolean_query->get_search_begin_timestamp(), earliest_result_ts + 1));
+            }
+        }
+        if (nullptr != ids_of_segments_to_search) {
+            auto segment_id = file_metadata_ix.get_segment_id();
+            if (cInvalidSegmentId != segment_id && false == ids_of_segments_to_search->contains(segment_id)) {
+                continue;
+            }
+        }
 
-            for (const auto& query : queries) {
-                archive.reset_file_indices(compressed_file);
-                num_matches += Grep::search_and_output(query, SIZE_MAX, archive, compressed_file, output_func, output_func_arg);
+        if (open_compressed_file(file_metadata_ix, archive, compressed_file)) {
+            if (nullptr != boolean_query) {
+                if (nullptr != search_results.aggregates) {
+                    num_matches += boolean_query->search_and_aggregate(archive, compressed_file, add_result_to_aggregates, search_results.aggregates,
+                                                                       num_full_decodes_avoided);
+                } else {
+                    auto num_query_matches = boolean_query->search_and_output(search_results.num_results_remaining, archive, compressed_file,
+                                                                              output_func, output_func_arg, num_full_decodes_avoided);
+                    num_matches += num_query_matches;
+                    search_results.num_results_remaining -= num_query_matches;
+                }
+            } else {
+                Grep::calculate_sub_queries_relevant_to_file(compressed_file, queries);
+
+                for (const auto& query : queries) {
+                    archive.reset_file_indices(compressed_file);
+                    if (nullptr != search_results.aggregates) {
+                        num_matches += Grep::search_and_aggregate(query, archive, compressed_file, add_result_to_aggregates,
+                                                                  search_results.aggregates, num_full_decodes_avoided);
+                        continue;
+                    }
+                    auto num_query_matches = Grep::search_and_output(query, search_results.num_results_remaining, archive, compressed_file,
+                                                                     output_func, output_func_arg, num_full_decodes_avoided);
+                    num_matches += num_query_matches;
+                    search_results.num_results_remaining -= num_query_matches;
+                    if (0 == search_results.num_results_remaining) {
+                        break;
+                    }
+                }
             }
         }
         archive.close_file(compressed_file);
@@ -260,6 +560,20 @@ static size_t search_files (vector<Query>& queries, const CommandLineArguments::
     return num_matches;
 }
 
+static bool get_output_func (const CommandLineArguments::OutputMethod output_method, Grep::OutputFunc& output_func) {
+    switch (output_method) {
+        case CommandLineArguments::OutputMethod::StdoutText:
+            output_func = print_result_text;
+            return true;
+        case CommandLineArguments::OutputMethod::StdoutBinary:
+            output_func = print_result_binary;
+            return true;
+        default:
+            SPDLOG_ERROR("Unknown output method - {}", (char)output_method);
+            return false;
+    }
+}
+
 static void print_result_text (const string& orig_file_path, const Message& compressed_msg, const string& decompressed_msg, void* custom_arg) {
     printf("%s:%s", orig_file_path.c_str(), decompressed_msg.c_str());
 }
@@ -317,6 +631,22 @@ static void print_result_binary (const string& orig_file_path, const Message& co
     }
 }
 
+static void print_batch_result_text (const string& query_id, const string& orig_file_path, const Message& compressed_msg,
+                                     const string& decompressed_msg, void* custom_arg)
+{
+    printf("%s\t%s:%s", query_id.c_str(), orig_file_path.c_str(), decompressed_msg.c_str());
+}
+
+static void add_result_to_latest_results (const string& orig_file_path, const Message& compressed_msg, const string& decompressed_msg,
+                                          void* custom_arg)
+{
+    static_cast<LatestResults*>(custom_arg)->add(orig_file_path, compressed_msg, decompressed_msg);
+}
+
+static void add_result_to_aggregates (epochtime_t timestamp, logtype_dictionary_id_t logtype_id, void* custom_arg) {
+    static_cast<MatchAggregates*>(custom_arg)->add(timestamp, logtype_id);
+}
+
 int main (int argc, const char* argv[]) {
     // Program-wide initialization
     try {
@@ -360,6 +690,29 @@ int main (int argc, const char* argv[]) {
         file_reader.close();
     }
 
+    std::unique_ptr<BooleanQuery> boolean_query;
+    if (command_line_args.kql()) {
+        try {
+            boolean_query = std::make_unique<BooleanQuery>(command_line_args.get_search_string());
+        } catch (BooleanQuery::OperationFailed& e) {
+            SPDLOG_ERROR("Invalid KQL expression - {}", e.what());
+            return -1;
+        }
+    }
+
+    std::unique_ptr<QueryBatch> query_batch;
+    if (false == command_line_args.get_query_batch_file_path().empty()) {
+        FileReader file_reader;
+        file_reader.open(command_line_args.get_query_batch_file_path());
+        try {
+            query_batch = QueryBatch::parse(file_reader, command_line_args.get_max_num_results());
+        } catch (QueryBatch::OperationFailed& e) {
+            SPDLOG_ERROR("Invalid query batch {} - {}", command_line_args.get_query_batch_file_path(), e.what());
+            return -1;
+        }
+        file_reader.close();
+    }
+
     // Validate archives directory
     struct stat archives_dir_stat = {};
     auto archives_dir = std::filesystem::path(command_line_args.get_archives_dir());
@@ -390,6 +743,23 @@ int main (int argc, const char* argv[]) {
     }
     global_metadata_db->open();
 
+    // If every search string requires some dictionary variables, we can skip archives whose variable dictionary filter rules them out without
+    // loading the archives' dictionaries
+    // NOTE: Filters are case-sensitive, and KQL and batch queries aren't plain wildcard searches, so we only use filters for the latter
+    vector<vector<string>> dict_vars_required_by_search_strings;
+    bool use_var_dict_filters = (false == command_line_args.ignore_case() && nullptr == boolean_query && nullptr == query_batch);
+    if (use_var_dict_filters) {
+        for (const auto& search_string : search_strings) {
+            auto& dict_vars = dict_vars_required_by_search_strings.emplace_back();
+            Grep::get_dictionary_vars_required_by_query(search_string, dict_vars);
+            if (dict_vars.empty()) {
+                // The search string may match messages in any archive
+                use_var_dict_filters = false;
+                break;
+            }
+        }
+    }
+
     /// TODO: if performance is too slow, can make this more efficient by only diffing files with the same checksum
     const uint32_t max_map_schema_length = 100000;
     std::map<std::string, compressor_frontend::lexers::ByteLexer> forward_lexer_map;
@@ -401,75 +771,208 @@ int main (int argc, const char* argv[]) {
 
     string archive_id;
     Archive archive_reader;
-    for (auto archive_ix = std::unique_ptr<GlobalMetadataDB::ArchiveIterator>(get_archive_iterator(*global_metadata_db, command_line_args.get_file_path(), command_line_args.get_search_begin_ts(), command_line_args.get_search_end_ts()));
-            archive_ix->contains_element(); archive_ix->get_next())
-    {
-        archive_ix->get_id(archive_id);
-        auto archive_path = archives_dir / archive_id;
-
-        if (false == std::filesystem::exists(archive_path)) {
-            SPDLOG_WARN("Archive {} does not exist in '{}'.", archive_id, command_line_args.get_archives_dir());
-            continue;
-        }
+    // In follow mode, archives are kept open so that each pass only reads what's become searchable since the last one, until they're finalized
+    // and have been searched to the end
+    std::unordered_map<string, std::unique_ptr<FollowedArchive>> followed_archives;
+    std::unordered_set<string> finished_archive_ids;
+    vector<segment_id_t> new_segment_ids;
+    std::unique_ptr<LatestResults> latest_results;
+    if (command_line_args.get_num_latest_results() > 0) {
+        latest_results = std::make_unique<LatestResults>(command_line_args.get_num_latest_results());
+    }
+    std::unique_ptr<MatchAggregates> aggregates;
+    if (command_line_args.aggregate()) {
+        aggregates = std::make_unique<MatchAggregates>(command_line_args.count_by_logtype(), command_line_args.get_count_by_time_bucket_size());
+    }
+    SearchResults search_results = {command_line_args.get_max_num_results(), latest_results.get(), aggregates.get()};
+    while (true) {
+        auto archive_ix = std::unique_ptr<GlobalMetadataDB::ArchiveIterator>(
+                get_archive_iterator(*global_metadata_db, command_line_args.get_file_path(), command_line_args.get_search_begin_ts(),
+                                     command_line_args.get_search_end_ts(), nullptr != latest_results));
+        for (; archive_ix->contains_element() && search_results.num_results_remaining > 0; archive_ix->get_next()) {
+            if (nullptr != latest_results && latest_results->is_full() && archive_ix->get_end_ts() <= latest_results->get_earliest_timestamp()) {
+                // Archives are in descending end-timestamp order, so none of the remaining archives can contain a later result
+                break;
+            }
+
+            archive_ix->get_id(archive_id);
+            auto archive_path = archives_dir / archive_id;
+
+            // NOTE: The archive must be checked for finalization before it's refreshed, so that nothing added in between is missed
+            bool is_finalized = archive_ix->is_finalized();
+            if (command_line_args.follow()) {
+                if (finished_archive_ids.count(archive_id) > 0) {
+                    continue;
+                }
+                auto followed_archive_it = followed_archives.find(archive_id);
+                if (followed_archives.end() != followed_archive_it) {
+                    auto& followed_archive = *followed_archive_it->second;
+                    if (!refresh_archive(followed_archive.reader, new_segment_ids)) {
+                        return -1;
+                    }
+                    if (false == new_segment_ids.empty() &&
+                        !search(search_strings, boolean_query.get(), command_line_args, followed_archive.reader, *followed_archive.forward_lexer,
+                                *followed_archive.reverse_lexer, followed_archive.use_heuristic, &new_segment_ids, search_results))
+                    {
+                        return -1;
+                    }
+                    if (is_finalized) {
+                        followed_archive.reader.close();
+                        followed_archives.erase(followed_archive_it);
+                        finished_archive_ids.emplace(archive_id);
+                    }
+                    continue;
+                }
+            }
+
+            if (false == std::filesystem::exists(archive_path)) {
+                SPDLOG_WARN("Archive {} does not exist in '{}'.", archive_id, command_line_args.get_archives_dir());
+                continue;
+            }
+
+            // NOTE: The required dictionary variables were found using heuristics, so they don't apply to archives compressed with a schema
+            if (use_var_dict_filters && false == std::filesystem::exists(archive_path / streaming_archive::cSchemaFileName) &&
+                false == archive_may_contain_matches(archive_path.string(), dict_vars_required_by_search_strings))
+            {
+                Profiler::increment_counter<Profiler::CounterIndex::ArchivesSkippedByFilter>(1);
+                continue;
+            }
+
+            std::unique_ptr<FollowedArchive> followed_archive;
+            Archive* archive = &archive_reader;
+            if (command_line_args.follow()) {
+                followed_archive = std::make_unique<FollowedArchive>();
+                archive = &followed_archive->reader;
+            }
+
+            // Open archive
+            if (!open_archive(archive_path.string(), *archive)) {
+                return -1;
+            }
+
+            // Generate lexer if schema file exists
+            auto schema_file_path = archive_path / streaming_archive::cSchemaFileName;
+            bool use_heuristic = true;
+            if (std::filesystem::exists(schema_file_path)) {
+                use_heuristic = false;
+
+                char buf[max_map_schema_length];
+                FileReader file_reader;
+                file_reader.try_open(schema_file_path);
+
+                size_t num_bytes_read;
+                file_reader.read (buf, max_map_schema_length, num_bytes_read);
+                if(num_bytes_read < max_map_schema_length) {
+                    auto forward_lexer_map_it = forward_lexer_map.find(buf);
+                    auto reverse_lexer_map_it = reverse_lexer_map.find(buf);
+                    // if there is a chance there might be a difference make a new lexer as it's pretty fast to create
+                    if (forward_lexer_map_it == forward_lexer_map.end()) {
+                        // Create forward lexer
+                        auto insert_result = forward_lexer_map.emplace(buf, compressor_frontend::lexers::ByteLexer());
+                        forward_lexer_ptr = &insert_result.first->second;
+                        load_lexer_from_file(schema_file_path, false, *forward_lexer_ptr);
+
+                        // Create reverse lexer
+                        insert_result = reverse_lexer_map.emplace(buf, compressor_frontend::lexers::ByteLexer());
+                        reverse_lexer_ptr = &insert_result.first->second;
+                        load_lexer_from_file(schema_file_path, true, *reverse_lexer_ptr);
+                    } else {
+                        // load the lexers if they already exist
+                        forward_lexer_ptr = &forward_lexer_map_it->second;
+                        reverse_lexer_ptr = &reverse_lexer_map_it->second;
+                    }
+                } else {
+                    if (nullptr != followed_archive) {
+                        // The archive is searched again in later passes, so it needs lexers that won't be reloaded for other archives
+                        forward_lexer_ptr = &followed_archive->own_forward_lexer;
+                        reverse_lexer_ptr = &followed_archive->own_reverse_lexer;
+                    } else {
+                        forward_lexer_ptr = &one_time_use_forward_lexer;
+                        reverse_lexer_ptr = &one_time_use_reverse_lexer;
+                    }
 
-        // Open archive
-        if (!open_archive(archive_path.string(), archive_reader)) {
-            return -1;
-        }
-        
-        // Generate lexer if schema file exists
-        auto schema_file_path = archive_path / streaming_archive::cSchemaFileName;
-        bool use_heuristic = true;
-        if (std::filesystem::exists(schema_file_path)) {
-            use_heuristic = false;
-
-            char buf[max_map_schema_length];
-            FileReader file_reader;
-            file_reader.try_open(schema_file_path);
-
-            size_t num_bytes_read;
-            file_reader.read (buf, max_map_schema_length, num_bytes_read);
-            if(num_bytes_read < max_map_schema_length) {
-                auto forward_lexer_map_it = forward_lexer_map.find(buf);
-                auto reverse_lexer_map_it = reverse_lexer_map.find(buf);
-                // if there is a chance there might be a difference make a new lexer as it's pretty fast to create
-                if (forward_lexer_map_it == forward_lexer_map.end()) {
                     // Create forward lexer
-                    auto insert_result = forward_lexer_map.emplace(buf, compressor_frontend::lexers::ByteLexer());
-                    forward_lexer_ptr = &insert_result.first->second;
                     load_lexer_from_file(schema_file_path, false, *forward_lexer_ptr);
 
                     // Create reverse lexer
-                    insert_result = reverse_lexer_map.emplace(buf, compressor_frontend::lexers::ByteLexer());
-                    reverse_lexer_ptr = &insert_result.first->second;
-                    load_lexer_from_file(schema_file_path, true, *reverse_lexer_ptr);
+                    load_lexer_from_file(schema_file_path, false, *reverse_lexer_ptr);
+                }
+            }
+
+            // Perform search
+            if (command_line_args.follow()) {
+                followed_archive->forward_lexer = forward_lexer_ptr;
+                followed_archive->reverse_lexer = reverse_lexer_ptr;
+                followed_archive->use_heuristic = use_heuristic;
+                if (!refresh_archive(*archive, new_segment_ids)) {
+                    return -1;
+                }
+                if (!search(search_strings, boolean_query.get(), command_line_args, *archive, *forward_lexer_ptr, *reverse_lexer_ptr, use_heuristic,
+                            &new_segment_ids, search_results))
+                {
+                    return -1;
+                }
+                if (is_finalized) {
+                    archive->close();
+                    finished_archive_ids.emplace(archive_id);
                 } else {
-                    // load the lexers if they already exist
-                    forward_lexer_ptr = &forward_lexer_map_it->second;
-                    reverse_lexer_ptr = &reverse_lexer_map_it->second;
+                    followed_archives.emplace(archive_id, std::move(followed_archive));
+                }
+            } else if (nullptr != query_batch) {
+                if (!search_batch(*query_batch, command_line_args, archive_reader, *forward_lexer_ptr, *reverse_lexer_ptr, use_heuristic)) {
+                    return -1;
+                }
+                archive_reader.close();
+                if (query_batch->all_queries_complete()) {
+                    break;
                 }
             } else {
-                // Create forward lexer
-                forward_lexer_ptr = &one_time_use_forward_lexer;
-                load_lexer_from_file(schema_file_path, false, one_time_use_forward_lexer);
-
-                // Create reverse lexer
-                reverse_lexer_ptr = &one_time_use_reverse_lexer;
-                load_lexer_from_file(schema_file_path, false, one_time_use_reverse_lexer);
+                if (!search(search_strings, boolean_query.get(), command_line_args, archive_reader, *forward_lexer_ptr, *reverse_lexer_ptr,
+                            use_heuristic, nullptr, search_results))
+                {
+                    return -1;
+                }
+                archive_reader.close();
             }
         }
+        // NOTE: The iterator must be released before sleeping so that it doesn't hold the metadata DB open while archives are updated
+        archive_ix.reset();
 
-        // Perform search
-        if (!search(search_strings, command_line_args, archive_reader, *forward_lexer_ptr, *reverse_lexer_ptr, use_heuristic)) {
-            return -1;
+        if (false == command_line_args.follow() || 0 == search_results.num_results_remaining) {
+            break;
         }
-        archive_reader.close();
+        fflush(stdout);
+        std::this_thread::sleep_for(cFollowPollInterval);
     }
 
     global_metadata_db->close();
 
+    if (nullptr != latest_results) {
+        Grep::OutputFunc output_func;
+        if (false == get_output_func(command_line_args.get_output_method(), output_func)) {
+            return -1;
+        }
+        latest_results->output_and_clear(output_func, nullptr);
+    }
+    if (nullptr != query_batch && command_line_args.aggregate()) {
+        for (size_t query_ix = 0; query_ix < query_batch->get_num_queries(); ++query_ix) {
+            printf("%s\t%zu\n", query_batch->get_query_id(query_ix).c_str(), query_batch->get_num_results(query_ix));
+        }
+    } else if (nullptr != aggregates) {
+        aggregates->print();
+    }
+
     Profiler::stop_continuous_measurement<Profiler::ContinuousMeasurementIndex::Search>();
     LOG_CONTINUOUS_MEASUREMENT(Profiler::ContinuousMeasurementIndex::Search)
+    if (false == command_line_args.get_profile_output_path().empty()) {
+        try {
+            Profiler::write_report(command_line_args.get_profile_output_path());
+        } catch (TraceableException& e) {
+            SPDLOG_ERROR("Failed to write profile report to {}: {}:{} {}, errno={}", command_line_args.get_profile_output_path(),
+                         e.get_filename(), e.get_line_number(), e.what(), errno);
+            return -1;
+        }
+    }
 
     return 0;
 }
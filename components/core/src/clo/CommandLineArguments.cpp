@@ -45,6 +45,9 @@ namespace clo {
                 ("version,V", "Print version")
                 ("config-file", po::value<string>(&config_file_path)->value_name("FILE")->default_value(config_file_path),
                  "Use configuration options from FILE")
+                ("profile-output", po::value<string>(&m_profile_output_path)->value_name("FILE"),
+                        "Write a JSON report of the time spent in each phase and of other profiling counters to FILE (requires a build with"
+                        " profiling enabled)")
                 ;
 
         // Define match controls
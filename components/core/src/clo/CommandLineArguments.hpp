@@ -30,6 +30,7 @@ namespace clo {
         const std::string& get_file_path () const { return m_file_path; }
         epochtime_t get_search_begin_ts () const { return m_search_begin_ts; }
         epochtime_t get_search_end_ts () const { return m_search_end_ts; }
+        const std::string& get_profile_output_path () const { return m_profile_output_path; }
 
     private:
         // Methods
@@ -43,6 +44,7 @@ namespace clo {
         std::string m_search_string;
         std::string m_file_path;
         epochtime_t m_search_begin_ts, m_search_end_ts;
+        std::string m_profile_output_path;
     };
 }
 
@@ -15,6 +15,8 @@
 #include <spdlog/sinks/stdout_sinks.h>
 
 // Project headers
+#include "../Bitmap.hpp"
+#include "../BloomFilter.hpp"
 #include "../Defs.h"
 #include "../compressor_frontend/utils.hpp"
 #include "../Grep.hpp"
@@ -78,6 +80,14 @@ static ErrorCode send_result (const string& orig_file_path, const Message& compr
  */
 static SearchFilesResult search_files (Query& query, Archive& archive, MetadataDB::FileIterator& file_metadata_ix,
                                        const std::atomic_bool& query_cancelled, int controller_socket_fd);
+/**
+ * Checks the archive's variable dictionary filter for the given dictionary variables
+ * @param archive_path
+ * @param dict_vars
+ * @return false if the filter rules out that the archive contains one of the dictionary variables, true otherwise (including when the filter
+ * doesn't exist or can't be read)
+ */
+static bool archive_may_contain_dict_vars (const string& archive_path, const vector<string>& dict_vars);
 /**
  * Searches an archive with the given path
  * @param command_line_args
@@ -188,6 +198,27 @@ static SearchFilesResult search_files (Query& query, Archive& archive, MetadataD
     return result;
 }
 
+static bool archive_may_contain_dict_vars (const string& archive_path, const vector<string>& dict_vars) {
+    BloomFilter filter;
+    try {
+        if (false == Archive::read_var_dict_filter(archive_path, filter)) {
+            return true;
+        }
+    } catch (TraceableException& e) {
+        // The filter is only an optimization, so search the archive as usual
+        SPDLOG_WARN("Reading variable dictionary filter failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(),
+                    e.get_error_code());
+        return true;
+    }
+
+    for (const auto& dict_var : dict_vars) {
+        if (false == filter.possibly_contains(BloomFilter::hash(dict_var))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static bool search_archive (const CommandLineArguments& command_line_args, const boost::filesystem::path& archive_path,
                             const std::atomic_bool& query_cancelled, int controller_socket_fd)
 {
@@ -217,6 +248,17 @@ static bool search_archive (const CommandLineArguments& command_line_args, const
         load_lexer_from_file(schema_file_path.string(), true, *reverse_lexer);
     }
 
+    // Skip the archive without loading its dictionaries if its variable dictionary filter rules out a dictionary variable the query requires
+    // NOTE: The required dictionary variables are found using heuristics, and the filter is case-sensitive
+    if (use_heuristic && false == command_line_args.ignore_case()) {
+        vector<string> required_dict_vars;
+        Grep::get_dictionary_vars_required_by_query(command_line_args.get_search_string(), required_dict_vars);
+        if (false == required_dict_vars.empty() && false == archive_may_contain_dict_vars(archive_path.string(), required_dict_vars)) {
+            Profiler::increment_counter<Profiler::CounterIndex::ArchivesSkippedByFilter>(1);
+            return true;
+        }
+    }
+
     Archive archive_reader;
     archive_reader.open(archive_path.string());
     archive_reader.refresh_dictionaries();
@@ -233,17 +275,18 @@ static bool search_archive (const CommandLineArguments& command_line_args, const
     }
 
     // Get all segments potentially containing query results
-    std::set<segment_id_t> ids_of_segments_to_search;
+    Bitmap ids_of_segments_to_search;
     for (auto& sub_query : query.get_sub_queries()) {
-        auto& ids_of_matching_segments = sub_query.get_ids_of_matching_segments();
-        ids_of_segments_to_search.insert(ids_of_matching_segments.cbegin(), ids_of_matching_segments.cend());
+        ids_of_segments_to_search |= sub_query.get_ids_of_matching_segments();
     }
 
     // Search segments
     auto file_metadata_ix_ptr = archive_reader.get_file_iterator(search_begin_ts, search_end_ts,
                                                                  command_line_args.get_file_path(), cInvalidSegmentId);
     auto& file_metadata_ix = *file_metadata_ix_ptr;
-    for (auto segment_id : ids_of_segments_to_search) {
+    for (auto segment_id = ids_of_segments_to_search.find_next(0); segment_id < ids_of_segments_to_search.size();
+         segment_id = ids_of_segments_to_search.find_next(segment_id + 1))
+    {
         file_metadata_ix.set_segment_id(segment_id);
         auto result = search_files(query, archive_reader, file_metadata_ix, query_cancelled, controller_socket_fd);
         if (SearchFilesResult::ResultSendFailure == result) {
@@ -335,5 +378,15 @@ int main (int argc, const char* argv[]) {
         return_value = -1;
     }
 
+    if (false == command_line_args.get_profile_output_path().empty()) {
+        try {
+            Profiler::write_report(command_line_args.get_profile_output_path());
+        } catch (TraceableException& e) {
+            SPDLOG_ERROR("Failed to write profile report to {}: {}:{} {}, errno={}", command_line_args.get_profile_output_path(),
+                         e.get_filename(), e.get_line_number(), e.what(), errno);
+            return_value = -1;
+        }
+    }
+
     return return_value;
 }
@@ -1,6 +1,7 @@
 #include "CommandLineArguments.hpp"
 
 // C++ standard libraries
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -51,6 +52,9 @@ namespace clp {
                 ("db-config-file",
                         po::value<string>(&global_metadata_db_config_file_path)->value_name("FILE")->default_value(global_metadata_db_config_file_path),
                         "Global metadata DB YAML config")
+                ("profile-output", po::value<string>(&m_profile_output_path)->value_name("FILE"),
+                        "Write a JSON report of the time spent in each phase and of other profiling counters to FILE (requires a build with"
+                        " profiling enabled)")
                 ;
 
         // Define functional options
@@ -131,8 +135,10 @@ namespace clp {
                     cerr << "COMMAND is one of:" << endl;
                     cerr << "  c - compress" << endl;
                     cerr << "  x - extract" << endl;
+                    cerr << "  i - ingest IR streams from a socket" << endl;
                     cerr << endl;
-                    cerr << "Try " << get_program_name() << " c --help OR " << get_program_name() << " x --help for command-specific details." << endl;
+                    cerr << "Try " << get_program_name() << " c --help OR " << get_program_name() << " x --help OR " << get_program_name()
+                         << " i --help for command-specific details." << endl;
                     cerr << endl;
 
                     cerr << "Options can be specified on the command line or through a configuration file." << endl;
@@ -145,9 +151,34 @@ namespace clp {
 
                 throw invalid_argument("COMMAND not specified.");
             }
+            // Define options shared by commands that create archives
+            po::options_description options_archive;
+            options_archive.add_options()
+                    ("target-encoded-file-size",
+                     po::value<size_t>(&m_target_encoded_file_size)->value_name("SIZE")->default_value(m_target_encoded_file_size),
+                            "Target size (B) for an encoded file before a new one is created")
+                    ("target-segment-size",
+                     po::value<size_t>(&m_target_segment_uncompressed_size)->value_name("SIZE")->default_value(m_target_segment_uncompressed_size),
+                            "Target uncompressed size (B) of a segment before a new one is created")
+                    ("target-dictionaries-size",
+                     po::value<size_t>(&m_target_data_size_of_dictionaries)->value_name("SIZE")->default_value(m_target_data_size_of_dictionaries),
+                            "Target size (B) for the dictionaries before a new archive is created")
+                    ("memory-budget", po::value<size_t>(&m_memory_budget)->value_name("SIZE")->default_value(m_memory_budget),
+                            "Approximate memory (B) the dictionaries and encoded files may use before buffered files are flushed to segments and"
+                            " dictionary entries are spilled to disk (0 means unlimited). Also caps target-encoded-file-size at a quarter of SIZE.")
+                    ("huge-pages-for-columns", po::bool_switch(&m_use_huge_pages_for_columns),
+                            "Back the buffers that encoded files' columns are written into with transparent huge pages. This can reduce page faults"
+                            " but may increase memory usage by up to 2 MiB per column of each buffered file.")
+                    ("compression-level", po::value<int>(&m_compression_level)->value_name("LEVEL")->default_value(m_compression_level),
+                            "1 (fast/low compression) to 9 (slow/high compression)")
+                    ("print-archive-stats-progress", po::bool_switch(&m_print_archive_stats_progress), "Print statistics (ndjson) about each archive as "
+                                                                                                       "it's compressed")
+                    ;
+
             switch (command_input) {
                 case (char)Command::Compress:
                 case (char)Command::Extract:
+                case (char)Command::Ingest:
                     m_command = (Command)command_input;
                     break;
                 default:
@@ -218,19 +249,12 @@ namespace clp {
                 options_compression.add_options()
                         ("remove-path-prefix", po::value<string>(&m_path_prefix_to_remove)->value_name("DIR")->default_value(m_path_prefix_to_remove),
                                 "Remove the given path prefix from each compressed file/dir.")
-                        ("target-encoded-file-size",
-                         po::value<size_t>(&m_target_encoded_file_size)->value_name("SIZE")->default_value(m_target_encoded_file_size),
-                                "Target size (B) for an encoded file before a new one is created")
-                        ("target-segment-size",
-                         po::value<size_t>(&m_target_segment_uncompressed_size)->value_name("SIZE")->default_value(m_target_segment_uncompressed_size),
-                                "Target uncompressed size (B) of a segment before a new one is created")
-                        ("target-dictionaries-size",
-                         po::value<size_t>(&m_target_data_size_of_dictionaries)->value_name("SIZE")->default_value(m_target_data_size_of_dictionaries),
-                                "Target size (B) for the dictionaries before a new archive is created")
-                        ("compression-level", po::value<int>(&m_compression_level)->value_name("LEVEL")->default_value(m_compression_level),
-                                "1 (fast/low compression) to 9 (slow/high compression)")
-                        ("print-archive-stats-progress", po::bool_switch(&m_print_archive_stats_progress), "Print statistics (ndjson) about each archive as "
-                                                                                                           "it's compressed")
+                        ;
+                options_compression.add(options_archive);
+                options_compression.add_options()
+                        ("segment-packing-window-size",
+                         po::value<size_t>(&m_segment_packing_window_size)->value_name("SIZE")->default_value(m_segment_packing_window_size),
+                                "Encoded size (B) of files to buffer so they can be grouped into segments by similarity (0 disables grouping)")
                         ("progress", po::bool_switch(&m_show_progress), "Show progress during compression")
                         ("schema-path", po::value<string>(&m_schema_file_path)->value_name("FILE")->default_value(m_schema_file_path),
                          "Path to a schema file. If not specified, heuristics are used to determine dictionary variables. See README-Schema.md for details.")
@@ -270,18 +294,6 @@ namespace clp {
                     throw invalid_argument("No input paths specified.");
                 }
 
-                if (m_target_encoded_file_size < 1) {
-                    throw invalid_argument("target-encoded-file-size must be non-zero.");
-                }
-
-                if (m_target_segment_uncompressed_size < 1) {
-                    throw invalid_argument("segment-size-threshold must be non-zero.");
-                }
-
-                if (m_target_data_size_of_dictionaries < 1) {
-                    throw invalid_argument("target-data-size-of-dictionaries must be non-zero.");
-                }
-
                 if (false == m_path_prefix_to_remove.empty()) {
                     if (false == boost::filesystem::exists(m_path_prefix_to_remove)) {
                         throw invalid_argument("Specified prefix to remove does not exist.");
@@ -299,6 +311,86 @@ namespace clp {
                         throw invalid_argument("Specified schema file '" +  m_schema_file_path + "' is not a regular file.");
                     }
                 }
+            } else if (Command::Ingest == m_command) {
+                // Define ingestion hidden positional options
+                po::options_description ingestion_positional_options;
+                ingestion_positional_options.add_options()
+                        ("output-dir", po::value<string>(&m_output_dir))
+                        ("socket-path", po::value<string>(&m_socket_path))
+                        ;
+                po::positional_options_description ingestion_positional_options_description;
+                ingestion_positional_options_description.add("output-dir", 1);
+                ingestion_positional_options_description.add("socket-path", 1);
+
+                // Define ingestion-specific options
+                po::options_description options_ingestion("Ingestion Options");
+                options_ingestion.add(options_archive);
+                options_ingestion.add_options()
+                        ("archive-roll-interval",
+                         po::value<size_t>(&m_archive_roll_interval)->value_name("SECONDS")->default_value(m_archive_roll_interval),
+                                "Maximum time (s) an archive stays open before a new one is created (0 disables time-based rolling)")
+                        ("publish-interval",
+                         po::value<size_t>(&m_publish_interval)->value_name("SECONDS")->default_value(m_publish_interval),
+                                "Maximum time (s) before ingested events become searchable in the open archive (0 means only once the archive"
+                                " is closed)")
+                        ;
+
+                po::options_description all_ingestion_options;
+                all_ingestion_options.add(options_ingestion);
+                all_ingestion_options.add(ingestion_positional_options);
+
+                vector<string> unrecognized_options = po::collect_unrecognized(parsed.options, po::include_positional);
+                unrecognized_options.erase(unrecognized_options.begin());
+                po::store(po::command_line_parser(unrecognized_options)
+                        .options(all_ingestion_options)
+                        .positional(ingestion_positional_options_description)
+                        .run(), parsed_command_line_options);
+
+                notify(parsed_command_line_options);
+
+                // Handle --help
+                if (parsed_command_line_options.count("help")) {
+                    print_ingestion_basic_usage();
+
+                    cerr << "Examples:" << endl;
+                    cerr << "  # Compress IR streams sent to /tmp/clp.sock into the output dir, starting a new archive every hour" << endl;
+                    cerr << "  " << get_program_name() << " i --archive-roll-interval 3600 output-dir /tmp/clp.sock" << endl;
+                    cerr << endl;
+
+                    cerr << "  # Compress IR streams sent to /tmp/clp.sock into the output dir, making events searchable (e.g., by clg --follow)"
+                            " within 10 seconds" << endl;
+                    cerr << "  " << get_program_name() << " i --publish-interval 10 output-dir /tmp/clp.sock" << endl;
+                    cerr << endl;
+
+                    po::options_description visible_options;
+                    visible_options.add(options_general);
+                    visible_options.add(options_ingestion);
+                    cerr << visible_options << endl;
+                    return ParsingResult::InfoCommand;
+                }
+
+                if (m_socket_path.empty()) {
+                    throw invalid_argument("socket-path not specified or empty.");
+                }
+            }
+
+            if (Command::Extract != m_command) {
+                if (m_target_encoded_file_size < 1) {
+                    throw invalid_argument("target-encoded-file-size must be non-zero.");
+                }
+
+                // The open file's columns can't be flushed until it's closed, so limit its size to leave room in the budget for everything else
+                if (m_memory_budget > 0) {
+                    m_target_encoded_file_size = std::max<size_t>(std::min(m_target_encoded_file_size, m_memory_budget / 4), 1);
+                }
+
+                if (m_target_segment_uncompressed_size < 1) {
+                    throw invalid_argument("segment-size-threshold must be non-zero.");
+                }
+
+                if (m_target_data_size_of_dictionaries < 1) {
+                    throw invalid_argument("target-data-size-of-dictionaries must be non-zero.");
+                }
             }
 
             // Validate an output directory was specified
@@ -330,4 +422,8 @@ namespace clp {
     void CommandLineArguments::print_extraction_basic_usage () const {
         cerr << "Usage: " << get_program_name() << " [OPTIONS] x ARCHIVES_DIR OUTPUT_DIR [FILE ...]" << endl;
     }
+
+    void CommandLineArguments::print_ingestion_basic_usage () const {
+        cerr << "Usage: " << get_program_name() << " [OPTIONS] i OUTPUT_DIR SOCKET_PATH" << endl;
+    }
 }
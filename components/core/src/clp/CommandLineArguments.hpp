@@ -19,12 +19,15 @@ namespace clp {
         enum class Command : char {
             Compress = 'c',
             Extract = 'x',
+            Ingest = 'i',
         };
 
         // Constructors
         explicit CommandLineArguments (const std::string& program_name) : CommandLineArgumentsBase(program_name), m_show_progress(false),
                 m_print_archive_stats_progress(false), m_target_segment_uncompressed_size(1L * 1024 * 1024 * 1024),
-                m_target_encoded_file_size(512L * 1024 * 1024), m_target_data_size_of_dictionaries(100L * 1024 * 1024), m_compression_level(3) {}
+                m_target_encoded_file_size(512L * 1024 * 1024), m_target_data_size_of_dictionaries(100L * 1024 * 1024),
+                m_segment_packing_window_size(0), m_memory_budget(0), m_use_huge_pages_for_columns(false), m_compression_level(3),
+                m_archive_roll_interval(0), m_publish_interval(0) {}
 
         // Methods
         ParsingResult parse_arguments (int argc, const char* argv[]) override;
@@ -39,17 +42,25 @@ namespace clp {
         size_t get_target_encoded_file_size () const { return m_target_encoded_file_size; }
         size_t get_target_segment_uncompressed_size () const { return m_target_segment_uncompressed_size; }
         size_t get_target_data_size_of_dictionaries () const { return m_target_data_size_of_dictionaries; }
+        size_t get_segment_packing_window_size () const { return m_segment_packing_window_size; }
+        size_t get_memory_budget () const { return m_memory_budget; }
+        bool use_huge_pages_for_columns () const { return m_use_huge_pages_for_columns; }
         int get_compression_level () const { return m_compression_level; }
+        const std::string& get_socket_path () const { return m_socket_path; }
+        size_t get_archive_roll_interval () const { return m_archive_roll_interval; }
+        size_t get_publish_interval () const { return m_publish_interval; }
         Command get_command () const { return m_command; }
         const std::string& get_archives_dir () const { return m_archives_dir; }
         const std::vector<std::string>& get_input_paths () const { return m_input_paths; }
         const GlobalMetadataDBConfig& get_metadata_db_config () const { return m_metadata_db_config; }
+        const std::string& get_profile_output_path () const { return m_profile_output_path; }
 
     private:
         // Methods
         void print_basic_usage () const override;
         void print_compression_basic_usage () const;
         void print_extraction_basic_usage () const;
+        void print_ingestion_basic_usage () const;
 
         // Variables
         std::string m_path_list_path;
@@ -61,11 +72,18 @@ namespace clp {
         size_t m_target_encoded_file_size;
         size_t m_target_segment_uncompressed_size;
         size_t m_target_data_size_of_dictionaries;
+        size_t m_segment_packing_window_size;
+        size_t m_memory_budget;
+        bool m_use_huge_pages_for_columns;
         int m_compression_level;
+        std::string m_socket_path;
+        size_t m_archive_roll_interval;
+        size_t m_publish_interval;
         Command m_command;
         std::string m_archives_dir;
         std::vector<std::string> m_input_paths;
         GlobalMetadataDBConfig m_metadata_db_config;
+        std::string m_profile_output_path;
     };
 }
 
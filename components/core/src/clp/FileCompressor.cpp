@@ -26,6 +26,9 @@ using std::set;
 using std::string;
 using std::vector;
 
+// Number of data blocks libarchive decompresses ahead of the parser when compressing files within an archive or compressed file
+static constexpr size_t cNumPrefetchedDataBlocks = 4;
+
 // Local prototypes
 /**
  * Computes empty directories as directories - parent_directories and adds them to the given archive
@@ -187,7 +190,9 @@ namespace clp {
         archive_writer.create_and_open_file(path_for_compression, group_id, m_uuid_generator(), 0);
 
         // Parse content from file
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
         while (m_message_parser.parse_next_message(true, reader, m_parsed_message)) {
+            Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
             if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dicts) {
                 split_file_and_archive(archive_user_config, path_for_compression, group_id, m_parsed_message.get_ts_patt(), archive_writer);
             } else if (archive_writer.get_file().get_encoded_size_in_bytes() >= target_encoded_file_size) {
@@ -195,7 +200,9 @@ namespace clp {
             }
 
             write_message_to_encoded_file(m_parsed_message, archive_writer);
+            Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
         }
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
 
         close_file_and_append_to_segment(archive_writer);
     }
@@ -263,7 +270,9 @@ namespace clp {
                 split_archive(archive_user_config, archive_writer);
             }
 
-            m_libarchive_reader.open_file_reader(m_libarchive_file_reader);
+            // NOTE: The archive can't be accessed while its data blocks are being prefetched, so the path is retrieved before the entry is opened
+            string file_path{m_libarchive_reader.get_path()};
+            m_libarchive_reader.open_file_reader(m_libarchive_file_reader, cNumPrefetchedDataBlocks);
 
             // Check that file is UTF-8 encoded
             if (auto error_code = m_libarchive_file_reader.try_load_data_block();
@@ -284,7 +293,6 @@ namespace clp {
                     utf8_validation_buf,
                     utf8_validation_buf_len
             );
-            string file_path{m_libarchive_reader.get_path()};
             if (is_utf8_sequence(utf8_validation_buf_len, utf8_validation_buf)) {
                 auto boost_path_for_compression = parent_boost_path / file_path;
                 if (use_heuristic) {
@@ -432,10 +440,10 @@ namespace clp {
         archive.change_ts_pattern(&timestamp_pattern);
 
         std::error_code error_code{};
+        // NOTE: The event is reused so that its buffers are only allocated once
+        ir::LogEvent<encoded_variable_t> log_event;
         while (true) {
-            auto result = log_event_deserializer.deserialize_log_event();
-            if (result.has_error()) {
-                auto error = result.error();
+            if (auto error = log_event_deserializer.deserialize_log_event(log_event); error) {
                 if (std::errc::no_message_available != error) {
                     error_code = error;
                 }
@@ -455,7 +463,7 @@ namespace clp {
                 split_file(path, group_id, &timestamp_pattern, archive);
             }
 
-            archive.write_log_event_ir(result.value());
+            archive.write_log_event_ir(log_event);
         }
 
         close_file_and_append_to_segment(archive);
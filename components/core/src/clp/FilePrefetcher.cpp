@@ -0,0 +1,151 @@
+#include "FilePrefetcher.hpp"
+
+// C libraries
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// C++ standard libraries
+#include <algorithm>
+
+// Project headers
+#include "../Platform.hpp"
+#include "../spdlog_with_specializations.hpp"
+
+// Define a posix_fadvise shim for compilation (just compilation) on macOS
+#if defined(__APPLE__) || defined(__MACH__)
+#define POSIX_FADV_WILLNEED 3
+int posix_fadvise (int fd, off_t offset, off_t len, int advice);
+#endif
+
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::unique_lock;
+using std::vector;
+
+namespace clp {
+    FilePrefetcher::~FilePrefetcher () {
+        if (false == m_is_open) {
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_state_changed.notify_all();
+        // NOTE: We must join here rather than in Thread's destructor since the thread uses this object's members
+        try {
+            join();
+        } catch (const Thread::OperationFailed& e) {
+            SPDLOG_ERROR("clp::FilePrefetcher: Failed to join thread - {}", e.what());
+        }
+    }
+
+    void FilePrefetcher::open (vector<string> paths, size_t max_num_files_ahead, size_t max_num_bytes_ahead) {
+        if (m_is_open) {
+            throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+        }
+
+        m_paths = std::move(paths);
+        m_max_num_files_ahead = max_num_files_ahead;
+        m_max_num_bytes_ahead = max_num_bytes_ahead;
+        m_num_files_consumed = 0;
+        m_num_files_prefetched = 0;
+        m_num_bytes_prefetched.assign(m_paths.size(), 0);
+        m_num_bytes_ahead = 0;
+        m_stop = false;
+
+        start();
+        m_is_open = true;
+    }
+
+    void FilePrefetcher::close () {
+        if (false == m_is_open) {
+            throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_state_changed.notify_all();
+        join();
+        m_is_open = false;
+
+        m_paths.clear();
+        m_num_bytes_prefetched.clear();
+    }
+
+    void FilePrefetcher::mark_next_file_consumed () {
+        if (false == m_is_open) {
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            if (m_num_files_consumed < m_num_files_prefetched) {
+                m_num_bytes_ahead -= m_num_bytes_prefetched[m_num_files_consumed];
+            }
+            ++m_num_files_consumed;
+        }
+        m_state_changed.notify_all();
+    }
+
+    void FilePrefetcher::thread_method () {
+        unique_lock<mutex> lock(m_mutex);
+        while (true) {
+            m_state_changed.wait(lock, [this] {
+                return m_stop || m_num_files_prefetched >= m_paths.size() || m_num_files_prefetched < m_num_files_consumed ||
+                       (m_num_files_prefetched - m_num_files_consumed < m_max_num_files_ahead && m_num_bytes_ahead < m_max_num_bytes_ahead);
+            });
+            if (m_stop) {
+                break;
+            }
+
+            // Skip any files the consumer has already reached
+            m_num_files_prefetched = std::max(m_num_files_prefetched, m_num_files_consumed);
+            if (m_num_files_prefetched >= m_paths.size()) {
+                break;
+            }
+
+            auto file_ix = m_num_files_prefetched;
+            auto max_num_bytes = m_max_num_bytes_ahead - m_num_bytes_ahead;
+            lock.unlock();
+            auto num_bytes = prefetch(m_paths[file_ix], max_num_bytes);
+            lock.lock();
+
+            // NOTE: If the consumer reached the file while it was being prefetched, it's no longer ahead
+            if (file_ix >= m_num_files_consumed) {
+                m_num_bytes_prefetched[file_ix] = num_bytes;
+                m_num_bytes_ahead += num_bytes;
+            }
+            ++m_num_files_prefetched;
+        }
+    }
+
+    size_t FilePrefetcher::prefetch (const string& path, size_t max_num_bytes) {
+        auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (-1 == fd) {
+            return 0;
+        }
+
+        size_t num_bytes = 0;
+        struct stat stat_buf = {};
+        if (0 == fstat(fd, &stat_buf)) {
+            num_bytes = std::min(static_cast<size_t>(stat_buf.st_size), max_num_bytes);
+        }
+        if constexpr (Platform::Linux == cCurrentPlatform) {
+            // NOTE: The kernel reads the range asynchronously, so this doesn't block until the file has been read
+            if (num_bytes > 0 && 0 != posix_fadvise(fd, 0, static_cast<off_t>(num_bytes), POSIX_FADV_WILLNEED)) {
+                num_bytes = 0;
+            }
+        } else {
+            num_bytes = 0;
+        }
+        ::close(fd);
+
+        return num_bytes;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef CLP_FILEPREFETCHER_HPP
+#define CLP_FILEPREFETCHER_HPP
+
+// C++ standard libraries
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Project headers
+#include "../Thread.hpp"
+#include "../TraceableException.hpp"
+
+namespace clp {
+    /**
+     * A thread that asks the kernel to read the files that will be compressed next into the page cache, so that opening and reading them doesn't
+     * stall the compression thread. Files are prefetched in the order they'll be compressed, while staying within a bounded number of files and
+     * bytes ahead of the compression thread (so that prefetched files aren't evicted before they're read).
+     *
+     * Prefetching is best-effort: files that can't be opened are skipped so the compression thread can report the error when it opens them.
+     */
+    class FilePrefetcher : public Thread {
+    public:
+        // Types
+        class OperationFailed : public TraceableException {
+        public:
+            // Constructors
+            OperationFailed (ErrorCode error_code, const char* const filename, int line_number) :
+                    TraceableException(error_code, filename, line_number) {}
+
+            // Methods
+            const char* what () const noexcept override {
+                return "clp::FilePrefetcher operation failed";
+            }
+        };
+
+        // Constructors
+        FilePrefetcher () : m_max_num_files_ahead(0), m_max_num_bytes_ahead(0), m_is_open(false), m_num_files_consumed(0), m_num_files_prefetched(0),
+                            m_num_bytes_ahead(0), m_stop(false) {}
+
+        // Destructor
+        ~FilePrefetcher () override;
+
+        // Methods
+        /**
+         * Starts prefetching the given files
+         * @param paths Paths of the files in the order they'll be consumed
+         * @param max_num_files_ahead
+         * @param max_num_bytes_ahead
+         * @throw FilePrefetcher::OperationFailed if the prefetcher is already open
+         * @throw Same as Thread::start
+         */
+        void open (std::vector<std::string> paths, size_t max_num_files_ahead, size_t max_num_bytes_ahead);
+        /**
+         * Stops prefetching
+         * @throw FilePrefetcher::OperationFailed if the prefetcher isn't open
+         * @throw Same as Thread::join
+         */
+        void close ();
+
+        /**
+         * Indicates that the next file in the list has been consumed, allowing another file to be prefetched
+         */
+        void mark_next_file_consumed ();
+
+    protected:
+        // Methods
+        void thread_method () override;
+
+    private:
+        // Methods
+        /**
+         * Opens the given file and asks the kernel to read (up to the given number of bytes of) it in the background
+         * @param path
+         * @param max_num_bytes
+         * @return The number of bytes requested
+         */
+        static size_t prefetch (const std::string& path, size_t max_num_bytes);
+
+        // Variables
+        std::vector<std::string> m_paths;
+        size_t m_max_num_files_ahead;
+        size_t m_max_num_bytes_ahead;
+        bool m_is_open;
+
+        std::mutex m_mutex;
+        std::condition_variable m_state_changed;
+        size_t m_num_files_consumed;
+        size_t m_num_files_prefetched;
+        // Number of bytes requested for each prefetched file, so they can be subtracted from m_num_bytes_ahead once the file is consumed
+        std::vector<size_t> m_num_bytes_prefetched;
+        size_t m_num_bytes_ahead;
+        bool m_stop;
+    };
+}
+
+#endif // CLP_FILEPREFETCHER_HPP
@@ -0,0 +1,169 @@
+#include "IngestedStreamWriter.hpp"
+
+// Project headers
+#include "../spdlog_with_specializations.hpp"
+#include "utils.hpp"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace clp {
+    // Constants
+    static constexpr group_id_t cIngestedStreamGroupId = 0;
+
+    void IngestedStreamWriter::write_batch (unique_ptr<IrStreamListener::EventBatch> batch) {
+        auto [stream_it, is_new_stream] = m_streams.try_emplace(batch->stream_id);
+        auto& stream = stream_it->second;
+        if (is_new_stream) {
+            stream.path = m_stream_path_prefix + std::to_string(batch->stream_id);
+            stream.orig_file_id = m_uuid_generator();
+            stream.next_split_ix = 0;
+            stream.num_buffered_events = 0;
+        }
+
+        auto is_end_of_stream = batch->is_end_of_stream;
+        auto error = batch->error;
+        if (batch->num_events > 0) {
+            if (stream.buffered_batches.empty()) {
+                stream.oldest_batch_buffered_time = std::chrono::steady_clock::now();
+            }
+            stream.num_buffered_events += batch->num_events;
+            m_num_buffered_events += batch->num_events;
+            stream.buffered_batches.push_back(std::move(batch));
+        } else {
+            m_listener.recycle_batch(std::move(batch));
+        }
+
+        if (is_end_of_stream) {
+            if (error) {
+                SPDLOG_WARN("Stream {} ended abnormally - {}", stream.path, error.message());
+            }
+            write_buffered_batches(stream);
+            if (&stream == m_open_stream) {
+                close_file(false);
+            }
+            m_streams.erase(stream_it);
+        } else if (stream.num_buffered_events >= m_min_num_events_per_split) {
+            write_buffered_batches(stream);
+        } else if (m_num_buffered_events > m_max_num_buffered_events) {
+            // Free the most memory while splitting the fewest streams
+            auto largest_stream_it = m_streams.begin();
+            for (auto it = m_streams.begin(); m_streams.end() != it; ++it) {
+                if (it->second.num_buffered_events > largest_stream_it->second.num_buffered_events) {
+                    largest_stream_it = it;
+                }
+            }
+            write_buffered_batches(largest_stream_it->second);
+        }
+    }
+
+    void IngestedStreamWriter::write_expired_batches (std::chrono::steady_clock::time_point now) {
+        for (auto& [stream_id, stream] : m_streams) {
+            if (false == stream.buffered_batches.empty() && now - stream.oldest_batch_buffered_time >= m_max_buffering_time) {
+                write_buffered_batches(stream);
+            }
+        }
+    }
+
+    void IngestedStreamWriter::roll_archive () {
+        write_all_buffered_batches();
+        if (m_archive_is_empty) {
+            return;
+        }
+
+        if (nullptr != m_open_stream) {
+            close_file(true);
+        }
+        split_archive(m_archive_user_config, m_archive_writer);
+        m_archive_is_empty = true;
+        m_has_unpublished_events = false;
+    }
+
+    void IngestedStreamWriter::publish () {
+        write_all_buffered_batches();
+        if (false == m_has_unpublished_events) {
+            return;
+        }
+
+        if (nullptr != m_open_stream) {
+            close_file(true);
+        }
+        m_archive_writer.close_open_segments();
+        m_has_unpublished_events = false;
+    }
+
+    void IngestedStreamWriter::close () {
+        write_all_buffered_batches();
+        if (nullptr != m_open_stream) {
+            close_file(false);
+        }
+    }
+
+    void IngestedStreamWriter::write_buffered_batches (IngestedStream& stream) {
+        if (stream.buffered_batches.empty()) {
+            return;
+        }
+
+        if (&stream != m_open_stream) {
+            if (nullptr != m_open_stream) {
+                close_file(true);
+            }
+            stream.timestamp_pattern = stream.buffered_batches.front()->timestamp_pattern;
+            open_file(stream);
+        }
+        for (auto& batch : stream.buffered_batches) {
+            stream.timestamp_pattern = batch->timestamp_pattern;
+            if (batch->uses_four_byte_encoding) {
+                write_events(stream, batch->four_byte_encoded_events, batch->num_events);
+            } else {
+                write_events(stream, batch->eight_byte_encoded_events, batch->num_events);
+            }
+            m_listener.recycle_batch(std::move(batch));
+        }
+        stream.buffered_batches.clear();
+        m_num_buffered_events -= stream.num_buffered_events;
+        stream.num_buffered_events = 0;
+    }
+
+    void IngestedStreamWriter::write_all_buffered_batches () {
+        // Write the open stream first, so that it isn't split just to be reopened
+        if (nullptr != m_open_stream) {
+            write_buffered_batches(*m_open_stream);
+        }
+        for (auto& [stream_id, stream] : m_streams) {
+            write_buffered_batches(stream);
+        }
+    }
+
+    template <typename encoded_variable_t>
+    void IngestedStreamWriter::write_events (IngestedStream& stream, const vector<ir::LogEvent<encoded_variable_t>>& events, size_t num_events) {
+        for (size_t i = 0; i < num_events; ++i) {
+            // Split archive/encoded file if necessary before writing the new event
+            if (m_archive_writer.get_data_size_of_dictionaries() >= m_target_data_size_of_dicts) {
+                split_file_and_archive(m_archive_user_config, stream.path, cIngestedStreamGroupId, &stream.timestamp_pattern, m_archive_writer);
+            } else if (m_archive_writer.get_file().get_encoded_size_in_bytes() >= m_target_encoded_file_size) {
+                split_file(stream.path, cIngestedStreamGroupId, &stream.timestamp_pattern, m_archive_writer);
+            }
+
+            m_archive_writer.write_log_event_ir(events[i]);
+        }
+        stream.next_split_ix = m_archive_writer.get_file().get_split_ix() + 1;
+        m_archive_is_empty = false;
+        m_has_unpublished_events = true;
+    }
+
+    void IngestedStreamWriter::open_file (IngestedStream& stream) {
+        m_archive_writer.create_and_open_file(stream.path, cIngestedStreamGroupId, stream.orig_file_id, stream.next_split_ix);
+        m_archive_writer.change_ts_pattern(&stream.timestamp_pattern);
+        m_open_stream = &stream;
+    }
+
+    void IngestedStreamWriter::close_file (bool is_split) {
+        if (is_split) {
+            m_archive_writer.set_file_is_split(true);
+        }
+        close_file_and_append_to_segment(m_archive_writer);
+        m_open_stream = nullptr;
+    }
+}
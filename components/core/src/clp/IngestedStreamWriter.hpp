@@ -0,0 +1,141 @@
+#ifndef CLP_INGESTEDSTREAMWRITER_HPP
+#define CLP_INGESTEDSTREAMWRITER_HPP
+
+// C++ standard libraries
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Boost libraries
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid.hpp>
+
+// Project headers
+#include "../streaming_archive/writer/Archive.hpp"
+#include "../TimestampPattern.hpp"
+#include "IrStreamListener.hpp"
+
+namespace clp {
+    /**
+     * Class to write batches of events from many IR streams into an archive. An archive can only have one encoded file open at a time, so
+     * writing a different stream means splitting the open file. To avoid splitting streams on every batch when they're interleaved, each
+     * stream's batches are buffered until the stream has enough events (or its oldest buffered batch has waited long enough), and then they're
+     * written into a single split.
+     */
+    class IngestedStreamWriter {
+    public:
+        // Constructors
+        /**
+         * @param listener Listener to return batches to once they're written
+         * @param archive_user_config
+         * @param archive_writer
+         * @param stream_path_prefix Prefix of each stream's path (followed by the stream's ID)
+         * @param target_encoded_file_size
+         * @param target_data_size_of_dicts
+         * @param min_num_events_per_split Number of events a stream buffers before they're written
+         * @param max_num_buffered_events Maximum number of events buffered across all streams, beyond which the largest buffer is written
+         * @param max_buffering_time Maximum time a stream's events are buffered before they're written
+         */
+        IngestedStreamWriter (IrStreamListener& listener, streaming_archive::writer::Archive::UserConfig& archive_user_config,
+                              streaming_archive::writer::Archive& archive_writer, std::string stream_path_prefix, size_t target_encoded_file_size,
+                              size_t target_data_size_of_dicts, size_t min_num_events_per_split, size_t max_num_buffered_events,
+                              std::chrono::milliseconds max_buffering_time) :
+                m_listener(listener), m_archive_user_config(archive_user_config), m_archive_writer(archive_writer),
+                m_stream_path_prefix(std::move(stream_path_prefix)), m_target_encoded_file_size(target_encoded_file_size),
+                m_target_data_size_of_dicts(target_data_size_of_dicts), m_min_num_events_per_split(min_num_events_per_split),
+                m_max_num_buffered_events(max_num_buffered_events), m_max_buffering_time(max_buffering_time), m_num_buffered_events(0),
+                m_open_stream(nullptr), m_archive_is_empty(true), m_has_unpublished_events(false) {}
+
+        // Methods
+        /**
+         * Buffers the given batch, writing the buffered batches of its stream if the stream has enough of them or ended
+         * @param batch
+         */
+        void write_batch (std::unique_ptr<IrStreamListener::EventBatch> batch);
+
+        /**
+         * Writes the buffered batches of every stream whose oldest buffered batch has waited for at least the maximum buffering time
+         * @param now
+         */
+        void write_expired_batches (std::chrono::steady_clock::time_point now);
+
+        /**
+         * Closes the current archive and starts a new one, unless nothing has been written to it
+         */
+        void roll_archive ();
+
+        /**
+         * Makes all events received so far searchable without closing the archive, by writing all buffered batches, splitting the open
+         * encoded file, and closing the archive's open segments
+         */
+        void publish ();
+
+        /**
+         * Writes all buffered batches and closes the open encoded file (if any)
+         */
+        void close ();
+
+    private:
+        // Types
+        /**
+         * State of a stream that's still being ingested
+         */
+        struct IngestedStream {
+            std::string path;
+            boost::uuids::uuid orig_file_id;
+            size_t next_split_ix;
+            TimestampPattern timestamp_pattern;
+            std::vector<std::unique_ptr<IrStreamListener::EventBatch>> buffered_batches;
+            size_t num_buffered_events;
+            std::chrono::steady_clock::time_point oldest_batch_buffered_time;
+        };
+
+        // Methods
+        /**
+         * Writes the given stream's buffered batches into the archive, switching the open encoded file to the stream if necessary
+         * @param stream
+         */
+        void write_buffered_batches (IngestedStream& stream);
+        /**
+         * Writes the buffered batches of every stream, starting with the stream whose file is open
+         */
+        void write_all_buffered_batches ();
+
+        template <typename encoded_variable_t>
+        void write_events (IngestedStream& stream, const std::vector<ir::LogEvent<encoded_variable_t>>& events, size_t num_events);
+
+        /**
+         * Opens the next split of the given stream
+         * @param stream
+         */
+        void open_file (IngestedStream& stream);
+        /**
+         * Closes the open encoded file
+         * @param is_split Whether more splits of the stream will follow
+         */
+        void close_file (bool is_split);
+
+        // Variables
+        IrStreamListener& m_listener;
+        streaming_archive::writer::Archive::UserConfig& m_archive_user_config;
+        streaming_archive::writer::Archive& m_archive_writer;
+        std::string m_stream_path_prefix;
+        size_t m_target_encoded_file_size;
+        size_t m_target_data_size_of_dicts;
+        size_t m_min_num_events_per_split;
+        size_t m_max_num_buffered_events;
+        std::chrono::milliseconds m_max_buffering_time;
+        boost::uuids::random_generator m_uuid_generator;
+
+        std::unordered_map<size_t, IngestedStream> m_streams;
+        size_t m_num_buffered_events;
+        // NOTE: Elements of an unordered_map aren't moved by insertions, so this remains valid until the stream is erased
+        IngestedStream* m_open_stream;
+        bool m_archive_is_empty;
+        bool m_has_unpublished_events;
+    };
+}
+
+#endif // CLP_INGESTEDSTREAMWRITER_HPP
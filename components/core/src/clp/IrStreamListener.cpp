@@ -0,0 +1,345 @@
+#include "IrStreamListener.hpp"
+
+// C libraries
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// C standard libraries
+#include <cerrno>
+#include <cstring>
+
+// C++ standard libraries
+#include <type_traits>
+
+// Project headers
+#include "../ffi/ir_stream/decoding_methods.hpp"
+#include "../ir/LogEventDeserializer.hpp"
+#include "../spdlog_with_specializations.hpp"
+
+using ir::LogEventDeserializer;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::unique_lock;
+using std::unique_ptr;
+
+namespace clp {
+    // Constants
+    // How often the listener checks whether it should stop while waiting for connections
+    static constexpr int cPollIntervalMs = 100;
+    // Maximum number of events in a batch. Batches are handed over early whenever the connection has no more data buffered, so that events from
+    // slow producers aren't delayed.
+    static constexpr size_t cMaxNumEventsPerBatch = 1024;
+
+    // Local prototypes
+    /**
+     * @tparam encoded_variable_t
+     * @param batch
+     * @return The batch's events with the given encoding
+     */
+    template <typename encoded_variable_t>
+    static std::vector<ir::LogEvent<encoded_variable_t>>& get_events (IrStreamListener::EventBatch& batch);
+
+    template <>
+    std::vector<ir::LogEvent<ffi::four_byte_encoded_variable_t>>& get_events (IrStreamListener::EventBatch& batch) {
+        return batch.four_byte_encoded_events;
+    }
+
+    template <>
+    std::vector<ir::LogEvent<ffi::eight_byte_encoded_variable_t>>& get_events (IrStreamListener::EventBatch& batch) {
+        return batch.eight_byte_encoded_events;
+    }
+
+    IrStreamListener::Connection::~Connection () {
+        // NOTE: We must join here rather than in Thread's destructor since the thread uses this object's members
+        try {
+            join();
+        } catch (const Thread::OperationFailed& e) {
+            SPDLOG_ERROR("clp::IrStreamListener: Failed to join connection thread - {}", e.what());
+        }
+        ::close(m_socket_fd);
+    }
+
+    void IrStreamListener::Connection::thread_method () {
+        networking::SocketReader reader(m_socket_fd);
+        bool uses_four_byte_encoding;
+        auto ir_error_code = ffi::ir_stream::get_encoding_type(reader, uses_four_byte_encoding);
+        if (ffi::ir_stream::IRErrorCode_Success != ir_error_code) {
+            auto batch = get_empty_batch();
+            batch->is_end_of_stream = true;
+            batch->error = std::make_error_code(std::errc::protocol_error);
+            m_listener.add_batch(std::move(batch));
+        } else if (uses_four_byte_encoding) {
+            deserialize_stream<ffi::four_byte_encoded_variable_t>(reader);
+        } else {
+            deserialize_stream<ffi::eight_byte_encoded_variable_t>(reader);
+        }
+
+        m_is_finished = true;
+    }
+
+    template <typename encoded_variable_t>
+    void IrStreamListener::Connection::deserialize_stream (networking::SocketReader& reader) {
+        constexpr bool uses_four_byte_encoding = std::is_same_v<encoded_variable_t, ffi::four_byte_encoded_variable_t>;
+
+        auto result = LogEventDeserializer<encoded_variable_t>::create(reader);
+        if (result.has_error()) {
+            auto batch = get_empty_batch();
+            batch->uses_four_byte_encoding = uses_four_byte_encoding;
+            batch->is_end_of_stream = true;
+            batch->error = result.error();
+            m_listener.add_batch(std::move(batch));
+            return;
+        }
+        auto& deserializer = result.value();
+
+        auto batch = get_empty_batch();
+        batch->uses_four_byte_encoding = uses_four_byte_encoding;
+        batch->timestamp_pattern = deserializer.get_timestamp_pattern();
+        while (true) {
+            auto& events = get_events<encoded_variable_t>(*batch);
+            if (events.size() == batch->num_events) {
+                events.emplace_back();
+            }
+            if (auto error = deserializer.deserialize_log_event(events[batch->num_events]); error) {
+                if (std::errc::no_message_available != error) {
+                    batch->error = error;
+                }
+                batch->is_end_of_stream = true;
+                m_listener.add_batch(std::move(batch));
+                return;
+            }
+            ++batch->num_events;
+
+            if (batch->num_events >= cMaxNumEventsPerBatch || false == reader.has_buffered_data()) {
+                m_listener.add_batch(std::move(batch));
+                batch = get_empty_batch();
+                batch->uses_four_byte_encoding = uses_four_byte_encoding;
+                batch->timestamp_pattern = deserializer.get_timestamp_pattern();
+            }
+        }
+    }
+
+    unique_ptr<IrStreamListener::EventBatch> IrStreamListener::Connection::get_empty_batch () {
+        auto batch = m_listener.get_unused_batch();
+        batch->stream_id = m_stream_id;
+        batch->num_events = 0;
+        batch->is_end_of_stream = false;
+        batch->error.clear();
+        return batch;
+    }
+
+    IrStreamListener::~IrStreamListener () {
+        if (false == m_is_open) {
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_discard_batches = true;
+        }
+        m_stop = true;
+        m_state_changed.notify_all();
+        // NOTE: We must join here rather than in Thread's destructor since the thread uses this object's members
+        try {
+            join();
+        } catch (const Thread::OperationFailed& e) {
+            SPDLOG_ERROR("clp::IrStreamListener: Failed to join thread - {}", e.what());
+        }
+        ::close(m_listening_socket_fd);
+        unlink(m_socket_path.c_str());
+    }
+
+    void IrStreamListener::open (const string& socket_path, size_t max_num_pending_batches) {
+        if (m_is_open) {
+            throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+        }
+
+        struct sockaddr_un address = {};
+        if (socket_path.empty() || socket_path.length() >= sizeof(address.sun_path) || 0 == max_num_pending_batches) {
+            throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
+        }
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        // Remove any socket left behind by a previous listener (but nothing else)
+        struct stat stat_buf = {};
+        if (0 == lstat(socket_path.c_str(), &stat_buf) && S_ISSOCK(stat_buf.st_mode)) {
+            unlink(socket_path.c_str());
+        }
+
+        m_listening_socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (-1 == m_listening_socket_fd) {
+            throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+        }
+        if (0 != bind(m_listening_socket_fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address))
+            || 0 != listen(m_listening_socket_fd, SOMAXCONN))
+        {
+            auto saved_errno = errno;
+            ::close(m_listening_socket_fd);
+            m_listening_socket_fd = -1;
+            errno = saved_errno;
+            throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+        }
+
+        m_socket_path = socket_path;
+        m_max_num_pending_batches = max_num_pending_batches;
+        m_stop = false;
+        m_is_accepting = true;
+        m_num_active_connections = 0;
+        m_discard_batches = false;
+
+        start();
+        m_is_open = true;
+    }
+
+    void IrStreamListener::close () {
+        if (false == m_is_open) {
+            throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_discard_batches = true;
+        }
+        m_stop = true;
+        m_state_changed.notify_all();
+        join();
+        m_is_open = false;
+
+        ::close(m_listening_socket_fd);
+        m_listening_socket_fd = -1;
+        unlink(m_socket_path.c_str());
+        m_pending_batches.clear();
+    }
+
+    void IrStreamListener::request_stop () {
+        m_stop = true;
+    }
+
+    ErrorCode IrStreamListener::try_get_next_batch (unique_ptr<EventBatch>& batch, std::chrono::milliseconds timeout) {
+        if (false == m_is_open) {
+            throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+        }
+
+        unique_lock<mutex> lock(m_mutex);
+        auto is_drained = [this] { return false == m_is_accepting && 0 == m_num_active_connections; };
+        m_state_changed.wait_for(lock, timeout, [&] { return false == m_pending_batches.empty() || is_drained(); });
+        if (m_pending_batches.empty()) {
+            return is_drained() ? ErrorCode_EndOfFile : ErrorCode_NotReady;
+        }
+
+        batch = std::move(m_pending_batches.front());
+        m_pending_batches.pop_front();
+        m_state_changed.notify_all();
+
+        return ErrorCode_Success;
+    }
+
+    void IrStreamListener::recycle_batch (unique_ptr<EventBatch> batch) {
+        lock_guard<mutex> lock(m_mutex);
+        m_unused_batches.push_back(std::move(batch));
+    }
+
+    void IrStreamListener::thread_method () {
+        while (false == m_stop) {
+            struct pollfd poll_fd = {};
+            poll_fd.fd = m_listening_socket_fd;
+            poll_fd.events = POLLIN;
+            auto num_ready_fds = poll(&poll_fd, 1, cPollIntervalMs);
+            if (num_ready_fds < 0 && EINTR != errno) {
+                SPDLOG_ERROR("clp::IrStreamListener: Failed to poll listening socket - errno={}", errno);
+                break;
+            }
+
+            reap_finished_connections();
+            if (num_ready_fds > 0) {
+                accept_connection();
+            }
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_is_accepting = false;
+        }
+        m_state_changed.notify_all();
+
+        // Disconnect all producers so their threads see EOF, then wait for them to hand over what they've already received
+        for (const auto& connection : m_connections) {
+            shutdown(connection->get_socket_fd(), SHUT_RDWR);
+        }
+        m_connections.clear();
+    }
+
+    unique_ptr<IrStreamListener::EventBatch> IrStreamListener::get_unused_batch () {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            if (false == m_unused_batches.empty()) {
+                auto batch = std::move(m_unused_batches.back());
+                m_unused_batches.pop_back();
+                return batch;
+            }
+        }
+        return std::make_unique<EventBatch>();
+    }
+
+    void IrStreamListener::add_batch (unique_ptr<EventBatch> batch) {
+        unique_lock<mutex> lock(m_mutex);
+        m_state_changed.wait(lock, [this] { return m_discard_batches || m_pending_batches.size() < m_max_num_pending_batches; });
+        if (batch->is_end_of_stream) {
+            --m_num_active_connections;
+        }
+        if (m_discard_batches) {
+            m_unused_batches.push_back(std::move(batch));
+        } else {
+            m_pending_batches.push_back(std::move(batch));
+        }
+        lock.unlock();
+        m_state_changed.notify_all();
+    }
+
+    void IrStreamListener::accept_connection () {
+        auto socket_fd = accept(m_listening_socket_fd, nullptr, nullptr);
+        if (-1 == socket_fd) {
+            // NOTE: The producer may have given up before we got to it
+            if (EINTR != errno && ECONNABORTED != errno && EAGAIN != errno) {
+                SPDLOG_WARN("clp::IrStreamListener: Failed to accept connection - errno={}", errno);
+            }
+            return;
+        }
+
+        auto stream_id = m_next_stream_id++;
+        auto connection = std::make_unique<Connection>(*this, socket_fd, stream_id);
+        {
+            lock_guard<mutex> lock(m_mutex);
+            ++m_num_active_connections;
+        }
+        try {
+            connection->start();
+        } catch (const Thread::OperationFailed& e) {
+            SPDLOG_ERROR("clp::IrStreamListener: Failed to start thread for stream {} - {}", stream_id, e.what());
+            {
+                lock_guard<mutex> lock(m_mutex);
+                --m_num_active_connections;
+            }
+            m_state_changed.notify_all();
+            return;
+        }
+        m_connections.push_back(std::move(connection));
+    }
+
+    void IrStreamListener::reap_finished_connections () {
+        for (size_t i = 0; i < m_connections.size();) {
+            if (m_connections[i]->is_finished()) {
+                // Joining a finished thread doesn't block
+                m_connections[i] = std::move(m_connections.back());
+                m_connections.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+}
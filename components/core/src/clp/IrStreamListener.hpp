@@ -0,0 +1,203 @@
+#ifndef CLP_IRSTREAMLISTENER_HPP
+#define CLP_IRSTREAMLISTENER_HPP
+
+// C++ standard libraries
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Project headers
+#include "../ErrorCode.hpp"
+#include "../ffi/encoding_methods.hpp"
+#include "../ir/LogEvent.hpp"
+#include "../networking/SocketReader.hpp"
+#include "../Thread.hpp"
+#include "../TimestampPattern.hpp"
+#include "../TraceableException.hpp"
+
+namespace clp {
+    /**
+     * A thread that listens on a Unix domain socket for producers, each of which connects to send a single IR stream. Every connection is served
+     * by its own thread which deserializes the stream's log events into batches. Batches from all streams are handed to a single consumer (the
+     * thread writing the archive) through a bounded queue, so producers are throttled (by the socket's flow control) when the consumer falls
+     * behind. Batches are recycled so that the buffers of their events are reused.
+     */
+    class IrStreamListener : public Thread {
+    public:
+        // Types
+        class OperationFailed : public TraceableException {
+        public:
+            // Constructors
+            OperationFailed (ErrorCode error_code, const char* const filename, int line_number) :
+                    TraceableException(error_code, filename, line_number) {}
+
+            // Methods
+            const char* what () const noexcept override {
+                return "clp::IrStreamListener operation failed";
+            }
+        };
+
+        /**
+         * A batch of consecutive log events from one IR stream
+         */
+        struct EventBatch {
+            // Constructors
+            EventBatch () : stream_id(0), uses_four_byte_encoding(false), num_events(0), is_end_of_stream(false) {}
+
+            // Variables
+            size_t stream_id;
+            bool uses_four_byte_encoding;
+            TimestampPattern timestamp_pattern;
+            // NOTE: Only the first num_events events of the vector matching the stream's encoding are valid; the rest are kept for reuse
+            std::vector<ir::LogEvent<ffi::four_byte_encoded_variable_t>> four_byte_encoded_events;
+            std::vector<ir::LogEvent<ffi::eight_byte_encoded_variable_t>> eight_byte_encoded_events;
+            size_t num_events;
+            // Whether this is the stream's last batch
+            bool is_end_of_stream;
+            // The error that ended the stream (if any)
+            std::error_code error;
+        };
+
+        // Constructors
+        IrStreamListener () : m_listening_socket_fd(-1), m_is_open(false), m_max_num_pending_batches(0), m_stop(false), m_is_accepting(false),
+                              m_num_active_connections(0), m_discard_batches(false), m_next_stream_id(0) {}
+
+        // Destructor
+        ~IrStreamListener () override;
+
+        // Methods
+        /**
+         * Starts listening for producers on the given socket path. Any stale socket at the path is replaced.
+         * @param socket_path
+         * @param max_num_pending_batches Maximum number of batches that can wait for the consumer before connections stop receiving data
+         * @throw IrStreamListener::OperationFailed if the listener is already open, the path is too long for a socket address, or the socket
+         * couldn't be created
+         * @throw Same as Thread::start
+         */
+        void open (const std::string& socket_path, size_t max_num_pending_batches);
+        /**
+         * Stops listening, closes all connections, and removes the socket. Any batches that haven't been consumed are discarded.
+         * @throw IrStreamListener::OperationFailed if the listener isn't open
+         * @throw Same as Thread::join
+         */
+        void close ();
+
+        /**
+         * Stops accepting new producers and disconnects the current ones. The batches they've already sent remain available to the consumer.
+         */
+        void request_stop ();
+
+        /**
+         * Waits for the next batch of log events from any stream
+         * @param batch Returns the batch, which should be given back with recycle_batch once it's consumed
+         * @param timeout Maximum time to wait
+         * @return ErrorCode_NotReady if no batch arrived before the timeout
+         * @return ErrorCode_EndOfFile if the listener was stopped and all batches have been consumed
+         * @return ErrorCode_Success on success
+         * @throw IrStreamListener::OperationFailed if the listener isn't open
+         */
+        ErrorCode try_get_next_batch (std::unique_ptr<EventBatch>& batch, std::chrono::milliseconds timeout);
+        /**
+         * Returns a consumed batch so that its buffers can be reused
+         * @param batch
+         */
+        void recycle_batch (std::unique_ptr<EventBatch> batch);
+
+    protected:
+        // Methods
+        void thread_method () override;
+
+    private:
+        // Types
+        /**
+         * A thread that deserializes the IR stream sent over one connection
+         */
+        class Connection : public Thread {
+        public:
+            // Constructors
+            Connection (IrStreamListener& listener, int socket_fd, size_t stream_id) : m_listener(listener), m_socket_fd(socket_fd),
+                                                                                       m_stream_id(stream_id), m_is_finished(false) {}
+
+            // Destructor
+            ~Connection () override;
+
+            // Methods
+            int get_socket_fd () const { return m_socket_fd; }
+            bool is_finished () const { return m_is_finished; }
+
+        protected:
+            // Methods
+            void thread_method () override;
+
+        private:
+            // Methods
+            /**
+             * Deserializes the rest of the stream, handing the events to the listener in batches
+             * @tparam encoded_variable_t Type of encoded variables in the stream
+             * @param reader
+             */
+            template <typename encoded_variable_t>
+            void deserialize_stream (networking::SocketReader& reader);
+
+            /**
+             * @return A batch with no events, initialized for this connection's stream
+             */
+            std::unique_ptr<EventBatch> get_empty_batch ();
+
+            // Variables
+            IrStreamListener& m_listener;
+            int m_socket_fd;
+            size_t m_stream_id;
+            // NOTE: Unlike Thread::is_running, this is never false before the thread has run, so the connection can be reaped as soon as it's set
+            std::atomic_bool m_is_finished;
+        };
+
+        // Methods
+        /**
+         * @return A recycled batch if one is available, or a new batch otherwise
+         */
+        std::unique_ptr<EventBatch> get_unused_batch ();
+        /**
+         * Adds a batch to the queue, waiting for space if the queue is full
+         * @param batch
+         */
+        void add_batch (std::unique_ptr<EventBatch> batch);
+
+        /**
+         * Accepts a pending connection and starts a thread to serve it
+         */
+        void accept_connection ();
+        /**
+         * Joins and closes all finished connections
+         */
+        void reap_finished_connections ();
+
+        // Variables
+        std::string m_socket_path;
+        int m_listening_socket_fd;
+        bool m_is_open;
+        size_t m_max_num_pending_batches;
+        // NOTE: Only accessed by the listener's thread
+        std::vector<std::unique_ptr<Connection>> m_connections;
+
+        std::mutex m_mutex;
+        std::condition_variable m_state_changed;
+        std::atomic_bool m_stop;
+        std::deque<std::unique_ptr<EventBatch>> m_pending_batches;
+        std::vector<std::unique_ptr<EventBatch>> m_unused_batches;
+        bool m_is_accepting;
+        // Number of connections that haven't yet added their last batch
+        size_t m_num_active_connections;
+        // Set when the listener is closed, so that connections don't wait for a consumer that's gone
+        bool m_discard_batches;
+        size_t m_next_stream_id;
+    };
+}
+
+#endif // CLP_IRSTREAMLISTENER_HPP
@@ -11,12 +11,11 @@
 #include <archive_entry.h>
 
 // Project headers
-#include "../GlobalMySQLMetadataDB.hpp"
-#include "../GlobalSQLiteMetadataDB.hpp"
 #include "../spdlog_with_specializations.hpp"
 #include "../streaming_archive/writer/Archive.hpp"
 #include "../Utils.hpp"
 #include "FileCompressor.hpp"
+#include "FilePrefetcher.hpp"
 #include "utils.hpp"
 
 using std::cout;
@@ -27,6 +26,10 @@ using std::string;
 using std::vector;
 
 namespace clp {
+    // Limits on how far ahead of the compression thread files are read into the page cache
+    static constexpr size_t cMaxNumFilesToPrefetch = 64;
+    static constexpr size_t cMaxNumBytesToPrefetch = 256ULL * 1024 * 1024;    // 256 MiB
+
     // Local prototypes
     /**
      * Comparator to sort files based on their group ID
@@ -63,23 +66,7 @@ namespace clp {
             return false;
         }
 
-        const auto& global_metadata_db_config = command_line_args.get_metadata_db_config();
-        std::unique_ptr<GlobalMetadataDB> global_metadata_db;
-        switch (global_metadata_db_config.get_metadata_db_type()) {
-            case GlobalMetadataDBConfig::MetadataDBType::SQLite: {
-                auto global_metadata_db_path = output_dir / streaming_archive::cMetadataDBFileName;
-                global_metadata_db = std::make_unique<GlobalSQLiteMetadataDB>(global_metadata_db_path.string());
-                break;
-            }
-            case GlobalMetadataDBConfig::MetadataDBType::MySQL:
-                global_metadata_db = std::make_unique<GlobalMySQLMetadataDB>(global_metadata_db_config.get_metadata_db_host(),
-                                                                             global_metadata_db_config.get_metadata_db_port(),
-                                                                             global_metadata_db_config.get_metadata_db_username(),
-                                                                             global_metadata_db_config.get_metadata_db_password(),
-                                                                             global_metadata_db_config.get_metadata_db_name(),
-                                                                             global_metadata_db_config.get_metadata_table_prefix());
-                break;
-        }
+        auto global_metadata_db = create_global_metadata_db(command_line_args.get_metadata_db_config(), output_dir);
 
         auto uuid_generator = boost::uuids::random_generator();
 
@@ -93,6 +80,9 @@ namespace clp {
         archive_user_config.output_dir = command_line_args.get_output_dir();
         archive_user_config.global_metadata_db = global_metadata_db.get();
         archive_user_config.print_archive_stats_progress = command_line_args.print_archive_stats_progress();
+        archive_user_config.segment_packing_window_size = command_line_args.get_segment_packing_window_size();
+        archive_user_config.use_huge_pages_for_columns = command_line_args.use_huge_pages_for_columns();
+        archive_user_config.memory_budget = command_line_args.get_memory_budget();
 
         // Open Archive
         streaming_archive::writer::Archive archive_writer;
@@ -116,6 +106,21 @@ namespace clp {
             num_files_to_compress = files_to_compress.size() + grouped_files_to_compress.size();
         }
         sort(files_to_compress.begin(), files_to_compress.end(), file_lt_last_write_time_comparator);
+        // Sort files by group ID to avoid spreading groups over multiple segments
+        sort(grouped_files_to_compress.begin(), grouped_files_to_compress.end(), file_group_id_comparator);
+
+        // Read files into the page cache ahead of compressing them
+        vector<string> paths_to_prefetch;
+        paths_to_prefetch.reserve(files_to_compress.size() + grouped_files_to_compress.size());
+        for (auto rit = files_to_compress.crbegin(); rit != files_to_compress.crend(); ++rit) {
+            paths_to_prefetch.emplace_back(rit->get_path());
+        }
+        for (const auto& file_to_compress : grouped_files_to_compress) {
+            paths_to_prefetch.emplace_back(file_to_compress.get_path());
+        }
+        FilePrefetcher file_prefetcher;
+        file_prefetcher.open(std::move(paths_to_prefetch), cMaxNumFilesToPrefetch, cMaxNumBytesToPrefetch);
+
         for (auto rit = files_to_compress.crbegin(); rit != files_to_compress.crend(); ++rit) {
             if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dictionaries) {
                 split_archive(archive_user_config, archive_writer);
@@ -124,14 +129,13 @@ namespace clp {
                                                        target_encoded_file_size, *rit, archive_writer, use_heuristic)) {
                 all_files_compressed_successfully = false;
             }
+            file_prefetcher.mark_next_file_consumed();
             if (command_line_args.show_progress()) {
                 ++num_files_compressed;
                 cerr << "Compressed " << num_files_compressed << '/' << num_files_to_compress << " files" << '\r';
             }
         }
 
-        // Sort files by group ID to avoid spreading groups over multiple segments
-        sort(grouped_files_to_compress.begin(), grouped_files_to_compress.end(), file_group_id_comparator);
         // Compress grouped files
         for (const auto& file_to_compress: grouped_files_to_compress) {
             if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dictionaries) {
@@ -142,12 +146,14 @@ namespace clp {
                                                        archive_writer, use_heuristic)) {
                 all_files_compressed_successfully = false;
             }
+            file_prefetcher.mark_next_file_consumed();
             if (command_line_args.show_progress()) {
                 ++num_files_compressed;
                 cerr << "Compressed " << num_files_compressed << '/' << num_files_to_compress << " files" << '\r';
             }
         }
 
+        file_prefetcher.close();
         archive_writer.close();
 
         return all_files_compressed_successfully;
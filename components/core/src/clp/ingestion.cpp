@@ -0,0 +1,153 @@
+#include "ingestion.hpp"
+
+// C standard libraries
+#include <csignal>
+#include <cstring>
+
+// C++ standard libraries
+#include <algorithm>
+#include <chrono>
+
+// Boost libraries
+#include <boost/filesystem/path.hpp>
+#include <boost/uuid/random_generator.hpp>
+
+// Project headers
+#include "../spdlog_with_specializations.hpp"
+#include "../streaming_archive/writer/Archive.hpp"
+#include "../Utils.hpp"
+#include "IngestedStreamWriter.hpp"
+#include "IrStreamListener.hpp"
+#include "utils.hpp"
+
+namespace clp {
+    // Constants
+    // Maximum number of batches that can be buffered before producers are throttled
+    static constexpr size_t cMaxNumPendingBatches = 64;
+    // Maximum time to wait for a batch before checking for signals and whether the archive should be rolled
+    static constexpr std::chrono::milliseconds cMaxBatchWaitTime{500};
+    // Number of events a stream buffers before they're written into the archive, so that interleaved streams aren't split on every batch
+    static constexpr size_t cMinNumEventsPerSplit = 16 * 1024;
+    // Maximum number of events buffered across all streams
+    static constexpr size_t cMaxNumBufferedEvents = 256 * 1024;
+    // Maximum time a stream's events are buffered before they're written into the archive
+    static constexpr std::chrono::milliseconds cMaxBufferingTime{5000};
+
+    // Local variables
+    static volatile std::sig_atomic_t s_stop_requested = 0;
+
+    // Local prototypes
+    /**
+     * Requests that ingestion stop
+     * @param signal_number
+     */
+    static void handle_stop_signal (int signal_number);
+
+    static void handle_stop_signal (int signal_number) {
+        s_stop_requested = 1;
+    }
+
+    bool ingest (CommandLineArguments& command_line_args) {
+        auto output_dir = boost::filesystem::path(command_line_args.get_output_dir());
+
+        // Create output directory in case it doesn't exist
+        auto error_code = create_directory(output_dir.parent_path().string(), 0700, true);
+        if (ErrorCode_Success != error_code) {
+            SPDLOG_ERROR("Failed to create {} - {}", output_dir.parent_path().c_str(), strerror(errno));
+            return false;
+        }
+
+        auto global_metadata_db = create_global_metadata_db(command_line_args.get_metadata_db_config(), output_dir);
+
+        auto uuid_generator = boost::uuids::random_generator();
+
+        // Setup config
+        streaming_archive::writer::Archive::UserConfig archive_user_config;
+        archive_user_config.id = uuid_generator();
+        archive_user_config.creator_id = uuid_generator();
+        archive_user_config.creation_num = 0;
+        archive_user_config.target_segment_uncompressed_size = command_line_args.get_target_segment_uncompressed_size();
+        archive_user_config.compression_level = command_line_args.get_compression_level();
+        archive_user_config.output_dir = command_line_args.get_output_dir();
+        archive_user_config.global_metadata_db = global_metadata_db.get();
+        archive_user_config.print_archive_stats_progress = command_line_args.print_archive_stats_progress();
+        // NOTE: Ingested streams are interleaved, so there's nothing to gain from buffering them for segment packing
+        archive_user_config.segment_packing_window_size = 0;
+        archive_user_config.use_huge_pages_for_columns = command_line_args.use_huge_pages_for_columns();
+        archive_user_config.memory_budget = command_line_args.get_memory_budget();
+
+        streaming_archive::writer::Archive archive_writer;
+        archive_writer.open(archive_user_config);
+
+        const auto& socket_path = command_line_args.get_socket_path();
+        IrStreamListener listener;
+        listener.open(socket_path, cMaxNumPendingBatches);
+
+        s_stop_requested = 0;
+        std::signal(SIGINT, handle_stop_signal);
+        std::signal(SIGTERM, handle_stop_signal);
+        SPDLOG_INFO("Listening for IR streams on {}", socket_path);
+
+        IngestedStreamWriter stream_writer(listener, archive_user_config, archive_writer, socket_path + '/',
+                                           command_line_args.get_target_encoded_file_size(), command_line_args.get_target_data_size_of_dictionaries(),
+                                           cMinNumEventsPerSplit, cMaxNumBufferedEvents, cMaxBufferingTime);
+
+        const std::chrono::seconds archive_roll_interval(command_line_args.get_archive_roll_interval());
+        auto archive_roll_time = std::chrono::steady_clock::now() + archive_roll_interval;
+        auto archive_creation_num = archive_user_config.creation_num;
+        const std::chrono::seconds publish_interval(command_line_args.get_publish_interval());
+        auto publish_time = std::chrono::steady_clock::now() + publish_interval;
+        bool is_stopping = false;
+        while (true) {
+            if (false == is_stopping && 0 != s_stop_requested) {
+                SPDLOG_INFO("Stopping ingestion...");
+                listener.request_stop();
+                is_stopping = true;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (archive_user_config.creation_num != archive_creation_num) {
+                // The archive was split because it reached its target size
+                archive_creation_num = archive_user_config.creation_num;
+                archive_roll_time = now + archive_roll_interval;
+            }
+            stream_writer.write_expired_batches(now);
+            auto wait_time = cMaxBatchWaitTime;
+            if (archive_roll_interval.count() > 0) {
+                if (now >= archive_roll_time) {
+                    stream_writer.roll_archive();
+                    archive_creation_num = archive_user_config.creation_num;
+                    archive_roll_time = now + archive_roll_interval;
+                }
+                wait_time = std::min(wait_time, std::chrono::duration_cast<std::chrono::milliseconds>(archive_roll_time - now));
+            }
+            if (publish_interval.count() > 0) {
+                if (now >= publish_time) {
+                    stream_writer.publish();
+                    publish_time = now + publish_interval;
+                }
+                wait_time = std::min(wait_time, std::chrono::duration_cast<std::chrono::milliseconds>(publish_time - now));
+            }
+
+            std::unique_ptr<IrStreamListener::EventBatch> batch;
+            error_code = listener.try_get_next_batch(batch, wait_time);
+            if (ErrorCode_EndOfFile == error_code) {
+                break;
+            }
+            if (ErrorCode_Success != error_code) {
+                continue;
+            }
+
+            stream_writer.write_batch(std::move(batch));
+        }
+
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+
+        stream_writer.close();
+        archive_writer.close();
+        listener.close();
+
+        return true;
+    }
+}
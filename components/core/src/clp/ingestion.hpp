@@ -0,0 +1,20 @@
+#ifndef CLP_INGESTION_HPP
+#define CLP_INGESTION_HPP
+
+// Project headers
+#include "CommandLineArguments.hpp"
+
+namespace clp {
+    /**
+     * Listens for IR streams on a Unix domain socket and compresses them into archives until interrupted (SIGINT or SIGTERM). Streams from
+     * concurrent producers are interleaved, so each stream's events are buffered and written in runs, storing the stream as a sequence of file
+     * splits. Encoded files and archives are split when they reach their target sizes, and archives are also closed once they've been open for
+     * the configured roll interval. Ingested events become searchable when their archive is closed or, if a publish interval is configured, when
+     * the open archive's segments are periodically closed.
+     * @param command_line_args
+     * @return true if ingestion stopped cleanly, false otherwise
+     */
+    bool ingest (CommandLineArguments& command_line_args);
+}
+
+#endif // CLP_INGESTION_HPP
@@ -14,6 +14,7 @@
 #include "CommandLineArguments.hpp"
 #include "compression.hpp"
 #include "decompression.hpp"
+#include "ingestion.hpp"
 #include "utils.hpp"
 
 using clp::CommandLineArguments;
@@ -110,6 +111,25 @@ namespace clp {
             if (!compression_successful) {
                 return -1;
             }
+        } else if (CommandLineArguments::Command::Ingest == command_line_args.get_command()) {
+            bool ingestion_successful;
+            try {
+                ingestion_successful = ingest(command_line_args);
+            } catch (TraceableException& e) {
+                ErrorCode error_code = e.get_error_code();
+                if (ErrorCode_errno == error_code) {
+                    SPDLOG_ERROR("Ingestion failed: {}:{} {}, errno={}", e.get_filename(), e.get_line_number(), e.what(), errno);
+                } else {
+                    SPDLOG_ERROR("Ingestion failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(), error_code);
+                }
+                ingestion_successful = false;
+            } catch (std::exception& e) {
+                SPDLOG_ERROR("Ingestion failed: Unexpected exception - {}", e.what());
+                ingestion_successful = false;
+            }
+            if (false == ingestion_successful) {
+                return -1;
+            }
         } else { // CommandLineArguments::Command::Extract == command
             unordered_set<string> files_to_decompress(input_paths.cbegin(), input_paths.cend());
             if (!decompress(command_line_args, files_to_decompress)) {
@@ -119,6 +139,16 @@ namespace clp {
 
         Profiler::stop_continuous_measurement<Profiler::ContinuousMeasurementIndex::Compression>();
         LOG_CONTINUOUS_MEASUREMENT(Profiler::ContinuousMeasurementIndex::Compression)
+        LOG_COUNTER(Profiler::CounterIndex::ColumnBufferPageFaultsAvoided)
+        if (false == command_line_args.get_profile_output_path().empty()) {
+            try {
+                Profiler::write_report(command_line_args.get_profile_output_path());
+            } catch (TraceableException& e) {
+                SPDLOG_ERROR("Failed to write profile report to {}: {}:{} {}, errno={}", command_line_args.get_profile_output_path(),
+                             e.get_filename(), e.get_line_number(), e.what(), errno);
+                return -1;
+            }
+        }
 
         return 0;
     }
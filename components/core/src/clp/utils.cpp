@@ -9,6 +9,8 @@
 
 // Project headers
 #include "../ErrorCode.hpp"
+#include "../GlobalMySQLMetadataDB.hpp"
+#include "../GlobalSQLiteMetadataDB.hpp"
 #include "../spdlog_with_specializations.hpp"
 #include "../Utils.hpp"
 
@@ -16,6 +18,25 @@ using std::string;
 using std::vector;
 
 namespace clp {
+    std::unique_ptr<GlobalMetadataDB> create_global_metadata_db (const GlobalMetadataDBConfig& global_metadata_db_config,
+                                                                 const boost::filesystem::path& output_dir)
+    {
+        switch (global_metadata_db_config.get_metadata_db_type()) {
+            case GlobalMetadataDBConfig::MetadataDBType::SQLite: {
+                auto global_metadata_db_path = output_dir / streaming_archive::cMetadataDBFileName;
+                return std::make_unique<GlobalSQLiteMetadataDB>(global_metadata_db_path.string());
+            }
+            case GlobalMetadataDBConfig::MetadataDBType::MySQL:
+                return std::make_unique<GlobalMySQLMetadataDB>(global_metadata_db_config.get_metadata_db_host(),
+                                                               global_metadata_db_config.get_metadata_db_port(),
+                                                               global_metadata_db_config.get_metadata_db_username(),
+                                                               global_metadata_db_config.get_metadata_db_password(),
+                                                               global_metadata_db_config.get_metadata_db_name(),
+                                                               global_metadata_db_config.get_metadata_table_prefix());
+        }
+        return nullptr;
+    }
+
     bool find_all_files_and_empty_directories (boost::filesystem::path& path_prefix_to_remove, const string& path, vector<FileToCompress>& file_paths,
                                                vector<string>& empty_directory_paths)
     {
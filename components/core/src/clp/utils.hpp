@@ -2,17 +2,29 @@
 #define CLP_UTILS_HPP
 
 // C++ standard libraries
+#include <memory>
 #include <string>
 
 // Boost libraries
 #include <boost/filesystem/path.hpp>
 
 // Project headers
+#include "../GlobalMetadataDB.hpp"
+#include "../GlobalMetadataDBConfig.hpp"
 #include "../streaming_archive/writer/Archive.hpp"
 #include "../streaming_archive/writer/File.hpp"
 #include "FileToCompress.hpp"
 
 namespace clp {
+    /**
+     * Creates the global metadata DB described by the given config
+     * @param global_metadata_db_config
+     * @param output_dir Directory in which to create the DB, if it's a SQLite DB
+     * @return The global metadata DB
+     */
+    std::unique_ptr<GlobalMetadataDB> create_global_metadata_db (const GlobalMetadataDBConfig& global_metadata_db_config,
+                                                                 const boost::filesystem::path& output_dir);
+
     /**
      * Recursively finds all files and empty directories at the given path
      * @param path_prefix_to_remove
@@ -0,0 +1,183 @@
+#include "CommandLineArguments.hpp"
+
+// C++ standard libraries
+#include <iostream>
+
+// Boost libraries
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+// Project headers
+#include "../spdlog_with_specializations.hpp"
+#include "../version.hpp"
+#include "benchmarks.hpp"
+
+namespace po = boost::program_options;
+using std::cerr;
+using std::endl;
+using std::exception;
+using std::invalid_argument;
+using std::string;
+using std::vector;
+
+namespace clp_bench {
+    CommandLineArgumentsBase::ParsingResult CommandLineArguments::parse_arguments (int argc, const char* argv[]) {
+        // Print out basic usage if user doesn't specify any options
+        if (1 == argc) {
+            print_basic_usage();
+            return ParsingResult::Failure;
+        }
+
+        // By default, use the clp and clg executables beside this one
+        auto executables_dir = boost::filesystem::path(argv[0]).parent_path();
+        m_clp_path = (executables_dir / "clp").string();
+        m_clg_path = (executables_dir / "clg").string();
+
+        // Define general options
+        po::options_description options_general("General Options");
+        options_general.add_options()
+                ("help,h", "Print help")
+                ("version,V", "Print version")
+                ;
+
+        // Define corpus options
+        po::options_description options_corpus("Corpus Options");
+        string timestamp_format_names = boost::algorithm::join(m_log_generator_config.timestamp_format_names, ",");
+        options_corpus.add_options()
+                ("num-messages", po::value<size_t>(&m_log_generator_config.num_messages)->value_name("N")
+                        ->default_value(m_log_generator_config.num_messages), "Generate N messages")
+                ("num-files", po::value<size_t>(&m_log_generator_config.num_files)->value_name("N")
+                        ->default_value(m_log_generator_config.num_files), "Split the messages across N files")
+                ("num-logtypes", po::value<size_t>(&m_log_generator_config.num_logtypes)->value_name("N")
+                        ->default_value(m_log_generator_config.num_logtypes), "Generate messages from N distinct logtypes")
+                ("num-variable-values", po::value<size_t>(&m_log_generator_config.num_dictionary_variable_values)->value_name("N")
+                        ->default_value(m_log_generator_config.num_dictionary_variable_values),
+                        "Draw dictionary variables from N distinct values")
+                ("multiline-ratio", po::value<double>(&m_log_generator_config.multiline_message_ratio)->value_name("RATIO")
+                        ->default_value(m_log_generator_config.multiline_message_ratio), "Make RATIO of the messages multiline")
+                ("timestamp-formats", po::value<string>(&timestamp_format_names)->value_name("NAMES")->default_value(timestamp_format_names),
+                        ("Comma-separated timestamp formats to use, one per file, from: " + LogGenerator::get_timestamp_format_names()).c_str())
+                ("seed", po::value<uint64_t>(&m_log_generator_config.seed)->value_name("N")->default_value(m_log_generator_config.seed),
+                        "Seed for the generator (the same options and seed always generate the same corpus)")
+                ;
+
+        // Define benchmark options
+        po::options_description options_benchmark("Benchmark Options");
+        string benchmark_names = clp_bench::get_benchmark_names();
+        options_benchmark.add_options()
+                ("benchmarks", po::value<string>(&benchmark_names)->value_name("NAMES")->default_value(benchmark_names),
+                        "Comma-separated benchmarks to run")
+                ("repetitions", po::value<size_t>(&m_num_repetitions)->value_name("N")->default_value(m_num_repetitions),
+                        "Run each benchmark N times")
+                ("clp-path", po::value<string>(&m_clp_path)->value_name("PATH")->default_value(m_clp_path), "Path of the clp executable")
+                ("clg-path", po::value<string>(&m_clg_path)->value_name("PATH")->default_value(m_clg_path), "Path of the clg executable")
+                ("output", po::value<string>(&m_output_path)->value_name("FILE"), "Write the results to FILE instead of stdout")
+                ;
+
+        // Define visible options
+        po::options_description visible_options;
+        visible_options.add(options_general);
+        visible_options.add(options_corpus);
+        visible_options.add(options_benchmark);
+
+        // Define hidden positional options (not shown in Boost's program options help message)
+        po::options_description hidden_positional_options;
+        hidden_positional_options.add_options()
+                ("work-dir", po::value<string>(&m_work_dir))
+                ;
+        po::positional_options_description positional_options_description;
+        positional_options_description.add("work-dir", 1);
+
+        // Aggregate all options
+        po::options_description all_options;
+        all_options.add(visible_options);
+        all_options.add(hidden_positional_options);
+
+        // Parse options
+        try {
+            // Parse options specified on the command line
+            po::parsed_options parsed = po::command_line_parser(argc, argv).options(all_options).positional(positional_options_description).run();
+            po::variables_map parsed_command_line_options;
+            store(parsed, parsed_command_line_options);
+
+            notify(parsed_command_line_options);
+
+            // Handle --help
+            if (parsed_command_line_options.count("help")) {
+                if (argc > 2) {
+                    SPDLOG_WARN("Ignoring all options besides --help.");
+                }
+
+                print_basic_usage();
+                cerr << endl;
+                cerr << "Generates a synthetic log corpus in WORK_DIR, then benchmarks compressing, searching, and extracting it, and outputs"
+                     << " the results as JSON." << endl;
+                cerr << "Benchmarks:" << endl;
+                cerr << "  compress-heuristic - Compress the corpus without a schema" << endl;
+                cerr << "  compress-schema - Compress the corpus with a schema" << endl;
+                cerr << "  search-needle - Search for a variable which occurs in a single message" << endl;
+                cerr << "  search-wildcard - Search for a wildcard query which matches a subset of logtypes" << endl;
+                cerr << "  search-time-range - Search for all messages in the middle 10% of the corpus' time range" << endl;
+                cerr << "  extract - Extract all files" << endl;
+                cerr << endl;
+
+                cerr << visible_options << endl;
+                return ParsingResult::InfoCommand;
+            }
+
+            // Handle --version
+            if (parsed_command_line_options.count("version")) {
+                cerr << cVersion << endl;
+                return ParsingResult::InfoCommand;
+            }
+
+            // Validate required parameters
+            if (m_work_dir.empty()) {
+                throw invalid_argument("WORK_DIR not specified or empty.");
+            }
+
+            // Validate corpus options
+            if (0 == m_log_generator_config.num_files) {
+                throw invalid_argument("num-files must be greater than 0.");
+            }
+            if (0 == m_log_generator_config.num_logtypes || m_log_generator_config.num_logtypes > LogGenerator::cMaxNumLogtypes) {
+                throw invalid_argument("num-logtypes must be in [1, " + std::to_string(LogGenerator::cMaxNumLogtypes) + "].");
+            }
+            if (0 == m_log_generator_config.num_dictionary_variable_values) {
+                throw invalid_argument("num-variable-values must be greater than 0.");
+            }
+            if (m_log_generator_config.multiline_message_ratio < 0 || m_log_generator_config.multiline_message_ratio > 1) {
+                throw invalid_argument("multiline-ratio must be in [0, 1].");
+            }
+            m_log_generator_config.timestamp_format_names.clear();
+            boost::algorithm::split(m_log_generator_config.timestamp_format_names, timestamp_format_names, boost::algorithm::is_any_of(","));
+            for (const auto& name : m_log_generator_config.timestamp_format_names) {
+                if (false == LogGenerator::is_known_timestamp_format(name)) {
+                    throw invalid_argument("Unknown timestamp format '" + name + "'.");
+                }
+            }
+
+            // Validate benchmark options
+            boost::algorithm::split(m_benchmark_names, benchmark_names, boost::algorithm::is_any_of(","));
+            for (const auto& name : m_benchmark_names) {
+                if (false == is_known_benchmark(name)) {
+                    throw invalid_argument("Unknown benchmark '" + name + "'.");
+                }
+            }
+            if (0 == m_num_repetitions) {
+                throw invalid_argument("repetitions must be greater than 0.");
+            }
+        } catch (exception& e) {
+            SPDLOG_ERROR("{}", e.what());
+            print_basic_usage();
+            return ParsingResult::Failure;
+        }
+
+        return ParsingResult::Success;
+    }
+
+    void CommandLineArguments::print_basic_usage () const {
+        cerr << "Usage: " << get_program_name() << " [OPTIONS] WORK_DIR" << endl;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef CLP_BENCH_COMMANDLINEARGUMENTS_HPP
+#define CLP_BENCH_COMMANDLINEARGUMENTS_HPP
+
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Project headers
+#include "../CommandLineArgumentsBase.hpp"
+#include "LogGenerator.hpp"
+
+namespace clp_bench {
+    class CommandLineArguments : public CommandLineArgumentsBase {
+    public:
+        // Constructors
+        explicit CommandLineArguments (const std::string& program_name) : CommandLineArgumentsBase(program_name), m_num_repetitions(3) {}
+
+        // Methods
+        ParsingResult parse_arguments (int argc, const char* argv[]) override;
+
+        const LogGenerator::Config& get_log_generator_config () const { return m_log_generator_config; }
+        size_t get_num_repetitions () const { return m_num_repetitions; }
+        const std::vector<std::string>& get_benchmark_names () const { return m_benchmark_names; }
+        const std::string& get_clp_path () const { return m_clp_path; }
+        const std::string& get_clg_path () const { return m_clg_path; }
+        const std::string& get_output_path () const { return m_output_path; }
+        const std::string& get_work_dir () const { return m_work_dir; }
+
+    private:
+        // Methods
+        void print_basic_usage () const override;
+
+        // Variables
+        LogGenerator::Config m_log_generator_config;
+        size_t m_num_repetitions;
+        std::vector<std::string> m_benchmark_names;
+        std::string m_clp_path;
+        std::string m_clg_path;
+        std::string m_output_path;
+        std::string m_work_dir;
+    };
+}
+
+#endif // CLP_BENCH_COMMANDLINEARGUMENTS_HPP
@@ -0,0 +1,284 @@
+#include "LogGenerator.hpp"
+
+// Project headers
+#include "../FileWriter.hpp"
+
+using std::string;
+using std::to_string;
+using std::vector;
+
+namespace {
+    struct TimestampFormat {
+        const char* name;
+        // Format understood by TimestampPattern
+        const char* pattern;
+        // Regex matching the format in a schema file
+        const char* schema_regex;
+    };
+
+    constexpr TimestampFormat cTimestampFormats[] = {
+            // E.g. 2023-01-01 00:00:00,000
+            {"default", "%Y-%m-%d %H:%M:%S,%3", R"(\d{4}\-\d{2}\-\d{2} \d{2}:\d{2}:\d{2},\d{3})"},
+            // E.g. 2023-01-01T00:00:00.000
+            {"iso8601", "%Y-%m-%dT%H:%M:%S.%3", R"(\d{4}\-\d{2}\-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3})"},
+            // E.g. [20230101-00:00:00]
+            {"compact", "[%Y%m%d-%H:%M:%S]", R"(\[\d{8}\-\d{2}:\d{2}:\d{2}\])"},
+            // E.g. 2023/01/01 00:00:00
+            {"slashes", "%Y/%m/%d %H:%M:%S", R"(\d{4}/\d{2}/\d{2} \d{2}:\d{2}:\d{2})"},
+            // E.g. 01 Jan 2023 00:00:00,000
+            {"month-name", "%d %b %Y %H:%M:%S,%3", R"(\d{2} [A-Z][a-z]{2} \d{4} \d{2}:\d{2}:\d{2},\d{3})"},
+    };
+
+    constexpr const char* cLevels[] = {"INFO", "INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"};
+    constexpr const char* cComponents[] = {"main", "scheduler", "executor", "storage", "network", "metrics", "auth", "cache"};
+    constexpr const char* cDictionaryVariablePrefixes[] = {"blk_", "task_", "container_", "attempt_", "session_"};
+    // NOTE: LogGenerator::cMaxNumLogtypes depends on the number of words
+    constexpr const char* cWords[] = {
+            "accepted", "acquired", "added", "allocated", "applied", "assigned", "started", "blocked",
+            "buffer", "cancelled", "checkpoint", "client", "closed", "committed", "completed", "connection",
+            "created", "deleted", "detected", "disk", "dropped", "elapsed", "enqueued", "expired",
+            "failed", "fetched", "finished", "flushed", "granted", "heartbeat", "ignored", "initialized",
+            "job", "joined", "lease", "leader", "loaded", "lock", "lost", "merged",
+            "node", "opened", "partition", "pending", "queue", "received", "recovered", "registered",
+            "released", "removed", "replica", "request", "retrying", "scheduled", "sent", "shutdown",
+            "snapshot", "stopped", "stream", "timeout", "updated", "waiting", "worker", "written",
+    };
+    constexpr size_t cNumWords = sizeof(cWords) / sizeof(cWords[0]);
+    static_assert(cNumWords * cNumWords * cNumWords == clp_bench::LogGenerator::cMaxNumLogtypes);
+
+    constexpr size_t cMaxNumVariablesPerLogtype = 4;
+    constexpr size_t cMaxNumExtraWordsPerLogtype = 3;
+    constexpr size_t cMaxNumContinuationLines = 8;
+    constexpr size_t cMaxTimestampIncrement = 10;
+
+    /**
+     * @param name
+     * @return The timestamp format with the given name or nullptr if there's no such format
+     */
+    const TimestampFormat* find_timestamp_format (const string& name) {
+        for (const auto& format : cTimestampFormats) {
+            if (name == format.name) {
+                return &format;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Mixes the bits of the given value (splitmix64's finalizer)
+     * @param value
+     * @return The mixed value
+     */
+    uint64_t mix (uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+}
+
+namespace clp_bench {
+    LogGenerator::LogGenerator (const Config& config) : m_config(config), m_random_number_generator(config.seed), m_num_uncompressed_bytes(0),
+                                                        m_end_timestamp(cBeginTimestamp)
+    {
+        if (0 == m_config.num_files || 0 == m_config.num_logtypes || m_config.num_logtypes > cMaxNumLogtypes ||
+            0 == m_config.num_dictionary_variable_values || m_config.multiline_message_ratio < 0 || m_config.multiline_message_ratio > 1 ||
+            m_config.timestamp_format_names.empty())
+        {
+            throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
+        }
+        for (const auto& name : m_config.timestamp_format_names) {
+            auto format = find_timestamp_format(name);
+            if (nullptr == format) {
+                throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
+            }
+            m_timestamp_patterns.emplace_back(0, format->pattern);
+        }
+
+        m_needle = "needle_" + to_string(m_config.seed);
+
+        generate_logtypes();
+    }
+
+    bool LogGenerator::is_known_timestamp_format (const string& name) {
+        return nullptr != find_timestamp_format(name);
+    }
+
+    string LogGenerator::get_timestamp_format_names () {
+        string names;
+        for (const auto& format : cTimestampFormats) {
+            if (false == names.empty()) {
+                names += ',';
+            }
+            names += format.name;
+        }
+        return names;
+    }
+
+    void LogGenerator::generate (const string& output_dir) {
+        m_file_paths.clear();
+        m_num_uncompressed_bytes = 0;
+        epochtime_t timestamp = cBeginTimestamp;
+
+        const size_t needle_message_ix = m_config.num_messages / 2;
+        FileWriter file_writer;
+        string message;
+        for (size_t file_ix = 0; file_ix < m_config.num_files; ++file_ix) {
+            m_file_paths.emplace_back(output_dir + "/log-" + to_string(file_ix) + ".log");
+            file_writer.open(m_file_paths.back(), FileWriter::OpenMode::CREATE_FOR_WRITING);
+
+            const auto& timestamp_pattern = m_timestamp_patterns[file_ix % m_timestamp_patterns.size()];
+            size_t end_message_ix = (file_ix + 1) * m_config.num_messages / m_config.num_files;
+            for (size_t message_ix = file_ix * m_config.num_messages / m_config.num_files; message_ix < end_message_ix; ++message_ix) {
+                timestamp += static_cast<epochtime_t>(get_random_value(cMaxTimestampIncrement));
+                if (needle_message_ix == message_ix) {
+                    message = " ERROR [main] found ";
+                    message += m_needle;
+                    message += '\n';
+                } else {
+                    generate_message(message);
+                }
+                timestamp_pattern.insert_formatted_timestamp(timestamp, message);
+
+                file_writer.write_string(message);
+                m_num_uncompressed_bytes += message.length();
+            }
+
+            file_writer.close();
+        }
+        m_end_timestamp = timestamp;
+    }
+
+    void LogGenerator::write_schema_file (const string& path) const {
+        FileWriter file_writer;
+        file_writer.open(path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+
+        file_writer.write_string("// Delimiters\n");
+        file_writer.write_string(R"(delimiters: \t\r\n!"#$%&'\(\)\*,:;<>?@\[\]\^_`\{\|\}~)" "\n\n");
+
+        file_writer.write_string("// Timestamps\n");
+        for (const auto& name : m_config.timestamp_format_names) {
+            file_writer.write_string("timestamp:");
+            file_writer.write_string(find_timestamp_format(name)->schema_regex);
+            file_writer.write_char('\n');
+        }
+
+        file_writer.write_string("\n// Specially-encoded variables\n");
+        file_writer.write_string(R"(int:\-{0,1}[0-9]+)" "\n");
+        file_writer.write_string(R"(double:\-{0,1}[0-9]+\.[0-9]+)" "\n");
+
+        file_writer.write_string("\n// Dictionary variables\n");
+        file_writer.write_string("hex:[a-fA-F]+\n");
+        file_writer.write_string(R"(hasNumber:.*\d.*)" "\n");
+        file_writer.write_string("equals:.*=.*[a-zA-Z0-9].*\n");
+
+        file_writer.close();
+    }
+
+    bool LogGenerator::get_random_bool (double probability) {
+        // Use the top 53 bits as the mantissa of a double in [0, 1)
+        return static_cast<double>(m_random_number_generator() >> 11) * 0x1.0p-53 < probability;
+    }
+
+    void LogGenerator::generate_logtypes () {
+        m_logtypes.resize(m_config.num_logtypes);
+        vector<string> parts;
+        for (size_t logtype_ix = 0; logtype_ix < m_config.num_logtypes; ++logtype_ix) {
+            // Identify the logtype with a unique combination of words, then add variables and some extra words
+            parts.clear();
+            for (size_t i = 0, remainder = logtype_ix; i < 3; ++i, remainder /= cNumWords) {
+                parts.emplace_back(cWords[remainder % cNumWords]);
+            }
+            auto num_variables = 1 + get_random_value(cMaxNumVariablesPerLogtype);
+            for (size_t i = 0; i < num_variables; ++i) {
+                // An empty part represents a variable
+                parts.emplace_back();
+            }
+            auto num_extra_words = get_random_value(cMaxNumExtraWordsPerLogtype + 1);
+            for (size_t i = 0; i < num_extra_words; ++i) {
+                parts.emplace_back(cWords[get_random_value(cNumWords)]);
+            }
+            // Fisher-Yates shuffle (std::shuffle's results are implementation-defined)
+            for (size_t i = parts.size() - 1; i > 0; --i) {
+                std::swap(parts[i], parts[get_random_value(i + 1)]);
+            }
+
+            auto& logtype = m_logtypes[logtype_ix];
+            string constant = " ";
+            constant += cLevels[get_random_value(std::size(cLevels))];
+            constant += " [";
+            constant += cComponents[logtype_ix % std::size(cComponents)];
+            constant += ']';
+            for (const auto& part : parts) {
+                constant += ' ';
+                if (false == part.empty()) {
+                    constant += part;
+                    continue;
+                }
+
+                logtype.push_back({TokenType::Constant, constant});
+                constant.clear();
+                switch (get_random_value(3)) {
+                    case 0:
+                        logtype.push_back({TokenType::Integer, {}});
+                        break;
+                    case 1:
+                        logtype.push_back({TokenType::Float, {}});
+                        break;
+                    default:
+                        logtype.push_back({TokenType::DictionaryVariable, {}});
+                        break;
+                }
+            }
+            constant += '\n';
+            logtype.push_back({TokenType::Constant, constant});
+        }
+    }
+
+    void LogGenerator::append_dictionary_variable (uint64_t value_ix, string& message) const {
+        // Derive the value's prefix and some noise from its index, so each index always maps to the same value
+        auto hash = mix(value_ix + m_config.seed * 0x9E3779B97F4A7C15ULL);
+        message += cDictionaryVariablePrefixes[hash % std::size(cDictionaryVariablePrefixes)];
+        message += to_string((hash >> 32) % 1000);
+        message += '_';
+        message += to_string(value_ix);
+    }
+
+    void LogGenerator::generate_message (string& message) {
+        message.clear();
+        const auto& logtype = m_logtypes[get_random_value(m_logtypes.size())];
+        for (const auto& token : logtype) {
+            switch (token.type) {
+                case TokenType::Constant:
+                    message += token.constant;
+                    break;
+                case TokenType::Integer:
+                    message += to_string(get_random_value(100'000));
+                    break;
+                case TokenType::Float: {
+                    // Format the float ourselves since printf's output depends on the locale
+                    auto thousandths = get_random_value(10'000'000);
+                    auto fraction = to_string(thousandths % 1000);
+                    message += to_string(thousandths / 1000);
+                    message += '.';
+                    message.append(3 - fraction.length(), '0');
+                    message += fraction;
+                    break;
+                }
+                case TokenType::DictionaryVariable:
+                    append_dictionary_variable(get_random_value(m_config.num_dictionary_variable_values), message);
+                    break;
+            }
+        }
+
+        if (get_random_bool(m_config.multiline_message_ratio)) {
+            auto num_continuation_lines = 1 + get_random_value(cMaxNumContinuationLines);
+            for (size_t i = 0; i < num_continuation_lines; ++i) {
+                message += "\tat com.example.";
+                message += cWords[get_random_value(cNumWords)];
+                message += ".Handler.run(Handler.java:";
+                message += to_string(get_random_value(1000));
+                message += ")\n";
+            }
+        }
+    }
+}
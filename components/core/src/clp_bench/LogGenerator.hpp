@@ -0,0 +1,151 @@
+#ifndef CLP_BENCH_LOGGENERATOR_HPP
+#define CLP_BENCH_LOGGENERATOR_HPP
+
+// C++ standard libraries
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Project headers
+#include "../Defs.h"
+#include "../ErrorCode.hpp"
+#include "../TimestampPattern.hpp"
+#include "../TraceableException.hpp"
+
+namespace clp_bench {
+    /**
+     * Class to generate a synthetic corpus of unstructured log files. The corpus is fully determined by the generator's config, so the same
+     * config produces byte-identical files on every platform. (We only use std::mt19937_64 and our own arithmetic on its output, since the
+     * standard library's distributions are implementation-defined.)
+     *
+     * Each message is an instance of one of a fixed number of logtypes, containing integer, float, and dictionary variables. Dictionary
+     * variables are drawn from a pool of fixed size. A configurable fraction of messages are multiline (e.g., followed by a stack trace). The
+     * messages are split evenly across files in increasing timestamp order, with each file using one of the configured timestamp formats.
+     */
+    class LogGenerator {
+    public:
+        // Types
+        class OperationFailed : public TraceableException {
+        public:
+            // Constructors
+            OperationFailed (ErrorCode error_code, const char* const filename, int line_number) :
+                    TraceableException (error_code, filename, line_number) {}
+
+            // Methods
+            const char* what () const noexcept override {
+                return "clp_bench::LogGenerator operation failed";
+            }
+        };
+
+        struct Config {
+            Config () : num_messages(1'000'000), num_files(8), num_logtypes(1000), num_dictionary_variable_values(100'000),
+                        multiline_message_ratio(0.01), timestamp_format_names({"default"}), seed(1) {}
+
+            size_t num_messages;
+            size_t num_files;
+            size_t num_logtypes;
+            size_t num_dictionary_variable_values;
+            // Fraction of messages which span multiple lines
+            double multiline_message_ratio;
+            // Names of the timestamp formats to use, assigned to files round-robin
+            std::vector<std::string> timestamp_format_names;
+            uint64_t seed;
+        };
+
+        // Constants
+        // Each logtype is identified by a combination of words from the generator's vocabulary, which limits the number of logtypes
+        static constexpr size_t cMaxNumLogtypes = 64 * 64 * 64;
+        static constexpr epochtime_t cBeginTimestamp = 1'672'531'200'000;  // 2023-01-01T00:00:00Z
+
+        // Constructors
+        /**
+         * @param config
+         * @throw LogGenerator::OperationFailed if the config is invalid
+         */
+        explicit LogGenerator (const Config& config);
+
+        // Methods
+        /**
+         * @param name
+         * @return Whether the given name is one of the generator's timestamp formats
+         */
+        static bool is_known_timestamp_format (const std::string& name);
+        /**
+         * @return The names of the generator's timestamp formats, separated by commas
+         */
+        static std::string get_timestamp_format_names ();
+
+        /**
+         * Generates the corpus into the given directory, which must already exist
+         * @param output_dir
+         * @throw FileWriter::OperationFailed if a file couldn't be written
+         */
+        void generate (const std::string& output_dir);
+        /**
+         * Writes a schema file which matches the corpus' timestamp formats and variables
+         * @param path
+         * @throw FileWriter::OperationFailed if the file couldn't be written
+         */
+        void write_schema_file (const std::string& path) const;
+
+        const Config& get_config () const { return m_config; }
+        const std::vector<std::string>& get_file_paths () const { return m_file_paths; }
+        size_t get_num_uncompressed_bytes () const { return m_num_uncompressed_bytes; }
+        epochtime_t get_end_timestamp () const { return m_end_timestamp; }
+        /**
+         * @return A dictionary variable which occurs in exactly one message of the corpus
+         */
+        const std::string& get_needle () const { return m_needle; }
+
+    private:
+        // Types
+        enum class TokenType : uint8_t {
+            Constant,
+            Integer,
+            Float,
+            DictionaryVariable
+        };
+
+        struct Token {
+            TokenType type;
+            std::string constant;
+        };
+
+        // Methods
+        /**
+         * @return A uniformly distributed value in [0, n)
+         */
+        uint64_t get_random_value (uint64_t n) { return m_random_number_generator() % n; }
+        /**
+         * @return Whether an event with the given probability should occur
+         */
+        bool get_random_bool (double probability);
+
+        void generate_logtypes ();
+        /**
+         * Appends the given dictionary variable value (identified by its index in the pool) to the message
+         * @param value_ix
+         * @param message
+         */
+        void append_dictionary_variable (uint64_t value_ix, std::string& message) const;
+        /**
+         * Generates the next message without its timestamp
+         * @param message
+         */
+        void generate_message (std::string& message);
+
+        // Variables
+        Config m_config;
+        std::vector<TimestampPattern> m_timestamp_patterns;
+        std::vector<std::vector<Token>> m_logtypes;
+        std::mt19937_64 m_random_number_generator;
+
+        std::vector<std::string> m_file_paths;
+        size_t m_num_uncompressed_bytes;
+        epochtime_t m_end_timestamp;
+        std::string m_needle;
+    };
+}
+
+#endif // CLP_BENCH_LOGGENERATOR_HPP
@@ -0,0 +1,312 @@
+#include "benchmarks.hpp"
+
+// C standard libraries
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Project headers
+#include "../spdlog_with_specializations.hpp"
+#include "../Stopwatch.hpp"
+#include "../version.hpp"
+#include "CommandLineArguments.hpp"
+#include "LogGenerator.hpp"
+
+using std::string;
+using std::to_string;
+using std::vector;
+
+namespace {
+    constexpr char cCompressHeuristicBenchmark[] = "compress-heuristic";
+    constexpr char cCompressSchemaBenchmark[] = "compress-schema";
+    constexpr char cSearchNeedleBenchmark[] = "search-needle";
+    constexpr char cSearchWildcardBenchmark[] = "search-wildcard";
+    constexpr char cSearchTimeRangeBenchmark[] = "search-time-range";
+    constexpr char cExtractBenchmark[] = "extract";
+    constexpr const char* cBenchmarkNames[] = {cCompressHeuristicBenchmark, cCompressSchemaBenchmark, cSearchNeedleBenchmark,
+                                               cSearchWildcardBenchmark, cSearchTimeRangeBenchmark, cExtractBenchmark};
+
+    // Matches ERROR messages containing task variables, i.e., a subset of logtypes and a subset of their messages
+    constexpr char cWildcardQuery[] = "*ERROR*task_*7*";
+
+    /**
+     * Runs the given command in a child process, discarding its stdout
+     * @param command
+     * @return Whether the command exited successfully
+     */
+    bool run_command (const vector<string>& command);
+    /**
+     * Gets the total size of the files in the given directory
+     * @param dir_path
+     * @return The size in bytes
+     */
+    uintmax_t get_size_of_directory (const boost::filesystem::path& dir_path);
+    /**
+     * Runs a benchmark's command the given number of times
+     * @param name
+     * @param command
+     * @param output_path A path the command creates, which is removed before each repetition, or an empty path
+     * @param profile_output_path The path the command writes its profiling report to, or an empty path
+     * @param num_repetitions
+     * @param num_uncompressed_bytes The number of uncompressed bytes the command processes, used to compute its throughput
+     * @param result Returns a JSON object containing the time taken and profiling report of each repetition, and the median throughput
+     * @return true on success, false otherwise
+     */
+    bool run_benchmark (const string& name, const vector<string>& command, const boost::filesystem::path& output_path,
+                        const boost::filesystem::path& profile_output_path, size_t num_repetitions, size_t num_uncompressed_bytes,
+                        nlohmann::json& result);
+
+    bool run_command (const vector<string>& command) {
+        vector<char*> argv;
+        for (const auto& arg : command) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        auto pid = fork();
+        if (-1 == pid) {
+            SPDLOG_ERROR("Failed to fork, errno={}", errno);
+            return false;
+        }
+        if (0 == pid) {
+            // Child
+            auto null_fd = open("/dev/null", O_WRONLY);
+            if (-1 == null_fd || -1 == dup2(null_fd, STDOUT_FILENO)) {
+                _exit(EXIT_FAILURE);
+            }
+            execvp(argv[0], argv.data());
+            // NOTE: We can't use the logger after forking
+            _exit(EXIT_FAILURE);
+        }
+
+        int status;
+        while (-1 == waitpid(pid, &status, 0)) {
+            if (EINTR != errno) {
+                SPDLOG_ERROR("Failed to wait for {}, errno={}", command[0], errno);
+                return false;
+            }
+        }
+        if (false == WIFEXITED(status) || 0 != WEXITSTATUS(status)) {
+            SPDLOG_ERROR("{} failed with status {}", command[0], status);
+            return false;
+        }
+        return true;
+    }
+
+    uintmax_t get_size_of_directory (const boost::filesystem::path& dir_path) {
+        uintmax_t size = 0;
+        for (boost::filesystem::recursive_directory_iterator it(dir_path), end; it != end; ++it) {
+            if (boost::filesystem::is_regular_file(it->status())) {
+                size += boost::filesystem::file_size(it->path());
+            }
+        }
+        return size;
+    }
+
+    bool run_benchmark (const string& name, const vector<string>& command, const boost::filesystem::path& output_path,
+                        const boost::filesystem::path& profile_output_path, size_t num_repetitions, size_t num_uncompressed_bytes,
+                        nlohmann::json& result)
+    {
+        result = nlohmann::json::object();
+        result["name"] = name;
+        result["command"] = command;
+        auto& repetitions = result["repetitions"] = nlohmann::json::array();
+
+        vector<double> times_taken_in_seconds;
+        for (size_t i = 0; i < num_repetitions; ++i) {
+            SPDLOG_INFO("Running {} ({}/{})", name, i + 1, num_repetitions);
+            if (false == output_path.empty()) {
+                boost::filesystem::remove_all(output_path);
+            }
+            if (false == profile_output_path.empty()) {
+                boost::filesystem::remove(profile_output_path);
+            }
+
+            Stopwatch stopwatch;
+            stopwatch.start();
+            if (false == run_command(command)) {
+                return false;
+            }
+            stopwatch.stop();
+            times_taken_in_seconds.push_back(stopwatch.get_time_taken_in_seconds());
+
+            nlohmann::json repetition = {{"seconds", times_taken_in_seconds.back()}};
+            // The profiling report is only useful if the executable was built with profiling enabled
+            std::ifstream profile_file(profile_output_path.string());
+            if (profile_file.is_open()) {
+                auto profile = nlohmann::json::parse(profile_file, nullptr, false);
+                if (false == profile.is_discarded() && false == profile.empty()) {
+                    repetition["profile"] = std::move(profile);
+                }
+            }
+            repetitions.push_back(std::move(repetition));
+        }
+
+        std::sort(times_taken_in_seconds.begin(), times_taken_in_seconds.end());
+        auto num_times = times_taken_in_seconds.size();
+        double median_seconds = (0 == num_times % 2)
+                ? (times_taken_in_seconds[num_times / 2 - 1] + times_taken_in_seconds[num_times / 2]) / 2
+                : times_taken_in_seconds[num_times / 2];
+        result["min_seconds"] = times_taken_in_seconds.front();
+        result["median_seconds"] = median_seconds;
+        result["max_seconds"] = times_taken_in_seconds.back();
+        result["throughput_bytes_per_second"] = static_cast<double>(num_uncompressed_bytes) / median_seconds;
+
+        return true;
+    }
+}
+
+namespace clp_bench {
+    bool is_known_benchmark (const string& name) {
+        return std::find(std::cbegin(cBenchmarkNames), std::cend(cBenchmarkNames), name) != std::cend(cBenchmarkNames);
+    }
+
+    string get_benchmark_names () {
+        string names;
+        for (const auto name : cBenchmarkNames) {
+            if (false == names.empty()) {
+                names += ',';
+            }
+            names += name;
+        }
+        return names;
+    }
+
+    bool run_benchmarks (const CommandLineArguments& command_line_args, nlohmann::json& results) {
+        const auto& benchmark_names = command_line_args.get_benchmark_names();
+        auto is_selected = [&benchmark_names] (const string& name) {
+            return std::find(benchmark_names.cbegin(), benchmark_names.cend(), name) != benchmark_names.cend();
+        };
+        auto num_repetitions = command_line_args.get_num_repetitions();
+        const auto& clp_path = command_line_args.get_clp_path();
+        const auto& clg_path = command_line_args.get_clg_path();
+
+        boost::filesystem::path work_dir(command_line_args.get_work_dir());
+        auto logs_dir = work_dir / "logs";
+        auto schema_path = work_dir / "schema.txt";
+        auto archives_dir = work_dir / "archives";
+        auto schema_archives_dir = work_dir / "archives-schema";
+        auto extraction_dir = work_dir / "extracted";
+        auto profile_output_path = work_dir / "profile.json";
+
+        // Generate the corpus
+        LogGenerator generator(command_line_args.get_log_generator_config());
+        SPDLOG_INFO("Generating corpus in {}", logs_dir.string());
+        boost::filesystem::remove_all(logs_dir);
+        boost::filesystem::create_directories(logs_dir);
+        generator.generate(logs_dir.string());
+        generator.write_schema_file(schema_path.string());
+
+        const auto& config = generator.get_config();
+        auto num_uncompressed_bytes = generator.get_num_uncompressed_bytes();
+        results = nlohmann::json::object();
+        results["version"] = cVersion;
+        results["corpus"] = {
+                {"num_messages", config.num_messages},
+                {"num_files", config.num_files},
+                {"num_logtypes", config.num_logtypes},
+                {"num_variable_values", config.num_dictionary_variable_values},
+                {"multiline_ratio", config.multiline_message_ratio},
+                {"timestamp_formats", config.timestamp_format_names},
+                {"seed", config.seed},
+                {"num_uncompressed_bytes", num_uncompressed_bytes}
+        };
+        auto& benchmark_results = results["benchmarks"] = nlohmann::json::array();
+        nlohmann::json result;
+
+        // Compression
+        vector<string> compress_command = {clp_path, "--profile-output", profile_output_path.string(), "c", archives_dir.string(),
+                                           logs_dir.string()};
+        if (is_selected(cCompressHeuristicBenchmark)) {
+            if (false == run_benchmark(cCompressHeuristicBenchmark, compress_command, archives_dir, profile_output_path, num_repetitions,
+                                       num_uncompressed_bytes, result))
+            {
+                return false;
+            }
+            auto compressed_size = get_size_of_directory(archives_dir);
+            result["compressed_bytes"] = compressed_size;
+            result["compression_ratio"] = static_cast<double>(num_uncompressed_bytes) / compressed_size;
+            benchmark_results.push_back(std::move(result));
+        } else if (is_selected(cSearchNeedleBenchmark) || is_selected(cSearchWildcardBenchmark) || is_selected(cSearchTimeRangeBenchmark) ||
+                   is_selected(cExtractBenchmark))
+        {
+            // The remaining benchmarks still need the archives
+            SPDLOG_INFO("Compressing corpus");
+            boost::filesystem::remove_all(archives_dir);
+            if (false == run_command(compress_command)) {
+                return false;
+            }
+        }
+        if (is_selected(cCompressSchemaBenchmark)) {
+            vector<string> command = {clp_path, "--profile-output", profile_output_path.string(), "c", "--schema-path", schema_path.string(),
+                                      schema_archives_dir.string(), logs_dir.string()};
+            if (false == run_benchmark(cCompressSchemaBenchmark, command, schema_archives_dir, profile_output_path, num_repetitions,
+                                       num_uncompressed_bytes, result))
+            {
+                return false;
+            }
+            auto compressed_size = get_size_of_directory(schema_archives_dir);
+            result["compressed_bytes"] = compressed_size;
+            result["compression_ratio"] = static_cast<double>(num_uncompressed_bytes) / compressed_size;
+            benchmark_results.push_back(std::move(result));
+        }
+
+        // Search
+        vector<string> search_command_prefix = {clg_path, "--profile-output", profile_output_path.string()};
+        if (is_selected(cSearchNeedleBenchmark)) {
+            auto command = search_command_prefix;
+            command.insert(command.end(), {archives_dir.string(), "*" + generator.get_needle() + "*"});
+            if (false == run_benchmark(cSearchNeedleBenchmark, command, {}, profile_output_path, num_repetitions, num_uncompressed_bytes,
+                                       result))
+            {
+                return false;
+            }
+            benchmark_results.push_back(std::move(result));
+        }
+        if (is_selected(cSearchWildcardBenchmark)) {
+            auto command = search_command_prefix;
+            command.insert(command.end(), {archives_dir.string(), cWildcardQuery});
+            if (false == run_benchmark(cSearchWildcardBenchmark, command, {}, profile_output_path, num_repetitions, num_uncompressed_bytes,
+                                       result))
+            {
+                return false;
+            }
+            benchmark_results.push_back(std::move(result));
+        }
+        if (is_selected(cSearchTimeRangeBenchmark)) {
+            auto time_range = generator.get_end_timestamp() - LogGenerator::cBeginTimestamp;
+            auto command = search_command_prefix;
+            command.insert(command.end(), {"--tge", to_string(LogGenerator::cBeginTimestamp + time_range * 45 / 100),
+                                           "--tlt", to_string(LogGenerator::cBeginTimestamp + time_range * 55 / 100),
+                                           archives_dir.string(), "*"});
+            if (false == run_benchmark(cSearchTimeRangeBenchmark, command, {}, profile_output_path, num_repetitions, num_uncompressed_bytes,
+                                       result))
+            {
+                return false;
+            }
+            benchmark_results.push_back(std::move(result));
+        }
+
+        // Extraction
+        if (is_selected(cExtractBenchmark)) {
+            vector<string> command = {clp_path, "--profile-output", profile_output_path.string(), "x", archives_dir.string(),
+                                      extraction_dir.string()};
+            if (false == run_benchmark(cExtractBenchmark, command, extraction_dir, profile_output_path, num_repetitions,
+                                       num_uncompressed_bytes, result))
+            {
+                return false;
+            }
+            benchmark_results.push_back(std::move(result));
+        }
+
+        return true;
+    }
+}
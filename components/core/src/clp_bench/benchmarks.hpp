@@ -0,0 +1,35 @@
+#ifndef CLP_BENCH_BENCHMARKS_HPP
+#define CLP_BENCH_BENCHMARKS_HPP
+
+// C++ standard libraries
+#include <string>
+
+// json
+#include <json/single_include/nlohmann/json.hpp>
+
+namespace clp_bench {
+    // Forward declarations
+    class CommandLineArguments;
+
+    /**
+     * @param name
+     * @return Whether the given name is the name of a benchmark
+     */
+    bool is_known_benchmark (const std::string& name);
+    /**
+     * @return The names of all benchmarks, separated by commas
+     */
+    std::string get_benchmark_names ();
+
+    /**
+     * Generates the corpus described by the command line arguments in the work directory and runs the selected benchmarks on it. Each
+     * benchmark runs clp or clg as a child process, so the executables are measured exactly as they're deployed.
+     * @param command_line_args
+     * @param results Returns a JSON object describing the corpus and containing the timings, throughput, and profiling report of each
+     * benchmark
+     * @return true on success, false otherwise
+     */
+    bool run_benchmarks (const CommandLineArguments& command_line_args, nlohmann::json& results);
+}
+
+#endif // CLP_BENCH_BENCHMARKS_HPP
@@ -0,0 +1,67 @@
+// C++ standard libraries
+#include <iostream>
+
+// spdlog
+#include <spdlog/sinks/stdout_sinks.h>
+
+// Project headers
+#include "../FileWriter.hpp"
+#include "../spdlog_with_specializations.hpp"
+#include "benchmarks.hpp"
+#include "CommandLineArguments.hpp"
+
+int main (int argc, const char* argv[]) {
+    // Program-wide initialization
+    try {
+        auto stderr_logger = spdlog::stderr_logger_st("stderr");
+        spdlog::set_default_logger(stderr_logger);
+        spdlog::set_pattern("%Y-%m-%d %H:%M:%S,%e [%l] %v");
+    } catch (std::exception& e) {
+        // NOTE: We can't log an exception if the logger couldn't be constructed
+        return -1;
+    }
+
+    clp_bench::CommandLineArguments command_line_args("clp-bench");
+    auto parsing_result = command_line_args.parse_arguments(argc, argv);
+    switch (parsing_result) {
+        case CommandLineArgumentsBase::ParsingResult::Failure:
+            return -1;
+        case CommandLineArgumentsBase::ParsingResult::InfoCommand:
+            return 0;
+        case CommandLineArgumentsBase::ParsingResult::Success:
+            // Continue processing
+            break;
+    }
+
+    nlohmann::json results;
+    try {
+        if (false == clp_bench::run_benchmarks(command_line_args, results)) {
+            return -1;
+        }
+
+        auto results_str = results.dump(4);
+        results_str += '\n';
+        const auto& output_path = command_line_args.get_output_path();
+        if (output_path.empty()) {
+            std::cout << results_str;
+        } else {
+            FileWriter file_writer;
+            file_writer.open(output_path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+            file_writer.write_string(results_str);
+            file_writer.close();
+        }
+    } catch (TraceableException& e) {
+        auto error_code = e.get_error_code();
+        if (ErrorCode_errno == error_code) {
+            SPDLOG_ERROR("Benchmarking failed: {}:{} {}, errno={}", e.get_filename(), e.get_line_number(), e.what(), errno);
+        } else {
+            SPDLOG_ERROR("Benchmarking failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(), error_code);
+        }
+        return -1;
+    } catch (std::exception& e) {
+        SPDLOG_ERROR("Benchmarking failed: Unexpected exception - {}", e.what());
+        return -1;
+    }
+
+    return 0;
+}
@@ -6,6 +6,7 @@
 
 // Project headers
 #include "../clp/utils.hpp"
+#include "../Profiler.hpp"
 #include "../spdlog_with_specializations.hpp"
 #include "Constants.hpp"
 #include "SchemaParser.hpp"
@@ -144,11 +145,14 @@ namespace compressor_frontend {
         }
         m_uncompressed_msg_size = cStaticByteBuffSize;
         m_active_uncompressed_msg = m_static_uncompressed_msg;
+        // NOTE: The measurement is stopped while each parsed message is encoded and written to the archive
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
         reset(reader);
         m_parse_stack_states.push(root_itemset_ptr);
         m_active_uncompressed_msg[0] = get_next_symbol();
         bool has_timestamp = false;
         if (m_active_uncompressed_msg[0].m_type_ids->at(0) == (int) SymbolID::TokenEndID) {
+            Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
             return;
         }
         if (m_active_uncompressed_msg[0].m_type_ids->at(0) == (int) SymbolID::TokenFirstTimestampId) {
@@ -164,6 +168,7 @@ namespace compressor_frontend {
             m_active_uncompressed_msg[m_uncompressed_msg_pos] = get_next_symbol();
             int token_type = m_active_uncompressed_msg[m_uncompressed_msg_pos].m_type_ids->at(0);
             if (token_type == (int) SymbolID::TokenEndID) {
+                Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
                 m_archive_writer_ptr->write_msg_using_schema(m_active_uncompressed_msg, m_uncompressed_msg_pos,
                                                              m_lexer.get_has_delimiters(), has_timestamp);
                 break;
@@ -175,8 +180,10 @@ namespace compressor_frontend {
             if (found_end_of_current_message) {
                 m_lexer.set_reduce_pos(m_active_uncompressed_msg[m_uncompressed_msg_pos].m_end_pos);
                 increment_uncompressed_msg_pos(reader);
+                Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
                 m_archive_writer_ptr->write_msg_using_schema(m_active_uncompressed_msg, m_uncompressed_msg_pos,
                                                              m_lexer.get_has_delimiters(), has_timestamp);
+                Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
                 m_uncompressed_msg_pos = 0;
                 m_lexer.soft_reset(NonTerminal::m_next_children_start);
             }
@@ -192,8 +199,10 @@ namespace compressor_frontend {
                         m_active_uncompressed_msg[m_uncompressed_msg_pos - 1].m_start_pos + 1;
                 m_active_uncompressed_msg[m_uncompressed_msg_pos - 1].m_type_ids = &Lexer<RegexNFAByteState, RegexDFAByteState>::cTokenUncaughtStringTypes;
                 m_lexer.set_reduce_pos(m_active_uncompressed_msg[m_uncompressed_msg_pos].m_start_pos - 1);
+                Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
                 m_archive_writer_ptr->write_msg_using_schema(m_active_uncompressed_msg, m_uncompressed_msg_pos,
                                                              m_lexer.get_has_delimiters(), has_timestamp);
+                Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageParsing>();
                 // switch to timestamped messages if a timestamp is ever found at the start of line (potentially dangerous as it never switches back)
                 /// TODO: potentially switch back if a new line is reached and the message is too long (100x static message size)
                 if (token_type == (int) SymbolID::TokenNewlineTimestampId) {
@@ -1,6 +1,7 @@
 #include "Token.hpp"
 
 using std::string;
+using std::string_view;
 
 namespace compressor_frontend {
 
@@ -13,6 +14,16 @@ namespace compressor_frontend {
         }
     }
 
+    string_view Token::get_string_view (string& wrapped_token_buffer) const {
+        if (m_start_pos <= m_end_pos) {
+            return {*m_buffer_ptr + m_start_pos, m_end_pos - m_start_pos};
+        } else {
+            wrapped_token_buffer.assign(*m_buffer_ptr + m_start_pos, *m_buffer_ptr + *m_buffer_size_ptr);
+            wrapped_token_buffer.append(*m_buffer_ptr, m_end_pos);
+            return wrapped_token_buffer;
+        }
+    }
+
     char Token::get_char (uint8_t i) const {
         return (*m_buffer_ptr)[m_start_pos + i];
     }
@@ -3,6 +3,7 @@
 
 // C++ standard libraries
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace compressor_frontend {
@@ -21,6 +22,14 @@ namespace compressor_frontend {
          */
         [[nodiscard]] std::string get_string () const;
 
+        /**
+         * Return a view of the token string. The view points directly into the input buffer unless the token wraps around the end of the buffer, in
+         * which case the token string is copied into the given buffer.
+         * @param wrapped_token_buffer
+         * @return std::string_view
+         */
+        [[nodiscard]] std::string_view get_string_view (std::string& wrapped_token_buffer) const;
+
         /**
          * Return the first character (as a string) of the token string (which is a delimiter if delimiters are being used)
          * @return std::string
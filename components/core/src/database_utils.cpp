@@ -65,6 +65,20 @@ string get_placeholders_sql (size_t num_placeholders) {
     return {buffer.data(), buffer.size()};
 }
 
+string get_multi_row_placeholders_sql (size_t num_placeholders_per_row, size_t num_rows) {
+    auto row_placeholders = get_placeholders_sql(num_placeholders_per_row);
+
+    fmt::memory_buffer buffer;
+    auto buffer_ix = std::back_inserter(buffer);
+    size_t i = 0;
+    fmt::format_to(buffer_ix, "({})", row_placeholders);
+    ++i;
+    for (; i < num_rows; ++i) {
+        fmt::format_to(buffer_ix, ",({})", row_placeholders);
+    }
+    return {buffer.data(), buffer.size()};
+}
+
 string get_numbered_placeholders_sql (size_t num_placeholders) {
     fmt::memory_buffer buffer;
     auto buffer_ix = std::back_inserter(buffer);
@@ -120,3 +134,27 @@ string get_numbered_set_field_sql (const vector<string>& field_names, size_t beg
 
     return {buffer.data(), buffer.size()};
 }
+
+string get_set_field_to_inserted_value_sql (const vector<string>& field_names, size_t begin_ix, size_t end_ix) {
+    fmt::memory_buffer buffer;
+    auto buffer_ix = std::back_inserter(buffer);
+    size_t i = begin_ix;
+    fmt::format_to(buffer_ix, "{0} = VALUES({0})", field_names[i]);
+    ++i;
+    for (; i < end_ix; ++i) {
+        fmt::format_to(buffer_ix, ",{0} = VALUES({0})", field_names[i]);
+    }
+    return {buffer.data(), buffer.size()};
+}
+
+string get_set_field_to_excluded_value_sql (const vector<pair<string, string>>& field_names_and_types, size_t begin_ix) {
+    fmt::memory_buffer buffer;
+    auto buffer_ix = std::back_inserter(buffer);
+    size_t i = begin_ix;
+    fmt::format_to(buffer_ix, "{0} = excluded.{0}", field_names_and_types[i].first);
+    ++i;
+    for (; i < field_names_and_types.size(); ++i) {
+        fmt::format_to(buffer_ix, ",{0} = excluded.{0}", field_names_and_types[i].first);
+    }
+    return {buffer.data(), buffer.size()};
+}
@@ -30,6 +30,13 @@ std::string get_field_names_sql (const std::vector<std::string>& field_names);
  * @return The SQL
  */
 std::string get_placeholders_sql (size_t num_placeholders);
+/**
+ * Gets the SQL for the given number of rows of placeholders in the form "(?,?,...),(?,?,...),..."
+ * @param num_placeholders_per_row
+ * @param num_rows
+ * @return The SQL
+ */
+std::string get_multi_row_placeholders_sql (size_t num_placeholders_per_row, size_t num_rows);
 /**
  * Gets the SQL for the given number of numbered placeholders
  * @param num_placeholders
@@ -58,5 +65,22 @@ std::string get_numbered_set_field_sql (const std::vector<std::pair<std::string,
  * @return The SQL
  */
 std::string get_numbered_set_field_sql (const std::vector<std::string>& field_names, size_t begin_ix);
+/**
+ * Gets the SQL to set a list of fields to the values of the row that failed to be inserted, for MySQL's "ON DUPLICATE KEY UPDATE" clause, in the
+ * form "field_name1 = VALUES(field_name1),field_name2 = VALUES(field_name2),..."
+ * @param field_names
+ * @param begin_ix Which field to start from
+ * @param end_ix
+ * @return The SQL
+ */
+std::string get_set_field_to_inserted_value_sql (const std::vector<std::string>& field_names, size_t begin_ix, size_t end_ix);
+/**
+ * Gets the SQL to set a list of fields to the values of the row that failed to be inserted, for SQLite's "ON CONFLICT DO UPDATE" clause, in the form
+ * "field_name1 = excluded.field_name1,field_name2 = excluded.field_name2,..."
+ * @param field_names_and_types
+ * @param begin_ix Which field to start from
+ * @return The SQL
+ */
+std::string get_set_field_to_excluded_value_sql (const std::vector<std::pair<std::string, std::string>>& field_names_and_types, size_t begin_ix);
 
 #endif // DATABASE_UTILS_HPP
@@ -359,7 +359,11 @@ auto deserialize_ir_message(
     }
 
     // Handle variables
-    string var_str;
+    // NOTE: To avoid allocations when the caller reuses the containers, we
+    // deserialize dictionary variables into the existing strings (reusing their
+    // capacity) and only remove any excess strings at the end
+    encoded_vars.clear();
+    size_t num_dict_vars{0};
     bool is_encoded_var{false};
     while (is_variable_tag<encoded_variable_t>(encoded_tag, is_encoded_var)) {
         if (is_encoded_var) {
@@ -369,17 +373,22 @@ auto deserialize_ir_message(
             }
             encoded_vars.push_back(encoded_variable);
         } else {
-            if (auto error_code = parse_dictionary_var(reader, encoded_tag, var_str);
+            if (dict_vars.size() == num_dict_vars) {
+                dict_vars.emplace_back();
+            }
+            if (auto error_code
+                = parse_dictionary_var(reader, encoded_tag, dict_vars[num_dict_vars]);
                 IRErrorCode_Success != error_code)
             {
                 return error_code;
             }
-            dict_vars.emplace_back(var_str);
+            ++num_dict_vars;
         }
         if (ErrorCode_Success != reader.try_read_numeric_value(encoded_tag)) {
             return IRErrorCode_Incomplete_IR;
         }
     }
+    dict_vars.resize(num_dict_vars);
 
     // Handle logtype
     if (auto error_code = parse_logtype(reader, encoded_tag, logtype);
@@ -57,6 +57,10 @@ IRErrorCode get_encoding_type(ReaderInterface& reader, bool& is_four_bytes_encod
 
 /**
  * Deserializes an IR message from the given stream
+ *
+ * NOTE: The given containers are overwritten rather than appended to, reusing
+ * their (and their elements') existing capacity where possible, so callers
+ * deserializing many messages should reuse them across calls.
  * @tparam encoded_variable_t
  * @param reader
  * @param logtype Returns the logtype
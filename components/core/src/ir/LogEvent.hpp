@@ -8,6 +8,9 @@
 #include "../ffi/encoding_methods.hpp"
 
 namespace ir {
+template <typename encoded_variable_t>
+class LogEventDeserializer;
+
 /**
  * A class representing a log event encoded using CLP's IR
  * @tparam encoded_variable_t The type of encoded variables in the event
@@ -16,6 +19,12 @@ template <typename encoded_variable_t>
 class LogEvent {
 public:
     // Constructors
+    /**
+     * Constructs an empty log event, e.g., to be reused when deserializing
+     * multiple events
+     */
+    LogEvent() : m_timestamp{0} {}
+
     LogEvent(
             ffi::epoch_time_ms_t timestamp,
             std::string logtype,
@@ -41,6 +50,9 @@ public:
     }
 
 private:
+    // The deserializer writes directly into an event's members to reuse them
+    friend class LogEventDeserializer<encoded_variable_t>;
+
     // Variables
     ffi::epoch_time_ms_t m_timestamp;
     std::string m_logtype;
@@ -66,39 +66,45 @@ auto LogEventDeserializer<encoded_variable_t>::create(ReaderInterface& reader)
 template <typename encoded_variable_t>
 auto LogEventDeserializer<encoded_variable_t>::deserialize_log_event()
         -> BOOST_OUTCOME_V2_NAMESPACE::std_result<LogEvent<encoded_variable_t>> {
-    ffi::epoch_time_ms_t timestamp_or_timestamp_delta{};
-    std::string logtype;
-    std::vector<std::string> dict_vars;
-    std::vector<encoded_variable_t> encoded_vars;
+    LogEvent<encoded_variable_t> log_event;
+    if (auto error_code = deserialize_log_event(log_event); error_code) {
+        return error_code;
+    }
+    return log_event;
+}
 
+template <typename encoded_variable_t>
+auto LogEventDeserializer<encoded_variable_t>::deserialize_log_event(
+        LogEvent<encoded_variable_t>& log_event
+) -> std::error_code {
+    ffi::epoch_time_ms_t timestamp_or_timestamp_delta{};
     auto ir_error_code = ffi::ir_stream::deserialize_ir_message(
             m_reader,
-            logtype,
-            encoded_vars,
-            dict_vars,
+            log_event.m_logtype,
+            log_event.m_encoded_vars,
+            log_event.m_dict_vars,
             timestamp_or_timestamp_delta
     );
     if (ffi::ir_stream::IRErrorCode_Success != ir_error_code) {
         switch (ir_error_code) {
             case ffi::ir_stream::IRErrorCode_Eof:
-                return std::errc::no_message_available;
+                return std::make_error_code(std::errc::no_message_available);
             case ffi::ir_stream::IRErrorCode_Incomplete_IR:
-                return std::errc::result_out_of_range;
+                return std::make_error_code(std::errc::result_out_of_range);
             case ffi::ir_stream::IRErrorCode_Corrupted_IR:
             default:
-                return std::errc::protocol_error;
+                return std::make_error_code(std::errc::protocol_error);
         }
     }
 
-    ffi::epoch_time_ms_t timestamp{};
     if constexpr (std::is_same_v<encoded_variable_t, ffi::eight_byte_encoded_variable_t>) {
-        timestamp = timestamp_or_timestamp_delta;
+        log_event.m_timestamp = timestamp_or_timestamp_delta;
     } else {  // std::is_same_v<encoded_variable_t, ffi::four_byte_encoded_variable_t>
         m_prev_msg_timestamp += timestamp_or_timestamp_delta;
-        timestamp = m_prev_msg_timestamp;
+        log_event.m_timestamp = m_prev_msg_timestamp;
     }
 
-    return LogEvent<encoded_variable_t>{timestamp, logtype, dict_vars, encoded_vars};
+    return {};
 }
 
 // Explicitly declare template specializations so that we can define the
@@ -115,4 +121,10 @@ template auto LogEventDeserializer<ffi::eight_byte_encoded_variable_t>::deserial
         -> BOOST_OUTCOME_V2_NAMESPACE::std_result<LogEvent<ffi::eight_byte_encoded_variable_t>>;
 template auto LogEventDeserializer<ffi::four_byte_encoded_variable_t>::deserialize_log_event()
         -> BOOST_OUTCOME_V2_NAMESPACE::std_result<LogEvent<ffi::four_byte_encoded_variable_t>>;
+template auto LogEventDeserializer<ffi::eight_byte_encoded_variable_t>::deserialize_log_event(
+        LogEvent<ffi::eight_byte_encoded_variable_t>& log_event
+) -> std::error_code;
+template auto LogEventDeserializer<ffi::four_byte_encoded_variable_t>::deserialize_log_event(
+        LogEvent<ffi::four_byte_encoded_variable_t>& log_event
+) -> std::error_code;
 }  // namespace ir
@@ -2,6 +2,7 @@
 #define IR_LOGEVENTDESERIALIZER_HPP
 
 #include <optional>
+#include <system_error>
 
 #include <boost-outcome/include/boost/outcome/std_result.hpp>
 
@@ -63,6 +64,18 @@ public:
     [[nodiscard]] auto deserialize_log_event()
             -> BOOST_OUTCOME_V2_NAMESPACE::std_result<LogEvent<encoded_variable_t>>;
 
+    /**
+     * Deserializes a log event from the stream into the given event, reusing
+     * its buffers so that deserializing many events doesn't allocate for each
+     * one
+     * @param log_event Returns the log event
+     * @return An error code indicating the failure (same as
+     * deserialize_log_event()), or an empty error code on success. On failure,
+     * log_event's contents are unspecified.
+     */
+    [[nodiscard]] auto deserialize_log_event(LogEvent<encoded_variable_t>& log_event)
+            -> std::error_code;
+
 private:
     // Constructors
     explicit LogEventDeserializer(ReaderInterface& reader) : m_reader{reader} {}
@@ -1,19 +1,116 @@
 #include "parsing.hpp"
 
+#include <array>
+#include <cstdint>
+
 #include "../string_utils.hpp"
 #include "../type_utils.hpp"
 
 using std::string_view;
 
 namespace ir {
-/*
- * For performance, we rely on the ASCII ordering of characters to compare
- * ranges of characters at a time instead of comparing individual characters
+namespace {
+/**
+ * Classes of characters used when tokenizing a message
+ */
+enum CharClass : uint8_t {
+    Delim = 1U << 0U,
+    DecimalDigit = 1U << 1U,
+    Alphabet = 1U << 2U,
+    HexDigit = 1U << 3U,
+};
+
+constexpr uint8_t cAllCharClasses
+        = CharClass::Delim | CharClass::DecimalDigit | CharClass::Alphabet | CharClass::HexDigit;
+
+/**
+ * Table mapping each character (as an unsigned char) to its classes, so that
+ * a character can be classified with a single lookup
+ */
+constexpr auto cCharClasses = [] {
+    std::array<uint8_t, 256> char_classes{};
+    for (size_t i = 0; i < char_classes.size(); ++i) {
+        auto const c = static_cast<signed char>(i);
+        uint8_t classes{0};
+        // NOTE: We rely on the ASCII ordering of characters to compare ranges
+        // of characters at a time instead of comparing individual characters
+        if (false
+            == ('+' == c || ('-' <= c && c <= '.') || ('0' <= c && c <= '9')
+                || ('A' <= c && c <= 'Z') || '\\' == c || '_' == c || ('a' <= c && c <= 'z')))
+        {
+            classes |= CharClass::Delim;
+        }
+        if ('0' <= c && c <= '9') {
+            classes |= CharClass::DecimalDigit | CharClass::HexDigit;
+        }
+        if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z')) {
+            classes |= CharClass::Alphabet;
+        }
+        if (('a' <= c && c <= 'f') || ('A' <= c && c <= 'F')) {
+            classes |= CharClass::HexDigit;
+        }
+        char_classes[i] = classes;
+    }
+    return char_classes;
+}();
+
+/**
+ * @param c
+ * @return The classes of the given character
+ */
+inline uint8_t get_char_classes(char c) {
+    return cCharClasses[static_cast<unsigned char>(c)];
+}
+
+/**
+ * Finds the first non-delimiter in the given string, starting at the given
+ * position
+ * @param str
+ * @param pos
+ * @return The position of the non-delimiter or the string's length if none
+ */
+inline size_t find_first_non_delim(string_view str, size_t pos) {
+    auto const length = str.length();
+    for (; pos < length; ++pos) {
+        if (0 == (get_char_classes(str[pos]) & CharClass::Delim)) {
+            break;
+        }
+    }
+    return pos;
+}
+
+/**
+ * Finds the first delimiter in the given string, starting at the given
+ * position, while accumulating the classes of the characters before it
+ * @param str
+ * @param pos
+ * @param classes_union Returns the union of the classes of the characters
+ * before the delimiter (ORed with the given value)
+ * @param classes_intersection Returns the intersection of the classes of the
+ * characters before the delimiter (ANDed with the given value)
+ * @return The position of the delimiter or the string's length if none
  */
+inline size_t find_first_delim(
+        string_view str,
+        size_t pos,
+        uint8_t& classes_union,
+        uint8_t& classes_intersection
+) {
+    auto const length = str.length();
+    for (; pos < length; ++pos) {
+        auto const classes = get_char_classes(str[pos]);
+        if (classes & CharClass::Delim) {
+            break;
+        }
+        classes_union |= classes;
+        classes_intersection &= classes;
+    }
+    return pos;
+}
+}  // namespace
+
 bool is_delim(signed char c) {
-    return false
-           == ('+' == c || ('-' <= c && c <= '.') || ('0' <= c && c <= '9')
-               || ('A' <= c && c <= 'Z') || '\\' == c || '_' == c || ('a' <= c && c <= 'z'));
+    return 0 != (get_char_classes(c) & CharClass::Delim);
 }
 
 bool is_variable_placeholder(char c) {
@@ -40,44 +137,24 @@ bool get_bounds_of_next_var(string_view const str, size_t& begin_pos, size_t& en
     }
 
     while (true) {
-        begin_pos = end_pos;
-
-        // Find next non-delimiter
-        for (; begin_pos < msg_length; ++begin_pos) {
-            auto c = str[begin_pos];
-            if (false == is_delim(c)) {
-                break;
-            }
-        }
+        begin_pos = find_first_non_delim(str, end_pos);
         if (msg_length == begin_pos) {
             // Early exit for performance
             return false;
         }
 
-        bool contains_decimal_digit = false;
-        bool contains_alphabet = false;
-
-        // Find next delimiter
-        end_pos = begin_pos;
-        for (; end_pos < msg_length; ++end_pos) {
-            auto c = str[end_pos];
-            if (is_decimal_digit(c)) {
-                contains_decimal_digit = true;
-            } else if (is_alphabet(c)) {
-                contains_alphabet = true;
-            } else if (is_delim(c)) {
-                break;
-            }
-        }
+        uint8_t token_classes_union{0};
+        uint8_t token_classes_intersection{cAllCharClasses};
+        end_pos = find_first_delim(str, begin_pos, token_classes_union, token_classes_intersection);
 
-        auto variable = str.substr(begin_pos, end_pos - begin_pos);
         // Treat token as variable if:
         // - it contains a decimal digit, or
         // - it's directly preceded by '=' and contains an alphabet char, or
         // - it could be a multi-digit hex value
-        if (contains_decimal_digit
-            || (0 < begin_pos && '=' == str[begin_pos - 1] && contains_alphabet)
-            || could_be_multi_digit_hex_value(variable))
+        if ((token_classes_union & CharClass::DecimalDigit)
+            || (0 < begin_pos && '=' == str[begin_pos - 1]
+                && (token_classes_union & CharClass::Alphabet))
+            || (end_pos - begin_pos >= 2 && (token_classes_intersection & CharClass::HexDigit)))
         {
             break;
         }
@@ -0,0 +1,78 @@
+#include "SocketReader.hpp"
+
+// C standard libraries
+#include <cerrno>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+
+// Project headers
+#include "socket_utils.hpp"
+
+namespace networking {
+    // Constants
+    static constexpr size_t cBufferSize = 64 * 1024;
+
+    SocketReader::SocketReader (int socket_fd) : m_socket_fd(socket_fd), m_buffer(cBufferSize), m_buffer_begin_pos(0), m_buffer_end_pos(0),
+                                                 m_pos(0)
+    {
+        if (socket_fd < 0) {
+            throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
+        }
+    }
+
+    ErrorCode SocketReader::try_get_pos (size_t& pos) {
+        pos = m_pos;
+        return ErrorCode_Success;
+    }
+
+    ErrorCode SocketReader::try_seek_from_begin (size_t pos) {
+        return ErrorCode_Unsupported;
+    }
+
+    ErrorCode SocketReader::try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) {
+        if (nullptr == buf) {
+            return ErrorCode_BadParam;
+        }
+
+        num_bytes_read = 0;
+        while (num_bytes_read < num_bytes_to_read) {
+            if (false == has_buffered_data()) {
+                auto error_code = refill_buffer();
+                if (ErrorCode_Success != error_code) {
+                    if (ErrorCode_EndOfFile == error_code && num_bytes_read > 0) {
+                        break;
+                    }
+                    // NOTE: Any bytes copied before the error were consumed from the buffer, so they still count towards the position
+                    m_pos += num_bytes_read;
+                    return error_code;
+                }
+            }
+
+            auto num_bytes_to_copy = std::min(num_bytes_to_read - num_bytes_read, m_buffer_end_pos - m_buffer_begin_pos);
+            memcpy(buf + num_bytes_read, &m_buffer[m_buffer_begin_pos], num_bytes_to_copy);
+            m_buffer_begin_pos += num_bytes_to_copy;
+            num_bytes_read += num_bytes_to_copy;
+        }
+        m_pos += num_bytes_read;
+
+        return ErrorCode_Success;
+    }
+
+    ErrorCode SocketReader::refill_buffer () {
+        m_buffer_begin_pos = 0;
+        m_buffer_end_pos = 0;
+        while (true) {
+            size_t num_bytes_received = 0;
+            auto error_code = try_receive(m_socket_fd, m_buffer.data(), m_buffer.size(), num_bytes_received);
+            if (ErrorCode_errno == error_code && EINTR == errno) {
+                continue;
+            }
+            if (ErrorCode_Success == error_code) {
+                m_buffer_end_pos = num_bytes_received;
+            }
+            return error_code;
+        }
+    }
+}
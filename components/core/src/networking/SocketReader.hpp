@@ -0,0 +1,86 @@
+#ifndef NETWORKING_SOCKETREADER_HPP
+#define NETWORKING_SOCKETREADER_HPP
+
+// C++ standard libraries
+#include <vector>
+
+// Project headers
+#include "../ErrorCode.hpp"
+#include "../ReaderInterface.hpp"
+#include "../TraceableException.hpp"
+
+namespace networking {
+    /**
+     * Class for reading a stream of bytes from a connected socket. Reads are buffered so that small reads (e.g., of single numeric values) don't
+     * each require a system call.
+     */
+    class SocketReader : public ReaderInterface {
+    public:
+        // Types
+        class OperationFailed : public TraceableException {
+        public:
+            // Constructors
+            OperationFailed (ErrorCode error_code, const char* const filename, int line_number) :
+                    TraceableException(error_code, filename, line_number) {}
+
+            // Methods
+            const char* what () const noexcept override {
+                return "networking::SocketReader operation failed";
+            }
+        };
+
+        // Constructors
+        /**
+         * @param socket_fd A connected socket, which remains owned by the caller
+         */
+        explicit SocketReader (int socket_fd);
+
+        // Methods implementing the ReaderInterface
+        /**
+         * Tries to get the number of bytes consumed from the socket so far
+         * @param pos
+         * @return ErrorCode_Success
+         */
+        ErrorCode try_get_pos (size_t& pos) override;
+        /**
+         * Unsupported method
+         * @param pos
+         * @return ErrorCode_Unsupported
+         */
+        ErrorCode try_seek_from_begin (size_t pos) override;
+        /**
+         * Tries to read up to a given number of bytes from the socket, blocking until they're all received or the peer closes the connection
+         * @param buf
+         * @param num_bytes_to_read The number of bytes to try and read
+         * @param num_bytes_read The actual number of bytes read, which may be non-zero on failure
+         * @return ErrorCode_EndOfFile if the connection was closed before any bytes were read
+         * @return Same as networking::try_receive on failure
+         * @return ErrorCode_Success on success
+         */
+        ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override;
+
+        // Methods
+        /**
+         * @return Whether any bytes have been received but not yet read, i.e., whether the next read can (at least partly) be served without
+         * blocking
+         */
+        bool has_buffered_data () const { return m_buffer_begin_pos < m_buffer_end_pos; }
+
+    private:
+        // Methods
+        /**
+         * Receives more bytes into the (empty) buffer, retrying if interrupted
+         * @return Same as networking::try_receive
+         */
+        ErrorCode refill_buffer ();
+
+        // Variables
+        int m_socket_fd;
+        std::vector<char> m_buffer;
+        size_t m_buffer_begin_pos;
+        size_t m_buffer_end_pos;
+        size_t m_pos;
+    };
+}
+
+#endif // NETWORKING_SOCKETREADER_HPP
@@ -5,11 +5,12 @@
 #define STREAMING_ARCHIVE_CONSTANTS_HPP
 
 namespace streaming_archive {
-    constexpr archive_format_version_t cArchiveFormatVersion = cArchiveFormatDevVersionFlag | 8;
+    constexpr archive_format_version_t cArchiveFormatVersion = cArchiveFormatDevVersionFlag | 9;
     constexpr char cSegmentsDirname[] = "s";
     constexpr char cSegmentListFilename[] = "segment_list.txt";
     constexpr char cLogTypeDictFilename[] = "logtype.dict";
     constexpr char cVarDictFilename[] = "var.dict";
+    constexpr char cVarDictFilterFilename[] = "var.dict.filter";
     constexpr char cLogTypeSegmentIndexFilename[] = "logtype.segindex";
     constexpr char cVarSegmentIndexFilename[] = "var.segindex";
     constexpr char cMetadataFileName[] = "metadata";
@@ -29,6 +30,7 @@ namespace streaming_archive {
             constexpr char Size[] = "size";
             constexpr char CreatorId[] = "creator_id";
             constexpr char CreationIx[] = "creation_ix";
+            constexpr char IsFinalized[] = "is_finalized";
         }
         namespace File {
             constexpr char Id[] = "id";
@@ -100,7 +100,7 @@ namespace streaming_archive {
     }
 
     static SQLitePreparedStatement get_files_select_statement (SQLiteDB& db, epochtime_t ts_begin, epochtime_t ts_end, const std::string& file_path,
-                                                               bool in_specific_segment, segment_id_t segment_id)
+                                                               bool in_specific_segment, segment_id_t segment_id, bool in_descending_end_ts_order)
     {
         vector<string> field_names(enum_to_underlying_type(FilesTableFieldIndexes::Length));
         field_names[enum_to_underlying_type(FilesTableFieldIndexes::Id)] = streaming_archive::cMetadataDB::File::Id;
@@ -155,8 +155,12 @@ namespace streaming_archive {
         }
 
         // Add ordering
-        fmt::format_to(statement_buffer_ix, " ORDER BY {} ASC, {} ASC", streaming_archive::cMetadataDB::File::SegmentId,
-                       streaming_archive::cMetadataDB::File::SegmentTimestampsPosition);
+        if (in_descending_end_ts_order) {
+            fmt::format_to(statement_buffer_ix, " ORDER BY {} DESC", streaming_archive::cMetadataDB::File::EndTimestamp);
+        } else {
+            fmt::format_to(statement_buffer_ix, " ORDER BY {} ASC, {} ASC", streaming_archive::cMetadataDB::File::SegmentId,
+                           streaming_archive::cMetadataDB::File::SegmentTimestampsPosition);
+        }
 
         auto statement = db.prepare_statement(statement_buffer.data(), statement_buffer.size());
         if (cEpochTimeMin != ts_begin) {
@@ -188,9 +192,9 @@ namespace streaming_archive {
     }
 
     MetadataDB::FileIterator::FileIterator (SQLiteDB& db, epochtime_t begin_timestamp, epochtime_t end_timestamp, const std::string& file_path,
-                                            bool in_specific_segment, segment_id_t segment_id) :
+                                            bool in_specific_segment, segment_id_t segment_id, bool in_descending_end_ts_order) :
                                             Iterator(get_files_select_statement(db, begin_timestamp, end_timestamp, file_path, in_specific_segment,
-                                                                                segment_id)) {}
+                                                                                segment_id, in_descending_end_ts_order)) {}
 
     MetadataDB::EmptyDirectoryIterator::EmptyDirectoryIterator (SQLiteDB& db) : Iterator(get_empty_directories_select_statement(db)) {}
 
@@ -262,13 +266,19 @@ namespace streaming_archive {
         return m_statement.column_int64(enum_to_underlying_type(FilesTableFieldIndexes::SegmentVariablesPosition));
     }
 
-    void MetadataDB::open (const string& path) {
+    void MetadataDB::open (const string& path, bool allow_concurrent_readers) {
         if (m_is_open) {
             throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
         }
 
         m_db.open(path);
 
+        m_allows_concurrent_readers = allow_concurrent_readers;
+        if (m_allows_concurrent_readers) {
+            auto set_journal_mode_statement = m_db.prepare_statement("PRAGMA journal_mode=WAL");
+            set_journal_mode_statement.step();
+        }
+
         vector<std::pair<string, string>> file_field_names_and_types(enum_to_underlying_type(FilesTableFieldIndexes::Length));
         file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].first = streaming_archive::cMetadataDB::File::Id;
         file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].second = "TEXT PRIMARY KEY";
@@ -350,6 +360,17 @@ namespace streaming_archive {
         m_transaction_end_statement.reset(nullptr);
         m_upsert_file_statement.reset(nullptr);
         m_insert_empty_directories_statement.reset(nullptr);
+        if (m_allows_concurrent_readers) {
+            // Revert to the default journal mode so that the closed database is a single file again. This fails if a reader still has the
+            // database open, in which case the database is left in WAL mode (which is harmless).
+            try {
+                auto set_journal_mode_statement = m_db.prepare_statement("PRAGMA journal_mode=DELETE");
+                set_journal_mode_statement.step();
+            } catch (const SQLitePreparedStatement::OperationFailed& e) {
+                SPDLOG_WARN("streaming_archive::MetadataDB: Failed to disable write-ahead logging - {}", m_db.get_error_message());
+            }
+            m_allows_concurrent_readers = false;
+        }
         if (false == m_db.close()) {
             SPDLOG_ERROR("streaming_archive::MetadataDB: Failed to close database - {}", m_db.get_error_message());
             throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
@@ -392,6 +413,18 @@ namespace streaming_archive {
         m_transaction_end_statement->reset();
     }
 
+    void MetadataDB::get_segment_ids (vector<segment_id_t>& segment_ids) {
+        fmt::memory_buffer statement_buffer;
+        auto statement_buffer_ix = std::back_inserter(statement_buffer);
+        fmt::format_to(statement_buffer_ix, "SELECT DISTINCT {} FROM {}", streaming_archive::cMetadataDB::File::SegmentId,
+                       streaming_archive::cMetadataDB::FilesTableName);
+        SPDLOG_DEBUG("{:.{}}", statement_buffer.data(), statement_buffer.size());
+        auto statement = m_db.prepare_statement(statement_buffer.data(), statement_buffer.size());
+        while (statement.step()) {
+            segment_ids.push_back(statement.column_int64(0));
+        }
+    }
+
     void MetadataDB::add_empty_directories (const vector<string>& empty_directory_paths) {
         for (const auto& path : empty_directory_paths) {
             m_insert_empty_directories_statement->bind_text(1, path, false);
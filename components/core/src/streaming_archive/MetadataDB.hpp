@@ -69,8 +69,18 @@ namespace streaming_archive {
             };
 
             // Constructors
+            /**
+             * @param db
+             * @param begin_timestamp
+             * @param end_timestamp
+             * @param file_path
+             * @param in_specific_segment
+             * @param segment_id
+             * @param in_descending_end_ts_order Whether to iterate from the file with the latest end timestamp to the one with the earliest,
+             * rather than in the order the files were stored in segments
+             */
             explicit FileIterator (SQLiteDB& db, epochtime_t begin_timestamp, epochtime_t end_timestamp, const std::string& file_path, bool in_specific_segment,
-                                   segment_id_t segment_id);
+                                   segment_id_t segment_id, bool in_descending_end_ts_order);
 
             // Methods
             void set_segment_id (segment_id_t segment_id);
@@ -116,25 +126,38 @@ namespace streaming_archive {
         };
 
         // Constructors
-        MetadataDB () : m_is_open(false) {}
+        MetadataDB () : m_is_open(false), m_allows_concurrent_readers(false) {}
 
         // Methods
-        void open (const std::string& path);
+        /**
+         * Opens the database, creating its tables if necessary
+         * @param path
+         * @param allow_concurrent_readers Whether the database is written while others may be reading it, in which case it's switched to
+         * write-ahead logging (until it's closed) so that readers and the writer don't block each other
+         */
+        void open (const std::string& path, bool allow_concurrent_readers = false);
         void close ();
 
         void update_files (const std::vector<writer::File*>& files);
         void add_empty_directories (const std::vector<std::string>& empty_directory_paths);
 
+        /**
+         * Gets the IDs of all segments that contain at least one file
+         * @param segment_ids Returns the IDs
+         */
+        void get_segment_ids (std::vector<segment_id_t>& segment_ids);
+
         std::unique_ptr<FileIterator> get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path, bool in_specific_segment,
-                                                         segment_id_t segment_id)
+                                                         segment_id_t segment_id, bool in_descending_end_ts_order)
         {
-            return std::make_unique<FileIterator>(m_db, begin_ts, end_ts, file_path, in_specific_segment, segment_id);
+            return std::make_unique<FileIterator>(m_db, begin_ts, end_ts, file_path, in_specific_segment, segment_id, in_descending_end_ts_order);
         }
         std::unique_ptr<EmptyDirectoryIterator> get_empty_directory_iterator () { return std::make_unique<EmptyDirectoryIterator>(m_db); }
 
     private:
         // Variables
         bool m_is_open;
+        bool m_allows_concurrent_readers;
 
         SQLiteDB m_db;
         std::unique_ptr<SQLitePreparedStatement> m_transaction_begin_statement;
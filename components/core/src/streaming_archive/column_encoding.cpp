@@ -0,0 +1,170 @@
+#include "column_encoding.hpp"
+
+// C++ standard libraries
+#include <cstring>
+#include <limits>
+
+// Project headers
+#include "../type_utils.hpp"
+
+using std::vector;
+
+// NOTE: Packed values are the low-order bytes of each offset, copied from the start of the offset, which is only correct on little-endian
+// machines. The header and raw columns are also copied in the machine's byte order, so archives are only portable between little-endian
+// machines.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Column encoding requires a little-endian machine");
+
+namespace streaming_archive::column_encoding {
+    // Local prototypes
+    /**
+     * @param codec
+     * @return The number of times the codec computes the deltas of a column before packing it
+     */
+    static int get_num_delta_passes (Codec codec);
+    /**
+     * Applies the given number of delta passes to the given value, updating the previous values of each pass
+     * @param value
+     * @param num_delta_passes
+     * @param previous_values The previous (input) value of each pass
+     * @return The transformed value
+     */
+    static uint64_t apply_delta_passes (uint64_t value, int num_delta_passes, uint64_t* previous_values);
+    /**
+     * @param range
+     * @return The minimum number of bytes necessary to represent every value in [0, range]
+     */
+    static uint8_t get_num_bytes_to_represent (uint64_t range);
+
+    static int get_num_delta_passes (Codec codec) {
+        switch (codec) {
+            case Codec::DeltaFrameOfReference:
+                return 1;
+            case Codec::DeltaOfDeltaFrameOfReference:
+                return 2;
+            default:
+                return 0;
+        }
+    }
+
+    static uint64_t apply_delta_passes (uint64_t value, int num_delta_passes, uint64_t* previous_values) {
+        // NOTE: Deltas are computed with unsigned (wrapping) arithmetic so that they can be exactly reversed for any input
+        for (int i = 0; i < num_delta_passes; ++i) {
+            auto delta = value - previous_values[i];
+            previous_values[i] = value;
+            value = delta;
+        }
+        return value;
+    }
+
+    static uint8_t get_num_bytes_to_represent (uint64_t range) {
+        uint8_t num_bytes = 0;
+        while (range > 0) {
+            ++num_bytes;
+            range >>= 8;
+        }
+        return num_bytes;
+    }
+
+    void encode_column (const int64_t* values, size_t num_values, bool try_delta_codecs, vector<char>& encoded_column) {
+        // Find the codec which requires the fewest bytes per value
+        uint64_t base = (num_values > 0) ? bit_cast<uint64_t>(values[0]) : 0;
+        ColumnHeader header = {Codec::Raw, sizeof(int64_t), 0, 0};
+        auto last_codec_to_try = try_delta_codecs ? Codec::DeltaOfDeltaFrameOfReference : Codec::FrameOfReference;
+        for (auto codec = Codec::FrameOfReference; codec <= last_codec_to_try;
+             codec = static_cast<Codec>(enum_to_underlying_type(codec) + 1))
+        {
+            auto num_delta_passes = get_num_delta_passes(codec);
+            uint64_t previous_values[2] = {base, 0};
+            auto min = std::numeric_limits<int64_t>::max();
+            auto max = std::numeric_limits<int64_t>::min();
+            for (size_t i = 0; i < num_values; ++i) {
+                auto value = bit_cast<int64_t>(apply_delta_passes(bit_cast<uint64_t>(values[i]), num_delta_passes, previous_values));
+                if (value < min) {
+                    min = value;
+                }
+                if (value > max) {
+                    max = value;
+                }
+            }
+            if (0 == num_values) {
+                min = max = 0;
+            }
+
+            auto num_bytes_per_value = get_num_bytes_to_represent(bit_cast<uint64_t>(max) - bit_cast<uint64_t>(min));
+            if (num_bytes_per_value < header.num_bytes_per_value) {
+                header = {codec, num_bytes_per_value, bit_cast<uint64_t>(min), base};
+            }
+        }
+
+        // Write header
+        auto header_begin_pos = encoded_column.size();
+        encoded_column.resize(header_begin_pos + cColumnHeaderSize + get_encoded_values_size(header, num_values));
+        auto* buf = encoded_column.data() + header_begin_pos;
+        buf[0] = static_cast<char>(header.codec);
+        buf[1] = static_cast<char>(header.num_bytes_per_value);
+        memcpy(buf + 2, &header.reference, sizeof(header.reference));
+        memcpy(buf + 10, &header.base, sizeof(header.base));
+        buf += cColumnHeaderSize;
+
+        // Write values
+        if (0 == num_values) {
+            return;
+        }
+        if (Codec::Raw == header.codec) {
+            memcpy(buf, values, num_values * sizeof(int64_t));
+            return;
+        }
+        auto num_delta_passes = get_num_delta_passes(header.codec);
+        uint64_t previous_values[2] = {header.base, 0};
+        for (size_t i = 0; i < num_values; ++i) {
+            auto offset = apply_delta_passes(bit_cast<uint64_t>(values[i]), num_delta_passes, previous_values) - header.reference;
+            // NOTE: This relies on the machine being little-endian (see the static_assert at the top of this file)
+            memcpy(buf, &offset, header.num_bytes_per_value);
+            buf += header.num_bytes_per_value;
+        }
+    }
+
+    ErrorCode parse_column_header (const char* buf, ColumnHeader& header) {
+        auto codec = static_cast<uint8_t>(buf[0]);
+        if (codec >= enum_to_underlying_type(Codec::Length)) {
+            return ErrorCode_Corrupt;
+        }
+        header.codec = static_cast<Codec>(codec);
+
+        header.num_bytes_per_value = static_cast<uint8_t>(buf[1]);
+        if (header.num_bytes_per_value > sizeof(int64_t) ||
+            (Codec::Raw == header.codec && sizeof(int64_t) != header.num_bytes_per_value))
+        {
+            return ErrorCode_Corrupt;
+        }
+
+        memcpy(&header.reference, buf + 2, sizeof(header.reference));
+        memcpy(&header.base, buf + 10, sizeof(header.base));
+
+        return ErrorCode_Success;
+    }
+
+    void decode_column_in_place (const ColumnHeader& header, uint64_t num_values, int64_t* values) {
+        if (Codec::Raw == header.codec || 0 == num_values) {
+            return;
+        }
+
+        // Unpack values from back to front so that we never overwrite encoded values that haven't been unpacked yet
+        auto num_bytes_per_value = header.num_bytes_per_value;
+        const auto* encoded_values = reinterpret_cast<const char*>(values);
+        for (auto i = num_values; i > 0; --i) {
+            uint64_t offset = 0;
+            memcpy(&offset, encoded_values + (i - 1) * num_bytes_per_value, num_bytes_per_value);
+            values[i - 1] = bit_cast<int64_t>(header.reference + offset);
+        }
+
+        // Reverse delta passes, starting with the last
+        for (auto pass_ix = get_num_delta_passes(header.codec); pass_ix > 0; --pass_ix) {
+            uint64_t previous_value = (1 == pass_ix) ? header.base : 0;
+            for (uint64_t i = 0; i < num_values; ++i) {
+                previous_value += bit_cast<uint64_t>(values[i]);
+                values[i] = bit_cast<int64_t>(previous_value);
+            }
+        }
+    }
+}
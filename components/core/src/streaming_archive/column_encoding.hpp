@@ -0,0 +1,79 @@
+#ifndef STREAMING_ARCHIVE_COLUMN_ENCODING_HPP
+#define STREAMING_ARCHIVE_COLUMN_ENCODING_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Project headers
+#include "../ErrorCode.hpp"
+
+/**
+ * Methods to encode and decode the 64-bit integer columns (timestamps, logtype IDs, and encoded variables) of files stored in segments. Each column is
+ * stored as a header followed by its encoded values. Values are encoded with frame-of-reference packing, i.e., the column's minimum value is stored in
+ * the header and each value is stored as its offset from the minimum using the fewest whole bytes necessary. Before packing, a column can optionally be
+ * transformed into its deltas or delta-of-deltas (relative to its first value), which suits monotonic columns like timestamps.
+ */
+namespace streaming_archive::column_encoding {
+    // Types
+    enum class Codec : uint8_t {
+        Raw = 0,
+        FrameOfReference,
+        DeltaFrameOfReference,
+        DeltaOfDeltaFrameOfReference,
+        Length
+    };
+
+    struct ColumnHeader {
+        Codec codec;
+        uint8_t num_bytes_per_value;
+        // The value that packed values are offsets from
+        uint64_t reference;
+        // The first value of the column, which delta codecs compute the first delta from
+        uint64_t base;
+    };
+
+    // Constants
+    // Codec (1B) + number of bytes per value (1B) + reference value (8B) + base value (8B)
+    constexpr size_t cColumnHeaderSize = 18;
+
+    // Methods
+    /**
+     * Encodes the given column, choosing whichever of the allowed codecs produces the smallest output
+     * @param values
+     * @param num_values
+     * @param try_delta_codecs Whether to try encoding the deltas/delta-of-deltas of the column
+     * @param encoded_column Buffer to store the encoded column (header and values) in
+     */
+    void encode_column (const int64_t* values, size_t num_values, bool try_delta_codecs, std::vector<char>& encoded_column);
+
+    /**
+     * Parses a column header from the given buffer
+     * @param buf Buffer containing at least cColumnHeaderSize bytes
+     * @param header
+     * @return ErrorCode_Corrupt if the header is invalid
+     * @return ErrorCode_Success otherwise
+     */
+    ErrorCode parse_column_header (const char* buf, ColumnHeader& header);
+
+    /**
+     * @param header
+     * @param num_values
+     * @return The size of the column's encoded values (excluding the header)
+     */
+    inline uint64_t get_encoded_values_size (const ColumnHeader& header, uint64_t num_values) {
+        return num_values * header.num_bytes_per_value;
+    }
+
+    /**
+     * Decodes a column in place. When called, the buffer should contain the column's encoded values (excluding the header) at its beginning. Since
+     * values are never encoded with more than 8 bytes, the encoded values always fit within the decoded column.
+     * @param header
+     * @param num_values
+     * @param values Buffer for num_values values
+     */
+    void decode_column_in_place (const ColumnHeader& header, uint64_t num_values, int64_t* values);
+}
+
+#endif // STREAMING_ARCHIVE_COLUMN_ENCODING_HPP
@@ -13,6 +13,8 @@
 
 // Project headers
 #include "../../EncodedVariableInterpreter.hpp"
+#include "../../FileReader.hpp"
+#include "../../Profiler.hpp"
 #include "../../spdlog_with_specializations.hpp"
 #include "../../Utils.hpp"
 #include "../ArchiveMetadata.hpp"
@@ -23,6 +25,23 @@ using std::unordered_set;
 using std::vector;
 
 namespace streaming_archive { namespace reader {
+    bool Archive::read_var_dict_filter (const string& path, BloomFilter& filter) {
+        FileReader file_reader;
+        auto error_code = file_reader.try_open(path + '/' + cVarDictFilterFilename);
+        if (ErrorCode_FileNotFound == error_code) {
+            return false;
+        }
+        if (ErrorCode_Success != error_code) {
+            throw OperationFailed(error_code, __FILENAME__, __LINE__);
+        }
+
+        error_code = filter.try_read_from_file(file_reader);
+        if (ErrorCode_Success != error_code) {
+            throw OperationFailed(error_code, __FILENAME__, __LINE__);
+        }
+        return true;
+    }
+
     void Archive::open (const string& path) {
         // Determine whether path is file or directory
         struct stat path_stat = {};
@@ -107,6 +126,7 @@ namespace streaming_archive { namespace reader {
         m_segment_manager.close();
         m_segments_dir_path.clear();
         m_metadata_db.close();
+        m_visible_segment_ids.clear();
         m_path.clear();
     }
 
@@ -115,6 +135,21 @@ namespace streaming_archive { namespace reader {
         m_var_dictionary.read_new_entries();
     }
 
+    void Archive::refresh (vector<segment_id_t>& new_segment_ids) {
+        new_segment_ids.clear();
+
+        // NOTE: The segments must be found before the dictionaries are refreshed, so that any entries they reference are read
+        vector<segment_id_t> segment_ids;
+        m_metadata_db.get_segment_ids(segment_ids);
+        for (auto segment_id : segment_ids) {
+            if (m_visible_segment_ids.insert(segment_id).second) {
+                new_segment_ids.push_back(segment_id);
+            }
+        }
+
+        refresh_dictionaries();
+    }
+
     ErrorCode Archive::open_file (File& file, MetadataDB::FileIterator& file_metadata_ix) {
         return file.open_me(m_logtype_dictionary, file_metadata_ix, m_segment_manager);
     }
@@ -139,6 +174,12 @@ namespace streaming_archive { namespace reader {
         return file.find_message_in_time_range(search_begin_timestamp, search_end_timestamp, msg);
     }
 
+    bool Archive::find_timestamp_and_logtype_in_time_range (File& file, epochtime_t search_begin_timestamp, epochtime_t search_end_timestamp,
+                                                            epochtime_t& timestamp, logtype_dictionary_id_t& logtype_id)
+    {
+        return file.find_timestamp_and_logtype_in_time_range(search_begin_timestamp, search_end_timestamp, timestamp, logtype_id);
+    }
+
     const SubQuery* Archive::find_message_matching_query (File& file, const Query& query, Message& msg) {
         return file.find_message_matching_query(query, msg);
     }
@@ -151,34 +192,57 @@ namespace streaming_archive { namespace reader {
         decompressed_msg.clear();
 
         // Build original message content
-        const logtype_dictionary_id_t logtype_id = compressed_msg.get_logtype_id();
-        const auto& logtype_entry = m_logtype_dictionary.get_entry(logtype_id);
-        if (!EncodedVariableInterpreter::decode_variables_into_message(logtype_entry, m_var_dictionary, compressed_msg.get_vars(), decompressed_msg)) {
-            SPDLOG_ERROR("streaming_archive::reader::Archive: Failed to decompress variables from logtype id {}", compressed_msg.get_logtype_id());
-            return false;
-        }
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageDecoding>();
+        try {
+            const logtype_dictionary_id_t logtype_id = compressed_msg.get_logtype_id();
+            const auto& logtype_template = m_logtype_dictionary.get_render_template(logtype_id);
+            if (!EncodedVariableInterpreter::decode_variables_into_message(logtype_template, m_var_dictionary, compressed_msg.get_vars(), decompressed_msg)) {
+                Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageDecoding>();
+                SPDLOG_ERROR("streaming_archive::reader::Archive: Failed to decompress variables from logtype id {}", compressed_msg.get_logtype_id());
+                return false;
+            }
 
-        // Determine which timestamp pattern to use
-        const auto& timestamp_patterns = file.get_timestamp_patterns();
-        if (!timestamp_patterns.empty() && compressed_msg.get_message_number() >= timestamp_patterns[file.get_current_ts_pattern_ix()].first) {
-            while (true) {
-                if (file.get_current_ts_pattern_ix() >= timestamp_patterns.size() - 1) {
-                    // Already at last timestamp pattern
-                    break;
-                }
-                auto next_patt_start_message_num = timestamp_patterns[file.get_current_ts_pattern_ix() + 1].first;
-                if (compressed_msg.get_message_number() < next_patt_start_message_num) {
-                    // Not yet time for next timestamp pattern
-                    break;
-                }
-                file.increment_current_ts_pattern_ix();
+            auto timestamp_pattern = get_timestamp_pattern(file, compressed_msg);
+            if (nullptr != timestamp_pattern) {
+                timestamp_pattern->insert_formatted_timestamp(compressed_msg.get_ts_in_milli(), decompressed_msg);
             }
-            timestamp_patterns[file.get_current_ts_pattern_ix()].second.insert_formatted_timestamp(compressed_msg.get_ts_in_milli(), decompressed_msg);
+        } catch (...) {
+            // Stop the measurement so that it isn't left running (and mis-timed) when the caller handles the exception
+            Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageDecoding>();
+            throw;
         }
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MessageDecoding>();
+        Profiler::increment_counter<Profiler::CounterIndex::DecodedMessages>(1);
 
         return true;
     }
 
+    bool Archive::message_may_match (File& file, const Message& compressed_msg, const EncodedMessageFilter& filter) {
+        const auto& logtype_entry = m_logtype_dictionary.get_entry(compressed_msg.get_logtype_id());
+        return filter.may_match(logtype_entry, m_var_dictionary, compressed_msg.get_vars(), get_timestamp_pattern(file, compressed_msg));
+    }
+
+    const TimestampPattern* Archive::get_timestamp_pattern (File& file, const Message& compressed_msg) {
+        const auto& timestamp_patterns = file.get_timestamp_patterns();
+        if (timestamp_patterns.empty() || compressed_msg.get_message_number() < timestamp_patterns[file.get_current_ts_pattern_ix()].first) {
+            return nullptr;
+        }
+
+        while (true) {
+            if (file.get_current_ts_pattern_ix() >= timestamp_patterns.size() - 1) {
+                // Already at last timestamp pattern
+                break;
+            }
+            auto next_patt_start_message_num = timestamp_patterns[file.get_current_ts_pattern_ix() + 1].first;
+            if (compressed_msg.get_message_number() < next_patt_start_message_num) {
+                // Not yet time for next timestamp pattern
+                break;
+            }
+            file.increment_current_ts_pattern_ix();
+        }
+        return &timestamp_patterns[file.get_current_ts_pattern_ix()].second;
+    }
+
     void Archive::decompress_empty_directories (const string& output_dir) {
         boost::filesystem::path output_dir_path = boost::filesystem::path(output_dir);
 
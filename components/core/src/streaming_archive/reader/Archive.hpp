@@ -7,9 +7,13 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 // Project headers
+#include "../../BloomFilter.hpp"
+#include "../../EncodedMessageFilter.hpp"
 #include "../../ErrorCode.hpp"
 #include "../../LogTypeDictionaryReader.hpp"
 #include "../../Query.hpp"
@@ -35,6 +39,16 @@ namespace streaming_archive { namespace reader {
         };
 
         // Methods
+        /**
+         * Reads the filter of the variable dictionary values of the archive at the given path, without opening the archive. This allows callers
+         * to skip archives which can't contain a query's dictionary variables without loading their dictionaries.
+         * @param path
+         * @param filter Returns the filter
+         * @return true if the filter was read, false if the archive has no filter (e.g., because it's still being written)
+         * @throw streaming_archive::reader::Archive::OperationFailed if the filter couldn't be read
+         */
+        static bool read_var_dict_filter (const std::string& path, BloomFilter& filter);
+
         /**
          * Opens archive for reading
          * @param path
@@ -49,6 +63,16 @@ namespace streaming_archive { namespace reader {
          * @throw Same as LogTypeDictionary::read_from_file and VariableDictionary::read_from_file
          */
         void refresh_dictionaries ();
+        /**
+         * Catches up with an archive that's still being written: finds the segments whose files have become visible since the last refresh (or
+         * since the archive was opened), and then reads any new dictionary entries. Since the writer flushes the dictionaries before a segment's
+         * files become visible, the dictionaries always cover the returned segments.
+         * @param new_segment_ids Returns the IDs of the newly visible segments (files that aren't in a segment are reported as being in
+         * cInvalidSegmentId)
+         * @throw Same as streaming_archive::reader::Archive::refresh_dictionaries
+         */
+        void refresh (std::vector<segment_id_t>& new_segment_ids);
+        const std::string& get_path () const { return m_path; }
         const LogTypeDictionaryReader& get_logtype_dictionary () const;
         const VariableDictionaryReader& get_var_dictionary () const;
 
@@ -74,6 +98,11 @@ namespace streaming_archive { namespace reader {
          * Wrapper for streaming_archive::reader::File::find_message_in_time_range
          */
         bool find_message_in_time_range (File& file, epochtime_t search_begin_timestamp, epochtime_t search_end_timestamp, Message& msg);
+        /**
+         * Wrapper for streaming_archive::reader::File::find_timestamp_and_logtype_in_time_range
+         */
+        bool find_timestamp_and_logtype_in_time_range (File& file, epochtime_t search_begin_timestamp, epochtime_t search_end_timestamp,
+                                                       epochtime_t& timestamp, logtype_dictionary_id_t& logtype_id);
         /**
          * Wrapper for streaming_archive::reader::File::find_message_matching_query
          */
@@ -92,25 +121,54 @@ namespace streaming_archive { namespace reader {
          * @throw TimestampPattern::OperationFailed if failed to insert timestamp
          */
         bool decompress_message (File& file, const Message& compressed_msg, std::string& decompressed_msg);
+        /**
+         * Checks whether a given message from a given file may match the given filter without decompressing the message
+         * @param file
+         * @param compressed_msg
+         * @param filter
+         * @return false if the message definitely won't match, true otherwise
+         */
+        bool message_may_match (File& file, const Message& compressed_msg, const EncodedMessageFilter& filter);
 
         void decompress_empty_directories (const std::string& output_dir);
 
         std::unique_ptr<MetadataDB::FileIterator> get_file_iterator () {
-            return m_metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId);
+            return m_metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId, false);
         }
         std::unique_ptr<MetadataDB::FileIterator> get_file_iterator (const std::string& file_path) {
-            return m_metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, file_path, false, cInvalidSegmentId);
+            return m_metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, file_path, false, cInvalidSegmentId, false);
         }
         std::unique_ptr<MetadataDB::FileIterator> get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path) {
-            return m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, false, cInvalidSegmentId);
+            return m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, false, cInvalidSegmentId, false);
         }
         std::unique_ptr<MetadataDB::FileIterator> get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path,
                                                                      segment_id_t segment_id)
         {
-            return m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, true, segment_id);
+            return m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, true, segment_id, false);
+        }
+        /**
+         * Gets an iterator over the files in the given time window, from the file with the latest end timestamp to the one with the earliest
+         * @param begin_ts
+         * @param end_ts
+         * @param file_path
+         * @return The file iterator
+         */
+        std::unique_ptr<MetadataDB::FileIterator> get_file_iterator_in_descending_end_ts_order (epochtime_t begin_ts, epochtime_t end_ts,
+                                                                                                const std::string& file_path)
+        {
+            return m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, false, cInvalidSegmentId, true);
         }
 
     private:
+        // Methods
+        /**
+         * Gets the timestamp pattern of the given message from the given file, advancing the file's current timestamp pattern as necessary
+         * @param file
+         * @param compressed_msg
+         * @return The timestamp pattern, or nullptr if the message doesn't have a timestamp
+         */
+        const TimestampPattern* get_timestamp_pattern (File& file, const Message& compressed_msg);
+
         // Variables
         std::string m_id;
         std::string m_path;
@@ -121,6 +179,8 @@ namespace streaming_archive { namespace reader {
         SegmentManager m_segment_manager;
 
         MetadataDB m_metadata_db;
+        // Segments returned by refresh
+        std::unordered_set<segment_id_t> m_visible_segment_ids;
     };
 } }
 
@@ -7,6 +7,7 @@
 // Project headers
 #include "../../EncodedVariableInterpreter.hpp"
 #include "../../spdlog_with_specializations.hpp"
+#include "../column_encoding.hpp"
 #include "../Constants.hpp"
 #include "SegmentManager.hpp"
 
@@ -84,7 +85,6 @@ namespace streaming_archive::reader {
 
         ErrorCode error_code;
 
-        uint64_t num_bytes_to_read;
         if (m_num_messages > 0) {
             if (m_num_messages > m_num_segment_msgs) {
                 // Buffers too small, so increase size to required amount
@@ -93,26 +93,14 @@ namespace streaming_archive::reader {
                 m_num_segment_msgs = m_num_messages;
             }
 
-            num_bytes_to_read = m_num_messages*sizeof(epochtime_t);
-            error_code = segment_manager.try_read(
-                    m_segment_id,
-                    m_segment_timestamps_decompressed_stream_pos,
-                    reinterpret_cast<char*>(m_segment_timestamps.get()),
-                    num_bytes_to_read
-            );
+            error_code = try_read_column(segment_manager, m_segment_timestamps_decompressed_stream_pos, m_num_messages, m_segment_timestamps.get());
             if (ErrorCode_Success != error_code) {
                 close_me();
                 return error_code;
             }
             m_timestamps = m_segment_timestamps.get();
 
-            num_bytes_to_read = m_num_messages*sizeof(logtype_dictionary_id_t);
-            error_code = segment_manager.try_read(
-                    m_segment_id,
-                    m_segment_logtypes_decompressed_stream_pos,
-                    reinterpret_cast<char*>(m_segment_logtypes.get()),
-                    num_bytes_to_read
-            );
+            error_code = try_read_column(segment_manager, m_segment_logtypes_decompressed_stream_pos, m_num_messages, m_segment_logtypes.get());
             if (ErrorCode_Success != error_code) {
                 close_me();
                 return error_code;
@@ -126,13 +114,7 @@ namespace streaming_archive::reader {
                 m_segment_variables = make_unique<encoded_variable_t[]>(m_num_variables);
                 m_num_segment_vars = m_num_variables;
             }
-            num_bytes_to_read = m_num_variables*sizeof(encoded_variable_t);
-            error_code = segment_manager.try_read(
-                    m_segment_id,
-                    m_segment_variables_decompressed_stream_pos,
-                    reinterpret_cast<char*>(m_segment_variables.get()),
-                    num_bytes_to_read
-            );
+            error_code = try_read_column(segment_manager, m_segment_variables_decompressed_stream_pos, m_num_variables, m_segment_variables.get());
             if (ErrorCode_Success != error_code) {
                 close_me();
                 return error_code;
@@ -149,6 +131,29 @@ namespace streaming_archive::reader {
         return ErrorCode_Success;
     }
 
+    ErrorCode File::try_read_column (SegmentManager& segment_manager, uint64_t decompressed_stream_pos, uint64_t num_values, int64_t* values) {
+        char header_buf[column_encoding::cColumnHeaderSize];
+        auto error_code = segment_manager.try_read(m_segment_id, decompressed_stream_pos, header_buf, sizeof(header_buf));
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        column_encoding::ColumnHeader header;
+        error_code = column_encoding::parse_column_header(header_buf, header);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+
+        // Read the encoded values directly into the column and then decode them in place
+        error_code = segment_manager.try_read(m_segment_id, decompressed_stream_pos + sizeof(header_buf), reinterpret_cast<char*>(values),
+                                              column_encoding::get_encoded_values_size(header, num_values));
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        column_encoding::decode_column_in_place(header, num_values, values);
+
+        return ErrorCode_Success;
+    }
+
     void File::close_me () {
         m_timestamps = nullptr;
         m_logtypes = nullptr;
@@ -177,6 +182,7 @@ namespace streaming_archive::reader {
     void File::reset_indices () {
         m_msgs_ix = 0;
         m_variables_ix = 0;
+        m_current_ts_pattern_ix = 0;
     }
 
     const string& File::get_orig_path () const {
@@ -246,6 +252,23 @@ namespace streaming_archive::reader {
         return found_msg;
     }
 
+    bool File::find_timestamp_and_logtype_in_time_range (epochtime_t search_begin_timestamp, epochtime_t search_end_timestamp,
+                                                         epochtime_t& timestamp, logtype_dictionary_id_t& logtype_id)
+    {
+        while (m_msgs_ix < m_num_messages) {
+            auto msg_timestamp = m_timestamps[m_msgs_ix];
+            if (search_begin_timestamp <= msg_timestamp && msg_timestamp <= search_end_timestamp) {
+                timestamp = msg_timestamp;
+                logtype_id = m_logtypes[m_msgs_ix];
+                ++m_msgs_ix;
+                return true;
+            }
+            ++m_msgs_ix;
+        }
+
+        return false;
+    }
+
     const SubQuery* File::find_message_matching_query (const Query& query, Message& msg) {
         const SubQuery* matching_sub_query = nullptr;
         while (m_msgs_ix < m_num_messages && nullptr == matching_sub_query) {
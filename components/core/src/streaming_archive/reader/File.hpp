@@ -78,6 +78,17 @@ namespace streaming_archive::reader {
         ErrorCode open_me (const LogTypeDictionaryReader& archive_logtype_dict,
                            MetadataDB::FileIterator& file_metadata_ix,
                            SegmentManager& segment_manager);
+        /**
+         * Reads and decodes a column of the file from its segment
+         * @param segment_manager
+         * @param decompressed_stream_pos Position of the column in the segment
+         * @param num_values Number of values in the column
+         * @param values Buffer for the decoded column
+         * @return ErrorCode_Corrupt if the column's header is invalid
+         * @return Same as SegmentManager::try_read
+         * @return ErrorCode_Success on success
+         */
+        ErrorCode try_read_column (SegmentManager& segment_manager, uint64_t decompressed_stream_pos, uint64_t num_values, int64_t* values);
         /**
          * Closes the file
          */
@@ -102,6 +113,18 @@ namespace streaming_archive::reader {
          */
         bool find_message_in_time_range (epochtime_t search_begin_timestamp,
                                          epochtime_t search_end_timestamp, Message& msg);
+        /**
+         * Finds message that falls in given time range, reading only the timestamp and logtype columns
+         * NOTE: Since the variables column isn't read, the message can't be decompressed and the file's indices must be reset before reading
+         * any other messages from the file.
+         * @param search_begin_timestamp
+         * @param search_end_timestamp
+         * @param timestamp Returns the message's timestamp
+         * @param logtype_id Returns the message's logtype ID
+         * @return true if a message was found, false otherwise
+         */
+        bool find_timestamp_and_logtype_in_time_range (epochtime_t search_begin_timestamp, epochtime_t search_end_timestamp, epochtime_t& timestamp,
+                                                       logtype_dictionary_id_t& logtype_id);
         /**
          * Finds message matching the given query
          * @param query
@@ -1,5 +1,8 @@
 #include "SegmentManager.hpp"
 
+// Project headers
+#include "../../Profiler.hpp"
+
 using std::string;
 
 namespace streaming_archive { namespace reader {
@@ -20,14 +23,18 @@ namespace streaming_archive { namespace reader {
     ErrorCode SegmentManager::try_read (segment_id_t segment_id, const uint64_t decompressed_stream_pos, char* extraction_buf, const uint64_t extraction_len) {
         static const size_t cMaxLRUSegments = 2;
 
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::SegmentDecompression>();
+
         // Check that segment exists or insert it if not
         if (m_id_to_open_segment.count(segment_id) == 0) {
             // Insert and open segment
             ErrorCode error_code = m_id_to_open_segment[segment_id].try_open(m_segment_dir_path, segment_id);
             if (ErrorCode_Success != error_code) {
                 m_id_to_open_segment.erase(segment_id);
+                Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::SegmentDecompression>();
                 return error_code;
             }
+            Profiler::increment_counter<Profiler::CounterIndex::DecompressedSegments>(1);
             m_lru_ids_of_open_segments.push_back(segment_id);
 
             // Evict a segment if necessary
@@ -41,6 +48,8 @@ namespace streaming_archive { namespace reader {
 
         // Extract data from compressed segment
         auto& segment = m_id_to_open_segment.at(segment_id);
-        return segment.try_read(decompressed_stream_pos, extraction_buf, extraction_len);
+        auto error_code = segment.try_read(decompressed_stream_pos, extraction_buf, extraction_len);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::SegmentDecompression>();
+        return error_code;
     }
 } }
\ No newline at end of file
@@ -6,8 +6,10 @@
 
 // C++ libraries
 #include <iostream>
+#include <iterator>
 #include <fstream>
 #include <filesystem>
+#include <list>
 
 // Boost libraries
 #include <boost/asio.hpp>
@@ -21,12 +23,15 @@
 // Project headers
 #include "../../compressor_frontend/LogParser.hpp"
 #include "../../EncodedVariableInterpreter.hpp"
+#include "../../Profiler.hpp"
 #include "../../spdlog_with_specializations.hpp"
 #include "../../Utils.hpp"
 #include "../Constants.hpp"
 
 using std::list;
+using std::lock_guard;
 using std::make_unique;
+using std::mutex;
 using std::string;
 using std::unordered_set;
 using std::vector;
@@ -34,10 +39,13 @@ using std::vector;
 namespace streaming_archive::writer {
     Archive::~Archive () {
         if (m_path.empty() == false || m_file != nullptr || m_files_with_timestamps_in_segment.empty() == false ||
-                m_files_without_timestamps_in_segment.empty() == false)
+                m_files_without_timestamps_in_segment.empty() == false || m_files_pending_segment_assignment.empty() == false)
         {
             SPDLOG_ERROR("Archive not closed before being destroyed - data loss may occur");
             delete m_file;
+            for (auto& pending_file : m_files_pending_segment_assignment) {
+                delete pending_file.file;
+            }
             for (auto file : m_files_with_timestamps_in_segment) {
                 delete file;
             }
@@ -103,7 +111,7 @@ namespace streaming_archive::writer {
 
         // Create metadata database
         auto metadata_db_path = archive_path / cMetadataDBFileName;
-        m_metadata_db.open(metadata_db_path.string());
+        m_metadata_db.open(metadata_db_path.string(), true);
 
         m_next_file_id = 0;
 
@@ -111,6 +119,22 @@ namespace streaming_archive::writer {
         m_next_segment_id = 0;
         m_compression_level = user_config.compression_level;
 
+        m_segment_packing_window_size = user_config.segment_packing_window_size;
+        m_encoded_size_of_files_pending_segment_assignment = 0;
+
+        m_memory_budget = user_config.memory_budget;
+        m_memory_budget_warning_logged = false;
+
+        m_column_buffer_pool = ColumnBufferPool(user_config.use_huge_pages_for_columns, ColumnBufferPool::cDefaultMaxNumResidentBytesPerColumn,
+                                                ColumnBufferPool::cDefaultMaxNumPooledColumnBuffers);
+
+        if (nullptr == m_segment_for_files_with_timestamps) {
+            m_segment_for_files_with_timestamps = m_segment_finalizer.get_unused_segment();
+        }
+        if (nullptr == m_segment_for_files_without_timestamps) {
+            m_segment_for_files_without_timestamps = m_segment_finalizer.get_unused_segment();
+        }
+
         /// TODO: add schema file size to m_stable_size???
         // Copy schema file into archive
         if (!m_schema_file_path.empty()) {
@@ -137,9 +161,10 @@ namespace streaming_archive::writer {
 
         m_global_metadata_db = user_config.global_metadata_db;
 
+        // NOTE: The global metadata DB is kept open until the archive is closed, so that its connection and prepared statements can be reused for
+        // every segment
         m_global_metadata_db->open();
         m_global_metadata_db->add_archive(m_id_as_string, *m_local_metadata);
-        m_global_metadata_db->close();
 
         m_file = nullptr;
 
@@ -165,6 +190,9 @@ namespace streaming_archive::writer {
             SPDLOG_WARN("Error when closing file descriptor for {}, errno={}", archive_path_string.c_str(), errno);
         }
 
+        m_segment_finalizer.open([this] (SegmentFinalizer::PendingSegment& pending_segment) { finalize_segment(pending_segment); },
+                                 cMaxNumSegmentsPendingFinalization);
+
         m_path = archive_path_string;
     }
 
@@ -174,25 +202,19 @@ namespace streaming_archive::writer {
             throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
         }
 
-        // Close segments if necessary
-        if (m_segment_for_files_with_timestamps.is_open()) {
-            close_segment_and_persist_file_metadata(m_segment_for_files_with_timestamps, m_files_with_timestamps_in_segment,
-                                                    m_logtype_ids_in_segment_for_files_with_timestamps, m_var_ids_in_segment_for_files_with_timestamps);
-            m_logtype_ids_in_segment_for_files_with_timestamps.clear();
-            m_var_ids_in_segment_for_files_with_timestamps.clear();
-        }
-        if (m_segment_for_files_without_timestamps.is_open()) {
-            close_segment_and_persist_file_metadata(m_segment_for_files_without_timestamps, m_files_without_timestamps_in_segment,
-                                                    m_logtype_ids_in_segment_for_files_without_timestamps, m_var_ids_in_segment_for_files_without_timestamps);
-            m_logtype_ids_in_segment_for_files_without_timestamps.clear();
-            m_var_ids_in_segment_for_files_without_timestamps.clear();
-        }
+        close_open_segments();
 
         // Persist all metadata including dictionaries
         write_dir_snapshot();
 
+        // Wait for all segments to be finalized
+        m_segment_finalizer.close();
+        print_pending_archive_stats();
+
         m_logtype_dict.close();
         m_logtype_dict_entry.clear();
+        // NOTE: The filter is only written once the archive is complete, so readers never skip an archive that may still gain values
+        m_var_dict.write_value_filter(m_path + '/' + cVarDictFilterFilename);
         m_var_dict.close();
 
         if (::close(m_segments_dir_fd) != 0) {
@@ -204,21 +226,41 @@ namespace streaming_archive::writer {
 
         m_metadata_file_writer.close();
 
-        m_global_metadata_db = nullptr;
-
         m_metadata_db.close();
 
+        // NOTE: The archive is only marked finalized once everything in it has been persisted, so readers following it can stop afterwards
+        m_global_metadata_db->mark_archive_finalized(m_id_as_string);
+        m_global_metadata_db->close();
+        m_global_metadata_db = nullptr;
+
         m_creator_id_as_string.clear();
         m_id_as_string.clear();
         m_path.clear();
     }
 
+    void Archive::close_open_segments () {
+        pack_and_append_pending_files_to_segments();
+
+        if (m_segment_for_files_with_timestamps->is_open()) {
+            close_segment_and_persist_file_metadata(m_segment_for_files_with_timestamps, m_files_with_timestamps_in_segment,
+                                                    m_logtype_ids_in_segment_for_files_with_timestamps, m_var_ids_in_segment_for_files_with_timestamps);
+            m_logtype_ids_in_segment_for_files_with_timestamps.clear();
+            m_var_ids_in_segment_for_files_with_timestamps.clear();
+        }
+        if (m_segment_for_files_without_timestamps->is_open()) {
+            close_segment_and_persist_file_metadata(m_segment_for_files_without_timestamps, m_files_without_timestamps_in_segment,
+                                                    m_logtype_ids_in_segment_for_files_without_timestamps, m_var_ids_in_segment_for_files_without_timestamps);
+            m_logtype_ids_in_segment_for_files_without_timestamps.clear();
+            m_var_ids_in_segment_for_files_without_timestamps.clear();
+        }
+    }
+
     void Archive::create_and_open_file (const string& path, const group_id_t group_id, const boost::uuids::uuid& orig_file_id, size_t split_ix) {
         if (m_file != nullptr) {
             throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
         }
         m_file = new File(m_uuid_generator(), orig_file_id, path, group_id, split_ix);
-        m_file->open();
+        m_file->open(m_column_buffer_pool);
     }
 
     void Archive::close_file () {
@@ -253,13 +295,20 @@ namespace streaming_archive::writer {
         // Encode message and add components to dictionaries
         vector<encoded_variable_t> encoded_vars;
         vector<variable_dictionary_id_t> var_ids;
+        // NOTE: This includes adding the message's dictionary variables to the variable dictionary
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::VariableEncoding>();
         EncodedVariableInterpreter::encode_and_add_to_dictionary(message, m_logtype_dict_entry, m_var_dict, encoded_vars, var_ids);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::VariableEncoding>();
         logtype_dictionary_id_t logtype_id;
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryInsertion>();
         m_logtype_dict.add_entry(m_logtype_dict_entry, logtype_id);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryInsertion>();
 
         m_file->write_encoded_msg(timestamp, logtype_id, encoded_vars, var_ids, num_uncompressed_bytes);
+        Profiler::increment_counter<Profiler::CounterIndex::EncodedMessages>(1);
 
         update_segment_indices(logtype_id, var_ids);
+        enforce_memory_budget();
     }
 
     void Archive::write_msg_using_schema (compressor_frontend::Token*& uncompressed_msg, uint32_t uncompressed_msg_pos, const bool has_delimiter,
@@ -299,6 +348,8 @@ namespace streaming_archive::writer {
         } else {
             num_uncompressed_bytes = *uncompressed_msg[0].m_buffer_size_ptr - start_pos + end_pos;
         }
+        // Only used to hold tokens that wrap around the end of the parser's input buffer
+        string wrapped_token_buffer;
         for (uint32_t i = 1; i < uncompressed_msg_pos; i++) {
             compressor_frontend::Token& token = uncompressed_msg[i];
             int token_type = token.m_type_ids->at(0);
@@ -319,9 +370,10 @@ namespace streaming_archive::writer {
                 }
                 case (int) compressor_frontend::SymbolID::TokenIntId: {
                     encoded_variable_t encoded_var;
-                    if (!EncodedVariableInterpreter::convert_string_to_representable_integer_var(token.get_string(), encoded_var)) {
+                    auto token_string = token.get_string_view(wrapped_token_buffer);
+                    if (!EncodedVariableInterpreter::convert_string_to_representable_integer_var(token_string, encoded_var)) {
                         variable_dictionary_id_t id;
-                        m_var_dict.add_entry(token.get_string(), id);
+                        m_var_dict.add_entry(token_string, id);
                         encoded_var = EncodedVariableInterpreter::encode_var_dict_id(id);
                         m_logtype_dict_entry.add_dictionary_var();
                     } else {
@@ -332,10 +384,10 @@ namespace streaming_archive::writer {
                 }
                 case (int) compressor_frontend::SymbolID::TokenFloatId: {
                     encoded_variable_t encoded_var;
-                    if (!EncodedVariableInterpreter::convert_string_to_representable_float_var(
-                            token.get_string(), encoded_var)) {
+                    auto token_string = token.get_string_view(wrapped_token_buffer);
+                    if (!EncodedVariableInterpreter::convert_string_to_representable_float_var(token_string, encoded_var)) {
                         variable_dictionary_id_t id;
-                        m_var_dict.add_entry(token.get_string(), id);
+                        m_var_dict.add_entry(token_string, id);
                         encoded_var = EncodedVariableInterpreter::encode_var_dict_id(id);
                         m_logtype_dict_entry.add_dictionary_var();
                     } else {
@@ -348,7 +400,7 @@ namespace streaming_archive::writer {
                     // Variable string looks like a dictionary variable, so encode it as so
                     encoded_variable_t encoded_var;
                     variable_dictionary_id_t id;
-                    m_var_dict.add_entry(token.get_string(), id);
+                    m_var_dict.add_entry(token.get_string_view(wrapped_token_buffer), id);
                     encoded_var = EncodedVariableInterpreter::encode_var_dict_id(id);
                     m_var_ids.push_back(id);
 
@@ -360,10 +412,14 @@ namespace streaming_archive::writer {
         }
         if (!m_logtype_dict_entry.get_value().empty()) {
             logtype_dictionary_id_t logtype_id;
+            Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryInsertion>();
             m_logtype_dict.add_entry(m_logtype_dict_entry, logtype_id);
+            Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryInsertion>();
             m_file->write_encoded_msg(timestamp, logtype_id, m_encoded_vars, m_var_ids, num_uncompressed_bytes);
+            Profiler::increment_counter<Profiler::CounterIndex::EncodedMessages>(1);
 
             update_segment_indices(logtype_id, m_var_ids);
+            enforce_memory_budget();
         }
     }
 
@@ -372,6 +428,7 @@ namespace streaming_archive::writer {
         vector<ffi::eight_byte_encoded_variable_t> encoded_vars;
         vector<variable_dictionary_id_t> var_ids;
         size_t original_num_bytes{0};
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::VariableEncoding>();
         EncodedVariableInterpreter::encode_and_add_to_dictionary(
                 log_event,
                 m_logtype_dict_entry,
@@ -380,9 +437,12 @@ namespace streaming_archive::writer {
                 var_ids,
                 original_num_bytes
         );
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::VariableEncoding>();
 
         logtype_dictionary_id_t logtype_id{cLogtypeDictionaryIdMax};
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryInsertion>();
         m_logtype_dict.add_entry(m_logtype_dict_entry, logtype_id);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::DictionaryInsertion>();
 
         m_file->write_encoded_msg(
                 log_event.get_timestamp(),
@@ -391,8 +451,10 @@ namespace streaming_archive::writer {
                 var_ids,
                 original_num_bytes
         );
+        Profiler::increment_counter<Profiler::CounterIndex::EncodedMessages>(1);
 
         update_segment_indices(logtype_id, var_ids);
+        enforce_memory_budget();
     }
 
     void Archive::write_dir_snapshot () {
@@ -405,7 +467,8 @@ namespace streaming_archive::writer {
             logtype_dictionary_id_t logtype_id,
             vector<variable_dictionary_id_t> const& var_ids
     ) {
-        if (m_file->has_ts_pattern()) {
+        // NOTE: When packing segments, we don't know which segment the file will be appended to until after it's closed
+        if (m_file->has_ts_pattern() && 0 == m_segment_packing_window_size) {
             m_logtype_ids_in_segment_for_files_with_timestamps.insert(logtype_id);
             m_var_ids_in_segment_for_files_with_timestamps.insert_all(var_ids);
         } else {
@@ -414,46 +477,171 @@ namespace streaming_archive::writer {
         }
     }
 
-    void Archive::append_file_contents_to_segment (Segment& segment, ArrayBackedPosIntSet<logtype_dictionary_id_t>& logtype_ids_in_segment,
+    void Archive::append_file_contents_to_segment (File* file, std::unique_ptr<Segment>& segment,
+                                                   ArrayBackedPosIntSet<logtype_dictionary_id_t>& logtype_ids_in_segment,
                                                    ArrayBackedPosIntSet<variable_dictionary_id_t>& var_ids_in_segment, vector<File*>& files_in_segment)
     {
-        if (!segment.is_open()) {
-            segment.open(m_segments_dir_path, m_next_segment_id++, m_compression_level);
+        if (!segment->is_open()) {
+            segment->open(m_segments_dir_path, m_next_segment_id++, m_compression_level);
         }
 
-        m_file->append_to_segment(m_logtype_dict, segment);
-        files_in_segment.emplace_back(m_file);
-        m_local_metadata->increment_static_uncompressed_size(m_file->get_num_uncompressed_bytes());
-        m_local_metadata->expand_time_range(m_file->get_begin_ts(), m_file->get_end_ts());
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::SegmentCompression>();
+        file->append_to_segment(m_logtype_dict, *segment);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::SegmentCompression>();
+        files_in_segment.emplace_back(file);
+        {
+            lock_guard<mutex> lock(m_metadata_mutex);
+            m_local_metadata->increment_static_uncompressed_size(file->get_num_uncompressed_bytes());
+            m_local_metadata->expand_time_range(file->get_begin_ts(), file->get_end_ts());
+        }
 
         // Close current segment if its uncompressed size is greater than the target
-        if (segment.get_uncompressed_size() >= m_target_segment_uncompressed_size) {
+        if (segment->get_uncompressed_size() >= m_target_segment_uncompressed_size) {
             close_segment_and_persist_file_metadata(segment, files_in_segment, logtype_ids_in_segment, var_ids_in_segment);
             logtype_ids_in_segment.clear();
             var_ids_in_segment.clear();
         }
     }
 
+    Segment& Archive::append_file_and_ids_to_segment (File* file, const unordered_set<logtype_dictionary_id_t>& logtype_ids,
+                                                      const unordered_set<variable_dictionary_id_t>& var_ids)
+    {
+        if (file->has_ts_pattern()) {
+            m_logtype_ids_in_segment_for_files_with_timestamps.insert_all(logtype_ids);
+            m_var_ids_in_segment_for_files_with_timestamps.insert_all(var_ids);
+            append_file_contents_to_segment(file, m_segment_for_files_with_timestamps, m_logtype_ids_in_segment_for_files_with_timestamps,
+                                            m_var_ids_in_segment_for_files_with_timestamps, m_files_with_timestamps_in_segment);
+            return *m_segment_for_files_with_timestamps;
+        } else {
+            m_logtype_ids_in_segment_for_files_without_timestamps.insert_all(logtype_ids);
+            m_var_ids_in_segment_for_files_without_timestamps.insert_all(var_ids);
+            append_file_contents_to_segment(file, m_segment_for_files_without_timestamps, m_logtype_ids_in_segment_for_files_without_timestamps,
+                                            m_var_ids_in_segment_for_files_without_timestamps, m_files_without_timestamps_in_segment);
+            return *m_segment_for_files_without_timestamps;
+        }
+    }
+
     void Archive::append_file_to_segment () {
         if (m_file == nullptr) {
             throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
         }
 
-        if (m_file->has_ts_pattern()) {
-            m_logtype_ids_in_segment_for_files_with_timestamps.insert_all(m_logtype_ids_for_file_with_unassigned_segment);
-            m_var_ids_in_segment_for_files_with_timestamps.insert_all(m_var_ids_for_file_with_unassigned_segment);
-            append_file_contents_to_segment(m_segment_for_files_with_timestamps, m_logtype_ids_in_segment_for_files_with_timestamps,
-                                            m_var_ids_in_segment_for_files_with_timestamps, m_files_with_timestamps_in_segment);
+        if (0 == m_segment_packing_window_size) {
+            append_file_and_ids_to_segment(m_file, m_logtype_ids_for_file_with_unassigned_segment, m_var_ids_for_file_with_unassigned_segment);
         } else {
-            m_logtype_ids_in_segment_for_files_without_timestamps.insert_all(m_logtype_ids_for_file_with_unassigned_segment);
-            m_var_ids_in_segment_for_files_without_timestamps.insert_all(m_var_ids_for_file_with_unassigned_segment);
-            append_file_contents_to_segment(m_segment_for_files_without_timestamps, m_logtype_ids_in_segment_for_files_without_timestamps,
-                                            m_var_ids_in_segment_for_files_without_timestamps, m_files_without_timestamps_in_segment);
+            FilePendingSegmentAssignment pending_file;
+            pending_file.file = m_file;
+            pending_file.logtype_ids_signature.add_all(m_logtype_ids_for_file_with_unassigned_segment);
+            pending_file.logtype_ids = std::move(m_logtype_ids_for_file_with_unassigned_segment);
+            pending_file.var_ids = std::move(m_var_ids_for_file_with_unassigned_segment);
+            m_encoded_size_of_files_pending_segment_assignment += m_file->get_encoded_size_in_bytes();
+            m_files_pending_segment_assignment.emplace_back(std::move(pending_file));
+
+            if (m_encoded_size_of_files_pending_segment_assignment >= m_segment_packing_window_size ||
+                m_files_pending_segment_assignment.size() >= cMaxNumFilesPendingSegmentAssignment)
+            {
+                pack_and_append_pending_files_to_segments();
+            }
         }
         m_logtype_ids_for_file_with_unassigned_segment.clear();
         m_var_ids_for_file_with_unassigned_segment.clear();
         // Make sure file pointer is nulled and cannot be accessed outside
         m_file = nullptr;
+
+        enforce_memory_budget();
+    }
+
+    void Archive::pack_and_append_pending_files_to_segments () {
+        // Files are removed from the middle of the list as they're packed, so we use a list to avoid shifting elements
+        list<FilePendingSegmentAssignment> pending_files(std::make_move_iterator(m_files_pending_segment_assignment.begin()),
+                                                         std::make_move_iterator(m_files_pending_segment_assignment.end()));
+        m_files_pending_segment_assignment.clear();
+        m_encoded_size_of_files_pending_segment_assignment = 0;
+
+        while (false == pending_files.empty()) {
+            // Seed the segment with the oldest pending file, so files are still roughly appended in the order they were closed
+            auto seed_file = std::move(pending_files.front());
+            pending_files.pop_front();
+            auto seed_has_ts_pattern = seed_file.file->has_ts_pattern();
+            auto seed_group_id = seed_file.file->get_group_id();
+            auto segment_signature = seed_file.logtype_ids_signature;
+            auto* segment = &append_file_and_ids_to_segment(seed_file.file, seed_file.logtype_ids, seed_file.var_ids);
+
+            // Fill the rest of the segment with the compatible files that are most similar to those already in the segment
+            while (segment->is_open()) {
+                auto most_similar_file_it = pending_files.end();
+                double max_similarity = -1;
+                for (auto it = pending_files.begin(); pending_files.end() != it; ++it) {
+                    if (it->file->has_ts_pattern() != seed_has_ts_pattern || it->file->get_group_id() != seed_group_id) {
+                        continue;
+                    }
+                    auto similarity = segment_signature.estimate_similarity(it->logtype_ids_signature);
+                    if (similarity > max_similarity) {
+                        max_similarity = similarity;
+                        most_similar_file_it = it;
+                    }
+                }
+                if (pending_files.end() == most_similar_file_it) {
+                    break;
+                }
+
+                segment_signature.merge(most_similar_file_it->logtype_ids_signature);
+                segment = &append_file_and_ids_to_segment(most_similar_file_it->file, most_similar_file_it->logtype_ids,
+                                                          most_similar_file_it->var_ids);
+                pending_files.erase(most_similar_file_it);
+            }
+        }
+    }
+
+    size_t Archive::get_in_memory_size () const {
+        size_t size = m_logtype_dict.get_in_memory_size() + m_var_dict.get_in_memory_size() + m_encoded_size_of_files_pending_segment_assignment +
+                      m_column_buffer_pool.get_num_resident_bytes();
+        if (nullptr != m_file) {
+            size += m_file->get_encoded_size_in_bytes();
+        }
+        return size;
+    }
+
+    void Archive::enforce_memory_budget () {
+        // NOTE: This is called after every message, so it must stay cheap when the archive is within its budget
+        if (0 == m_memory_budget || get_in_memory_size() <= m_memory_budget) {
+            return;
+        }
+
+        // Appending the pending files to segments frees their columns without slowing down later dictionary lookups, so we do it first
+        if (false == m_files_pending_segment_assignment.empty()) {
+            pack_and_append_pending_files_to_segments();
+            if (get_in_memory_size() <= m_memory_budget) {
+                return;
+            }
+        }
+
+        // Pooled column buffers only save page faults, so they're cheaper to give up than the dictionaries' mappings
+        m_column_buffer_pool.clear();
+        if (get_in_memory_size() <= m_memory_budget) {
+            return;
+        }
+
+        // Spill the dictionaries' mappings to disk, larger first, until the archive is within its budget
+        while (get_in_memory_size() > m_memory_budget) {
+            auto logtype_dict_mappings_size = m_logtype_dict.get_in_memory_mappings_size();
+            auto var_dict_mappings_size = m_var_dict.get_in_memory_mappings_size();
+            if (var_dict_mappings_size >= logtype_dict_mappings_size && var_dict_mappings_size >= cMinDictionarySpillSize) {
+                m_var_dict.spill_mappings_to_disk();
+            } else if (logtype_dict_mappings_size >= cMinDictionarySpillSize) {
+                m_logtype_dict.spill_mappings_to_disk();
+            } else {
+                break;
+            }
+            Profiler::increment_counter<Profiler::CounterIndex::DictionarySpills>(1);
+        }
+
+        if (get_in_memory_size() > m_memory_budget && false == m_memory_budget_warning_logged) {
+            // The rest is the open file and the spilled dictionaries' indexes, which can't be freed until the file is closed
+            SPDLOG_WARN("Archive {} is using {} B of memory, exceeding the memory budget of {} B. Consider reducing the target encoded file size.",
+                        m_id_as_string, get_in_memory_size(), m_memory_budget);
+            m_memory_budget_warning_logged = true;
+        }
     }
 
     void Archive::persist_file_metadata (const vector<File*>& files) {
@@ -461,7 +649,10 @@ namespace streaming_archive::writer {
             return;
         }
 
-        m_metadata_db.update_files(files);
+        {
+            lock_guard<mutex> lock(m_metadata_mutex);
+            m_metadata_db.update_files(files);
+        }
 
         m_global_metadata_db->update_metadata_for_files(m_id_as_string, files);
 
@@ -471,17 +662,46 @@ namespace streaming_archive::writer {
         }
     }
 
-    void Archive::close_segment_and_persist_file_metadata (Segment& segment, std::vector<File*>& files,
+    void Archive::close_segment_and_persist_file_metadata (std::unique_ptr<Segment>& segment, std::vector<File*>& files,
                                                            ArrayBackedPosIntSet<logtype_dictionary_id_t>& segment_logtype_ids,
                                                            ArrayBackedPosIntSet<variable_dictionary_id_t>& segment_var_ids)
     {
-        auto segment_id = segment.get_id();
+        // NOTE: The dictionaries are only modified by the compression thread, so they're indexed and flushed here rather than by the finalizer.
+        // Flushing them before the segment is closed is safe since files only become visible once their metadata is persisted.
+        auto segment_id = segment->get_id();
         m_logtype_dict.index_segment(segment_id, segment_logtype_ids);
         m_var_dict.index_segment(segment_id, segment_var_ids);
 
-        segment.close();
+        // Flush dictionaries
+        m_logtype_dict.write_header_and_flush_to_disk();
+        m_var_dict.write_header_and_flush_to_disk();
+
+        SegmentFinalizer::PendingSegment pending_segment;
+        pending_segment.segment = std::move(segment);
+        pending_segment.files = std::move(files);
+        files.clear();
+        try {
+            segment = m_segment_finalizer.get_unused_segment();
+            pending_segment.dynamic_compressed_size = get_dynamic_compressed_size();
+        } catch (...) {
+            SegmentFinalizer::discard(pending_segment);
+            throw;
+        }
+        // NOTE: If this throws, the finalizer discards the segment
+        m_segment_finalizer.add_segment(std::move(pending_segment));
 
-        m_local_metadata->increment_static_compressed_size(segment.get_compressed_size());
+        // Print the stats of any segments finalized since the last segment was closed
+        print_pending_archive_stats();
+    }
+
+    void Archive::finalize_segment (SegmentFinalizer::PendingSegment& pending_segment) {
+        auto& segment = *pending_segment.segment;
+        auto& files = pending_segment.files;
+
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::SegmentCompression>();
+        segment.close();
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::SegmentCompression>();
+        Profiler::increment_counter<Profiler::CounterIndex::CompressedSegments>(1);
 
         #if FLUSH_TO_DISK_ENABLED
             // fsync segments directory to flush segment's directory entry
@@ -491,18 +711,14 @@ namespace streaming_archive::writer {
             }
         #endif
 
-        // Flush dictionaries
-        m_logtype_dict.write_header_and_flush_to_disk();
-        m_var_dict.write_header_and_flush_to_disk();
-
         for (auto file : files) {
             file->mark_as_in_committed_segment();
         }
 
-        m_global_metadata_db->open();
+        Profiler::start_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MetadataPersistence>();
         persist_file_metadata(files);
-        update_metadata();
-        m_global_metadata_db->close();
+        update_metadata(segment.get_compressed_size(), pending_segment.dynamic_compressed_size);
+        Profiler::stop_fragmented_measurement<Profiler::FragmentedMeasurementIndex::MetadataPersistence>();
 
         for (auto file : files) {
             delete file;
@@ -515,6 +731,7 @@ namespace streaming_archive::writer {
             return;
         }
 
+        lock_guard<mutex> lock(m_metadata_mutex);
         m_metadata_db.add_empty_directories(empty_directory_paths);
     }
 
@@ -522,31 +739,56 @@ namespace streaming_archive::writer {
         uint64_t on_disk_size = m_logtype_dict.get_on_disk_size() + m_var_dict.get_on_disk_size();
 
         // Add size of unclosed segments
-        if (m_segment_for_files_with_timestamps.is_open()) {
-            on_disk_size += m_segment_for_files_with_timestamps.get_compressed_size();
+        if (m_segment_for_files_with_timestamps->is_open()) {
+            on_disk_size += m_segment_for_files_with_timestamps->get_compressed_size();
         }
-        if (m_segment_for_files_without_timestamps.is_open()) {
-            on_disk_size += m_segment_for_files_without_timestamps.get_compressed_size();
+        if (m_segment_for_files_without_timestamps->is_open()) {
+            on_disk_size += m_segment_for_files_without_timestamps->get_compressed_size();
         }
 
         return on_disk_size;
     }
 
-    void Archive::update_metadata () {
-        m_local_metadata->set_dynamic_uncompressed_size(0);
-        m_local_metadata->set_dynamic_compressed_size(get_dynamic_compressed_size());
+    void Archive::update_metadata (uint64_t segment_compressed_size, uint64_t dynamic_compressed_size) {
+        // Update the metadata and then persist a copy of it, so that the compression thread isn't blocked while it's persisted
+        std::optional<ArchiveMetadata> metadata;
+        {
+            lock_guard<mutex> lock(m_metadata_mutex);
+            m_local_metadata->increment_static_compressed_size(segment_compressed_size);
+            m_local_metadata->set_dynamic_uncompressed_size(0);
+            m_local_metadata->set_dynamic_compressed_size(dynamic_compressed_size);
+            metadata = m_local_metadata;
+        }
+
         // Rewrite (overwrite) the metadata file
         m_metadata_file_writer.seek_from_begin(0);
-        m_local_metadata->write_to_file(m_metadata_file_writer);
+        metadata->write_to_file(m_metadata_file_writer);
 
-        m_global_metadata_db->update_archive_metadata(m_id_as_string, *m_local_metadata);
+        m_global_metadata_db->update_archive_metadata(m_id_as_string, *metadata);
 
         if (m_print_archive_stats_progress) {
             nlohmann::json json_msg;
             json_msg["id"] = m_id_as_string;
-            json_msg["uncompressed_size"] = m_local_metadata->get_uncompressed_size_bytes();
-            json_msg["size"] = m_local_metadata->get_compressed_size_bytes();
-            std::cout << json_msg.dump(-1, ' ', true, nlohmann::json::error_handler_t::ignore) << std::endl;
+            json_msg["uncompressed_size"] = metadata->get_uncompressed_size_bytes();
+            json_msg["size"] = metadata->get_compressed_size_bytes();
+            auto json_msg_str = json_msg.dump(-1, ' ', true, nlohmann::json::error_handler_t::ignore);
+            lock_guard<mutex> lock(m_metadata_mutex);
+            m_pending_archive_stats.emplace_back(std::move(json_msg_str));
+        }
+    }
+
+    void Archive::print_pending_archive_stats () {
+        if (false == m_print_archive_stats_progress) {
+            return;
+        }
+
+        vector<string> archive_stats;
+        {
+            lock_guard<mutex> lock(m_metadata_mutex);
+            archive_stats.swap(m_pending_archive_stats);
+        }
+        for (const auto& stats : archive_stats) {
+            std::cout << stats << std::endl;
         }
     }
 
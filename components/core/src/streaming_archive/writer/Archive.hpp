@@ -4,6 +4,7 @@
 // C++ libraries
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -21,9 +22,12 @@
 #include "../../GlobalMetadataDB.hpp"
 #include "../../ir/LogEvent.hpp"
 #include "../../LogTypeDictionaryWriter.hpp"
+#include "../../MinHashSignature.hpp"
 #include "../../VariableDictionaryWriter.hpp"
 #include "../ArchiveMetadata.hpp"
 #include "../MetadataDB.hpp"
+#include "ColumnBufferPool.hpp"
+#include "SegmentFinalizer.hpp"
 
 namespace streaming_archive { namespace writer {
     class Archive {
@@ -39,6 +43,11 @@ namespace streaming_archive { namespace writer {
          * @param output_dir Output directory
          * @param global_metadata_db
          * @param print_archive_stats_progress Enable printing statistics about the archive as it's compressed
+         * @param segment_packing_window_size Encoded size (B) of closed files to buffer before grouping them into segments by the similarity of their
+         * logtypes. 0 disables packing, so files are added to segments in the order they're closed.
+         * @param use_huge_pages_for_columns Whether to back the buffers that files' columns are encoded into with transparent huge pages
+         * @param memory_budget Approximate amount of memory (B) the archive's dictionaries and buffered files may use before files pending segment
+         * assignment are flushed to segments and dictionary mappings are spilled to disk. 0 means unlimited.
          */
         struct UserConfig {
             boost::uuids::uuid id;
@@ -49,6 +58,9 @@ namespace streaming_archive { namespace writer {
             std::string output_dir;
             GlobalMetadataDB* global_metadata_db;
             bool print_archive_stats_progress;
+            size_t segment_packing_window_size;
+            bool use_huge_pages_for_columns;
+            size_t memory_budget;
         };
 
         class OperationFailed : public TraceableException {
@@ -88,12 +100,14 @@ namespace streaming_archive { namespace writer {
          */
         void open (const UserConfig& user_config);
         /**
-         * Writes a final snapshot of the archive, closes all open files, and closes the dictionaries
+         * Writes a final snapshot of the archive, closes all open files, writes the variable dictionary's filter, and closes the dictionaries
          * @throw FileWriter::OperationFailed if any writer could not be closed
          * @throw streaming_archive::writer::Archive::OperationFailed if any empty directories could not be removed
          * @throw streaming_archive::writer::Archive::OperationFailed if the file is not reset
          * @throw Same as streaming_archive::writer::SegmentManager::close
          * @throw Same as streaming_archive::writer::Archive::write_dir_snapshot
+         * @throw Same as streaming_archive::writer::SegmentFinalizer::close
+         * @throw Same as VariableDictionaryWriter::write_value_filter
          */
         void close ();
 
@@ -159,12 +173,22 @@ namespace streaming_archive { namespace writer {
         void write_dir_snapshot ();
 
         /**
-         * Adds the encoded file to the segment
+         * Adds the encoded file to the segment. If segment packing is enabled, the file is buffered until enough files have been closed to group
+         * them by similarity.
          * @throw streaming_archive::writer::Archive::OperationFailed if failed the file is not tracked by the current archive
          * @throw Same as streaming_archive::writer::Archive::persist_file_metadata
          */
         void append_file_to_segment ();
 
+        /**
+         * Closes the open segments (after appending any files pending segment assignment) so that every file appended to the archive so far
+         * becomes searchable once its segment is finalized, without closing the archive. This lets readers follow an archive that's still being
+         * written, at the cost of smaller segments.
+         * NOTE: The open file (if any) isn't included; it must be closed (e.g., as a split) first.
+         * @throw Same as streaming_archive::writer::Archive::close_segment_and_persist_file_metadata
+         */
+        void close_open_segments ();
+
         /**
          * Adds empty directories to the archive
          * @param empty_directory_paths
@@ -177,6 +201,11 @@ namespace streaming_archive { namespace writer {
 
         size_t get_data_size_of_dictionaries () const { return m_logtype_dict.get_data_size() + m_var_dict.get_data_size(); }
 
+        /**
+         * @return The approximate amount of memory (B) used by the archive's dictionary mappings, open file, and files pending segment assignment
+         */
+        size_t get_in_memory_size () const;
+
     private:
         // Types
         /**
@@ -209,6 +238,16 @@ namespace streaming_archive { namespace writer {
             }
         };
 
+        /**
+         * A closed file that's waiting to be assigned to a segment, along with the IDs it contains
+         */
+        struct FilePendingSegmentAssignment {
+            File* file;
+            std::unordered_set<logtype_dictionary_id_t> logtype_ids;
+            std::unordered_set<variable_dictionary_id_t> var_ids;
+            MinHashSignature logtype_ids_signature;
+        };
+
         // Methods
         void update_segment_indices(
                 logtype_dictionary_id_t logtype_id,
@@ -216,14 +255,36 @@ namespace streaming_archive { namespace writer {
         );
 
         /**
-         * Appends the content of the current encoded file to the given segment
+         * Appends the content of the given encoded file to the given segment
+         * @param file
          * @param segment
          * @param logtype_ids_in_segment
          * @param var_ids_in_segment
          * @param files_in_segment
          */
-        void append_file_contents_to_segment (Segment& segment, ArrayBackedPosIntSet<logtype_dictionary_id_t>& logtype_ids_in_segment,
+        void append_file_contents_to_segment (File* file, std::unique_ptr<Segment>& segment, ArrayBackedPosIntSet<logtype_dictionary_id_t>& logtype_ids_in_segment,
                                               ArrayBackedPosIntSet<variable_dictionary_id_t>& var_ids_in_segment, std::vector<File*>& files_in_segment);
+        /**
+         * Appends the given encoded file to the timestamp or timestamp-less segment (depending on whether it contains timestamps), adding the given
+         * logtype and variable IDs to the segment's indices
+         * @param file
+         * @param logtype_ids
+         * @param var_ids
+         * @return The segment the file was appended to
+         */
+        Segment& append_file_and_ids_to_segment (File* file, const std::unordered_set<logtype_dictionary_id_t>& logtype_ids,
+                                                 const std::unordered_set<variable_dictionary_id_t>& var_ids);
+        /**
+         * Appends all files pending segment assignment to segments, such that each segment is filled with files whose logtypes are most similar
+         * to those already in the segment. Files are only grouped with files that have the same group ID and that will be appended to the same
+         * (timestamp or timestamp-less) segment.
+         */
+        void pack_and_append_pending_files_to_segments ();
+        /**
+         * If the archive is using more memory than its budget, frees memory by first appending the files pending segment assignment to segments,
+         * and then spilling the larger dictionary's mappings to disk
+         */
+        void enforce_memory_budget ();
         /**
          * Writes the given files' metadata to the database using bulk writes
          * @param files
@@ -232,17 +293,26 @@ namespace streaming_archive { namespace writer {
          */
         void persist_file_metadata (const std::vector<File*>& files);
         /**
-         * Closes a given segment, persists the metadata of the files in the segment, and cleans up any data remaining outside the segment
+         * Indexes the given segment in the dictionaries, flushes the dictionaries, and hands the segment and its files to the segment finalizer,
+         * replacing the segment with an unused one
          * @param segment
          * @param files
          * @param segment_logtype_ids
          * @param segment_var_ids
-         * @throw Same as streaming_archive::writer::Segment::close
-         * @throw Same as streaming_archive::writer::Archive::persist_file_metadata
+         * @throw Same as streaming_archive::writer::SegmentFinalizer::add_segment
          */
-        void close_segment_and_persist_file_metadata (Segment& segment, std::vector<File*>& files,
+        void close_segment_and_persist_file_metadata (std::unique_ptr<Segment>& segment, std::vector<File*>& files,
                                                       ArrayBackedPosIntSet<logtype_dictionary_id_t>& segment_logtype_ids,
                                                       ArrayBackedPosIntSet<variable_dictionary_id_t>& segment_var_ids);
+        /**
+         * Closes a segment, persists the metadata of the files in the segment, and deletes the files. Called on the segment finalizer's thread.
+         * NOTE: The files' metadata is only persisted after the segment has been closed (and the dictionaries flushed), so that a crash never
+         * leaves metadata referring to missing data.
+         * @param pending_segment
+         * @throw Same as streaming_archive::writer::Segment::close
+         * @throw Same as streaming_archive::writer::Archive::persist_file_metadata
+         */
+        void finalize_segment (SegmentFinalizer::PendingSegment& pending_segment);
 
         /**
          * @return The size (in bytes) of compressed data whose size may change
@@ -250,9 +320,16 @@ namespace streaming_archive { namespace writer {
          */
         uint64_t get_dynamic_compressed_size ();
         /**
-         * Updates the archive's metadata
+         * Updates the archive's metadata after a segment has been finalized, and queues the archive's stats to be printed (if enabled)
+         * @param segment_compressed_size
+         * @param dynamic_compressed_size
          */
-        void update_metadata ();
+        void update_metadata (uint64_t segment_compressed_size, uint64_t dynamic_compressed_size);
+        /**
+         * Prints the archive stats queued by the segment finalizer. Called on the compression thread, so that stdout is only written to by one
+         * thread.
+         */
+        void print_pending_archive_stats ();
 
         // Variables
         boost::uuids::uuid m_id;
@@ -270,6 +347,8 @@ namespace streaming_archive { namespace writer {
 
         // Holds the file being compressed
         File* m_file;
+        // NOTE: This must outlive every open file or file pending segment assignment, since they return their column buffers to it
+        ColumnBufferPool m_column_buffer_pool;
 
         LogTypeDictionaryWriter m_logtype_dict;
         // Holds preallocated logtype dictionary entry for performance
@@ -290,26 +369,52 @@ namespace streaming_archive { namespace writer {
         std::vector<File*> m_files_without_timestamps_in_segment;
 
         size_t m_target_segment_uncompressed_size;
-        Segment m_segment_for_files_with_timestamps;
+        std::unique_ptr<Segment> m_segment_for_files_with_timestamps;
         ArrayBackedPosIntSet<logtype_dictionary_id_t> m_logtype_ids_in_segment_for_files_with_timestamps;
         ArrayBackedPosIntSet<variable_dictionary_id_t> m_var_ids_in_segment_for_files_with_timestamps;
         // Logtype and variable IDs for a file that hasn't yet been assigned to the timestamp or timestamp-less segment
         std::unordered_set<logtype_dictionary_id_t> m_logtype_ids_for_file_with_unassigned_segment;
         std::unordered_set<variable_dictionary_id_t> m_var_ids_for_file_with_unassigned_segment;
-        Segment m_segment_for_files_without_timestamps;
+        std::unique_ptr<Segment> m_segment_for_files_without_timestamps;
         ArrayBackedPosIntSet<logtype_dictionary_id_t> m_logtype_ids_in_segment_for_files_without_timestamps;
         ArrayBackedPosIntSet<variable_dictionary_id_t> m_var_ids_in_segment_for_files_without_timestamps;
 
+        // Closed files which are buffered so that they can be packed into segments by similarity
+        // NOTE: The number of buffered files is capped since packing is quadratic in the number of files
+        static constexpr size_t cMaxNumFilesPendingSegmentAssignment = 1024;
+        size_t m_segment_packing_window_size;
+        std::vector<FilePendingSegmentAssignment> m_files_pending_segment_assignment;
+        size_t m_encoded_size_of_files_pending_segment_assignment;
+
+        // NOTE: Dictionaries are only spilled once their in-memory mappings reach this size, so that we don't create many tiny runs on disk. It
+        // must be larger than a StringArena block, since a dictionary with a single value already uses a whole block.
+        static constexpr size_t cMinDictionarySpillSize = 4 * StringArena::cDefaultBlockSize;
+        size_t m_memory_budget;
+        bool m_memory_budget_warning_logged;
+
         int m_compression_level;
 
+        // Guards m_metadata_db and m_local_metadata, which are updated by both the compression thread and the segment finalizer
+        std::mutex m_metadata_mutex;
         MetadataDB m_metadata_db;
 
         std::optional<ArchiveMetadata> m_local_metadata;
         FileWriter m_metadata_file_writer;
 
+        // NOTE: The global metadata DB isn't thread-safe, so it's only used by one thread at a time: the compression thread opens it and adds the
+        // archive before the segment finalizer starts, the segment finalizer updates it, and the compression thread closes it after the segment
+        // finalizer has been closed
         GlobalMetadataDB* m_global_metadata_db;
 
         bool m_print_archive_stats_progress;
+        // Archive stats (ndjson) waiting to be printed by the compression thread, guarded by m_metadata_mutex
+        std::vector<std::string> m_pending_archive_stats;
+
+        // Segments are finalized in the background so that compression doesn't stall at segment boundaries. The queue is bounded so that at most
+        // one segment of each kind (with and without timestamps) is pending finalization while the next one is being filled.
+        // NOTE: This must be declared last so that it's destroyed (and its thread joined) before any of the state it uses
+        static constexpr size_t cMaxNumSegmentsPendingFinalization = 2;
+        SegmentFinalizer m_segment_finalizer;
     };
 } }
 
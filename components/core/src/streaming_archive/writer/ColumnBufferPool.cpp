@@ -0,0 +1,36 @@
+#include "ColumnBufferPool.hpp"
+
+// Project headers
+#include "../../Profiler.hpp"
+
+namespace streaming_archive { namespace writer {
+    std::unique_ptr<ColumnBufferPool::ColumnBuffers> ColumnBufferPool::acquire () {
+        if (m_free_column_buffers.empty()) {
+            return std::make_unique<ColumnBuffers>(m_use_huge_pages);
+        }
+        auto column_buffers = std::move(m_free_column_buffers.back());
+        m_free_column_buffers.pop_back();
+        m_num_resident_bytes -= column_buffers->get_num_resident_bytes();
+        return column_buffers;
+    }
+
+    void ColumnBufferPool::release (std::unique_ptr<ColumnBuffers> column_buffers) {
+        if (m_free_column_buffers.size() >= m_max_num_pooled_column_buffers) {
+            // The pool is full, so let the buffers be unmapped
+            return;
+        }
+
+        size_t num_page_faults_avoided = column_buffers->timestamps.recycle(m_max_num_resident_bytes_per_column);
+        num_page_faults_avoided += column_buffers->logtypes.recycle(m_max_num_resident_bytes_per_column);
+        num_page_faults_avoided += column_buffers->variables.recycle(m_max_num_resident_bytes_per_column);
+        Profiler::increment_counter<Profiler::CounterIndex::ColumnBufferPageFaultsAvoided>(num_page_faults_avoided);
+
+        m_num_resident_bytes += column_buffers->get_num_resident_bytes();
+        m_free_column_buffers.emplace_back(std::move(column_buffers));
+    }
+
+    void ColumnBufferPool::clear () {
+        m_free_column_buffers.clear();
+        m_num_resident_bytes = 0;
+    }
+} }
@@ -0,0 +1,88 @@
+#ifndef STREAMING_ARCHIVE_WRITER_COLUMNBUFFERPOOL_HPP
+#define STREAMING_ARCHIVE_WRITER_COLUMNBUFFERPOOL_HPP
+
+// C++ standard libraries
+#include <memory>
+#include <vector>
+
+// Project headers
+#include "../../Defs.h"
+#include "../../PageAllocatedVector.hpp"
+
+namespace streaming_archive { namespace writer {
+    /**
+     * Class representing a pool of the column buffers that files are encoded into before they're appended to a segment. Buffers are recycled
+     * across files rather than being unmapped once a file has been appended, so once the pool is warm, encoding a file requires no new
+     * mappings and, for the most part, no page faults.
+     */
+    class ColumnBufferPool {
+    public:
+        // Types
+        /**
+         * The buffers of each column of a file
+         */
+        struct ColumnBuffers {
+            explicit ColumnBuffers (bool use_huge_pages) : timestamps(use_huge_pages), logtypes(use_huge_pages), variables(use_huge_pages) {}
+
+            size_t get_num_resident_bytes () const {
+                return timestamps.get_num_resident_bytes() + logtypes.get_num_resident_bytes() + variables.get_num_resident_bytes();
+            }
+
+            PageAllocatedVector<epochtime_t> timestamps;
+            PageAllocatedVector<logtype_dictionary_id_t> logtypes;
+            PageAllocatedVector<encoded_variable_t> variables;
+        };
+
+        // Constants
+        static constexpr size_t cDefaultMaxNumResidentBytesPerColumn = 16 * 1024 * 1024;
+        static constexpr size_t cDefaultMaxNumPooledColumnBuffers = 4;
+
+        // Constructors
+        ColumnBufferPool () : ColumnBufferPool(false, cDefaultMaxNumResidentBytesPerColumn, cDefaultMaxNumPooledColumnBuffers) {}
+
+        /**
+         * @param use_huge_pages Whether to advise the kernel to back the buffers with transparent huge pages
+         * @param max_num_resident_bytes_per_column The maximum number of bytes of each column buffer that are kept resident while the buffer is
+         * in the pool. This bounds the memory held by the pool after encoding a large file.
+         * @param max_num_pooled_column_buffers The maximum number of files' column buffers kept in the pool. Any others that are released are
+         * unmapped, so that the pool doesn't hold onto the buffers of every file pending segment assignment.
+         */
+        ColumnBufferPool (bool use_huge_pages, size_t max_num_resident_bytes_per_column, size_t max_num_pooled_column_buffers) :
+                m_use_huge_pages(use_huge_pages), m_max_num_resident_bytes_per_column(max_num_resident_bytes_per_column),
+                m_max_num_pooled_column_buffers(max_num_pooled_column_buffers), m_num_resident_bytes(0) {}
+
+        // Methods
+        /**
+         * Gets empty column buffers, reusing buffers from the pool if possible
+         * @return The column buffers
+         * @throw PageAllocatedVector::OperationFailed if new buffers couldn't be created
+         */
+        std::unique_ptr<ColumnBuffers> acquire ();
+        /**
+         * Empties the given column buffers and returns them to the pool
+         * @param column_buffers
+         * @throw PageAllocatedVector::OperationFailed if the buffers' excess memory couldn't be released
+         */
+        void release (std::unique_ptr<ColumnBuffers> column_buffers);
+        /**
+         * Unmaps all column buffers in the pool
+         */
+        void clear ();
+
+        size_t get_num_pooled_column_buffers () const { return m_free_column_buffers.size(); }
+        /**
+         * @return The number of bytes of the pooled column buffers that are resident
+         */
+        size_t get_num_resident_bytes () const { return m_num_resident_bytes; }
+
+    private:
+        // Variables
+        bool m_use_huge_pages;
+        size_t m_max_num_resident_bytes_per_column;
+        size_t m_max_num_pooled_column_buffers;
+        std::vector<std::unique_ptr<ColumnBuffers>> m_free_column_buffers;
+        size_t m_num_resident_bytes;
+    };
+} }
+
+#endif // STREAMING_ARCHIVE_WRITER_COLUMNBUFFERPOOL_HPP
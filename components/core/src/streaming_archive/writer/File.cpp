@@ -2,6 +2,7 @@
 
 // Project headers
 #include "../../EncodedVariableInterpreter.hpp"
+#include "../column_encoding.hpp"
 
 using std::string;
 using std::to_string;
@@ -9,13 +10,12 @@ using std::unordered_set;
 using std::vector;
 
 namespace streaming_archive { namespace writer {
-    void File::open () {
+    void File::open (ColumnBufferPool& column_buffer_pool) {
         if (m_is_written_out) {
             throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
         }
-        m_timestamps = std::make_unique<PageAllocatedVector<epochtime_t>>();
-        m_logtypes = std::make_unique<PageAllocatedVector<logtype_dictionary_id_t>>();
-        m_variables = std::make_unique<PageAllocatedVector<encoded_variable_t>>();
+        m_column_buffer_pool = &column_buffer_pool;
+        m_columns = m_column_buffer_pool->acquire();
         m_is_open = true;
     }
 
@@ -24,29 +24,33 @@ namespace streaming_archive { namespace writer {
             throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
         }
 
-        // Append files to segment
+        // Encode and append columns to segment
+        vector<char> encoded_column;
         uint64_t segment_timestamps_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(m_timestamps->data()), m_timestamps->size_in_bytes(), segment_timestamps_uncompressed_pos);
+        column_encoding::encode_column(m_columns->timestamps.data(), m_columns->timestamps.size(), true, encoded_column);
+        segment.append(encoded_column.data(), encoded_column.size(), segment_timestamps_uncompressed_pos);
+        encoded_column.clear();
         uint64_t segment_logtypes_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(m_logtypes->data()), m_logtypes->size_in_bytes(), segment_logtypes_uncompressed_pos);
+        column_encoding::encode_column(m_columns->logtypes.data(), m_columns->logtypes.size(), false, encoded_column);
+        segment.append(encoded_column.data(), encoded_column.size(), segment_logtypes_uncompressed_pos);
+        encoded_column.clear();
         uint64_t segment_variables_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(m_variables->data()), m_variables->size_in_bytes(), segment_variables_uncompressed_pos);
+        column_encoding::encode_column(m_columns->variables.data(), m_columns->variables.size(), false, encoded_column);
+        segment.append(encoded_column.data(), encoded_column.size(), segment_variables_uncompressed_pos);
         set_segment_metadata(segment.get_id(), segment_timestamps_uncompressed_pos, segment_logtypes_uncompressed_pos, segment_variables_uncompressed_pos);
         m_segmentation_state = SegmentationState_MovingToSegment;
 
         // Mark file as written out and clear in-memory columns and clear the in-memory data (except metadata)
         m_is_written_out = true;
-        m_timestamps.reset(nullptr);
-        m_logtypes.reset(nullptr);
-        m_variables.reset(nullptr);
+        m_column_buffer_pool->release(std::move(m_columns));
     }
 
     void File::write_encoded_msg (epochtime_t timestamp, logtype_dictionary_id_t logtype_id, const vector<encoded_variable_t>& encoded_vars,
                                   const vector<variable_dictionary_id_t>& var_ids, size_t num_uncompressed_bytes)
     {
-        m_timestamps->push_back(timestamp);
-        m_logtypes->push_back(logtype_id);
-        m_variables->push_back_all(encoded_vars);
+        m_columns->timestamps.push_back(timestamp);
+        m_columns->logtypes.push_back(logtype_id);
+        m_columns->variables.push_back_all(encoded_vars);
 
         // Update metadata
         ++m_num_messages;
@@ -13,8 +13,8 @@
 #include "../../Defs.h"
 #include "../../ErrorCode.hpp"
 #include "../../LogTypeDictionaryWriter.hpp"
-#include "../../PageAllocatedVector.hpp"
 #include "../../TimestampPattern.hpp"
+#include "ColumnBufferPool.hpp"
 #include "Segment.hpp"
 
 namespace streaming_archive { namespace writer {
@@ -52,6 +52,7 @@ namespace streaming_archive { namespace writer {
                 m_segment_variables_pos(0),
                 m_is_split(split_ix > 0),
                 m_split_ix(split_ix),
+                m_column_buffer_pool(nullptr),
                 m_segmentation_state(SegmentationState_NotInSegment),
                 m_is_metadata_clean(false),
                 m_is_written_out(false),
@@ -63,10 +64,14 @@ namespace streaming_archive { namespace writer {
 
         // Methods
         bool is_open () const { return m_is_open; }
-        void open ();
+        /**
+         * Opens the file for writing
+         * @param column_buffer_pool The pool to get the file's column buffers from and return them to once the file is appended to a segment
+         */
+        void open (ColumnBufferPool& column_buffer_pool);
         void close () { m_is_open = false; }
         /**
-         * Appends the file's columns to the given segment
+         * Appends the file's columns to the given segment and returns the column buffers to their pool
          * @param logtype_dict
          * @param segment
          */
@@ -205,9 +210,8 @@ namespace streaming_archive { namespace writer {
         size_t m_split_ix;
 
         // Data variables
-        std::unique_ptr<PageAllocatedVector<epochtime_t>> m_timestamps;
-        std::unique_ptr<PageAllocatedVector<logtype_dictionary_id_t>> m_logtypes;
-        std::unique_ptr<PageAllocatedVector<encoded_variable_t>> m_variables;
+        ColumnBufferPool* m_column_buffer_pool;
+        std::unique_ptr<ColumnBufferPool::ColumnBuffers> m_columns;
 
         // State variables
         SegmentationState m_segmentation_state;
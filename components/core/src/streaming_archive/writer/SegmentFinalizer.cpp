@@ -0,0 +1,153 @@
+#include "SegmentFinalizer.hpp"
+
+// Project headers
+#include "../../spdlog_with_specializations.hpp"
+
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
+using std::unique_lock;
+using std::unique_ptr;
+
+namespace streaming_archive { namespace writer {
+    SegmentFinalizer::~SegmentFinalizer () {
+        if (false == m_is_open) {
+            return;
+        }
+
+        SPDLOG_ERROR("streaming_archive::writer::SegmentFinalizer: Not closed before being destroyed - data loss may occur");
+        {
+            lock_guard<mutex> lock(m_mutex);
+            // Discard any segments that haven't started finalization
+            if (nullptr == m_finalization_error) {
+                m_finalization_error = std::make_exception_ptr(OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__));
+            }
+            m_stop = true;
+        }
+        m_state_changed.notify_all();
+        // NOTE: We must join here rather than in Thread's destructor since the thread uses this object's members
+        try {
+            join();
+        } catch (const Thread::OperationFailed& e) {
+            SPDLOG_ERROR("streaming_archive::writer::SegmentFinalizer: Failed to join thread - {}", e.what());
+        }
+    }
+
+    void SegmentFinalizer::open (FinalizeMethod finalize_segment, size_t max_num_pending_segments) {
+        if (m_is_open) {
+            throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+        }
+
+        m_finalize_segment = std::move(finalize_segment);
+        m_max_num_pending_segments = max_num_pending_segments;
+        m_finalization_error = nullptr;
+        m_stop = false;
+
+        start();
+        m_is_open = true;
+    }
+
+    void SegmentFinalizer::close () {
+        if (false == m_is_open) {
+            throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_state_changed.notify_all();
+        join();
+        m_is_open = false;
+        m_finalize_segment = nullptr;
+
+        lock_guard<mutex> lock(m_mutex);
+        rethrow_finalization_error();
+    }
+
+    unique_ptr<Segment> SegmentFinalizer::get_unused_segment () {
+        lock_guard<mutex> lock(m_mutex);
+        if (m_unused_segments.empty()) {
+            return make_unique<Segment>();
+        }
+        auto segment = std::move(m_unused_segments.back());
+        m_unused_segments.pop_back();
+        return segment;
+    }
+
+    void SegmentFinalizer::add_segment (PendingSegment&& pending_segment) {
+        unique_lock<mutex> lock(m_mutex);
+        m_state_changed.wait(lock, [this] {
+            return m_pending_segments.size() < m_max_num_pending_segments || nullptr != m_finalization_error;
+        });
+        if (nullptr != m_finalization_error) {
+            // The segment won't be finalized, so discard it rather than leaving its files and open segment with the caller
+            auto finalization_error = m_finalization_error;
+            lock.unlock();
+            discard(pending_segment);
+            std::rethrow_exception(finalization_error);
+        }
+
+        m_pending_segments.emplace_back(std::move(pending_segment));
+        lock.unlock();
+        m_state_changed.notify_all();
+    }
+
+    void SegmentFinalizer::thread_method () {
+        unique_lock<mutex> lock(m_mutex);
+        while (true) {
+            m_state_changed.wait(lock, [this] { return m_stop || false == m_pending_segments.empty(); });
+            if (m_pending_segments.empty()) {
+                // Stopped and all segments have been finalized
+                break;
+            }
+
+            // NOTE: References to the deque's elements remain valid when the compression thread appends to it
+            auto& pending_segment = m_pending_segments.front();
+            if (nullptr == m_finalization_error) {
+                lock.unlock();
+                std::exception_ptr finalization_error;
+                try {
+                    m_finalize_segment(pending_segment);
+                } catch (...) {
+                    finalization_error = std::current_exception();
+                }
+                lock.lock();
+                if (nullptr != finalization_error && nullptr == m_finalization_error) {
+                    m_finalization_error = finalization_error;
+                }
+            }
+
+            if (nullptr == m_finalization_error) {
+                m_unused_segments.emplace_back(std::move(pending_segment.segment));
+            } else {
+                discard(pending_segment);
+            }
+            m_pending_segments.pop_front();
+            m_state_changed.notify_all();
+        }
+    }
+
+    void SegmentFinalizer::rethrow_finalization_error () const {
+        if (nullptr != m_finalization_error) {
+            std::rethrow_exception(m_finalization_error);
+        }
+    }
+
+    void SegmentFinalizer::discard (PendingSegment& pending_segment) {
+        auto& segment = pending_segment.segment;
+        if (nullptr != segment && segment->is_open()) {
+            // NOTE: The segment won't be committed, so failing to close it is only logged
+            try {
+                segment->close();
+            } catch (const TraceableException& e) {
+                SPDLOG_WARN("streaming_archive::writer::SegmentFinalizer: Failed to close discarded segment - {}:{} {}, error_code={}",
+                            e.get_filename(), e.get_line_number(), e.what(), e.get_error_code());
+            }
+        }
+        for (auto file : pending_segment.files) {
+            delete file;
+        }
+        pending_segment.files.clear();
+    }
+} }
@@ -0,0 +1,108 @@
+#ifndef STREAMING_ARCHIVE_WRITER_SEGMENTFINALIZER_HPP
+#define STREAMING_ARCHIVE_WRITER_SEGMENTFINALIZER_HPP
+
+// C++ standard libraries
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Project headers
+#include "../../Thread.hpp"
+#include "File.hpp"
+#include "Segment.hpp"
+
+namespace streaming_archive { namespace writer {
+    /**
+     * A thread that finalizes (closes and commits the metadata of) segments in the order they're added, so that the compression thread can continue
+     * encoding while a previous segment is being finalized. The number of segments pending finalization is bounded, so the compression thread blocks
+     * if it gets too far ahead. Finalized segments are kept so that they (and their buffers) can be reused for new segments.
+     *
+     * If a segment fails to be finalized, all subsequent segments are discarded without being finalized (since committing them could leave the archive
+     * inconsistent), and the exception is rethrown by every subsequent call to add_segment or close.
+     */
+    class SegmentFinalizer : public Thread {
+    public:
+        // Types
+        struct PendingSegment {
+            std::unique_ptr<Segment> segment;
+            // Files in the segment, which are owned by the finalizer until they're deleted
+            std::vector<File*> files;
+            // Size of the archive's compressed data that may change before the archive is closed, as of when the segment was added
+            uint64_t dynamic_compressed_size;
+        };
+
+        /**
+         * Method which finalizes a segment and then deletes its files
+         */
+        using FinalizeMethod = std::function<void (PendingSegment&)>;
+
+        // Constructors
+        SegmentFinalizer () : m_max_num_pending_segments(0), m_is_open(false), m_stop(false) {}
+
+        // Destructor
+        ~SegmentFinalizer () override;
+
+        // Methods
+        /**
+         * Starts the finalizer thread
+         * @param finalize_segment
+         * @param max_num_pending_segments Number of segments that can be pending finalization before add_segment blocks
+         * @throw Same as Thread::start
+         */
+        void open (FinalizeMethod finalize_segment, size_t max_num_pending_segments);
+        /**
+         * Waits for all pending segments to be finalized and then stops the finalizer thread
+         * @throw Any exception thrown while finalizing a segment
+         * @throw Same as Thread::join
+         */
+        void close ();
+
+        /**
+         * @return A closed segment for reuse or a new segment if none are available
+         */
+        std::unique_ptr<Segment> get_unused_segment ();
+        /**
+         * Queues the given segment for finalization, blocking while the maximum number of segments are pending finalization
+         * @param pending_segment
+         * @throw Any exception thrown while finalizing a previous segment, in which case the given segment is discarded (its segment is closed
+         * and its files are deleted)
+         */
+        void add_segment (PendingSegment&& pending_segment);
+
+        /**
+         * Closes a segment that won't be finalized and deletes its files
+         * @param pending_segment
+         */
+        static void discard (PendingSegment& pending_segment);
+
+    protected:
+        // Methods
+        void thread_method () override;
+
+    private:
+        // Methods
+        /**
+         * Rethrows the exception thrown while finalizing a segment, if any. Must be called while holding m_mutex.
+         */
+        void rethrow_finalization_error () const;
+
+        // Variables
+        FinalizeMethod m_finalize_segment;
+        size_t m_max_num_pending_segments;
+        bool m_is_open;
+
+        std::mutex m_mutex;
+        std::condition_variable m_state_changed;
+        // NOTE: The segment being finalized remains at the front of the queue until it's finalized
+        std::deque<PendingSegment> m_pending_segments;
+        std::vector<std::unique_ptr<Segment>> m_unused_segments;
+        std::exception_ptr m_finalization_error;
+        bool m_stop;
+    };
+} }
+
+#endif // STREAMING_ARCHIVE_WRITER_SEGMENTFINALIZER_HPP
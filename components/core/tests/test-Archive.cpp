@@ -0,0 +1,126 @@
+// C++ standard libraries
+#include <map>
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/GlobalSQLiteMetadataDB.hpp"
+#include "../src/streaming_archive/reader/Archive.hpp"
+#include "../src/streaming_archive/writer/Archive.hpp"
+
+using std::map;
+using std::string;
+using std::to_string;
+using std::vector;
+
+/**
+ * Compresses files into a new archive, where each file contains copies of the given messages
+ * @param archives_dir
+ * @param segment_packing_window_size
+ * @param target_segment_uncompressed_size
+ * @param files_messages The messages of each file (in the order the files are compressed)
+ * @param num_copies_per_file The number of copies of its messages that each file contains
+ * @return The archive's path
+ */
+static string compress_files (const string& archives_dir, size_t segment_packing_window_size, size_t target_segment_uncompressed_size,
+                              const vector<vector<string>>& files_messages, size_t num_copies_per_file)
+{
+    boost::uuids::random_generator uuid_generator;
+    GlobalSQLiteMetadataDB global_metadata_db(archives_dir + "/metadata.db");
+
+    streaming_archive::writer::Archive::UserConfig archive_user_config;
+    archive_user_config.id = uuid_generator();
+    archive_user_config.creator_id = uuid_generator();
+    archive_user_config.creation_num = 0;
+    archive_user_config.target_segment_uncompressed_size = target_segment_uncompressed_size;
+    archive_user_config.compression_level = 0;
+    archive_user_config.output_dir = archives_dir;
+    archive_user_config.global_metadata_db = &global_metadata_db;
+    archive_user_config.print_archive_stats_progress = false;
+    archive_user_config.segment_packing_window_size = segment_packing_window_size;
+    archive_user_config.use_huge_pages_for_columns = false;
+    archive_user_config.memory_budget = 0;
+
+    streaming_archive::writer::Archive archive_writer;
+    archive_writer.open(archive_user_config);
+    for (size_t i = 0; i < files_messages.size(); ++i) {
+        archive_writer.create_and_open_file("file" + to_string(i), 0, uuid_generator(), 0);
+        for (size_t j = 0; j < num_copies_per_file; ++j) {
+            for (const auto& message : files_messages[i]) {
+                archive_writer.write_msg(0, message, message.length());
+            }
+        }
+        archive_writer.close_file();
+        archive_writer.append_file_to_segment();
+    }
+    archive_writer.close();
+
+    return archives_dir + '/' + boost::uuids::to_string(archive_user_config.id);
+}
+
+/**
+ * @param archive_path
+ * @return A map from the path of each file in the given archive to the ID of the segment containing it
+ */
+static map<string, segment_id_t> get_segment_ids_of_files (const string& archive_path) {
+    streaming_archive::reader::Archive archive_reader;
+    archive_reader.open(archive_path);
+
+    map<string, segment_id_t> segment_ids_of_files;
+    {
+        // NOTE: The iterator must be destroyed before the archive is closed
+        auto file_metadata_ix_ptr = archive_reader.get_file_iterator();
+        for (auto& file_metadata_ix = *file_metadata_ix_ptr; file_metadata_ix.has_next(); file_metadata_ix.next()) {
+            string path;
+            file_metadata_ix.get_path(path);
+            segment_ids_of_files[path] = file_metadata_ix.get_segment_id();
+        }
+    }
+    archive_reader.close();
+
+    return segment_ids_of_files;
+}
+
+TEST_CASE("Test packing files into segments by logtype similarity", "[Archive][segment_packing]") {
+    const string cArchivesDir = "unit-test-archive-packing";
+    // Each file's timestamps and variables are constant, so its encoded columns take about one byte per logtype ID (plus the column headers),
+    // and two files fill a segment
+    constexpr size_t cNumCopiesPerFile = 50;
+    constexpr size_t cTargetSegmentUncompressedSize = 2 * cNumCopiesPerFile * 2;
+
+    // Files alternate between two disjoint sets of logtypes
+    vector<string> task_messages = {"Task 1 started\n", "Task 1 finished\n"};
+    vector<string> connection_messages = {"Connection to 10.0.0.1 opened\n", "Connection to 10.0.0.1 closed\n"};
+    vector<vector<string>> files_messages = {task_messages, connection_messages, task_messages, connection_messages};
+
+    boost::filesystem::remove_all(cArchivesDir);
+    boost::filesystem::create_directory(cArchivesDir);
+
+    SECTION("Files are appended to segments in the order they're closed without packing") {
+        auto archive_path = compress_files(cArchivesDir, 0, cTargetSegmentUncompressedSize, files_messages, cNumCopiesPerFile);
+        auto segment_ids_of_files = get_segment_ids_of_files(archive_path);
+        REQUIRE(segment_ids_of_files.size() == files_messages.size());
+        REQUIRE(segment_ids_of_files["file0"] == segment_ids_of_files["file1"]);
+        REQUIRE(segment_ids_of_files["file2"] == segment_ids_of_files["file3"]);
+        REQUIRE(segment_ids_of_files["file0"] != segment_ids_of_files["file2"]);
+    }
+
+    SECTION("Files with similar logtypes are packed into the same segment") {
+        auto archive_path = compress_files(cArchivesDir, 1024 * 1024, cTargetSegmentUncompressedSize, files_messages, cNumCopiesPerFile);
+        auto segment_ids_of_files = get_segment_ids_of_files(archive_path);
+        REQUIRE(segment_ids_of_files.size() == files_messages.size());
+        REQUIRE(segment_ids_of_files["file0"] == segment_ids_of_files["file2"]);
+        REQUIRE(segment_ids_of_files["file1"] == segment_ids_of_files["file3"]);
+        REQUIRE(segment_ids_of_files["file0"] != segment_ids_of_files["file1"]);
+    }
+
+    boost::filesystem::remove_all(cArchivesDir);
+}
@@ -0,0 +1,150 @@
+// C++ standard libraries
+#include <cstring>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/ArrayBackedPosIntSet.hpp"
+#include "../src/Defs.h"
+
+using std::set;
+using std::unordered_set;
+using std::vector;
+
+/**
+ * Compressor that keeps the data written to it in memory so the values written can be compared with the expected values
+ */
+class ValueCollectingCompressor : public streaming_compression::Compressor {
+public:
+    // Constructors
+    ValueCollectingCompressor () : streaming_compression::Compressor(streaming_compression::CompressorType::Passthrough) {}
+
+    // Methods implementing the WriterInterface
+    void write (const char* data, size_t data_length) override { m_data.append(data, data_length); }
+    void flush () override {}
+    ErrorCode try_get_pos (size_t& pos) const override {
+        pos = m_data.size();
+        return ErrorCode_Success;
+    }
+
+    // Methods implementing Compressor
+    void close () override {}
+
+    // Methods
+    size_t get_num_bytes_written () const { return m_data.size(); }
+    vector<variable_dictionary_id_t> get_values () const {
+        vector<variable_dictionary_id_t> values(m_data.size() / sizeof(variable_dictionary_id_t));
+        memcpy(values.data(), m_data.data(), values.size() * sizeof(variable_dictionary_id_t));
+        return values;
+    }
+    void clear () { m_data.clear(); }
+
+private:
+    std::string m_data;
+};
+
+TEST_CASE("ArrayBackedPosIntSet", "[ArrayBackedPosIntSet]") {
+    ArrayBackedPosIntSet<variable_dictionary_id_t> ids;
+    set<variable_dictionary_id_t> expected_ids;
+    ValueCollectingCompressor compressor;
+
+    SECTION("Sparse values") {
+        // Values in far apart chunks, out of order, with duplicates
+        vector<variable_dictionary_id_t> values = {500000000, 3, 70000, 3, 1, 500000000, 65535, 65536};
+        ids.insert_all(values);
+        expected_ids.insert(values.cbegin(), values.cend());
+
+        // Only the chunks containing values should be allocated
+        REQUIRE(ids.get_num_chunks() == 3);
+    }
+
+    SECTION("Dense values") {
+        // Enough values in the first chunk for it to become a bitmap, inserted both in and out of order
+        for (variable_dictionary_id_t id = 0; id < 20000; id += 2) {
+            ids.insert(id);
+            expected_ids.insert(id);
+        }
+        for (size_t i = 0; i < 3000; ++i) {
+            variable_dictionary_id_t id = 19999 - i * 6;
+            ids.insert(id);
+            expected_ids.insert(id);
+        }
+        ids.insert(0);
+    }
+
+    SECTION("Insert all from another set") {
+        ArrayBackedPosIntSet<variable_dictionary_id_t> other_ids;
+        unordered_set<variable_dictionary_id_t> other_values;
+        for (variable_dictionary_id_t id = 0; id < 10000; id += 3) {
+            ids.insert(id);
+            expected_ids.insert(id);
+        }
+        for (variable_dictionary_id_t id = 0; id < 200000; id += 5) {
+            other_ids.insert(id);
+            expected_ids.insert(id);
+        }
+        for (variable_dictionary_id_t id = 300000; id < 300100; ++id) {
+            other_values.insert(id);
+            expected_ids.insert(id);
+        }
+        other_ids.insert_all(other_values);
+        ids.insert_all(other_ids);
+
+        // Merging a set into itself should add nothing
+        auto size = ids.size();
+        ids.insert_all(ids);
+        REQUIRE(ids.size() == size);
+    }
+
+    REQUIRE(ids.size() == expected_ids.size());
+    ids.write_to_compressor(compressor);
+    REQUIRE(compressor.get_values() == vector<variable_dictionary_id_t>(expected_ids.cbegin(), expected_ids.cend()));
+
+    ids.clear();
+    REQUIRE(ids.size() == 0);
+    compressor.clear();
+    ids.write_to_compressor(compressor);
+    REQUIRE(compressor.get_values().empty());
+}
+
+TEST_CASE("ArrayBackedPosIntSet benchmarks", "[ArrayBackedPosIntSet][!benchmark]") {
+    constexpr size_t cNumIds = 100000;
+    constexpr variable_dictionary_id_t cFirstIdOfSparseSegment = 300000000;
+
+    ValueCollectingCompressor compressor;
+
+    // A small segment whose IDs are spread across a large dictionary
+    ArrayBackedPosIntSet<variable_dictionary_id_t> sparse_ids;
+    BENCHMARK("Insert sparse IDs") {
+        sparse_ids.clear();
+        for (size_t i = 0; i < cNumIds; ++i) {
+            sparse_ids.insert(cFirstIdOfSparseSegment + i * 997);
+        }
+        return sparse_ids.size();
+    };
+    BENCHMARK("Serialize sparse IDs") {
+        compressor.clear();
+        sparse_ids.write_to_compressor(compressor);
+        return compressor.get_num_bytes_written();
+    };
+
+    // A segment containing most IDs in a range of the dictionary
+    ArrayBackedPosIntSet<variable_dictionary_id_t> dense_ids;
+    BENCHMARK("Insert dense IDs") {
+        dense_ids.clear();
+        for (size_t i = 0; i < cNumIds; ++i) {
+            dense_ids.insert(i + i / 4);
+        }
+        return dense_ids.size();
+    };
+    BENCHMARK("Serialize dense IDs") {
+        compressor.clear();
+        dense_ids.write_to_compressor(compressor);
+        return compressor.get_num_bytes_written();
+    };
+}
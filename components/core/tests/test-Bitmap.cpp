@@ -0,0 +1,126 @@
+// C++ standard libraries
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/Bitmap.hpp"
+
+using std::vector;
+
+TEST_CASE("Bitmap", "[Bitmap]") {
+    constexpr size_t cNumBits = 200;
+
+    Bitmap bitmap(cNumBits);
+    REQUIRE(bitmap.size() == cNumBits);
+    REQUIRE(bitmap.none());
+    REQUIRE(bitmap.find_next(0) == cNumBits);
+
+    vector<size_t> set_bits = {0, 1, 63, 64, 127, 130, cNumBits - 1};
+    for (auto ix : set_bits) {
+        bitmap.set(ix);
+    }
+    REQUIRE(bitmap.count() == set_bits.size());
+    REQUIRE(false == bitmap.none());
+    for (size_t ix = 0; ix < cNumBits; ++ix) {
+        REQUIRE(bitmap.test(ix) == (std::find(set_bits.cbegin(), set_bits.cend(), ix) != set_bits.cend()));
+    }
+
+    SECTION("Iterate over set bits") {
+        vector<size_t> found_bits;
+        for (auto ix = bitmap.find_next(0); ix < bitmap.size(); ix = bitmap.find_next(ix + 1)) {
+            found_bits.push_back(ix);
+        }
+        REQUIRE(found_bits == set_bits);
+    }
+
+    SECTION("Reset") {
+        bitmap.reset(64);
+        REQUIRE(false == bitmap.test(64));
+        REQUIRE(bitmap.find_next(64) == 127);
+        REQUIRE(bitmap.count() == set_bits.size() - 1);
+    }
+
+    SECTION("Combine") {
+        Bitmap other(cNumBits);
+        other.set(1);
+        other.set(64);
+        other.set(65);
+
+        Bitmap intersection = bitmap;
+        intersection &= other;
+        REQUIRE(intersection.count() == 2);
+        REQUIRE(intersection.test(1));
+        REQUIRE(intersection.test(64));
+
+        Bitmap union_ = bitmap;
+        union_ |= other;
+        REQUIRE(union_.count() == set_bits.size() + 1);
+        REQUIRE(union_.test(65));
+
+        Bitmap difference = bitmap;
+        difference.subtract(other);
+        REQUIRE(difference.count() == set_bits.size() - 2);
+        REQUIRE(false == difference.test(1));
+        REQUIRE(false == difference.test(64));
+    }
+
+    SECTION("Combine bitmaps of different sizes") {
+        Bitmap smaller(70);
+        smaller.set(1);
+        smaller.set(64);
+        smaller.set(69);
+
+        Bitmap intersection = bitmap;
+        intersection &= smaller;
+        REQUIRE(intersection.size() == cNumBits);
+        REQUIRE(intersection.count() == 2);
+        REQUIRE(intersection.test(1));
+        REQUIRE(intersection.test(64));
+
+        Bitmap union_ = smaller;
+        union_ |= bitmap;
+        REQUIRE(union_.size() == cNumBits);
+        REQUIRE(union_.count() == set_bits.size() + 1);
+        REQUIRE(union_.test(69));
+        REQUIRE(union_.test(cNumBits - 1));
+
+        Bitmap difference = smaller;
+        difference.subtract(bitmap);
+        REQUIRE(difference.size() == 70);
+        REQUIRE(difference.count() == 1);
+        REQUIRE(difference.test(69));
+    }
+
+    SECTION("Membership") {
+        Bitmap ids;
+        REQUIRE(false == ids.contains(0));
+        ids.insert(130);
+        ids.insert(3);
+        REQUIRE(ids.size() == 131);
+        REQUIRE(ids.contains(3));
+        REQUIRE(ids.contains(130));
+        REQUIRE(false == ids.contains(4));
+        REQUIRE(false == ids.contains(SIZE_MAX));
+    }
+
+    SECTION("Resize") {
+        bitmap.resize(100);
+        REQUIRE(bitmap.size() == 100);
+        REQUIRE(bitmap.count() == 4);
+        REQUIRE(bitmap.find_next(65) == 100);
+        bitmap.resize(cNumBits);
+        REQUIRE(bitmap.count() == 4);
+        REQUIRE(false == bitmap.test(127));
+    }
+
+    SECTION("Resize and clear") {
+        bitmap.resize_and_clear(10);
+        REQUIRE(bitmap.size() == 10);
+        REQUIRE(bitmap.none());
+        REQUIRE(bitmap.find_next(0) == 10);
+    }
+}
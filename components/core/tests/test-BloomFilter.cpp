@@ -0,0 +1,78 @@
+// C++ standard libraries
+#include <string>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/BloomFilter.hpp"
+#include "../src/FileReader.hpp"
+#include "../src/FileWriter.hpp"
+
+using std::string;
+using std::to_string;
+
+TEST_CASE("BloomFilter", "[BloomFilter]") {
+    constexpr size_t cNumValues = 10000;
+    constexpr double cFalsePositiveRate = 0.01;
+
+    BloomFilter empty_filter;
+    REQUIRE(false == empty_filter.possibly_contains(BloomFilter::hash("value0")));
+
+    BloomFilter filter(cNumValues, cFalsePositiveRate);
+    for (size_t i = 0; i < cNumValues; ++i) {
+        filter.add(BloomFilter::hash("value" + to_string(i)));
+    }
+
+    // There should be no false negatives, and roughly the configured rate of false positives
+    for (size_t i = 0; i < cNumValues; ++i) {
+        REQUIRE(filter.possibly_contains(BloomFilter::hash("value" + to_string(i))));
+    }
+    size_t num_false_positives = 0;
+    for (size_t i = cNumValues; i < 2 * cNumValues; ++i) {
+        if (filter.possibly_contains(BloomFilter::hash("value" + to_string(i)))) {
+            ++num_false_positives;
+        }
+    }
+    REQUIRE(num_false_positives < 2 * cFalsePositiveRate * cNumValues);
+
+    SECTION("Write and read") {
+        const string cFilterPath = "unit-test-bloom-filter";
+        FileWriter file_writer;
+        file_writer.open(cFilterPath, FileWriter::OpenMode::CREATE_FOR_WRITING);
+        filter.write_to_file(file_writer);
+        file_writer.close();
+
+        BloomFilter read_filter;
+        FileReader file_reader;
+        file_reader.open(cFilterPath);
+        REQUIRE(ErrorCode_Success == read_filter.try_read_from_file(file_reader));
+        file_reader.close();
+        REQUIRE(read_filter.get_size_in_bytes() == filter.get_size_in_bytes());
+        for (size_t i = 0; i < 2 * cNumValues; ++i) {
+            auto hash = BloomFilter::hash("value" + to_string(i));
+            REQUIRE(read_filter.possibly_contains(hash) == filter.possibly_contains(hash));
+        }
+
+        // A truncated filter should be rejected
+        boost::filesystem::resize_file(cFilterPath, boost::filesystem::file_size(cFilterPath) - 1);
+        file_reader.open(cFilterPath);
+        REQUIRE(ErrorCode_Success != read_filter.try_read_from_file(file_reader));
+        file_reader.close();
+
+        // A filter claiming more bits than the file contains should be rejected without trying to allocate them
+        file_writer.open(cFilterPath, FileWriter::OpenMode::CREATE_FOR_WRITING);
+        file_writer.write_numeric_value<uint64_t>(7);
+        file_writer.write_numeric_value<uint64_t>(UINT64_MAX);
+        file_writer.write_numeric_value<uint64_t>(0);
+        file_writer.close();
+        file_reader.open(cFilterPath);
+        REQUIRE(ErrorCode_Corrupt == read_filter.try_read_from_file(file_reader));
+        file_reader.close();
+
+        boost::filesystem::remove(cFilterPath);
+    }
+}
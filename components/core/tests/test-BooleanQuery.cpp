@@ -0,0 +1,227 @@
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/Bitmap.hpp"
+#include "../src/clg/BooleanQuery.hpp"
+
+using clg::BooleanQuery;
+using std::string;
+using std::vector;
+
+// Constants
+// Every combination of whether a message matches each of three wildcard strings, where bit i of a message's number is whether it matches the
+// i-th wildcard string
+static constexpr size_t cNumWildcardStrings = 3;
+static constexpr size_t cNumMessages = 1 << cNumWildcardStrings;
+
+/**
+ * @param num_bits
+ * @param set_bits
+ * @return A bitmap with only the given bits set
+ */
+static Bitmap create_bitmap (size_t num_bits, const vector<size_t>& set_bits) {
+    Bitmap bitmap(num_bits);
+    for (auto ix : set_bits) {
+        bitmap.set(ix);
+    }
+    return bitmap;
+}
+
+/**
+ * @param bitmap
+ * @return The indices of the bits set in the given bitmap
+ */
+static vector<size_t> get_set_bits (const Bitmap& bitmap) {
+    vector<size_t> set_bits;
+    for (auto ix = bitmap.find_next(0); ix < bitmap.size(); ix = bitmap.find_next(ix + 1)) {
+        set_bits.push_back(ix);
+    }
+    return set_bits;
+}
+
+/**
+ * Evaluates the given expression over every combination of whether a message matches each wildcard string, where every match is definite
+ * @param kql_expression An expression with one wildcard string per operand
+ * @return The messages that match the expression
+ */
+static vector<size_t> evaluate_over_truth_table (const string& kql_expression) {
+    BooleanQuery query(kql_expression);
+    auto num_wildcard_strings = query.get_wildcard_strings().size();
+    REQUIRE(num_wildcard_strings <= cNumWildcardStrings);
+
+    Bitmap messages_in_time_range(cNumMessages);
+    vector<Bitmap> query_matches(num_wildcard_strings, Bitmap(cNumMessages));
+    for (size_t msg_ix = 0; msg_ix < cNumMessages; ++msg_ix) {
+        messages_in_time_range.set(msg_ix);
+        for (size_t i = 0; i < num_wildcard_strings; ++i) {
+            if ((msg_ix >> i) & 1) {
+                query_matches[i].set(msg_ix);
+            }
+        }
+    }
+    query.combine_matches(messages_in_time_range, query_matches, query_matches);
+
+    // Since every match is definite, so is every match of the expression
+    REQUIRE(get_set_bits(query.get_matches()) == get_set_bits(query.get_possible_matches()));
+    return get_set_bits(query.get_matches());
+}
+
+TEST_CASE("BooleanQuery parsing", "[BooleanQuery]") {
+    SECTION("Operands are wildcard strings in the order they appear") {
+        BooleanQuery query("abc* AND (NOT *def OR ghi)");
+        REQUIRE(query.get_wildcard_strings() == vector<string>{"abc*", "*def", "ghi"});
+    }
+
+    SECTION("Operators") {
+        // Message numbers whose bit 0 is whether "a" matches, bit 1 is whether "b" matches, and bit 2 is whether "c" matches
+        REQUIRE(evaluate_over_truth_table("a") == vector<size_t>{1, 3, 5, 7});
+        REQUIRE(evaluate_over_truth_table("a AND b") == vector<size_t>{3, 7});
+        REQUIRE(evaluate_over_truth_table("a OR b") == vector<size_t>{1, 2, 3, 5, 6, 7});
+        REQUIRE(evaluate_over_truth_table("NOT a") == vector<size_t>{0, 2, 4, 6});
+
+        // Operators are case-insensitive
+        REQUIRE(evaluate_over_truth_table("a and b") == evaluate_over_truth_table("a AND b"));
+        REQUIRE(evaluate_over_truth_table("a Or b") == evaluate_over_truth_table("a OR b"));
+        REQUIRE(evaluate_over_truth_table("not a") == evaluate_over_truth_table("NOT a"));
+    }
+
+    SECTION("Parentheses") {
+        REQUIRE(evaluate_over_truth_table("(a)") == evaluate_over_truth_table("a"));
+        REQUIRE(evaluate_over_truth_table("a AND (b OR c)") == vector<size_t>{3, 5, 7});
+        REQUIRE(evaluate_over_truth_table("(a OR b) AND NOT c") == vector<size_t>{1, 2, 3});
+        REQUIRE(evaluate_over_truth_table("NOT (a AND b)") == vector<size_t>{0, 1, 2, 4, 5, 6});
+        REQUIRE(evaluate_over_truth_table("NOT NOT a") == evaluate_over_truth_table("a"));
+
+        // NOT applies only to the operand that follows it
+        REQUIRE(evaluate_over_truth_table("NOT a AND b") == vector<size_t>{2, 6});
+    }
+
+    SECTION("Invalid expressions") {
+        REQUIRE_THROWS_AS(BooleanQuery("a AND"), BooleanQuery::OperationFailed);
+        REQUIRE_THROWS_AS(BooleanQuery("(a OR b"), BooleanQuery::OperationFailed);
+        REQUIRE_THROWS_AS(BooleanQuery(""), BooleanQuery::OperationFailed);
+    }
+
+    SECTION("Column expressions are rejected") {
+        try {
+            BooleanQuery query("level: ERROR");
+            FAIL("Column expression was accepted");
+        } catch (BooleanQuery::OperationFailed& e) {
+            REQUIRE(ErrorCode_Unsupported == e.get_error_code());
+        }
+        REQUIRE_THROWS_AS(BooleanQuery("a AND level: ERROR"), BooleanQuery::OperationFailed);
+        REQUIRE_THROWS_AS(BooleanQuery("duration > 10"), BooleanQuery::OperationFailed);
+    }
+
+    SECTION("Nested expressions are rejected") {
+        try {
+            BooleanQuery query("request: {a AND b}");
+            FAIL("Nested expression was accepted");
+        } catch (BooleanQuery::OperationFailed& e) {
+            REQUIRE(ErrorCode_Unsupported == e.get_error_code());
+        }
+    }
+}
+
+TEST_CASE("BooleanQuery literal conversion", "[BooleanQuery]") {
+    auto get_wildcard_string = [] (const string& kql_expression) {
+        BooleanQuery query(kql_expression);
+        REQUIRE(query.get_wildcard_strings().size() == 1);
+        return query.get_wildcard_strings().front();
+    };
+
+    SECTION("Unquoted literals may contain wildcards") {
+        REQUIRE(get_wildcard_string("abc") == "abc");
+        REQUIRE(get_wildcard_string("a*c") == "a*c");
+        REQUIRE(get_wildcard_string("a?c") == "a?c");
+    }
+
+    SECTION("Escaped wildcards in unquoted literals are matched literally") {
+        REQUIRE(get_wildcard_string(R"(a\*c)") == R"(a\*c)");
+        REQUIRE(get_wildcard_string(R"(a\\c)") == R"(a\\c)");
+    }
+
+    SECTION("Other escaped characters in unquoted literals are unescaped") {
+        REQUIRE(get_wildcard_string(R"(a\(b\))") == "a(b)");
+        REQUIRE(get_wildcard_string(R"(a\:b)") == "a:b");
+        REQUIRE(get_wildcard_string(R"(a\tb)") == "a\tb");
+        REQUIRE(get_wildcard_string(R"(a\nb)") == "a\nb");
+    }
+
+    SECTION("Quoted literals are matched exactly") {
+        REQUIRE(get_wildcard_string(R"("a b")") == "a b");
+        REQUIRE(get_wildcard_string(R"("a*c?")") == R"(a\*c\?)");
+        REQUIRE(get_wildcard_string(R"("AND")") == "AND");
+        REQUIRE(get_wildcard_string("\"(a:b)\"") == "(a:b)");
+    }
+
+    SECTION("Escaped characters in quoted literals") {
+        REQUIRE(get_wildcard_string(R"("say \"hi\"")") == R"(say "hi")");
+        REQUIRE(get_wildcard_string(R"("a\\b")") == R"(a\\b)");
+        REQUIRE(get_wildcard_string(R"("a\*b")") == R"(a\*b)");
+        REQUIRE(get_wildcard_string(R"("a\tb")") == "a\tb");
+    }
+}
+
+TEST_CASE("BooleanQuery match combination", "[BooleanQuery]") {
+    // Messages 6 and 7 are outside the search's time range
+    constexpr size_t cNumMessagesInFile = 8;
+    auto messages_in_time_range = create_bitmap(cNumMessagesInFile, {0, 1, 2, 3, 4, 5});
+
+    SECTION("NOT of a possible match stays possible") {
+        BooleanQuery query("NOT a");
+        vector<Bitmap> query_matches = {create_bitmap(cNumMessagesInFile, {0})};
+        vector<Bitmap> query_possible_matches = {create_bitmap(cNumMessagesInFile, {0, 1})};
+        query.combine_matches(messages_in_time_range, query_matches, query_possible_matches);
+
+        REQUIRE(get_set_bits(query.get_matches()) == vector<size_t>{2, 3, 4, 5});
+        REQUIRE(get_set_bits(query.get_possible_matches()) == vector<size_t>{1, 2, 3, 4, 5});
+    }
+
+    SECTION("NOT stays within the time range") {
+        BooleanQuery query("NOT a");
+        vector<Bitmap> query_matches = {create_bitmap(cNumMessagesInFile, {})};
+        query.combine_matches(messages_in_time_range, query_matches, query_matches);
+
+        REQUIRE(get_set_bits(query.get_matches()) == get_set_bits(messages_in_time_range));
+        REQUIRE(get_set_bits(query.get_possible_matches()) == get_set_bits(messages_in_time_range));
+    }
+
+    SECTION("AND") {
+        BooleanQuery query("a AND b");
+        vector<Bitmap> query_matches = {create_bitmap(cNumMessagesInFile, {0, 2}), create_bitmap(cNumMessagesInFile, {0, 1})};
+        vector<Bitmap> query_possible_matches = {create_bitmap(cNumMessagesInFile, {0, 1, 2}), create_bitmap(cNumMessagesInFile, {0, 1, 3})};
+        query.combine_matches(messages_in_time_range, query_matches, query_possible_matches);
+
+        // A message only definitely matches if it definitely matches both operands
+        REQUIRE(get_set_bits(query.get_matches()) == vector<size_t>{0});
+        REQUIRE(get_set_bits(query.get_possible_matches()) == vector<size_t>{0, 1});
+    }
+
+    SECTION("OR") {
+        BooleanQuery query("a OR b");
+        vector<Bitmap> query_matches = {create_bitmap(cNumMessagesInFile, {0}), create_bitmap(cNumMessagesInFile, {})};
+        vector<Bitmap> query_possible_matches = {create_bitmap(cNumMessagesInFile, {0, 1}), create_bitmap(cNumMessagesInFile, {0, 2})};
+        query.combine_matches(messages_in_time_range, query_matches, query_possible_matches);
+
+        // A message definitely matches if it definitely matches either operand
+        REQUIRE(get_set_bits(query.get_matches()) == vector<size_t>{0});
+        REQUIRE(get_set_bits(query.get_possible_matches()) == vector<size_t>{0, 1, 2});
+    }
+
+    SECTION("NOT of a combination") {
+        BooleanQuery query("NOT (a AND b)");
+        vector<Bitmap> query_matches = {create_bitmap(cNumMessagesInFile, {0, 1}), create_bitmap(cNumMessagesInFile, {0})};
+        vector<Bitmap> query_possible_matches = {create_bitmap(cNumMessagesInFile, {0, 1, 6}), create_bitmap(cNumMessagesInFile, {0, 1, 2, 6})};
+        query.combine_matches(messages_in_time_range, query_matches, query_possible_matches);
+
+        // Message 1 definitely matches a but only possibly matches b, so it only possibly matches the query
+        REQUIRE(get_set_bits(query.get_matches()) == vector<size_t>{2, 3, 4, 5});
+        REQUIRE(get_set_bits(query.get_possible_matches()) == vector<size_t>{1, 2, 3, 4, 5});
+    }
+}
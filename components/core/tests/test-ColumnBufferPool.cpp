@@ -0,0 +1,169 @@
+// C standard libraries
+#include <unistd.h>
+
+// C++ standard libraries
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/PageAllocatedVector.hpp"
+#include "../src/streaming_archive/writer/ColumnBufferPool.hpp"
+
+using std::unique_ptr;
+using std::vector;
+using streaming_archive::writer::ColumnBufferPool;
+
+/**
+ * Fills the given vector with the given number of values, starting from the given value
+ * @param vector
+ * @param num_values
+ * @param first_value
+ */
+static void fill (PageAllocatedVector<int64_t>& vector, size_t num_values, int64_t first_value) {
+    for (size_t i = 0; i < num_values; ++i) {
+        vector.push_back(first_value + static_cast<int64_t>(i));
+    }
+}
+
+/**
+ * @param vector
+ * @param num_values
+ * @param first_value
+ * @return Whether the vector contains exactly the given number of values, starting from the given value
+ */
+static bool contains_values (const PageAllocatedVector<int64_t>& vector, size_t num_values, int64_t first_value) {
+    if (vector.size() != num_values) {
+        return false;
+    }
+    for (size_t i = 0; i < num_values; ++i) {
+        if (vector.data()[i] != first_value + static_cast<int64_t>(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("PageAllocatedVector::recycle", "[PageAllocatedVector]") {
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    const size_t num_values_per_page = page_size / sizeof(int64_t);
+
+    PageAllocatedVector<int64_t> vector;
+    fill(vector, 4 * num_values_per_page, 0);
+    REQUIRE(contains_values(vector, 4 * num_values_per_page, 0));
+    auto capacity = vector.capacity();
+    auto data = vector.data();
+
+    // None of the pages were resident before they were used
+    REQUIRE(0 == vector.recycle(2 * page_size));
+    REQUIRE(0 == vector.size());
+    REQUIRE(2 * page_size == vector.get_num_resident_bytes());
+
+    SECTION("Contents can be refilled without reallocating") {
+        fill(vector, 4 * num_values_per_page, 100);
+        REQUIRE(contains_values(vector, 4 * num_values_per_page, 100));
+        REQUIRE(vector.capacity() == capacity);
+        REQUIRE(vector.data() == data);
+
+        // Only the pages that were kept resident avoided page faults
+        REQUIRE(2 == vector.recycle(2 * page_size));
+        REQUIRE(2 * page_size == vector.get_num_resident_bytes());
+
+        // Refilling the pages that were released should give the new values rather than zeroes or the old values
+        fill(vector, 3 * num_values_per_page, 200);
+        REQUIRE(contains_values(vector, 3 * num_values_per_page, 200));
+        REQUIRE(2 == vector.recycle(4 * page_size));
+        REQUIRE(3 * page_size == vector.get_num_resident_bytes());
+    }
+
+    SECTION("Resident bytes are trimmed to the maximum") {
+        fill(vector, num_values_per_page / 2, 0);
+        // Part of a resident page was used
+        REQUIRE(1 == vector.recycle(2 * page_size));
+        REQUIRE(2 * page_size == vector.get_num_resident_bytes());
+
+        // The maximum is rounded up to a whole page
+        REQUIRE(0 == vector.recycle(page_size / 2));
+        REQUIRE(page_size == vector.get_num_resident_bytes());
+
+        REQUIRE(0 == vector.recycle(0));
+        REQUIRE(0 == vector.get_num_resident_bytes());
+
+        fill(vector, num_values_per_page, 0);
+        REQUIRE(0 == vector.recycle(0));
+        REQUIRE(contains_values(vector, 0, 0));
+    }
+
+    SECTION("Clear unmaps the vector") {
+        vector.clear();
+        REQUIRE(0 == vector.capacity());
+        REQUIRE(0 == vector.get_num_resident_bytes());
+    }
+}
+
+TEST_CASE("ColumnBufferPool", "[ColumnBufferPool]") {
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    constexpr size_t cMaxNumPooledColumnBuffers = 2;
+    ColumnBufferPool pool(false, page_size, cMaxNumPooledColumnBuffers);
+    REQUIRE(0 == pool.get_num_pooled_column_buffers());
+    REQUIRE(0 == pool.get_num_resident_bytes());
+
+    // Fills each of the given column buffers with two pages of values
+    auto fill_column_buffers = [page_size] (ColumnBufferPool::ColumnBuffers& column_buffers) {
+        for (size_t i = 0; i < 2 * page_size / sizeof(epochtime_t); ++i) {
+            column_buffers.timestamps.push_back(i);
+        }
+        for (size_t i = 0; i < 2 * page_size / sizeof(logtype_dictionary_id_t); ++i) {
+            column_buffers.logtypes.push_back(i);
+        }
+        for (size_t i = 0; i < 2 * page_size / sizeof(encoded_variable_t); ++i) {
+            column_buffers.variables.push_back(i);
+        }
+    };
+
+    SECTION("Buffers are reused") {
+        auto column_buffers = pool.acquire();
+        auto column_buffers_ptr = column_buffers.get();
+        fill_column_buffers(*column_buffers);
+        auto timestamps_data = column_buffers->timestamps.data();
+
+        pool.release(std::move(column_buffers));
+        REQUIRE(1 == pool.get_num_pooled_column_buffers());
+        // Each column keeps one page resident
+        REQUIRE(3 * page_size == pool.get_num_resident_bytes());
+
+        column_buffers = pool.acquire();
+        REQUIRE(column_buffers.get() == column_buffers_ptr);
+        REQUIRE(column_buffers->timestamps.data() == timestamps_data);
+        REQUIRE(0 == column_buffers->timestamps.size());
+        REQUIRE(0 == column_buffers->logtypes.size());
+        REQUIRE(0 == column_buffers->variables.size());
+        REQUIRE(0 == pool.get_num_pooled_column_buffers());
+        REQUIRE(0 == pool.get_num_resident_bytes());
+
+        // New buffers are created once the pool is empty
+        auto other_column_buffers = pool.acquire();
+        REQUIRE(other_column_buffers.get() != column_buffers_ptr);
+        REQUIRE(0 == other_column_buffers->timestamps.capacity());
+    }
+
+    SECTION("The number of pooled buffers is capped") {
+        vector<unique_ptr<ColumnBufferPool::ColumnBuffers>> column_buffers_list;
+        for (size_t i = 0; i < cMaxNumPooledColumnBuffers + 2; ++i) {
+            column_buffers_list.emplace_back(pool.acquire());
+            fill_column_buffers(*column_buffers_list.back());
+        }
+        for (auto& column_buffers : column_buffers_list) {
+            pool.release(std::move(column_buffers));
+        }
+        REQUIRE(cMaxNumPooledColumnBuffers == pool.get_num_pooled_column_buffers());
+        REQUIRE(cMaxNumPooledColumnBuffers * 3 * page_size == pool.get_num_resident_bytes());
+
+        pool.clear();
+        REQUIRE(0 == pool.get_num_pooled_column_buffers());
+        REQUIRE(0 == pool.get_num_resident_bytes());
+    }
+}
@@ -0,0 +1,64 @@
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/EncodedMessageFilter.hpp"
+
+using std::string;
+using std::vector;
+
+TEST_CASE("EncodedMessageFilter", "[EncodedMessageFilter]") {
+    // Build the logtype for "INFO Task <int> finished in <float> ms"
+    LogTypeDictionaryEntry logtype_entry;
+    string constant = "INFO Task ";
+    logtype_entry.add_constant(constant, 0, constant.length());
+    logtype_entry.add_int_var();
+    constant = " finished in ";
+    logtype_entry.add_constant(constant, 0, constant.length());
+    logtype_entry.add_float_var();
+    constant = " ms";
+    logtype_entry.add_constant(constant, 0, constant.length());
+
+    VariableDictionaryReader var_dict;
+    vector<encoded_variable_t> encoded_vars = {12, 0};
+    TimestampPattern ts_pattern(0, "%Y-%m-%d %H:%M:%S,%3 ");
+
+    auto may_match = [&] (const string& search_string, bool ignore_case, const TimestampPattern* pattern) {
+        EncodedMessageFilter filter(search_string, ignore_case);
+        return filter.may_match(logtype_entry, var_dict, encoded_vars, pattern);
+    };
+
+    SECTION("Fragments in constants") {
+        REQUIRE(may_match("*finished*", false, nullptr));
+        REQUIRE(may_match("*fin?shed*", false, nullptr));
+        REQUIRE(may_match("*", false, nullptr));
+        REQUIRE(false == may_match("*failed*", false, nullptr));
+        REQUIRE(false == may_match("*finished*failed*", false, nullptr));
+
+        REQUIRE(false == may_match("*info task*", false, nullptr));
+        REQUIRE(may_match("*info task*", true, nullptr));
+    }
+
+    SECTION("Fragments spanning variables") {
+        REQUIRE(may_match("*Task 12 fin*", false, nullptr));
+        REQUIRE(may_match("*in 3.5 ms*", false, nullptr));
+        REQUIRE(false == may_match("*Task x*", false, nullptr));
+        REQUIRE(false == may_match("*in 3,5 ms*", false, nullptr));
+    }
+
+    SECTION("Fragments spanning the timestamp") {
+        REQUIRE(false == may_match("*2023-01-01 00*", false, nullptr));
+        REQUIRE(may_match("*2023-01-01 00*", false, &ts_pattern));
+        REQUIRE(may_match("*:00,000 INFO*", false, &ts_pattern));
+        REQUIRE(false == may_match("*Jan*", false, &ts_pattern));
+    }
+
+    SECTION("Escaped wildcards") {
+        REQUIRE(false == may_match("*Task\\*12*", false, nullptr));
+        REQUIRE(false == may_match("*fin\\?shed*", false, nullptr));
+    }
+}
@@ -291,6 +291,12 @@ TEST_CASE("EncodedVariableInterpreter", "[EncodedVariableInterpreter]") {
         REQUIRE(EncodedVariableInterpreter::decode_variables_into_message(logtype_dict_entry, var_dict_reader, encoded_vars, decompressed_msg));
         REQUIRE(msg == decompressed_msg);
 
+        // Test decoding with a render template into a buffer that already has content
+        LogTypeRenderTemplate logtype_template(logtype_dict_entry);
+        decompressed_msg = "prefix ";
+        REQUIRE(EncodedVariableInterpreter::decode_variables_into_message(logtype_template, var_dict_reader, encoded_vars, decompressed_msg));
+        REQUIRE("prefix " + msg == decompressed_msg);
+
         var_dict_reader.close();
 
         // Clean-up
@@ -299,4 +305,24 @@ TEST_CASE("EncodedVariableInterpreter", "[EncodedVariableInterpreter]") {
         retval = unlink(cVarSegmentIndexPath);
         REQUIRE(0 == retval);
     }
+
+    SECTION("Test decoding integer variables at the edges of the representable range") {
+        LogTypeDictionaryEntry logtype_dict_entry;
+        string constant = "min=";
+        logtype_dict_entry.add_constant(constant, 0, constant.length());
+        logtype_dict_entry.add_int_var();
+        constant = " max=";
+        logtype_dict_entry.add_constant(constant, 0, constant.length());
+        logtype_dict_entry.add_int_var();
+        constant = " zero=";
+        logtype_dict_entry.add_constant(constant, 0, constant.length());
+        logtype_dict_entry.add_int_var();
+        vector<encoded_variable_t> encoded_vars = {INT64_MIN, INT64_MAX, 0};
+
+        VariableDictionaryReader var_dict_reader;
+        string decompressed_msg;
+        REQUIRE(EncodedVariableInterpreter::decode_variables_into_message(LogTypeRenderTemplate(logtype_dict_entry), var_dict_reader, encoded_vars,
+                                                                          decompressed_msg));
+        REQUIRE("min=-9223372036854775808 max=9223372036854775807 zero=0" == decompressed_msg);
+    }
 }
@@ -0,0 +1,107 @@
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/clp/FilePrefetcher.hpp"
+#include "../src/FileReader.hpp"
+#include "../src/FileWriter.hpp"
+
+using std::string;
+using std::vector;
+
+/**
+ * Reads each of the given files in order, marking each as consumed once it's been read
+ * @param paths
+ * @param prefetcher If not null, the prefetcher to mark files as consumed in
+ * @param contents Returns the contents of each file, or "<error>" for files which couldn't be read
+ */
+static void read_files (const vector<string>& paths, clp::FilePrefetcher* prefetcher, vector<string>& contents) {
+    contents.clear();
+    for (const auto& path : paths) {
+        FileReader file_reader;
+        string file_contents;
+        if (ErrorCode_Success != file_reader.try_open(path)) {
+            file_contents = "<error>";
+        } else {
+            char buf[4096];
+            size_t num_bytes_read;
+            while (ErrorCode_Success == file_reader.try_read(buf, sizeof(buf), num_bytes_read)) {
+                file_contents.append(buf, num_bytes_read);
+            }
+            file_reader.close();
+        }
+        contents.emplace_back(std::move(file_contents));
+        if (nullptr != prefetcher) {
+            prefetcher->mark_next_file_consumed();
+        }
+    }
+}
+
+TEST_CASE("Test reading files while they're prefetched", "[FilePrefetcher]") {
+    const string cTestDir = "unit-test-file-prefetcher";
+    boost::filesystem::remove_all(cTestDir);
+    boost::filesystem::create_directory(cTestDir);
+
+    // Create files of varying sizes (including an empty file), with a nonexistent file in the middle of the list
+    vector<string> paths;
+    for (size_t i = 0; i < 16; ++i) {
+        auto path = cTestDir + "/file" + std::to_string(i);
+        paths.emplace_back(path);
+        if (5 == i) {
+            continue;
+        }
+
+        FileWriter file_writer;
+        file_writer.open(path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+        for (size_t j = 0; j < i * i * 100; ++j) {
+            file_writer.write_string("line " + std::to_string(j) + " of file " + std::to_string(i) + '\n');
+        }
+        file_writer.close();
+    }
+
+    vector<string> expected_contents;
+    read_files(paths, nullptr, expected_contents);
+    REQUIRE("<error>" == expected_contents[5]);
+
+    clp::FilePrefetcher prefetcher;
+    vector<string> contents;
+
+    SECTION("Prefetching ahead of the consumer") {
+        prefetcher.open(paths, 4, 64 * 1024);
+        read_files(paths, &prefetcher, contents);
+        prefetcher.close();
+        REQUIRE(expected_contents == contents);
+    }
+
+    SECTION("Prefetching with no room ahead of the consumer") {
+        prefetcher.open(paths, 0, 0);
+        read_files(paths, &prefetcher, contents);
+        prefetcher.close();
+        REQUIRE(expected_contents == contents);
+    }
+
+    SECTION("Closing the prefetcher before every file has been consumed") {
+        prefetcher.open(paths, 2, 1024 * 1024);
+        vector<string> first_paths(paths.cbegin(), paths.cbegin() + 3);
+        read_files(first_paths, &prefetcher, contents);
+        prefetcher.close();
+        REQUIRE(vector<string>(expected_contents.cbegin(), expected_contents.cbegin() + 3) == contents);
+
+        // The prefetcher can be reopened and files can still be read after it's closed
+        prefetcher.open(paths, 2, 1024 * 1024);
+        prefetcher.close();
+        read_files(paths, &prefetcher, contents);
+        REQUIRE(expected_contents == contents);
+    }
+
+    REQUIRE_THROWS_AS(prefetcher.close(), clp::FilePrefetcher::OperationFailed);
+
+    boost::filesystem::remove_all(cTestDir);
+}
@@ -0,0 +1,211 @@
+// C++ standard libraries
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// fmt
+#include <fmt/core.h>
+
+// Project headers
+#include "../src/GlobalSQLiteMetadataDB.hpp"
+#include "../src/SQLiteDB.hpp"
+#include "../src/streaming_archive/ArchiveMetadata.hpp"
+#include "../src/streaming_archive/Constants.hpp"
+#include "../src/streaming_archive/writer/File.hpp"
+
+using std::map;
+using std::string;
+using std::to_string;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * @param db_path
+ * @return A map from the ID of each file in the given global metadata DB to its path and archive ID
+ */
+static map<string, std::pair<string, string>> get_files (const string& db_path) {
+    SQLiteDB db;
+    db.open(db_path);
+
+    map<string, std::pair<string, string>> files;
+    {
+        // NOTE: The statement must be destroyed before the DB is closed
+        auto statement = db.prepare_statement(fmt::format("SELECT {}, {}, {} FROM {}", streaming_archive::cMetadataDB::File::Id,
+                                                          streaming_archive::cMetadataDB::File::Path, streaming_archive::cMetadataDB::File::ArchiveId,
+                                                          streaming_archive::cMetadataDB::FilesTableName));
+        while (statement.step()) {
+            string id;
+            string path;
+            string archive_id;
+            statement.column_string(0, id);
+            statement.column_string(1, path);
+            statement.column_string(2, archive_id);
+            files[id] = {path, archive_id};
+        }
+    }
+    REQUIRE(db.close());
+
+    return files;
+}
+
+TEST_CASE("Test upserting batches of files into the global metadata DB", "[GlobalMetadataDB]") {
+    const string cTestDir = "unit-test-global-metadata-db";
+    const string cDBPath = cTestDir + "/metadata.db";
+    boost::filesystem::remove_all(cTestDir);
+    boost::filesystem::create_directory(cTestDir);
+
+    // Batches smaller than, equal to, and larger than the number of files upserted by a single statement (64), as well as a multiple of it
+    vector<size_t> batch_sizes = {1, 63, 64, 65, 128, 200, 1};
+
+    boost::uuids::random_generator uuid_generator;
+    vector<vector<unique_ptr<streaming_archive::writer::File>>> batches;
+    size_t num_files = 0;
+    for (auto batch_size : batch_sizes) {
+        vector<unique_ptr<streaming_archive::writer::File>> batch;
+        for (size_t i = 0; i < batch_size; ++i) {
+            batch.emplace_back(std::make_unique<streaming_archive::writer::File>(uuid_generator(), uuid_generator(), "file" + to_string(num_files), 0, 0));
+            ++num_files;
+        }
+        batches.emplace_back(std::move(batch));
+    }
+
+    /**
+     * Upserts every batch of files into the DB, as part of the given archive
+     */
+    auto upsert_batches = [&] (GlobalSQLiteMetadataDB& global_metadata_db, const string& archive_id) {
+        for (const auto& batch : batches) {
+            vector<streaming_archive::writer::File*> files;
+            for (const auto& file : batch) {
+                files.push_back(file.get());
+            }
+            global_metadata_db.update_metadata_for_files(archive_id, files);
+        }
+    };
+
+    /**
+     * Checks that the DB contains exactly one row for every file, each belonging to the given archive
+     */
+    auto check_files = [&] (const string& archive_id) {
+        auto files = get_files(cDBPath);
+        REQUIRE(files.size() == num_files);
+        for (const auto& batch : batches) {
+            for (const auto& file : batch) {
+                auto file_it = files.find(file->get_id_as_string());
+                REQUIRE(files.cend() != file_it);
+                REQUIRE(file_it->second.first == file->get_orig_path());
+                REQUIRE(file_it->second.second == archive_id);
+            }
+        }
+    };
+
+    GlobalSQLiteMetadataDB global_metadata_db(cDBPath);
+    global_metadata_db.open();
+    upsert_batches(global_metadata_db, "archive0");
+    global_metadata_db.close();
+    check_files("archive0");
+
+    // Upserting the same files should update their rows rather than insert new ones
+    global_metadata_db.open();
+    upsert_batches(global_metadata_db, "archive1");
+    global_metadata_db.close();
+    check_files("archive1");
+
+    boost::filesystem::remove_all(cTestDir);
+}
+
+TEST_CASE("Test marking archives as finalized in the global metadata DB", "[GlobalMetadataDB]") {
+    const string cTestDir = "unit-test-global-metadata-db";
+    const string cDBPath = cTestDir + "/metadata.db";
+    boost::filesystem::remove_all(cTestDir);
+    boost::filesystem::create_directory(cTestDir);
+
+    const vector<string> archive_ids = {"archive0", "archive1"};
+    GlobalSQLiteMetadataDB global_metadata_db(cDBPath);
+    global_metadata_db.open();
+    for (const auto& archive_id : archive_ids) {
+        streaming_archive::ArchiveMetadata metadata(streaming_archive::cArchiveFormatVersion, "creator", 0);
+        global_metadata_db.add_archive(archive_id, metadata);
+    }
+
+    /**
+     * @return A map from the ID of each archive in the DB to whether it's finalized
+     */
+    auto get_archives_finalized = [&] () {
+        map<string, bool> archives_finalized;
+        // NOTE: The iterator must be destroyed before the DB is closed
+        unique_ptr<GlobalMetadataDB::ArchiveIterator> archive_ix(global_metadata_db.get_archive_iterator());
+        for (; archive_ix->contains_element(); archive_ix->get_next()) {
+            string archive_id;
+            archive_ix->get_id(archive_id);
+            archives_finalized[archive_id] = archive_ix->is_finalized();
+        }
+        return archives_finalized;
+    };
+
+    // Archives shouldn't be finalized until they're marked so
+    REQUIRE(get_archives_finalized() == map<string, bool>{{"archive0", false}, {"archive1", false}});
+    global_metadata_db.mark_archive_finalized("archive1");
+    REQUIRE(get_archives_finalized() == map<string, bool>{{"archive0", false}, {"archive1", true}});
+    global_metadata_db.close();
+
+    boost::filesystem::remove_all(cTestDir);
+}
+
+TEST_CASE("Test opening a global metadata DB created before archives were marked finalized", "[GlobalMetadataDB]") {
+    const string cTestDir = "unit-test-global-metadata-db";
+    const string cDBPath = cTestDir + "/metadata.db";
+    boost::filesystem::remove_all(cTestDir);
+    boost::filesystem::create_directory(cTestDir);
+
+    // Create an archives table without the is_finalized column
+    {
+        SQLiteDB db;
+        db.open(cDBPath);
+        {
+            // NOTE: The statements must be destroyed before the DB is closed
+            auto create_archives_table = db.prepare_statement(fmt::format(
+                    "CREATE TABLE {} ({} TEXT PRIMARY KEY, {} INTEGER, {} INTEGER, {} INTEGER, {} INTEGER, {} TEXT, {} INTEGER) WITHOUT ROWID",
+                    streaming_archive::cMetadataDB::ArchivesTableName, streaming_archive::cMetadataDB::Archive::Id,
+                    streaming_archive::cMetadataDB::Archive::BeginTimestamp, streaming_archive::cMetadataDB::Archive::EndTimestamp,
+                    streaming_archive::cMetadataDB::Archive::UncompressedSize, streaming_archive::cMetadataDB::Archive::Size,
+                    streaming_archive::cMetadataDB::Archive::CreatorId, streaming_archive::cMetadataDB::Archive::CreationIx));
+            create_archives_table.step();
+            auto insert_archive = db.prepare_statement(fmt::format("INSERT INTO {} VALUES ('old_archive', 0, 0, 0, 0, 'creator', 0)",
+                                                                   streaming_archive::cMetadataDB::ArchivesTableName));
+            insert_archive.step();
+        }
+        REQUIRE(db.close());
+    }
+
+    GlobalSQLiteMetadataDB global_metadata_db(cDBPath);
+    global_metadata_db.open();
+    streaming_archive::ArchiveMetadata metadata(streaming_archive::cArchiveFormatVersion, "creator", 1);
+    global_metadata_db.add_archive("new_archive", metadata);
+
+    // Existing archives should be treated as finalized, while new ones aren't until they're marked so
+    map<string, bool> archives_finalized;
+    {
+        unique_ptr<GlobalMetadataDB::ArchiveIterator> archive_ix(global_metadata_db.get_archive_iterator());
+        for (; archive_ix->contains_element(); archive_ix->get_next()) {
+            string archive_id;
+            archive_ix->get_id(archive_id);
+            archives_finalized[archive_id] = archive_ix->is_finalized();
+        }
+    }
+    REQUIRE(archives_finalized == map<string, bool>{{"new_archive", false}, {"old_archive", true}});
+    global_metadata_db.close();
+
+    // Reopening the DB shouldn't try to add the column again
+    global_metadata_db.open();
+    global_metadata_db.close();
+
+    boost::filesystem::remove_all(cTestDir);
+}
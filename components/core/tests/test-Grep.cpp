@@ -1,5 +1,6 @@
 // C++ standard libraries
 #include <string>
+#include <vector>
 
 // Catch2
 #include <Catch2/single_include/catch2/catch.hpp>
@@ -17,6 +18,7 @@ using compressor_frontend::SchemaFileAST;
 using compressor_frontend::SchemaParser;
 using compressor_frontend::SchemaVarAST;
 using std::string;
+using std::vector;
 
 TEST_CASE("get_bounds_of_next_potential_var", "[get_bounds_of_next_potential_var]") {
     ByteLexer forward_lexer;
@@ -116,3 +118,20 @@ TEST_CASE("get_bounds_of_next_potential_var", "[get_bounds_of_next_potential_var
 
     REQUIRE(Grep::get_bounds_of_next_potential_var(str, begin_pos, end_pos, is_var, forward_lexer, reverse_lexer) == false);
 }
+
+TEST_CASE("get_dictionary_vars_required_by_query", "[get_dictionary_vars_required_by_query]") {
+    vector<string> dict_vars;
+
+    // The search string is a sub-string match, so a token at either end could be part of a larger variable
+    Grep::get_dictionary_vars_required_by_query("container_15", dict_vars);
+    REQUIRE(dict_vars.empty());
+
+    // Only variables without wildcards that can't be encoded as integers or floats are required
+    Grep::get_dictionary_vars_required_by_query(" container_15 started in 12 ms on node-7* ", dict_vars);
+    REQUIRE(dict_vars == vector<string>{"container_15"});
+
+    dict_vars.clear();
+    Grep::get_dictionary_vars_required_by_query("user 0x1f2e accessed /var/log/app1.log and c?ntainer_15 ", dict_vars);
+    REQUIRE(dict_vars == vector<string>{"0x1f2e", "app1.log"});
+}
+
@@ -0,0 +1,268 @@
+// C libraries
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// C standard libraries
+#include <cstring>
+
+// C++ standard libraries
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/clp/IngestedStreamWriter.hpp"
+#include "../src/clp/IrStreamListener.hpp"
+#include "../src/ffi/ir_stream/encoding_methods.hpp"
+#include "../src/ffi/ir_stream/protocol_constants.hpp"
+#include "../src/GlobalSQLiteMetadataDB.hpp"
+#include "../src/networking/socket_utils.hpp"
+#include "../src/streaming_archive/reader/Archive.hpp"
+#include "../src/streaming_archive/writer/Archive.hpp"
+
+using std::map;
+using std::string;
+using std::to_string;
+using std::vector;
+
+// Constants
+static constexpr size_t cNumStreams = 2;
+static constexpr size_t cNumChunksPerStream = 10;
+static constexpr size_t cNumEventsPerChunk = 50;
+
+/**
+ * Connects to the listener at the given socket path
+ * @param socket_path
+ * @return The connected socket
+ */
+static int connect_to_listener (const string& socket_path) {
+    int socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(-1 != socket_fd);
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    REQUIRE(0 == connect(socket_fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)));
+    return socket_fd;
+}
+
+/**
+ * Sends the given IR bytes over the given socket
+ * @param socket_fd
+ * @param ir_buf Returns empty
+ */
+static void send_ir (int socket_fd, vector<int8_t>& ir_buf) {
+    networking::send(socket_fd, reinterpret_cast<const char*>(ir_buf.data()), ir_buf.size());
+    ir_buf.clear();
+}
+
+/**
+ * Gets batches from the listener and writes them until the given number of events, or the end of a stream, has been received
+ * @param listener
+ * @param stream_writer
+ * @param num_events
+ * @param wait_for_end_of_stream
+ * @param write_expired_batches Whether to write every stream's buffered batches as if they'd expired after each batch
+ * @param stream_ids Returns the ID of each stream in the order their first batches were received
+ */
+static void receive_and_write_batches (clp::IrStreamListener& listener, clp::IngestedStreamWriter& stream_writer, size_t num_events,
+                                       bool wait_for_end_of_stream, bool write_expired_batches, vector<size_t>& stream_ids)
+{
+    size_t num_events_received = 0;
+    bool end_of_stream_received = false;
+    while (num_events_received < num_events || (wait_for_end_of_stream && false == end_of_stream_received)) {
+        std::unique_ptr<clp::IrStreamListener::EventBatch> batch;
+        auto error_code = listener.try_get_next_batch(batch, std::chrono::milliseconds(10 * 1000));
+        REQUIRE(ErrorCode_Success == error_code);
+
+        if (std::find(stream_ids.cbegin(), stream_ids.cend(), batch->stream_id) == stream_ids.cend()) {
+            stream_ids.push_back(batch->stream_id);
+        }
+        REQUIRE(false == static_cast<bool>(batch->error));
+        num_events_received += batch->num_events;
+        end_of_stream_received = batch->is_end_of_stream;
+        stream_writer.write_batch(std::move(batch));
+        if (write_expired_batches) {
+            stream_writer.write_expired_batches(std::chrono::steady_clock::now() + std::chrono::hours(2));
+        }
+    }
+    REQUIRE(num_events_received == num_events);
+}
+
+/**
+ * Ingests streams that are sent in interleaved chunks, where each chunk is received before the next is sent
+ * @param archives_dir
+ * @param min_num_events_per_split
+ * @param write_expired_batches Whether to write every stream's buffered batches as if they'd expired after each batch
+ * @param streams_messages Returns the messages sent in each stream
+ * @param stream_ids Returns the ID of each stream
+ * @return The path of the archive the streams were written into
+ */
+static string ingest_interleaved_streams (const string& archives_dir, size_t min_num_events_per_split, bool write_expired_batches,
+                                          vector<vector<string>>& streams_messages, vector<size_t>& stream_ids)
+{
+    boost::uuids::random_generator uuid_generator;
+    GlobalSQLiteMetadataDB global_metadata_db(archives_dir + "/metadata.db");
+
+    streaming_archive::writer::Archive::UserConfig archive_user_config;
+    archive_user_config.id = uuid_generator();
+    archive_user_config.creator_id = uuid_generator();
+    archive_user_config.creation_num = 0;
+    archive_user_config.target_segment_uncompressed_size = 1L * 1024 * 1024 * 1024;
+    archive_user_config.compression_level = 0;
+    archive_user_config.output_dir = archives_dir;
+    archive_user_config.global_metadata_db = &global_metadata_db;
+    archive_user_config.print_archive_stats_progress = false;
+    archive_user_config.segment_packing_window_size = 0;
+    archive_user_config.use_huge_pages_for_columns = false;
+    archive_user_config.memory_budget = 0;
+
+    streaming_archive::writer::Archive archive_writer;
+    archive_writer.open(archive_user_config);
+
+    const string socket_path = archives_dir + "/socket";
+    clp::IrStreamListener listener;
+    listener.open(socket_path, 4);
+
+    // NOTE: The file and dictionary targets are large enough that streams are only split when the stream being written changes
+    clp::IngestedStreamWriter stream_writer(listener, archive_user_config, archive_writer, "stream", 1L * 1024 * 1024 * 1024,
+                                            1L * 1024 * 1024 * 1024, min_num_events_per_split, 1024 * 1024, std::chrono::hours(1));
+
+    vector<int> socket_fds;
+    vector<int8_t> ir_buf;
+    streams_messages.assign(cNumStreams, {});
+    for (size_t stream_ix = 0; stream_ix < cNumStreams; ++stream_ix) {
+        socket_fds.push_back(connect_to_listener(socket_path));
+        REQUIRE(ffi::ir_stream::eight_byte_encoding::encode_preamble("", "", "UTC", ir_buf));
+        send_ir(socket_fds.back(), ir_buf);
+    }
+
+    string logtype;
+    for (size_t chunk_ix = 0; chunk_ix < cNumChunksPerStream; ++chunk_ix) {
+        for (size_t stream_ix = 0; stream_ix < cNumStreams; ++stream_ix) {
+            for (size_t i = 0; i < cNumEventsPerChunk; ++i) {
+                auto event_ix = chunk_ix * cNumEventsPerChunk + i;
+                string message = "Stream " + to_string(stream_ix) + " event " + to_string(event_ix) + " value=" + to_string(event_ix * 7) + '\n';
+                REQUIRE(ffi::ir_stream::eight_byte_encoding::encode_message(1'600'000'000'000 + event_ix, message, logtype, ir_buf));
+                streams_messages[stream_ix].emplace_back(std::move(message));
+            }
+            send_ir(socket_fds[stream_ix], ir_buf);
+            receive_and_write_batches(listener, stream_writer, cNumEventsPerChunk, false, write_expired_batches, stream_ids);
+        }
+    }
+    for (size_t stream_ix = 0; stream_ix < cNumStreams; ++stream_ix) {
+        ir_buf.push_back(ffi::ir_stream::cProtocol::Eof);
+        send_ir(socket_fds[stream_ix], ir_buf);
+        close(socket_fds[stream_ix]);
+        receive_and_write_batches(listener, stream_writer, 0, true, write_expired_batches, stream_ids);
+    }
+    REQUIRE(cNumStreams == stream_ids.size());
+
+    stream_writer.close();
+    archive_writer.close();
+    listener.close();
+
+    return archives_dir + '/' + boost::uuids::to_string(archive_user_config.id);
+}
+
+/**
+ * Decompresses every split of every file in the given archive
+ * @param archive_path
+ * @return A map from each file's path to the decompressed messages of each of its splits, in split order
+ */
+static map<string, map<size_t, vector<string>>> decompress_splits (const string& archive_path) {
+    streaming_archive::reader::Archive archive_reader;
+    archive_reader.open(archive_path);
+    archive_reader.refresh_dictionaries();
+
+    map<string, map<size_t, vector<string>>> files_splits;
+    {
+        // NOTE: The iterator must be destroyed before the archive is closed
+        auto file_metadata_ix_ptr = archive_reader.get_file_iterator();
+        for (auto& file_metadata_ix = *file_metadata_ix_ptr; file_metadata_ix.has_next(); file_metadata_ix.next()) {
+            string path;
+            file_metadata_ix.get_path(path);
+            auto& messages = files_splits[path][file_metadata_ix.get_split_ix()];
+
+            streaming_archive::reader::File file;
+            REQUIRE(ErrorCode_Success == archive_reader.open_file(file, file_metadata_ix));
+            streaming_archive::reader::Message compressed_message;
+            string decompressed_message;
+            while (archive_reader.get_next_message(file, compressed_message)) {
+                REQUIRE(archive_reader.decompress_message(file, compressed_message, decompressed_message));
+                messages.push_back(decompressed_message);
+            }
+            archive_reader.close_file(file);
+        }
+    }
+    archive_reader.close();
+
+    return files_splits;
+}
+
+TEST_CASE("Test ingesting interleaved IR streams", "[IngestedStreamWriter][IrStreamListener]") {
+    const string cArchivesDir = "unit-test-ingestion";
+    boost::filesystem::remove_all(cArchivesDir);
+    boost::filesystem::create_directory(cArchivesDir);
+
+    size_t min_num_events_per_split;
+    bool write_expired_batches = false;
+    size_t expected_num_splits_per_stream;
+    SECTION("Streams are split whenever the stream being written changes without buffering") {
+        min_num_events_per_split = 1;
+        expected_num_splits_per_stream = cNumChunksPerStream;
+    }
+    SECTION("Streams are split once per run of buffered events") {
+        // Each stream's buffer is written after every third chunk and at the end of the stream
+        min_num_events_per_split = 3 * cNumEventsPerChunk;
+        expected_num_splits_per_stream = (cNumChunksPerStream + 2) / 3;
+    }
+    SECTION("Streams aren't split if they're buffered until they end") {
+        min_num_events_per_split = cNumChunksPerStream * cNumEventsPerChunk + 1;
+        expected_num_splits_per_stream = 1;
+    }
+    SECTION("Streams are split whenever their buffering time expires") {
+        min_num_events_per_split = cNumChunksPerStream * cNumEventsPerChunk + 1;
+        write_expired_batches = true;
+        expected_num_splits_per_stream = cNumChunksPerStream;
+    }
+
+    vector<vector<string>> streams_messages;
+    vector<size_t> stream_ids;
+    auto archive_path = ingest_interleaved_streams(cArchivesDir, min_num_events_per_split, write_expired_batches, streams_messages, stream_ids);
+    auto files_splits = decompress_splits(archive_path);
+    REQUIRE(files_splits.size() == cNumStreams);
+
+    TimestampPattern timestamp_pattern(0, "%Y-%m-%dT%H:%M:%S.%3");
+    for (size_t stream_ix = 0; stream_ix < cNumStreams; ++stream_ix) {
+        const auto& splits = files_splits["stream" + to_string(stream_ids[stream_ix])];
+        REQUIRE(splits.size() == expected_num_splits_per_stream);
+
+        vector<string> decompressed_messages;
+        size_t expected_split_ix = 0;
+        for (const auto& [split_ix, messages] : splits) {
+            REQUIRE(expected_split_ix == split_ix);
+            ++expected_split_ix;
+            decompressed_messages.insert(decompressed_messages.end(), messages.cbegin(), messages.cend());
+        }
+
+        REQUIRE(decompressed_messages.size() == streams_messages[stream_ix].size());
+        for (size_t i = 0; i < decompressed_messages.size(); ++i) {
+            string expected_message = streams_messages[stream_ix][i];
+            timestamp_pattern.insert_formatted_timestamp(1'600'000'000'000 + i, expected_message);
+            REQUIRE(decompressed_messages[i] == expected_message);
+        }
+    }
+
+    boost::filesystem::remove_all(cArchivesDir);
+}
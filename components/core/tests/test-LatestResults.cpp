@@ -0,0 +1,44 @@
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/clg/LatestResults.hpp"
+
+using clg::LatestResults;
+using std::string;
+using std::vector;
+using streaming_archive::reader::Message;
+
+static void collect_timestamp (const string& orig_file_path, const Message& compressed_msg, const string& decompressed_msg, void* custom_arg) {
+    auto& timestamps = *static_cast<vector<epochtime_t>*>(custom_arg);
+    timestamps.push_back(compressed_msg.get_ts_in_milli());
+    REQUIRE(std::to_string(compressed_msg.get_ts_in_milli()) == decompressed_msg);
+}
+
+TEST_CASE("LatestResults", "[LatestResults]") {
+    constexpr size_t cNumLatestResults = 4;
+    LatestResults latest_results(cNumLatestResults);
+    REQUIRE(false == latest_results.is_full());
+
+    Message msg;
+    for (epochtime_t timestamp : {50, 10, 70, 30, 90, 20, 60, 80, 40}) {
+        msg.set_timestamp(timestamp);
+        latest_results.add("file", msg, std::to_string(timestamp));
+    }
+    REQUIRE(latest_results.is_full());
+    REQUIRE(60 == latest_results.get_earliest_timestamp());
+
+    // Results no later than the earliest result kept should be ignored
+    msg.set_timestamp(60);
+    latest_results.add("file", msg, "60");
+    REQUIRE(60 == latest_results.get_earliest_timestamp());
+
+    vector<epochtime_t> timestamps;
+    latest_results.output_and_clear(collect_timestamp, &timestamps);
+    REQUIRE(vector<epochtime_t>{60, 70, 80, 90} == timestamps);
+    REQUIRE(false == latest_results.is_full());
+}
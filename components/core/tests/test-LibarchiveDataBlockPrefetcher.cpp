@@ -0,0 +1,176 @@
+// C++ standard libraries
+#include <random>
+#include <string>
+#include <vector>
+
+// libarchive
+#include <archive.h>
+#include <archive_entry.h>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/LibarchiveDataBlockPrefetcher.hpp"
+
+using std::string;
+using std::vector;
+
+/**
+ * Creates a gzipped tar archive in memory
+ * @param entries The name and contents of each entry
+ * @return The archive's bytes
+ */
+static vector<char> create_tar_gz (const vector<std::pair<string, string>>& entries) {
+    vector<char> archive_bytes(16 * 1024 * 1024);
+    size_t archive_size = 0;
+
+    auto* writer = archive_write_new();
+    REQUIRE(ARCHIVE_OK == archive_write_set_format_pax_restricted(writer));
+    REQUIRE(ARCHIVE_OK == archive_write_add_filter_gzip(writer));
+    REQUIRE(ARCHIVE_OK == archive_write_open_memory(writer, archive_bytes.data(), archive_bytes.size(), &archive_size));
+    for (const auto& entry : entries) {
+        auto* archive_entry = archive_entry_new();
+        archive_entry_set_pathname(archive_entry, entry.first.c_str());
+        archive_entry_set_size(archive_entry, static_cast<la_int64_t>(entry.second.size()));
+        archive_entry_set_filetype(archive_entry, AE_IFREG);
+        archive_entry_set_perm(archive_entry, 0644);
+        REQUIRE(ARCHIVE_OK == archive_write_header(writer, archive_entry));
+        REQUIRE(static_cast<la_ssize_t>(entry.second.size()) == archive_write_data(writer, entry.second.data(), entry.second.size()));
+        archive_entry_free(archive_entry);
+    }
+    REQUIRE(ARCHIVE_OK == archive_write_close(writer));
+    archive_write_free(writer);
+
+    archive_bytes.resize(archive_size);
+    return archive_bytes;
+}
+
+/**
+ * Opens an archive in memory and advances it to its first entry
+ * @param archive_bytes
+ * @return The archive
+ */
+static struct archive* open_archive_at_first_entry (const vector<char>& archive_bytes) {
+    auto* archive = archive_read_new();
+    REQUIRE(ARCHIVE_OK == archive_read_support_filter_all(archive));
+    REQUIRE(ARCHIVE_OK == archive_read_support_format_all(archive));
+    REQUIRE(ARCHIVE_OK == archive_read_open_memory(archive, archive_bytes.data(), archive_bytes.size()));
+    struct archive_entry* archive_entry;
+    REQUIRE(ARCHIVE_OK == archive_read_next_header(archive, &archive_entry));
+    return archive;
+}
+
+/**
+ * Reads the data blocks of the archive's current entry
+ * @param archive
+ * @param prefetcher If not null, the blocks are read through this prefetcher; otherwise they're read directly from libarchive
+ * @param data Returns the blocks' data, each preceded by its position in the file
+ * @return ErrorCode_EndOfFile if the entry was read to its end
+ * @return ErrorCode_Failure if reading failed
+ */
+static ErrorCode read_data_blocks (struct archive* archive, LibarchiveDataBlockPrefetcher* prefetcher, string& data) {
+    data.clear();
+    while (true) {
+        const void* data_block;
+        size_t data_block_length;
+        la_int64_t data_block_pos_in_file;
+        ErrorCode error_code;
+        if (nullptr == prefetcher) {
+            auto return_value = archive_read_data_block(archive, &data_block, &data_block_length, &data_block_pos_in_file);
+            if (ARCHIVE_OK == return_value) {
+                error_code = ErrorCode_Success;
+            } else if (ARCHIVE_EOF == return_value) {
+                error_code = ErrorCode_EndOfFile;
+            } else {
+                error_code = ErrorCode_Failure;
+            }
+        } else {
+            error_code = prefetcher->try_get_next_data_block(data_block, data_block_length, data_block_pos_in_file);
+        }
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        data += std::to_string(data_block_pos_in_file);
+        data += ':';
+        data.append(static_cast<const char*>(data_block), data_block_length);
+    }
+}
+
+TEST_CASE("Test prefetching libarchive data blocks", "[LibarchiveDataBlockPrefetcher]") {
+    // Random (incompressible) contents span many data blocks
+    std::mt19937_64 random_generator(1);
+    std::uniform_int_distribution<int> char_distribution('a', 'z');
+    string large_contents(4 * 1024 * 1024, '\0');
+    for (auto& c : large_contents) {
+        c = static_cast<char>(char_distribution(random_generator));
+    }
+    auto archive_bytes = create_tar_gz({{"large.log", large_contents}, {"small.log", "a small file\n"}, {"empty.log", ""}});
+
+    LibarchiveDataBlockPrefetcher prefetcher;
+
+    SECTION("Blocks are the same as when read directly, for every entry") {
+        auto* direct_archive = open_archive_at_first_entry(archive_bytes);
+        auto* prefetched_archive = open_archive_at_first_entry(archive_bytes);
+        for (size_t entry_ix = 0; entry_ix < 3; ++entry_ix) {
+            if (entry_ix > 0) {
+                struct archive_entry* archive_entry;
+                REQUIRE(ARCHIVE_OK == archive_read_next_header(direct_archive, &archive_entry));
+                REQUIRE(ARCHIVE_OK == archive_read_next_header(prefetched_archive, &archive_entry));
+            }
+
+            string direct_data;
+            REQUIRE(ErrorCode_EndOfFile == read_data_blocks(direct_archive, nullptr, direct_data));
+
+            // NOTE: The prefetcher is reused for each entry, reusing its buffers
+            prefetcher.open(prefetched_archive, 2);
+            string prefetched_data;
+            REQUIRE(ErrorCode_EndOfFile == read_data_blocks(prefetched_archive, &prefetcher, prefetched_data));
+            // Reading past EOF should keep returning EOF
+            const void* data_block;
+            size_t data_block_length;
+            la_int64_t data_block_pos_in_file;
+            REQUIRE(ErrorCode_EndOfFile == prefetcher.try_get_next_data_block(data_block, data_block_length, data_block_pos_in_file));
+            prefetcher.close();
+
+            REQUIRE(direct_data == prefetched_data);
+        }
+        archive_read_free(direct_archive);
+        archive_read_free(prefetched_archive);
+    }
+
+    SECTION("Blocks before a read error are the same as when read directly") {
+        // Truncate the archive in the middle of the large entry
+        auto truncated_archive_bytes = archive_bytes;
+        truncated_archive_bytes.resize(archive_bytes.size() / 2);
+
+        auto* direct_archive = open_archive_at_first_entry(truncated_archive_bytes);
+        string direct_data;
+        REQUIRE(ErrorCode_Failure == read_data_blocks(direct_archive, nullptr, direct_data));
+        archive_read_free(direct_archive);
+
+        auto* prefetched_archive = open_archive_at_first_entry(truncated_archive_bytes);
+        prefetcher.open(prefetched_archive, 4);
+        string prefetched_data;
+        REQUIRE(ErrorCode_Failure == read_data_blocks(prefetched_archive, &prefetcher, prefetched_data));
+        prefetcher.close();
+        archive_read_free(prefetched_archive);
+
+        REQUIRE(false == direct_data.empty());
+        REQUIRE(direct_data == prefetched_data);
+    }
+
+    SECTION("Closing the prefetcher before the entry is consumed discards the remaining blocks") {
+        auto* archive = open_archive_at_first_entry(archive_bytes);
+        prefetcher.open(archive, 2);
+        const void* data_block;
+        size_t data_block_length;
+        la_int64_t data_block_pos_in_file;
+        REQUIRE(ErrorCode_Success == prefetcher.try_get_next_data_block(data_block, data_block_length, data_block_pos_in_file));
+        REQUIRE(0 == data_block_pos_in_file);
+        prefetcher.close();
+        archive_read_free(archive);
+    }
+
+    REQUIRE_THROWS_AS(prefetcher.close(), LibarchiveDataBlockPrefetcher::OperationFailed);
+}
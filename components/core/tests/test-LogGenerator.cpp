@@ -0,0 +1,116 @@
+// C++ standard libraries
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/clp_bench/LogGenerator.hpp"
+#include "../src/FileReader.hpp"
+#include "../src/MessageParser.hpp"
+#include "../src/TimestampPattern.hpp"
+#include "../src/Utils.hpp"
+
+using clp_bench::LogGenerator;
+using std::string;
+using std::vector;
+
+/**
+ * Reads the given files into a string
+ * @param file_paths
+ * @return The concatenated contents of the files
+ */
+static string read_files (const vector<string>& file_paths);
+
+static string read_files (const vector<string>& file_paths) {
+    std::ostringstream contents;
+    for (const auto& path : file_paths) {
+        std::ifstream file(path, std::ios::binary);
+        contents << file.rdbuf();
+    }
+    return contents.str();
+}
+
+TEST_CASE("LogGenerator", "[LogGenerator]") {
+    TimestampPattern::init();
+
+    const string output_dir = "unit-test-log-generator";
+    REQUIRE(ErrorCode_Success == create_directory_structure(output_dir, 0700));
+
+    LogGenerator::Config config;
+    config.num_messages = 5000;
+    config.num_files = 3;
+    config.num_logtypes = 50;
+    config.num_dictionary_variable_values = 200;
+    config.multiline_message_ratio = 0.1;
+    config.timestamp_format_names = {"default", "compact", "month-name"};
+
+    LogGenerator generator(config);
+    generator.generate(output_dir);
+    REQUIRE(generator.get_file_paths().size() == config.num_files);
+    auto corpus = read_files(generator.get_file_paths());
+    REQUIRE(corpus.size() == generator.get_num_uncompressed_bytes());
+
+    SECTION("Messages can be parsed") {
+        // Every message should have a timestamp (no multiline message should be split) and the timestamps should be increasing
+        MessageParser message_parser;
+        ParsedMessage message;
+        FileReader file_reader;
+        size_t num_messages = 0;
+        size_t num_multiline_messages = 0;
+        size_t num_needles = 0;
+        epochtime_t prev_timestamp = LogGenerator::cBeginTimestamp;
+        for (size_t file_ix = 0; file_ix < config.num_files; ++file_ix) {
+            file_reader.open(generator.get_file_paths()[file_ix]);
+            while (message_parser.parse_next_message(true, file_reader, message)) {
+                REQUIRE(nullptr != message.get_ts_patt());
+                REQUIRE(message.get_ts_patt()->get_format() == (0 == file_ix % 3 ? "%Y-%m-%d %H:%M:%S,%3" : (1 == file_ix % 3
+                        ? "[%Y%m%d-%H:%M:%S]" : "%d %b %Y %H:%M:%S,%3")));
+                REQUIRE(message.get_ts() >= prev_timestamp - 1000);
+                prev_timestamp = message.get_ts();
+
+                const auto& content = message.get_content();
+                if (content.find('\n') != content.length() - 1) {
+                    ++num_multiline_messages;
+                }
+                if (content.find(generator.get_needle()) != string::npos) {
+                    ++num_needles;
+                }
+                ++num_messages;
+            }
+            file_reader.close();
+        }
+        REQUIRE(num_messages == config.num_messages);
+        REQUIRE(num_needles == 1);
+        REQUIRE(num_multiline_messages > 0);
+        REQUIRE(num_multiline_messages < config.num_messages / 5);
+        REQUIRE(prev_timestamp <= generator.get_end_timestamp());
+    }
+
+    SECTION("Generation is deterministic") {
+        LogGenerator same_generator(config);
+        same_generator.generate(output_dir);
+        REQUIRE(read_files(same_generator.get_file_paths()) == corpus);
+
+        config.seed = 2;
+        LogGenerator other_generator(config);
+        other_generator.generate(output_dir);
+        REQUIRE(read_files(other_generator.get_file_paths()) != corpus);
+    }
+
+    SECTION("Invalid configs are rejected") {
+        config.num_logtypes = LogGenerator::cMaxNumLogtypes + 1;
+        REQUIRE_THROWS_AS(LogGenerator(config), LogGenerator::OperationFailed);
+        config.num_logtypes = 1;
+        config.timestamp_format_names = {"unknown"};
+        REQUIRE_THROWS_AS(LogGenerator(config), LogGenerator::OperationFailed);
+    }
+
+    boost::filesystem::remove_all(output_dir);
+}
@@ -0,0 +1,230 @@
+// C++ standard libraries
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/clg/MatchAggregates.hpp"
+#include "../src/GlobalSQLiteMetadataDB.hpp"
+#include "../src/Grep.hpp"
+#include "../src/Profiler.hpp"
+#include "../src/streaming_archive/reader/Archive.hpp"
+#include "../src/streaming_archive/writer/Archive.hpp"
+
+using clg::MatchAggregates;
+using std::map;
+using std::pair;
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+// Constants
+// Messages and their timestamps, which straddle the epoch and the boundaries of 1 s time buckets
+static const vector<pair<epochtime_t, string>> cMessages = {
+        {-1500, "Task 12 finished in 34 ms\n"},
+        {-1000, "User user123 logged in\n"},
+        {-1, "Task 56 finished in 78 ms\n"},
+        {0, "Connection reset by peer\n"},
+        {999, "User admin42 logged in\n"},
+        {1000, "Task 90 finished in 12 ms\n"},
+        {2500, "User user456 logged in\n"},
+};
+static constexpr char cTaskLogtype[] = "Task \\i finished in \\i ms\\n";
+static constexpr char cUserLogtype[] = "User \\d logged in\\n";
+static constexpr char cConnectionLogtype[] = "Connection reset by peer\\n";
+
+/**
+ * Compresses the given messages into a single file in a new archive
+ * @param archives_dir
+ * @param messages
+ * @return The archive's path
+ */
+static string compress_messages (const string& archives_dir, const vector<pair<epochtime_t, string>>& messages) {
+    boost::uuids::random_generator uuid_generator;
+    GlobalSQLiteMetadataDB global_metadata_db(archives_dir + "/metadata.db");
+
+    streaming_archive::writer::Archive::UserConfig archive_user_config;
+    archive_user_config.id = uuid_generator();
+    archive_user_config.creator_id = uuid_generator();
+    archive_user_config.creation_num = 0;
+    archive_user_config.target_segment_uncompressed_size = 1L * 1024 * 1024 * 1024;
+    archive_user_config.compression_level = 0;
+    archive_user_config.output_dir = archives_dir;
+    archive_user_config.global_metadata_db = &global_metadata_db;
+    archive_user_config.print_archive_stats_progress = false;
+    archive_user_config.segment_packing_window_size = 0;
+    archive_user_config.use_huge_pages_for_columns = false;
+    archive_user_config.memory_budget = 0;
+
+    streaming_archive::writer::Archive archive_writer;
+    archive_writer.open(archive_user_config);
+    archive_writer.create_and_open_file("file", 0, uuid_generator(), 0);
+    for (const auto& [timestamp, message] : messages) {
+        archive_writer.write_msg(timestamp, message, message.length());
+    }
+    archive_writer.close_file();
+    archive_writer.append_file_to_segment();
+    archive_writer.close();
+
+    return archives_dir + '/' + boost::uuids::to_string(archive_user_config.id);
+}
+
+/**
+ * @return The number of messages decoded so far, or 0 if profiling isn't compiled in
+ */
+static size_t get_num_decoded_messages () {
+    return Profiler::get_counter<Profiler::CounterIndex::DecodedMessages>();
+}
+
+static void add_to_aggregates (epochtime_t timestamp, logtype_dictionary_id_t logtype_id, void* custom_arg) {
+    static_cast<MatchAggregates*>(custom_arg)->add(timestamp, logtype_id);
+}
+
+/**
+ * Searches the given archive for the given search string like clg does when aggregating results
+ * @param archive_path
+ * @param search_string
+ * @param search_begin_ts
+ * @param search_end_ts
+ * @param aggregates
+ * @param num_decoded_messages Returns the number of messages decoded by the search (always 0 if profiling isn't compiled in)
+ * @return The number of matches
+ */
+static size_t search_and_aggregate (const string& archive_path, const string& search_string, epochtime_t search_begin_ts,
+                                    epochtime_t search_end_ts, MatchAggregates& aggregates, size_t& num_decoded_messages)
+{
+    streaming_archive::reader::Archive archive_reader;
+    archive_reader.open(archive_path);
+    archive_reader.refresh_dictionaries();
+
+    compressor_frontend::lexers::ByteLexer forward_lexer;
+    compressor_frontend::lexers::ByteLexer reverse_lexer;
+    vector<Query> queries(1);
+    size_t num_matches = 0;
+    auto num_decoded_messages_before_search = get_num_decoded_messages();
+    if (Grep::process_raw_query(archive_reader, search_string, search_begin_ts, search_end_ts, false, queries.front(), forward_lexer,
+                                reverse_lexer, true))
+    {
+        // NOTE: The iterator must be destroyed before the archive is closed
+        auto file_metadata_ix_ptr = archive_reader.get_file_iterator();
+        for (auto& file_metadata_ix = *file_metadata_ix_ptr; file_metadata_ix.has_next(); file_metadata_ix.next()) {
+            streaming_archive::reader::File file;
+            REQUIRE(ErrorCode_Success == archive_reader.open_file(file, file_metadata_ix));
+            Grep::calculate_sub_queries_relevant_to_file(file, queries);
+            archive_reader.reset_file_indices(file);
+            size_t num_full_decodes_avoided = 0;
+            num_matches += Grep::search_and_aggregate(queries.front(), archive_reader, file, add_to_aggregates, &aggregates,
+                                                      num_full_decodes_avoided);
+            archive_reader.close_file(file);
+        }
+    }
+    num_decoded_messages = get_num_decoded_messages() - num_decoded_messages_before_search;
+    aggregates.merge_archive_logtype_counts(archive_reader.get_logtype_dictionary());
+    archive_reader.close();
+
+    return num_matches;
+}
+
+TEST_CASE("MatchAggregates", "[MatchAggregates]") {
+    SECTION("Count") {
+        MatchAggregates aggregates(false, 0);
+        for (const auto& [timestamp, message] : cMessages) {
+            aggregates.add(timestamp, 0);
+        }
+        REQUIRE(aggregates.get_num_matches() == cMessages.size());
+        REQUIRE(aggregates.get_logtype_to_num_matches().empty());
+        REQUIRE(aggregates.get_time_bucket_to_num_matches().empty());
+    }
+
+    SECTION("Count by time") {
+        MatchAggregates aggregates(false, 1000);
+        for (const auto& [timestamp, message] : cMessages) {
+            aggregates.add(timestamp, 0);
+        }
+
+        // Each bucket includes its begin timestamp and excludes its end timestamp, including before the epoch
+        REQUIRE(aggregates.get_time_bucket_to_num_matches() == map<epochtime_t, size_t>{{-2000, 1}, {-1000, 2}, {0, 2}, {1000, 1}, {2000, 1}});
+        REQUIRE(aggregates.get_num_matches() == cMessages.size());
+    }
+
+    SECTION("Count by time with buckets that don't divide 1 s") {
+        MatchAggregates aggregates(false, 7);
+        for (epochtime_t timestamp : {-15, -14, -8, -7, -1, 0, 6, 7, 13, 14}) {
+            aggregates.add(timestamp, 0);
+        }
+        REQUIRE(aggregates.get_time_bucket_to_num_matches() == map<epochtime_t, size_t>{{-21, 1}, {-14, 2}, {-7, 2}, {0, 2}, {7, 2}, {14, 1}});
+    }
+}
+
+TEST_CASE("Test aggregating search results", "[MatchAggregates][Grep][search_and_aggregate]") {
+    const string cArchivesDir = "unit-test-aggregation";
+    boost::filesystem::remove_all(cArchivesDir);
+    boost::filesystem::create_directory(cArchivesDir);
+
+    auto archive_path = compress_messages(cArchivesDir, cMessages);
+
+    MatchAggregates aggregates(true, 1000);
+    size_t num_decoded_messages;
+
+    SECTION("Search strings which match every message don't require any message to be decoded") {
+        REQUIRE(search_and_aggregate(archive_path, "*", cEpochTimeMin, cEpochTimeMax, aggregates, num_decoded_messages) == cMessages.size());
+        REQUIRE(0 == num_decoded_messages);
+
+        REQUIRE(aggregates.get_num_matches() == cMessages.size());
+        REQUIRE(aggregates.get_logtype_to_num_matches() ==
+                unordered_map<string, size_t>{{cTaskLogtype, 3}, {cUserLogtype, 3}, {cConnectionLogtype, 1}});
+        REQUIRE(aggregates.get_time_bucket_to_num_matches() == map<epochtime_t, size_t>{{-2000, 1}, {-1000, 2}, {0, 2}, {1000, 1}, {2000, 1}});
+    }
+
+    SECTION("Only messages in the search's time range are aggregated") {
+        REQUIRE(search_and_aggregate(archive_path, "*", -1000, 999, aggregates, num_decoded_messages) == 4);
+        REQUIRE(0 == num_decoded_messages);
+
+        REQUIRE(aggregates.get_logtype_to_num_matches() ==
+                unordered_map<string, size_t>{{cTaskLogtype, 1}, {cUserLogtype, 2}, {cConnectionLogtype, 1}});
+        REQUIRE(aggregates.get_time_bucket_to_num_matches() == map<epochtime_t, size_t>{{-1000, 2}, {0, 2}});
+    }
+
+    SECTION("Search strings which only match logtypes don't require any message to be decoded") {
+        REQUIRE(search_and_aggregate(archive_path, "*finished*", cEpochTimeMin, cEpochTimeMax, aggregates, num_decoded_messages) == 3);
+        REQUIRE(0 == num_decoded_messages);
+
+        REQUIRE(aggregates.get_logtype_to_num_matches() == unordered_map<string, size_t>{{cTaskLogtype, 3}});
+        REQUIRE(aggregates.get_time_bucket_to_num_matches() == map<epochtime_t, size_t>{{-2000, 1}, {-1000, 1}, {1000, 1}});
+    }
+
+    SECTION("Only messages that require a wildcard match are decoded") {
+        // Only the messages with the user logtype may match, and they need to be decoded to check if they do
+        REQUIRE(search_and_aggregate(archive_path, "User user* logged*", cEpochTimeMin, cEpochTimeMax, aggregates, num_decoded_messages) == 2);
+        if constexpr (PROF_ENABLED) {
+            REQUIRE(num_decoded_messages > 0);
+            REQUIRE(num_decoded_messages <= 3);
+        }
+
+        REQUIRE(aggregates.get_logtype_to_num_matches() == unordered_map<string, size_t>{{cUserLogtype, 2}});
+        REQUIRE(aggregates.get_time_bucket_to_num_matches() == map<epochtime_t, size_t>{{-1000, 1}, {2000, 1}});
+    }
+
+    SECTION("Counts accumulate across archives") {
+        auto other_archive_path = compress_messages(cArchivesDir, {{-999, "Connection reset by peer\n"}, {5, "Task 1 finished in 2 ms\n"}});
+        REQUIRE(search_and_aggregate(archive_path, "*", cEpochTimeMin, cEpochTimeMax, aggregates, num_decoded_messages) == cMessages.size());
+        REQUIRE(search_and_aggregate(other_archive_path, "*", cEpochTimeMin, cEpochTimeMax, aggregates, num_decoded_messages) == 2);
+
+        REQUIRE(aggregates.get_num_matches() == cMessages.size() + 2);
+        REQUIRE(aggregates.get_logtype_to_num_matches() ==
+                unordered_map<string, size_t>{{cTaskLogtype, 4}, {cUserLogtype, 3}, {cConnectionLogtype, 2}});
+        REQUIRE(aggregates.get_time_bucket_to_num_matches() == map<epochtime_t, size_t>{{-2000, 1}, {-1000, 3}, {0, 3}, {1000, 1}, {2000, 1}});
+    }
+
+    boost::filesystem::remove_all(cArchivesDir);
+}
@@ -0,0 +1,56 @@
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/MultiWildcardMatcher.hpp"
+#include "../src/string_utils.hpp"
+
+using std::string;
+using std::vector;
+
+TEST_CASE("MultiWildcardMatcher", "[MultiWildcardMatcher]") {
+    vector<string> wildcard_strings = {
+            "*",
+            "*connection*timed out*",
+            "*Connection * to ? failed*",
+            "*timed out",
+            "*out*out*",
+            "task\\*done*",
+            "*\\?*",
+            "*ab*abc*",
+    };
+    vector<string> values = {
+            "",
+            "connection to server timed out",
+            "Connection 12 to A failed after retry",
+            "Connection 12 to AB failed",
+            "request timed out",
+            "time out, then out again",
+            "task*done in 5s",
+            "taskXdone",
+            "why?",
+            "xxabcxx",
+            "abxabc",
+            "CONNECTION TIMED OUT",
+    };
+
+    for (auto ignore_case : {false, true}) {
+        MultiWildcardMatcher matcher(wildcard_strings, ignore_case);
+        vector<size_t> matching_wildcard_string_ixs;
+        for (const auto& value : values) {
+            matcher.get_matching_wildcard_strings(value, matching_wildcard_string_ixs);
+
+            vector<size_t> expected_matching_wildcard_string_ixs;
+            for (size_t i = 0; i < wildcard_strings.size(); ++i) {
+                if (wildcard_match_unsafe(value, wildcard_strings[i], false == ignore_case)) {
+                    expected_matching_wildcard_string_ixs.push_back(i);
+                }
+            }
+            REQUIRE(expected_matching_wildcard_string_ixs == matching_wildcard_string_ixs);
+        }
+    }
+}
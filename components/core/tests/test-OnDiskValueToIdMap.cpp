@@ -0,0 +1,114 @@
+// C++ standard libraries
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/OnDiskValueToIdMap.hpp"
+
+using std::pair;
+using std::string;
+using std::string_view;
+using std::to_string;
+using std::vector;
+
+TEST_CASE("OnDiskValueToIdMap", "[OnDiskValueToIdMap]") {
+    const string cPathPrefix = "unit-test-value-to-id-map";
+    // Enough runs that they're merged at least once
+    constexpr uint64_t cNumRuns = 7;
+    constexpr uint64_t cNumMappingsPerRun = 2000;
+
+    OnDiskValueToIdMap map;
+    map.open(cPathPrefix);
+    REQUIRE(map.empty());
+
+    uint64_t id;
+    REQUIRE(false == map.find("missing", id));
+
+    vector<string> values;
+    for (uint64_t run_ix = 0; run_ix < cNumRuns; ++run_ix) {
+        for (uint64_t i = 0; i < cNumMappingsPerRun; ++i) {
+            values.push_back("value" + to_string(run_ix * cNumMappingsPerRun + i));
+        }
+        vector<pair<string_view, uint64_t>> mappings;
+        for (uint64_t i = 0; i < cNumMappingsPerRun; ++i) {
+            auto value_id = run_ix * cNumMappingsPerRun + i;
+            mappings.emplace_back(values[value_id], value_id);
+        }
+        // Duplicate a mapping from the first run, as happens when a spilled value is brought back into memory and spilled again
+        mappings.emplace_back(values[0], 0);
+        map.add_mappings(mappings);
+    }
+    REQUIRE(false == map.empty());
+    REQUIRE(map.get_num_runs() < cNumRuns);
+
+    for (uint64_t value_id = 0; value_id < values.size(); ++value_id) {
+        REQUIRE(map.find(values[value_id], id));
+        REQUIRE(id == value_id);
+    }
+    REQUIRE(false == map.find("value", id));
+    REQUIRE(false == map.find("value" + to_string(values.size()), id));
+    REQUIRE(false == map.find("", id));
+
+    map.close();
+    for (uint64_t run_number = 0; run_number <= cNumRuns; ++run_number) {
+        REQUIRE(false == boost::filesystem::exists(cPathPrefix + '.' + to_string(run_number)));
+    }
+}
+
+TEST_CASE("OnDiskValueToIdMap merges runs of a similar size", "[OnDiskValueToIdMap]") {
+    const string cPathPrefix = "unit-test-value-to-id-map";
+    // Runs are merged four at a time once there are four in the same size tier (i.e., floor(log4(number of entries))), so each 4^k runs of
+    // these are eventually merged into one. 100 is in tier 3, since 64 <= 100 < 256.
+    constexpr uint64_t cNumMappingsPerRun = 100;
+
+    OnDiskValueToIdMap map;
+    map.open(cPathPrefix);
+
+    vector<string> values;
+    uint64_t id;
+    auto add_run = [&] () {
+        auto first_value_id = values.size();
+        for (uint64_t i = 0; i < cNumMappingsPerRun; ++i) {
+            values.push_back("value" + to_string(first_value_id + i));
+        }
+        vector<pair<string_view, uint64_t>> mappings;
+        for (uint64_t value_id = first_value_id; value_id < values.size(); ++value_id) {
+            mappings.emplace_back(values[value_id], value_id);
+        }
+        map.add_mappings(mappings);
+    };
+
+    for (size_t num_runs_added = 1; num_runs_added <= 64; ++num_runs_added) {
+        add_run();
+
+        // The runs are the base-4 digits of the number of runs added
+        size_t expected_num_runs = 0;
+        for (auto n = num_runs_added; n > 0; n /= 4) {
+            expected_num_runs += n % 4;
+        }
+        REQUIRE(map.get_num_runs() == expected_num_runs);
+    }
+    REQUIRE(1 == map.get_num_runs());
+
+    // Smaller runs are only merged with runs of a similar size, so they aren't merged into the larger run
+    for (size_t i = 0; i < 3; ++i) {
+        add_run();
+    }
+    REQUIRE(4 == map.get_num_runs());
+
+    for (uint64_t value_id = 0; value_id < values.size(); ++value_id) {
+        REQUIRE(map.find(values[value_id], id));
+        REQUIRE(id == value_id);
+    }
+    REQUIRE(false == map.find("value" + to_string(values.size()), id));
+
+    map.close();
+}
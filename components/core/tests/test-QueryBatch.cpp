@@ -0,0 +1,87 @@
+// C++ standard libraries
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/BufferReader.hpp"
+#include "../src/clg/QueryBatch.hpp"
+
+using clg::QueryBatch;
+using std::string;
+using std::unique_ptr;
+
+/**
+ * Parses a query batch from the given string
+ * @param batch
+ * @param max_num_results_per_query
+ * @return The query batch
+ * @throw Same as QueryBatch::parse
+ */
+static unique_ptr<QueryBatch> parse_batch (const string& batch, size_t max_num_results_per_query) {
+    BufferReader reader(batch.data(), batch.length());
+    return QueryBatch::parse(reader, max_num_results_per_query);
+}
+
+TEST_CASE("QueryBatch parsing", "[QueryBatch]") {
+    SECTION("Valid batch") {
+        // NOTE: Only the first tab separates the query ID from the wildcard string, and the last line doesn't need to end with a newline
+        auto query_batch = parse_batch("q1\t*error*\n\nq2\tUser * logged in\n\n\nq3\t*\tstatus=*", SIZE_MAX);
+        REQUIRE(query_batch->get_num_queries() == 3);
+        REQUIRE(query_batch->get_query_id(0) == "q1");
+        REQUIRE(query_batch->get_query_id(1) == "q2");
+        REQUIRE(query_batch->get_query_id(2) == "q3");
+        for (size_t query_ix = 0; query_ix < query_batch->get_num_queries(); ++query_ix) {
+            REQUIRE(query_batch->get_num_results(query_ix) == 0);
+        }
+    }
+
+    SECTION("Line without a tab") {
+        REQUIRE_THROWS_AS(parse_batch("q1\t*error*\nq2 *warning*\n", SIZE_MAX), QueryBatch::OperationFailed);
+    }
+
+    SECTION("Empty query ID") {
+        REQUIRE_THROWS_AS(parse_batch("q1\t*error*\n\t*warning*\n", SIZE_MAX), QueryBatch::OperationFailed);
+    }
+
+    SECTION("No queries") {
+        REQUIRE_THROWS_AS(parse_batch("", SIZE_MAX), QueryBatch::OperationFailed);
+        REQUIRE_THROWS_AS(parse_batch("\n\n", SIZE_MAX), QueryBatch::OperationFailed);
+    }
+}
+
+TEST_CASE("QueryBatch result limits", "[QueryBatch]") {
+    SECTION("Each query has its own limit") {
+        constexpr size_t cMaxNumResultsPerQuery = 2;
+        auto query_batch = parse_batch("q1\ta\nq2\tb\nq3\tc\n", cMaxNumResultsPerQuery);
+        REQUIRE(false == query_batch->all_queries_complete());
+
+        query_batch->add_result(0);
+        query_batch->add_result(0);
+        REQUIRE(query_batch->get_num_results(0) == cMaxNumResultsPerQuery);
+        REQUIRE(false == query_batch->all_queries_complete());
+
+        query_batch->add_result(1);
+        query_batch->add_result(2);
+        query_batch->add_result(2);
+        REQUIRE(false == query_batch->all_queries_complete());
+
+        query_batch->add_result(1);
+        REQUIRE(query_batch->all_queries_complete());
+        REQUIRE(query_batch->get_num_results(1) == cMaxNumResultsPerQuery);
+        REQUIRE(query_batch->get_num_results(2) == cMaxNumResultsPerQuery);
+    }
+
+    SECTION("Without a limit, queries are never complete") {
+        auto query_batch = parse_batch("q1\ta\n", SIZE_MAX);
+        for (size_t i = 0; i < 100; ++i) {
+            query_batch->add_result(0);
+        }
+        REQUIRE(query_batch->get_num_results(0) == 100);
+        REQUIRE(false == query_batch->all_queries_complete());
+    }
+}
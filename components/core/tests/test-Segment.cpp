@@ -10,6 +10,7 @@
 // Project headers
 #include "../src/streaming_archive/reader/Segment.hpp"
 #include "../src/streaming_archive/writer/Segment.hpp"
+#include "../src/streaming_archive/writer/SegmentFinalizer.hpp"
 #include "../src/Utils.hpp"
 
 using namespace std;
@@ -68,3 +69,56 @@ TEST_CASE("Test writing and reading a segment", "[Segment]") {
     boost::filesystem::remove_all(segments_dir_path, boost_error_code);
     REQUIRE(!boost_error_code);
 }
+
+TEST_CASE("Test finalizing segments in the background", "[Segment]") {
+    ErrorCode error_code;
+
+    string segments_dir_path = "unit-test-segment-finalizer/";
+    error_code = create_directory_structure(segments_dir_path, 0700);
+    REQUIRE(ErrorCode_Success == error_code);
+
+    constexpr segment_id_t cNumSegments = 8;
+    constexpr segment_id_t cFailingSegmentId = 5;
+    char data[] = "segment data";
+    vector<segment_id_t> finalized_segment_ids;
+
+    writer::SegmentFinalizer segment_finalizer;
+    segment_finalizer.open([&] (writer::SegmentFinalizer::PendingSegment& pending_segment) {
+        pending_segment.segment->close();
+        if (cFailingSegmentId == pending_segment.segment->get_id()) {
+            throw writer::Segment::OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
+        }
+        finalized_segment_ids.push_back(pending_segment.segment->get_id());
+    }, 2);
+
+    for (segment_id_t segment_id = 0; segment_id < cNumSegments; ++segment_id) {
+        auto segment = segment_finalizer.get_unused_segment();
+        REQUIRE(false == segment->is_open());
+        segment->open(segments_dir_path, segment_id, 0);
+        uint64_t offset;
+        segment->append(data, sizeof(data), offset);
+
+        writer::SegmentFinalizer::PendingSegment pending_segment;
+        pending_segment.segment = std::move(segment);
+        pending_segment.dynamic_compressed_size = 0;
+        try {
+            segment_finalizer.add_segment(std::move(pending_segment));
+        } catch (const writer::Segment::OperationFailed& e) {
+            // Segments after the failed one should be rejected and closed
+            REQUIRE(segment_id > cFailingSegmentId);
+            REQUIRE(false == pending_segment.segment->is_open());
+            break;
+        }
+    }
+    REQUIRE_THROWS_AS(segment_finalizer.close(), writer::Segment::OperationFailed);
+
+    // Segments should be finalized in order up until the failed one
+    REQUIRE(finalized_segment_ids.size() == cFailingSegmentId);
+    for (segment_id_t i = 0; i < finalized_segment_ids.size(); ++i) {
+        REQUIRE(i == finalized_segment_ids[i]);
+    }
+
+    boost::system::error_code boost_error_code;
+    boost::filesystem::remove_all(segments_dir_path, boost_error_code);
+    REQUIRE(!boost_error_code);
+}
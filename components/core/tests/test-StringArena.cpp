@@ -0,0 +1,87 @@
+// C++ standard libraries
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/StringArena.hpp"
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+TEST_CASE("StringArena", "[StringArena]") {
+    constexpr size_t cBlockSize = 64;
+    StringArena arena(cBlockSize);
+    REQUIRE(0 == arena.get_allocated_size());
+
+    SECTION("Views remain valid as the arena grows") {
+        // Add enough values to fill many blocks
+        vector<string> values;
+        vector<string_view> views;
+        for (size_t i = 0; i < 100; ++i) {
+            values.push_back("value" + std::to_string(i));
+            views.push_back(arena.add(values.back()));
+            // Views shouldn't point into the original string
+            REQUIRE(views.back().data() != values.back().data());
+        }
+        REQUIRE(arena.get_allocated_size() > cBlockSize);
+        REQUIRE(arena.get_allocated_size() % cBlockSize == 0);
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            REQUIRE(views[i] == values[i]);
+        }
+    }
+
+    SECTION("Empty values") {
+        REQUIRE(arena.add("").empty());
+        REQUIRE(0 == arena.get_allocated_size());
+    }
+
+    SECTION("Values larger than a block") {
+        auto small_view = arena.add("small");
+        REQUIRE(cBlockSize == arena.get_allocated_size());
+
+        string large_value(cBlockSize * 3, 'x');
+        auto large_view = arena.add(large_value);
+        REQUIRE(large_view == large_value);
+        REQUIRE(cBlockSize + large_value.length() == arena.get_allocated_size());
+
+        // Large values get their own block, so the current block should still be used for small values
+        auto other_small_view = arena.add("other");
+        REQUIRE(other_small_view.data() == small_view.data() + small_view.length());
+        REQUIRE(cBlockSize + large_value.length() == arena.get_allocated_size());
+
+        REQUIRE(small_view == "small");
+        REQUIRE(large_view == large_value);
+        REQUIRE(other_small_view == "other");
+    }
+
+    SECTION("Values larger than the default block size") {
+        StringArena default_arena;
+        string large_value(StringArena::cDefaultBlockSize + 1, 'z');
+        auto large_view = default_arena.add(large_value);
+        auto small_view = default_arena.add("small");
+        REQUIRE(large_view == large_value);
+        REQUIRE(small_view == "small");
+        REQUIRE(large_value.length() + StringArena::cDefaultBlockSize == default_arena.get_allocated_size());
+    }
+
+    SECTION("Clear") {
+        for (size_t i = 0; i < 20; ++i) {
+            arena.add("value" + std::to_string(i));
+        }
+        REQUIRE(arena.get_allocated_size() > 0);
+
+        arena.clear();
+        REQUIRE(0 == arena.get_allocated_size());
+
+        // The arena should be usable after it's cleared
+        auto view = arena.add("after clear");
+        REQUIRE(view == "after clear");
+        REQUIRE(cBlockSize == arena.get_allocated_size());
+    }
+}
@@ -0,0 +1,108 @@
+// C++ standard libraries
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/Defs.h"
+#include "../src/streaming_archive/column_encoding.hpp"
+
+using streaming_archive::column_encoding::Codec;
+using streaming_archive::column_encoding::ColumnHeader;
+using streaming_archive::column_encoding::cColumnHeaderSize;
+using streaming_archive::column_encoding::decode_column_in_place;
+using streaming_archive::column_encoding::encode_column;
+using streaming_archive::column_encoding::get_encoded_values_size;
+using streaming_archive::column_encoding::parse_column_header;
+using std::vector;
+
+/**
+ * Encodes the given column, then decodes it and validates it matches the original
+ * @param values
+ * @param try_delta_codecs
+ * @param header Returns the header of the encoded column
+ */
+static void encode_and_decode_column (const vector<int64_t>& values, bool try_delta_codecs, ColumnHeader& header);
+
+static void encode_and_decode_column (const vector<int64_t>& values, bool try_delta_codecs, ColumnHeader& header) {
+    vector<char> encoded_column;
+    encode_column(values.data(), values.size(), try_delta_codecs, encoded_column);
+    REQUIRE(encoded_column.size() >= cColumnHeaderSize);
+    REQUIRE(ErrorCode_Success == parse_column_header(encoded_column.data(), header));
+    REQUIRE(encoded_column.size() == cColumnHeaderSize + get_encoded_values_size(header, values.size()));
+
+    // Copy the encoded values into a column-sized buffer, as a reader would
+    vector<int64_t> decoded_values(values.size());
+    if (false == values.empty()) {
+        memcpy(decoded_values.data(), encoded_column.data() + cColumnHeaderSize, encoded_column.size() - cColumnHeaderSize);
+    }
+    decode_column_in_place(header, decoded_values.size(), decoded_values.data());
+    REQUIRE(values == decoded_values);
+}
+
+TEST_CASE("column_encoding", "[column_encoding]") {
+    ColumnHeader header;
+
+    SECTION("Empty column") {
+        encode_and_decode_column({}, true, header);
+    }
+
+    SECTION("Constant column") {
+        vector<int64_t> values(1000, 42);
+        encode_and_decode_column(values, false, header);
+        REQUIRE(Codec::FrameOfReference == header.codec);
+        REQUIRE(0 == header.num_bytes_per_value);
+    }
+
+    SECTION("Logtype-like IDs") {
+        vector<int64_t> values;
+        for (int64_t i = 0; i < 10000; ++i) {
+            values.push_back(1000 + (i * 7919) % 300);
+        }
+        encode_and_decode_column(values, false, header);
+        REQUIRE(Codec::FrameOfReference == header.codec);
+        REQUIRE(2 == header.num_bytes_per_value);
+    }
+
+    SECTION("Timestamps") {
+        vector<int64_t> values;
+        epochtime_t timestamp = 1'650'000'000'000;
+        for (int64_t i = 0; i < 10000; ++i) {
+            values.push_back(timestamp);
+            timestamp += i % 3;
+        }
+        encode_and_decode_column(values, true, header);
+        REQUIRE(Codec::DeltaFrameOfReference == header.codec);
+        REQUIRE(1 == header.num_bytes_per_value);
+
+        // Timestamps with a jittery but steadily growing interval should be encoded as delta-of-deltas
+        values.clear();
+        timestamp = 1'650'000'000'000;
+        for (int64_t i = 0; i < 10000; ++i) {
+            values.push_back(timestamp);
+            timestamp += i * 100 + i % 2;
+        }
+        encode_and_decode_column(values, true, header);
+        REQUIRE(Codec::DeltaOfDeltaFrameOfReference == header.codec);
+        REQUIRE(1 == header.num_bytes_per_value);
+    }
+
+    SECTION("Values spanning the full range") {
+        vector<int64_t> values = {std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 0, -1, 1,
+                                  std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+        encode_and_decode_column(values, true, header);
+        REQUIRE(Codec::Raw == header.codec);
+    }
+
+    SECTION("Invalid header") {
+        char header_buf[cColumnHeaderSize] = {};
+        header_buf[0] = static_cast<char>(Codec::Length);
+        REQUIRE(ErrorCode_Corrupt == parse_column_header(header_buf, header));
+        header_buf[0] = static_cast<char>(Codec::FrameOfReference);
+        header_buf[1] = 9;
+        REQUIRE(ErrorCode_Corrupt == parse_column_header(header_buf, header));
+    }
+}
@@ -0,0 +1,149 @@
+// C++ standard libraries
+#include <string>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/BloomFilter.hpp"
+#include "../src/FileReader.hpp"
+#include "../src/VariableDictionaryReader.hpp"
+#include "../src/VariableDictionaryWriter.hpp"
+
+using std::string;
+using std::to_string;
+
+/**
+ * @param path
+ * @return The Bloom filter read from the given path
+ */
+static BloomFilter read_filter (const string& path) {
+    BloomFilter filter;
+    FileReader filter_reader;
+    filter_reader.open(path);
+    REQUIRE(ErrorCode_Success == filter.try_read_from_file(filter_reader));
+    filter_reader.close();
+    return filter;
+}
+
+TEST_CASE("Test reading a dictionary while it's being written", "[DictionaryReader][DictionaryWriter]") {
+    const string cVarDictPath = "unit-test-var.dict";
+    const string cVarSegmentIndexPath = "unit-test-var.segindex";
+    constexpr size_t cNumEntriesPerSegment = 1000;
+    constexpr segment_id_t cNumSegments = 3;
+
+    VariableDictionaryWriter var_dict_writer;
+    var_dict_writer.open(cVarDictPath, cVarSegmentIndexPath, cVariableDictionaryIdMax);
+    var_dict_writer.write_header_and_flush_to_disk();
+
+    VariableDictionaryReader var_dict_reader;
+    var_dict_reader.open(cVarDictPath, cVarSegmentIndexPath);
+    var_dict_reader.read_new_entries();
+    REQUIRE(var_dict_reader.get_entries().empty());
+
+    for (segment_id_t segment_id = 0; segment_id < cNumSegments; ++segment_id) {
+        // Add entries to a segment but don't flush them
+        ArrayBackedPosIntSet<variable_dictionary_id_t> ids_in_segment;
+        variable_dictionary_id_t id;
+        for (size_t i = 0; i < cNumEntriesPerSegment; ++i) {
+            var_dict_writer.add_entry("var" + to_string(segment_id) + "_" + to_string(i), id);
+            ids_in_segment.insert(id);
+        }
+        // Every segment also contains the first entry
+        ids_in_segment.insert(0);
+        var_dict_writer.index_segment(segment_id, ids_in_segment);
+
+        // Unflushed entries shouldn't be visible
+        var_dict_reader.read_new_entries();
+        REQUIRE(var_dict_reader.get_entries().size() == segment_id * cNumEntriesPerSegment);
+
+        // Once flushed, exactly the new entries and segment should be read
+        var_dict_writer.write_header_and_flush_to_disk();
+        var_dict_reader.read_new_entries();
+        REQUIRE(var_dict_reader.get_entries().size() == (segment_id + 1) * cNumEntriesPerSegment);
+        REQUIRE(var_dict_reader.get_value(id) == "var" + to_string(segment_id) + "_" + to_string(cNumEntriesPerSegment - 1));
+        REQUIRE(var_dict_reader.get_entry(0).get_ids_of_segments_containing_entry().size() == segment_id + 1);
+        REQUIRE(var_dict_reader.get_entry(id).get_ids_of_segments_containing_entry().count(segment_id) == 1);
+    }
+
+    var_dict_writer.close();
+    var_dict_reader.read_new_entries();
+    REQUIRE(var_dict_reader.get_entries().size() == cNumSegments * cNumEntriesPerSegment);
+    var_dict_reader.close();
+
+    boost::filesystem::remove(cVarDictPath);
+    boost::filesystem::remove(cVarSegmentIndexPath);
+}
+
+TEST_CASE("Test spilling a dictionary's mappings to disk", "[DictionaryWriter]") {
+    const string cVarDictPath = "unit-test-spilled-var.dict";
+    const string cVarSegmentIndexPath = "unit-test-spilled-var.segindex";
+    constexpr size_t cNumEntriesPerSpill = 1000;
+    constexpr size_t cNumSpills = 6;
+
+    VariableDictionaryWriter var_dict_writer;
+    var_dict_writer.open(cVarDictPath, cVarSegmentIndexPath, cVariableDictionaryIdMax);
+
+    variable_dictionary_id_t id;
+    for (size_t spill_ix = 0; spill_ix < cNumSpills; ++spill_ix) {
+        for (size_t i = 0; i < cNumEntriesPerSpill; ++i) {
+            REQUIRE(var_dict_writer.add_entry("var" + to_string(spill_ix) + "_" + to_string(i), id));
+            REQUIRE(id == spill_ix * cNumEntriesPerSpill + i);
+        }
+        // Re-add a value from the first batch, so that it's brought back into memory and spilled again
+        REQUIRE(false == var_dict_writer.add_entry("var0_0", id));
+        REQUIRE(0 == id);
+
+        auto in_memory_size = var_dict_writer.get_in_memory_size();
+        var_dict_writer.spill_mappings_to_disk();
+        REQUIRE(var_dict_writer.get_in_memory_size() < in_memory_size);
+    }
+
+    // Existing values should keep their IDs, whether they were spilled or not
+    for (size_t spill_ix = 0; spill_ix < cNumSpills; ++spill_ix) {
+        for (size_t i = 0; i < cNumEntriesPerSpill; i += 7) {
+            REQUIRE(false == var_dict_writer.add_entry("var" + to_string(spill_ix) + "_" + to_string(i), id));
+            REQUIRE(id == spill_ix * cNumEntriesPerSpill + i);
+        }
+    }
+    REQUIRE(var_dict_writer.add_entry("new", id));
+    REQUIRE(id == cNumSpills * cNumEntriesPerSpill);
+
+    // The value filter should contain every value, including spilled ones
+    const string cVarDictFilterPath = "unit-test-spilled-var.dict.filter";
+    var_dict_writer.write_value_filter(cVarDictFilterPath);
+    REQUIRE(false == boost::filesystem::exists(cVarDictFilterPath + ".tmp"));
+    auto filter = read_filter(cVarDictFilterPath);
+    REQUIRE(filter.possibly_contains(BloomFilter::hash("var0_0")));
+    REQUIRE(filter.possibly_contains(BloomFilter::hash("var" + to_string(cNumSpills - 1) + "_" + to_string(cNumEntriesPerSpill - 1))));
+    REQUIRE(filter.possibly_contains(BloomFilter::hash("new")));
+    boost::filesystem::remove(cVarDictFilterPath);
+
+    var_dict_writer.close();
+    REQUIRE(false == boost::filesystem::exists(cVarDictPath + ".spill.0"));
+
+    // All entries should have been written to the dictionary exactly once
+    VariableDictionaryReader var_dict_reader;
+    var_dict_reader.open(cVarDictPath, cVarSegmentIndexPath);
+    var_dict_reader.read_new_entries();
+    REQUIRE(var_dict_reader.get_entries().size() == cNumSpills * cNumEntriesPerSpill + 1);
+    REQUIRE(var_dict_reader.get_value(cNumEntriesPerSpill + 1) == "var1_1");
+    var_dict_reader.close();
+
+    // The value filter of a preloaded dictionary should contain the preloaded values as well as new ones
+    var_dict_writer.open_and_preload(cVarDictPath, cVarSegmentIndexPath, cVariableDictionaryIdMax);
+    REQUIRE(var_dict_writer.add_entry("newer", id));
+    var_dict_writer.write_value_filter(cVarDictFilterPath);
+    filter = read_filter(cVarDictFilterPath);
+    REQUIRE(filter.possibly_contains(BloomFilter::hash("var0_0")));
+    REQUIRE(filter.possibly_contains(BloomFilter::hash("new")));
+    REQUIRE(filter.possibly_contains(BloomFilter::hash("newer")));
+    boost::filesystem::remove(cVarDictFilterPath);
+    var_dict_writer.close();
+
+    boost::filesystem::remove(cVarDictPath);
+    boost::filesystem::remove(cVarSegmentIndexPath);
+}
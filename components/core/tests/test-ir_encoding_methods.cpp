@@ -438,6 +438,63 @@ TEMPLATE_TEST_CASE(
             == decode_next_message<TestType>(incomplete_preamble_buffer, message, timestamp));
 }
 
+TEMPLATE_TEST_CASE(
+        "deserialize_ir_message_reusing_containers",
+        "[ffi][deserialize_ir_message]",
+        four_byte_encoded_variable_t,
+        eight_byte_encoded_variable_t
+) {
+    vector<int8_t> ir_buf;
+    string logtype;
+
+    // Messages with decreasing and then increasing numbers of variables
+    vector<string> const messages{
+            "Static text, dictVar1, dictVar2, dictVar3, 123, 456.7",
+            "Static text, dictVar4, 987",
+            "Static text without variables",
+            "Static text, dictVar5, dictVar6, dictVar7, dictVar8, 654.3"};
+    epoch_time_ms_t const reference_timestamp = get_next_timestamp_for_test<TestType>();
+    for (auto const& message : messages) {
+        REQUIRE(encode_message<TestType>(reference_timestamp, message, logtype, ir_buf));
+    }
+
+    BufferReader ir_buffer{size_checked_pointer_cast<char const>(ir_buf.data()), ir_buf.size()};
+    BufferReader fresh_ir_buffer{
+            size_checked_pointer_cast<char const>(ir_buf.data()),
+            ir_buf.size()
+    };
+    string reused_logtype;
+    vector<TestType> reused_encoded_vars;
+    vector<string> reused_dict_vars;
+    epoch_time_ms_t timestamp{};
+    for (size_t i = 0; i < messages.size(); ++i) {
+        REQUIRE(IRErrorCode::IRErrorCode_Success
+                == ffi::ir_stream::deserialize_ir_message(
+                        ir_buffer,
+                        reused_logtype,
+                        reused_encoded_vars,
+                        reused_dict_vars,
+                        timestamp
+                ));
+
+        // Results should match those deserialized into empty containers
+        string fresh_logtype;
+        vector<TestType> fresh_encoded_vars;
+        vector<string> fresh_dict_vars;
+        REQUIRE(IRErrorCode::IRErrorCode_Success
+                == ffi::ir_stream::deserialize_ir_message(
+                        fresh_ir_buffer,
+                        fresh_logtype,
+                        fresh_encoded_vars,
+                        fresh_dict_vars,
+                        timestamp
+                ));
+        REQUIRE(fresh_logtype == reused_logtype);
+        REQUIRE(fresh_encoded_vars == reused_encoded_vars);
+        REQUIRE(fresh_dict_vars == reused_dict_vars);
+    }
+}
+
 // NOTE: This test only tests eight_byte_encoded_variable_t because we trigger
 // IRErrorCode_Decode_Error by manually modifying the logtype within the IR, and
 // this is easier for the eight_byte_encoded_variable_t case.
@@ -99,3 +99,63 @@ TEST_CASE("ir::get_bounds_of_next_var", "[ir][get_bounds_of_next_var]") {
     REQUIRE(get_bounds_of_next_var(str, begin_pos, end_pos) == true);
     REQUIRE("var123" == str.substr(begin_pos, end_pos - begin_pos));
 }
+
+TEST_CASE("ir::get_bounds_of_next_var long tokens", "[ir][get_bounds_of_next_var]") {
+    // Long tokens and delimiter runs, including tokens whose classification
+    // depends on their last character and non-ASCII delimiters
+    string const long_delims(37, ' ');
+    string const long_hex(35, 'a');
+    string const long_non_var = string(20, 'x') + "__--..++" + string(20, 'y');
+    string const long_var_with_digit = string(33, 'z') + "7";
+    string const long_non_hex = string(31, 'f') + "g";
+    string str = long_delims + long_hex + long_delims + long_non_var + "/" + long_var_with_digit
+                 + "\xC3\xA9" + long_non_hex + "=" + string(40, 'q') + long_delims + "\xFF";
+
+    size_t begin_pos = 0;
+    size_t end_pos = 0;
+
+    REQUIRE(get_bounds_of_next_var(str, begin_pos, end_pos) == true);
+    REQUIRE(long_hex == str.substr(begin_pos, end_pos - begin_pos));
+
+    REQUIRE(get_bounds_of_next_var(str, begin_pos, end_pos) == true);
+    REQUIRE(long_var_with_digit == str.substr(begin_pos, end_pos - begin_pos));
+
+    REQUIRE(get_bounds_of_next_var(str, begin_pos, end_pos) == true);
+    REQUIRE(string(40, 'q') == str.substr(begin_pos, end_pos - begin_pos));
+
+    REQUIRE(get_bounds_of_next_var(str, begin_pos, end_pos) == false);
+    REQUIRE(str.length() == begin_pos);
+}
+
+TEST_CASE("ir::get_bounds_of_next_var benchmarks", "[ir][get_bounds_of_next_var][!benchmark]") {
+    // Each iteration finds every variable in one message, so the reported
+    // times are per message
+    auto find_all_vars = [](string_view message) {
+        size_t begin_pos = 0;
+        size_t end_pos = 0;
+        size_t num_vars = 0;
+        while (get_bounds_of_next_var(message, begin_pos, end_pos)) {
+            ++num_vars;
+        }
+        return num_vars;
+    };
+
+    string const typical_message
+            = "2023-03-14 09:26:53,589 INFO [org.apache.hadoop.yarn.server.nodemanager."
+              "NodeStatusUpdaterImpl] Sending out 3 NM container statuses: "
+              "[container_1678781033_0042_01_000007, 0xdeadbeef, task_id=73]";
+    BENCHMARK("Typical message") {
+        return find_all_vars(typical_message);
+    };
+
+    string const long_tokens_message = string(64, 'a') + " " + string(64, 'x') + "7 "
+                                       + string(64, '-') + " /" + string(64, 'f') + "g";
+    BENCHMARK("Message with long tokens") {
+        return find_all_vars(long_tokens_message);
+    };
+
+    string const delims_message(150, ' ');
+    BENCHMARK("Message of delimiters") {
+        return find_all_vars(delims_message);
+    };
+}
@@ -1,2 +1,10 @@
-#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_RUNNER
 #include <Catch2/single_include/catch2/catch.hpp>
+
+// Project headers
+#include "../src/Profiler.hpp"
+
+int main (int argc, char* argv[]) {
+    Profiler::init();
+    return Catch::Session().run(argc, argv);
+}